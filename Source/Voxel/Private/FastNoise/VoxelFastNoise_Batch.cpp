@@ -0,0 +1,217 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "FastNoise/VoxelFastNoise_Batch.h"
+#include "FastNoise/VoxelFastNoise.h"
+#include "FastNoise/VoxelFastNoise.inl"
+#include "VoxelMinimal.h"
+#include "HAL/IConsoleManager.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+static TAutoConsoleVariable<int32> CVarMaxNoiseSIMDLevel(
+	TEXT("voxel.noise.MaxSIMDLevel"),
+	3,
+	TEXT("Max instruction set used by the batched noise functions. 0: scalar reference path, 1: SSE4, 2: AVX2, 3: AVX512"),
+	ECVF_Default);
+
+#if PLATFORM_CPU_X86_FAMILY
+static void VoxelCpuid(int32 Leaf, int32 SubLeaf, uint32 Registers[4])
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	int32 Info[4];
+	__cpuidex(Info, Leaf, SubLeaf);
+	FMemory::Memcpy(Registers, Info, sizeof(Info));
+#else
+	if (!__get_cpuid_count(Leaf, SubLeaf, &Registers[0], &Registers[1], &Registers[2], &Registers[3]))
+	{
+		FMemory::Memzero(Registers, 4 * sizeof(uint32));
+	}
+#endif
+}
+
+static uint64 VoxelXgetbv()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	return _xgetbv(0);
+#else
+	uint32 Eax;
+	uint32 Edx;
+	__asm__ volatile("xgetbv" : "=a"(Eax), "=d"(Edx) : "c"(0));
+	return (uint64(Edx) << 32) | Eax;
+#endif
+}
+
+static EVoxelNoiseSIMDLevel DetectCPULevel()
+{
+	uint32 Registers[4];
+
+	VoxelCpuid(0, 0, Registers);
+	const uint32 MaxLeaf = Registers[0];
+	if (MaxLeaf < 1)
+	{
+		return EVoxelNoiseSIMDLevel::Scalar;
+	}
+
+	VoxelCpuid(1, 0, Registers);
+	const bool bSSE41 = Registers[2] & (1u << 19);
+	const bool bOSXSAVE = Registers[2] & (1u << 27);
+	if (!bSSE41)
+	{
+		return EVoxelNoiseSIMDLevel::Scalar;
+	}
+	if (!bOSXSAVE || MaxLeaf < 7)
+	{
+		return EVoxelNoiseSIMDLevel::SSE4;
+	}
+
+	// The OS must save the wide registers on context switches
+	const uint64 XCR0 = VoxelXgetbv();
+	const bool bOSSavesYMM = (XCR0 & 0x6) == 0x6;
+	const bool bOSSavesZMM = (XCR0 & 0xE6) == 0xE6;
+
+	VoxelCpuid(7, 0, Registers);
+	const bool bAVX2 = Registers[1] & (1u << 5);
+	const bool bAVX512F = Registers[1] & (1u << 16);
+
+	if (bAVX512F && bAVX2 && bOSSavesZMM)
+	{
+		return EVoxelNoiseSIMDLevel::AVX512;
+	}
+	if (bAVX2 && bOSSavesYMM)
+	{
+		return EVoxelNoiseSIMDLevel::AVX2;
+	}
+	return EVoxelNoiseSIMDLevel::SSE4;
+}
+#endif
+
+EVoxelNoiseSIMDLevel FVoxelFastNoiseSIMD::GetLevel()
+{
+	const int32 MaxLevel = FMath::Clamp(CVarMaxNoiseSIMDLevel.GetValueOnAnyThread(), 0, int32(EVoxelNoiseSIMDLevel::AVX512));
+	return EVoxelNoiseSIMDLevel(FMath::Min(int32(GetCPULevel()), MaxLevel));
+}
+
+EVoxelNoiseSIMDLevel FVoxelFastNoiseSIMD::GetCPULevel()
+{
+#if PLATFORM_CPU_X86_FAMILY
+	static const EVoxelNoiseSIMDLevel Level = DetectCPULevel();
+	return Level;
+#else
+	return EVoxelNoiseSIMDLevel::Scalar;
+#endif
+}
+
+const TCHAR* FVoxelFastNoiseSIMD::ToString(EVoxelNoiseSIMDLevel Level)
+{
+	switch (Level)
+	{
+	default: ensure(false);
+	case EVoxelNoiseSIMDLevel::Scalar: return TEXT("Scalar");
+	case EVoxelNoiseSIMDLevel::SSE4: return TEXT("SSE4");
+	case EVoxelNoiseSIMDLevel::AVX2: return TEXT("AVX2");
+	case EVoxelNoiseSIMDLevel::AVX512: return TEXT("AVX512");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Throughput of every batched kernel at every level supported by this CPU, and max difference with the scalar path
+static void BenchmarkVoxelNoiseBatch(const TArray<FString>& Args)
+{
+	const int32 NumPoints = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 65536;
+	const int32 Octaves = 6;
+	const v_flt Frequency = 0.02;
+	const int32 NumIterations = 8;
+
+	FVoxelFastNoise Noise;
+	Noise.SetSeed(1337);
+	Noise.SetFractalOctavesAndGain(Octaves, 0.5);
+
+	FRandomStream Stream(0);
+	TArray<v_flt> X;
+	TArray<v_flt> Y;
+	TArray<v_flt> Z;
+	X.SetNumUninitialized(NumPoints);
+	Y.SetNumUninitialized(NumPoints);
+	Z.SetNumUninitialized(NumPoints);
+	for (int32 Index = 0; Index < NumPoints; Index++)
+	{
+		X[Index] = Stream.FRandRange(-10000, 10000);
+		Y[Index] = Stream.FRandRange(-10000, 10000);
+		Z[Index] = Stream.FRandRange(-1000, 1000);
+	}
+
+	using FKernel = TFunction<void(EVoxelNoiseSIMDLevel Level, v_flt* Out)>;
+	const TArray<TPair<const TCHAR*, FKernel>> Kernels =
+	{
+		{ TEXT("Value3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetValue_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Out, NumPoints, Level); } },
+		{ TEXT("ValueFractal3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetValueFractal_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Octaves, Out, NumPoints, Level); } },
+		{ TEXT("Perlin2D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetPerlin_2D_Batch(X.GetData(), Y.GetData(), Frequency, Out, NumPoints, Level); } },
+		{ TEXT("Perlin3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetPerlin_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Out, NumPoints, Level); } },
+		{ TEXT("PerlinFractal3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetPerlinFractal_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Octaves, Out, NumPoints, Level); } },
+		{ TEXT("Simplex3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetSimplex_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Out, NumPoints, Level); } },
+		{ TEXT("SimplexFractal3D"), [&](EVoxelNoiseSIMDLevel Level, v_flt* Out) { Noise.GetSimplexFractal_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Octaves, Out, NumPoints, Level); } },
+	};
+
+	const EVoxelNoiseSIMDLevel CPULevel = FVoxelFastNoiseSIMD::GetCPULevel();
+	LOG_VOXEL(Log, TEXT("Voxel noise batch benchmark: %d points, CPU level: %s, current level: %s"),
+		NumPoints,
+		FVoxelFastNoiseSIMD::ToString(CPULevel),
+		FVoxelFastNoiseSIMD::ToString(FVoxelFastNoiseSIMD::GetLevel()));
+
+	TArray<v_flt> Reference;
+	TArray<v_flt> Values;
+	Reference.SetNumUninitialized(NumPoints);
+	Values.SetNumUninitialized(NumPoints);
+
+	for (auto& Kernel : Kernels)
+	{
+		Kernel.Value(EVoxelNoiseSIMDLevel::Scalar, Reference.GetData());
+
+		for (int32 LevelIndex = 0; LevelIndex <= int32(CPULevel); LevelIndex++)
+		{
+			const EVoxelNoiseSIMDLevel Level = EVoxelNoiseSIMDLevel(LevelIndex);
+
+			const double StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+			{
+				Kernel.Value(Level, Values.GetData());
+			}
+			const double Time = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+			v_flt MaxDifference = 0;
+			for (int32 Index = 0; Index < NumPoints; Index++)
+			{
+				MaxDifference = FMath::Max(MaxDifference, FMath::Abs(Values[Index] - Reference[Index]));
+			}
+
+			LOG_VOXEL(Log, TEXT("%-16s %-6s: %8.2f Mpts/s, %6.2fns/pt, max difference with scalar: %g"),
+				Kernel.Key,
+				FVoxelFastNoiseSIMD::ToString(Level),
+				NumPoints / Time / 1e6,
+				Time * 1e9 / NumPoints,
+				double(MaxDifference));
+		}
+	}
+
+	// Cellular has no vectorized kernel, only log its batch cost for reference
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Noise.GetCellular_3D_Batch(X.GetData(), Y.GetData(), Z.GetData(), Frequency, Values.GetData(), NumPoints);
+		const double Time = FPlatformTime::Seconds() - StartTime;
+		LOG_VOXEL(Log, TEXT("%-16s %-6s: %8.2f Mpts/s, %6.2fns/pt"), TEXT("Cellular3D"), TEXT("Scalar"), NumPoints / Time / 1e6, Time * 1e9 / NumPoints);
+	}
+}
+
+static FAutoConsoleCommand BenchmarkVoxelNoiseBatchCmd(
+	TEXT("voxel.noise.BenchmarkBatch"),
+	TEXT("Measure the throughput of the batched noise kernels at every SIMD level supported by this CPU. Args: [NumPoints=65536]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkVoxelNoiseBatch));
@@ -5,6 +5,7 @@
 #include "VoxelData/VoxelSave.h"
 #include "VoxelData/VoxelDataLock.h"
 #include "VoxelData/VoxelDataOctree.h"
+#include "VoxelData/VoxelDataSnapshot.h"
 #include "VoxelData/VoxelSaveUtilities.h"
 #include "VoxelData/VoxelDataUtilities.h"
 
@@ -17,6 +18,7 @@
 
 #include "Misc/ScopeLock.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 
 VOXEL_API TAutoConsoleVariable<int32> CVarMaxPlaceableItemsPerOctree(
 		TEXT("voxel.data.MaxPlaceableItemsPerOctree"),
@@ -94,7 +96,7 @@ FVoxelDataSettings::FVoxelDataSettings(
 
 FVoxelData::FVoxelData(const FVoxelDataSettings& Settings)
 	: IVoxelData(Settings.Depth, Settings.WorldBounds, Settings.bEnableMultiplayer, Settings.bEnableUndoRedo, Settings.Generator)
-	, Octree(MakeUnique<FVoxelDataOctreeParent>(Depth))
+	, Octree(MakeUnique<FVoxelDataOctreeParent>(Depth, GetSlabAllocator()))
 {
 	check(Depth > 0);
 	check(Octree->GetBounds().Contains(WorldBounds));
@@ -138,14 +140,18 @@ public:
 	const EVoxelLockType LockType;
 	const FVoxelIntBox Bounds;
 	const FName Name;
+	const bool bRecordVersions;
 
-	FVoxelDataOctreeLocker(EVoxelLockType LockType, const FVoxelIntBox& Bounds, FName Name)
+	FVoxelDataOctreeLocker(EVoxelLockType LockType, const FVoxelIntBox& Bounds, FName Name, bool bRecordVersions = false)
 		: LockType(LockType)
 		, Bounds(Bounds)
 		, Name(Name)
+		, bRecordVersions(bRecordVersions)
 	{
 	}
 
+	TArray<TPair<const FVoxelSharedMutex*, uint32>> LockedVersions;
+
 	TArray<FVoxelOctreeId> Lock(FVoxelDataOctreeBase& Octree)
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
@@ -190,6 +196,14 @@ private:
 		if (Octree.IsLeafOrHasNoChildren())
 		{
 			LockedOctrees.Add(Octree.GetId());
+
+			if (bRecordVersions)
+			{
+				// No writer can hold the lock, so the version is even
+				const uint32 Version = Octree.Mutex.GetVersion();
+				checkVoxelSlow(Version % 2 == 0);
+				LockedVersions.Emplace(&Octree.Mutex, Version);
+			}
 		}
 		else
 		{
@@ -259,20 +273,169 @@ private:
 	}
 };
 
+class FVoxelDataOctreeTryLocker
+{
+public:
+	const FVoxelIntBox Bounds;
+	const bool bCreateChildren;
+	const TFunctionRef<void(FVoxelDataOctreeLeaf&)> Lambda;
+
+	FVoxelDataOctreeTryLocker(const FVoxelIntBox& Bounds, bool bCreateChildren, TFunctionRef<void(FVoxelDataOctreeLeaf&)> Lambda)
+		: Bounds(Bounds)
+		, bCreateChildren(bCreateChildren)
+		, Lambda(Lambda)
+	{
+	}
+
+	void Iterate(FVoxelDataOctreeBase& Octree)
+	{
+		checkVoxelSlow(Bounds.Intersect(Octree.GetBounds()));
+
+		if (Octree.IsLeaf())
+		{
+			if (Octree.Mutex.TryLock(EVoxelLockType::Write))
+			{
+				Lambda(Octree.AsLeaf());
+				Octree.Mutex.Unlock(EVoxelLockType::Write);
+			}
+			return;
+		}
+
+		// Parents with children are only locked for a short time by the lockers going through them: only skip the ones being written
+		if (!Octree.Mutex.TryLock(EVoxelLockType::Read))
+		{
+			return;
+		}
+
+		auto& Parent = Octree.AsParent();
+		if (!Parent.HasChildren())
+		{
+			Octree.Mutex.Unlock(EVoxelLockType::Read);
+
+			if (!bCreateChildren || !Octree.Mutex.TryLock(EVoxelLockType::Write))
+			{
+				return;
+			}
+
+			// Might have been created while unlocked
+			if (!Parent.HasChildren())
+			{
+				// The new children are locked through their parent
+				FVoxelOctreeUtilities::IterateTreeInBounds(Octree, Bounds, [&](FVoxelDataOctreeBase& Chunk)
+				{
+					if (Chunk.IsLeaf())
+					{
+						Lambda(Chunk.AsLeaf());
+					}
+					else if (!Chunk.AsParent().HasChildren())
+					{
+						Chunk.AsParent().CreateChildren();
+					}
+				});
+				Octree.Mutex.Unlock(EVoxelLockType::Write);
+				return;
+			}
+
+			Octree.Mutex.Unlock(EVoxelLockType::Write);
+		}
+		else
+		{
+			Octree.Mutex.Unlock(EVoxelLockType::Read);
+		}
+
+		for (auto& Child : Parent.GetChildren())
+		{
+			if (Child.GetBounds().Intersect(Bounds))
+			{
+				Iterate(Child);
+			}
+		}
+	}
+};
+
 TUniquePtr<FVoxelDataLockInfo> FVoxelData::Lock(EVoxelLockType LockType, const FVoxelIntBox& Bounds, FName Name) const
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 	ensure(Bounds.IsValid());
 
+	const bool bReportStats = FVoxelDataLockStats::IsEnabled();
+	const uint64 StartCycles = bReportStats ? FPlatformTime::Cycles64() : 0;
+
 	MainLock.Lock(EVoxelLockType::Read);
 
 	auto LockInfo = TUniquePtr<FVoxelDataLockInfo>(new FVoxelDataLockInfo());
 	LockInfo->Name = Name;
 	LockInfo->LockType = LockType;
 	LockInfo->LockedOctrees = FVoxelDataOctreeLocker(LockType, Bounds, Name).Lock(GetOctree());
+
+	if (LockType == EVoxelLockType::Write && NumSnapshots.GetValue() > 0)
+	{
+		// The locked leaves are about to be modified
+		CaptureSnapshots(Bounds);
+	}
+
+	if (bReportStats)
+	{
+		FVoxelDataLockStats::ReportLock(LockType, false, FPlatformTime::Cycles64() - StartCycles);
+	}
+
 	return LockInfo;
 }
 
+TUniquePtr<FVoxelDataLockInfo> FVoxelData::LockOptimistic(const FVoxelIntBox& Bounds, FName Name) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	ensure(Bounds.IsValid());
+
+	const bool bReportStats = FVoxelDataLockStats::IsEnabled();
+	const uint64 StartCycles = bReportStats ? FPlatformTime::Cycles64() : 0;
+
+	MainLock.Lock(EVoxelLockType::Read);
+
+	auto LockInfo = TUniquePtr<FVoxelDataLockInfo>(new FVoxelDataLockInfo());
+	LockInfo->Name = Name;
+	LockInfo->LockType = EVoxelLockType::Read;
+	LockInfo->bOptimistic = true;
+
+	FVoxelDataOctreeLocker Locker(EVoxelLockType::Read, Bounds, Name, true);
+	LockInfo->LockedOctrees = Locker.Lock(GetOctree());
+	LockInfo->LockedVersions = MoveTemp(Locker.LockedVersions);
+
+	if (bReportStats)
+	{
+		FVoxelDataLockStats::ReportLock(EVoxelLockType::Read, true, FPlatformTime::Cycles64() - StartCycles);
+	}
+
+	return LockInfo;
+}
+
+void FVoxelData::IterateUnlockedLeaves(const FVoxelIntBox& Bounds, bool bCreateChildren, TFunctionRef<void(FVoxelDataOctreeLeaf&)> Lambda)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	ensure(Bounds.IsValid());
+
+	MainLock.Lock(EVoxelLockType::Read);
+
+	if (GetOctree().GetBounds().Intersect(Bounds))
+	{
+		FVoxelDataOctreeTryLocker(Bounds, bCreateChildren, Lambda).Iterate(GetOctree());
+	}
+
+	MainLock.Unlock(EVoxelLockType::Read);
+}
+
+bool FVoxelData::IsLockValid(const FVoxelDataLockInfo& LockInfo) const
+{
+	for (const auto& It : LockInfo.LockedVersions)
+	{
+		if (It.Key->GetVersion() != It.Value)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 void FVoxelData::Unlock(TUniquePtr<FVoxelDataLockInfo> LockInfo) const
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
@@ -284,6 +447,7 @@ void FVoxelData::Unlock(TUniquePtr<FVoxelDataLockInfo> LockInfo) const
 	MainLock.Unlock(EVoxelLockType::Read);
 
 	LockInfo->LockedOctrees.Reset();
+	LockInfo->LockedVersions.Reset();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -296,6 +460,16 @@ void FVoxelData::ClearData()
 
 	MainLock.Lock(EVoxelLockType::Write);
 	{
+		{
+			// The leaves are about to be destroyed
+			FScopeLock Lock(&SnapshotsSection);
+			for (FVoxelDataSnapshot* Snapshot : Snapshots)
+			{
+				Snapshot->CaptureAll();
+				Snapshot->UpdateStats();
+			}
+		}
+
 		// Clear the data to have clean memory reports
 		FVoxelOctreeUtilities::IterateAllLeaves(GetOctree(), [&](FVoxelDataOctreeLeaf& Leaf)
 		{
@@ -309,13 +483,15 @@ void FVoxelData::ClearData()
 		ensure(GetCachedMemory().Values.GetValue() == 0);
 		ensure(GetCachedMemory().Materials.GetValue() == 0);
 
-		Octree = MakeUnique<FVoxelDataOctreeParent>(Depth);
+		Octree = MakeUnique<FVoxelDataOctreeParent>(Depth, GetSlabAllocator());
 	}
 	MainLock.Unlock(EVoxelLockType::Write);
 
 	UndoRedo = {};
 	MarkAsDirty();
 
+	ClearPendingSaveRegions();
+
 #define CLEAR(Type, Stat) \
 	{ \
 		auto& ItemsData = GetItemsData<Type>(); \
@@ -334,6 +510,9 @@ void FVoxelData::ClearData()
 void FVoxelData::ClearOctreeData(TArray<FVoxelIntBox>& OutBoundsToUpdate)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	// The pending regions are edits too
+	ClearPendingSaveRegions();
 	
 	FVoxelOctreeUtilities::IterateAllLeaves(GetOctree(), [&](FVoxelDataOctreeLeaf& Leaf)
 	{
@@ -589,75 +768,102 @@ TVoxelRange<v_flt> FVoxelData::GetCustomOutputRange(TVoxelRange<v_flt> DefaultVa
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-void FVoxelData::GetSave(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FVoxelObjectArchiveEntry>& OutObjects)
+TVoxelSharedRef<FVoxelDataSnapshot> FVoxelData::CreateSnapshot() const
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
-	
-	FVoxelReadScopeLock Lock(*this, FVoxelIntBox::Infinite, "GetSave");
 
-	FVoxelSaveBuilder Builder(Depth);
+	// Wait for the pending edits. Edits done after the snapshot is registered will capture the leaves they modify
+	FVoxelReadScopeLock Lock(*this, FVoxelIntBox::Infinite, "CreateSnapshot");
 
-	TArray<TUniquePtr<TVoxelDataOctreeLeafData<FVoxelValue>>> BuffersToDelete;
+	const TVoxelSharedRef<FVoxelDataSnapshot> Snapshot = MakeShareable(new FVoxelDataSnapshot(*this));
 
-	FVoxelOctreeUtilities::IterateAllLeaves(*Octree, [&](FVoxelDataOctreeLeaf& Leaf)
+	FVoxelOctreeUtilities::IterateAllLeaves(GetOctree(), [&](const FVoxelDataOctreeLeaf& Leaf)
 	{
-		TVoxelDataOctreeLeafData<FVoxelValue>* ValuesPtr = &Leaf.Values;
-		
-		if (CVarStoreSpecialValueForGeneratorValuesInSaves.GetValueOnGameThread() != 0)
-		{
-			VOXEL_ASYNC_SCOPE_COUNTER("Diffing with generator");
-			
-			// Only if dirty and not compressed to a single value
-			if (Leaf.Values.IsDirty() && !Leaf.Values.IsSingleValue())
-			{
-				auto UniquePtr = MakeUnique<TVoxelDataOctreeLeafData<FVoxelValue>>();
-				UniquePtr->CreateData(*this);
-				UniquePtr->SetIsDirty(true, *this);
+		const int32 Index = Snapshot->Entries.Num();
+		FVoxelDataSnapshot::FEntry& Entry = Snapshot->Entries.Emplace_GetRef();
+		Entry.Position = Leaf.Position;
+		Entry.Bounds = Leaf.GetBounds();
+		Entry.Leaf = &Leaf;
+		Snapshot->PositionToEntry.Add(Leaf.Position, Index);
+	});
 
-				const FVoxelIntBox LeafBounds = Leaf.GetBounds();
-				LeafBounds.Iterate([&](int32 X, int32 Y, int32 Z)
-				{
-					const FVoxelCellIndex Index = FVoxelDataOctreeUtilities::IndexFromGlobalCoordinates(LeafBounds.Min, X, Y, Z);
-					const FVoxelValue Value = Leaf.Values.Get(Index);
-					// Empty stack: items not loaded when loading in LoadFromSave
-					const FVoxelValue GeneratorValue = Generator->Get<FVoxelValue>(X, Y, Z, 0, FVoxelItemStack::Empty);
+	// Items are added & removed under write locks
+	for (auto& Item : AssetItemsData.Items)
+	{
+		Snapshot->AssetItems.Add(Item->Item);
+	}
 
-					if (GeneratorValue == Value)
-					{
-						UniquePtr->GetRef(Index) = FVoxelValue::Special();
-					}
-					else
-					{
-						UniquePtr->GetRef(Index) = Value;
-					}
-				});
+	{
+		FScopeLock SnapshotsLock(&SnapshotsSection);
+		Snapshots.Add(&Snapshot.Get());
+		NumSnapshots.Increment();
+	}
 
-				UniquePtr->TryCompressToSingleValue(*this);
-				ValuesPtr = UniquePtr.Get();
-				BuffersToDelete.Emplace(MoveTemp(UniquePtr));
-			}
-		}
-		
-		Builder.AddChunk(Leaf.Position, *ValuesPtr, Leaf.Materials);
-	});
+	return Snapshot;
+}
 
+void FVoxelData::CaptureSnapshots(const FVoxelIntBox& Bounds) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	FScopeLock Lock(&SnapshotsSection);
+
+	FVoxelOctreeUtilities::IterateLeavesInBounds(GetOctree(), Bounds, [&](const FVoxelDataOctreeLeaf& Leaf)
 	{
-		VOXEL_ASYNC_SCOPE_COUNTER("Items");
-		
-		for (auto& Item : AssetItemsData.Items)
+		for (FVoxelDataSnapshot* Snapshot : Snapshots)
 		{
-			Builder.AddAssetItem(Item->Item);
+			Snapshot->CaptureLeaf(Leaf);
 		}
+	});
+
+	for (FVoxelDataSnapshot* Snapshot : Snapshots)
+	{
+		Snapshot->UpdateStats();
 	}
+}
 
-	Builder.Save(OutSave, OutObjects);
+void FVoxelData::UnregisterSnapshot(FVoxelDataSnapshot& Snapshot) const
+{
+	FScopeLock Lock(&SnapshotsSection);
+	ensure(Snapshots.RemoveSwap(&Snapshot) == 1);
+	NumSnapshots.Decrement();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelData::GetSave(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FVoxelObjectArchiveEntry>& OutObjects)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
 	
-	VOXEL_ASYNC_SCOPE_COUNTER("ClearData");
-	for (auto& Buffer : BuffersToDelete)
+	// Query the pending regions before the snapshot: regions loaded in between are in both, and are deduplicated below
+	TVoxelSharedPtr<const FVoxelCompressedWorldSaveImpl> Save;
+	TArray<int32> RegionIndices;
+	{
+		FScopeLock Lock(&PendingSaveRegionsSection);
+		Save = PendingSave;
+		RegionIndices = PendingSaveRegions;
+	}
+
+	CreateSnapshot()->GetSave(OutSave, OutObjects);
+
+	if (RegionIndices.Num() == 0)
+	{
+		return;
+	}
+
+	VOXEL_ASYNC_SCOPE_COUNTER("Add pending save regions");
+
+	// The regions that are not loaded yet are still part of the world
+	FVoxelUncompressedWorldSaveImpl PendingRegionsSave;
+	if (!UVoxelSaveUtilities::DecompressVoxelSaveRegions(*Save, RegionIndices, PendingRegionsSave, false))
 	{
-		// For correct memory reports
-		Buffer->ClearData(*this);
+		return;
 	}
+
+	// Leaves loaded or edited since then are already in the save
+	FVoxelSaveRegionUtilities::AddMissingChunks(PendingRegionsSave, OutSave);
 }
 
 bool FVoxelData::LoadFromSave(const FVoxelUncompressedWorldSaveImpl& Save, const FVoxelPlaceableItemLoadInfo& LoadInfo, TArray<FVoxelIntBox>* OutBoundsToUpdate)
@@ -699,36 +905,7 @@ bool FVoxelData::LoadFromSave(const FVoxelUncompressedWorldSaveImpl& Save, const
 			auto& Leaf = Tree.AsLeaf();
 			if (CurrentPosition == Tree.Position)
 			{
-				Loader.ExtractChunk(ChunkIndex, *this, Leaf.Values, Leaf.Materials);
-				
-				if (CVarStoreSpecialValueForGeneratorValuesInSaves.GetValueOnGameThread() != 0)
-				{
-					VOXEL_ASYNC_SCOPE_COUNTER("Loading generator values");
-					
-					// If we are dirty and we are not a single value, or if we are a single special value
-					if (Leaf.Values.IsDirty() && (!Leaf.Values.IsSingleValue() || Leaf.Values.GetSingleValue() == FVoxelValue::Special()))
-					{
-						if (Leaf.Values.IsSingleValue())
-						{
-							Leaf.Values.ExpandSingleValue(*this);
-						}
-
-						OctreeBounds.Iterate([&](int32 X, int32 Y, int32 Z)
-						{
-							const FVoxelCellIndex Index = FVoxelDataOctreeUtilities::IndexFromGlobalCoordinates(OctreeBounds.Min, X, Y, Z);
-							FVoxelValue& Value = Leaf.Values.GetRef(Index);
-
-							if (Value == FVoxelValue::Special())
-							{
-								// Use the generator value, ignoring all assets and items as they are not loaded
-								// The same is done when checking on save
-								Value = Generator->Get<FVoxelValue>(X, Y, Z, 0, FVoxelItemStack::Empty);
-							}
-						});
-
-						Leaf.Values.TryCompressToSingleValue(*this);
-					}
-				}
+				LoadLeafFromSave(Leaf, Loader, ChunkIndex);
 
 				ChunkIndex++;
 				if (OutBoundsToUpdate)
@@ -761,6 +938,254 @@ bool FVoxelData::LoadFromSave(const FVoxelUncompressedWorldSaveImpl& Save, const
 	return !Loader.GetError();
 }
 
+bool FVoxelData::LoadFromSave(
+	const TVoxelSharedRef<const FVoxelCompressedWorldSaveImpl>& Save,
+	const FVoxelPlaceableItemLoadInfo& LoadInfo,
+	TConstArrayView<FVoxelIntBox> BoundsToLoad,
+	TArray<FVoxelIntBox>* OutBoundsToUpdate)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	if (!Save->IsRegionIndexed())
+	{
+		FVoxelUncompressedWorldSaveImpl UncompressedSave;
+		if (!UVoxelSaveUtilities::DecompressVoxelSave(*Save, UncompressedSave))
+		{
+			return false;
+		}
+		return LoadFromSave(UncompressedSave, LoadInfo, OutBoundsToUpdate);
+	}
+
+	TArray<int32> RegionsToLoad;
+	TArray<int32> RegionsToDefer;
+	for (int32 RegionIndex = 0; RegionIndex < Save->GetRegions().Num(); RegionIndex++)
+	{
+		const FVoxelIntBox& RegionBounds = Save->GetRegions()[RegionIndex].Bounds;
+		if (BoundsToLoad.ContainsByPredicate([&](const FVoxelIntBox& Bounds) { return Bounds.Intersect(RegionBounds); }))
+		{
+			RegionsToLoad.Add(RegionIndex);
+		}
+		else
+		{
+			RegionsToDefer.Add(RegionIndex);
+		}
+	}
+
+	FVoxelUncompressedWorldSaveImpl UncompressedSave;
+	if (!UVoxelSaveUtilities::DecompressVoxelSaveRegions(*Save, RegionsToLoad, UncompressedSave))
+	{
+		return false;
+	}
+
+	// Clears the previous pending regions
+	const bool bSuccess = LoadFromSave(UncompressedSave, LoadInfo, OutBoundsToUpdate);
+
+	LOG_VOXEL(Log, TEXT("LoadFromSave: loaded %d regions, %d regions pending"), RegionsToLoad.Num(), RegionsToDefer.Num());
+
+	if (RegionsToDefer.Num() > 0)
+	{
+		FScopeLock Lock(&PendingSaveRegionsSection);
+		PendingSave = Save;
+		PendingSaveRegions = MoveTemp(RegionsToDefer);
+		NumPendingSaveRegions.Set(PendingSaveRegions.Num());
+	}
+
+	return bSuccess;
+}
+
+int32 FVoxelData::LoadPendingSaveRegions(const FVoxelIntBox& Bounds, TArray<FVoxelIntBox>* OutBoundsToUpdate)
+{
+	if (!HasPendingSaveRegions())
+	{
+		return 0;
+	}
+	
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	// The regions stay pending until they are loaded under the write lock, so that GetSave never misses them
+	TVoxelSharedPtr<const FVoxelCompressedWorldSaveImpl> Save;
+	TArray<int32> RegionsToLoad;
+	{
+		FScopeLock Lock(&PendingSaveRegionsSection);
+		if (!PendingSave.IsValid())
+		{
+			return 0;
+		}
+		
+		Save = PendingSave;
+		for (const int32 RegionIndex : PendingSaveRegions)
+		{
+			if (Save->GetRegions()[RegionIndex].Bounds.Intersect(Bounds))
+			{
+				RegionsToLoad.Add(RegionIndex);
+			}
+		}
+	}
+
+	if (RegionsToLoad.Num() == 0)
+	{
+		return 0;
+	}
+
+	// Each region is decompressed separately, as they are locked separately
+	TArray<FVoxelUncompressedWorldSaveImpl> RegionSaves;
+	RegionSaves.SetNum(RegionsToLoad.Num());
+	TArray<bool> RegionSuccess;
+	RegionSuccess.SetNumZeroed(RegionsToLoad.Num());
+	
+	ParallelFor(RegionsToLoad.Num(), [&](int32 Index)
+	{
+		RegionSuccess[Index] = UVoxelSaveUtilities::DecompressVoxelSaveRegions(*Save, MakeArrayView(&RegionsToLoad[Index], 1), RegionSaves[Index], false);
+	});
+
+	// Returns false if the region was already loaded by another call, or if another save was loaded since
+	const auto RemovePendingRegion = [&](int32 RegionIndex)
+	{
+		FScopeLock Lock(&PendingSaveRegionsSection);
+		if (PendingSave != Save || PendingSaveRegions.Remove(RegionIndex) == 0)
+		{
+			return false;
+		}
+		
+		NumPendingSaveRegions.Set(PendingSaveRegions.Num());
+		if (PendingSaveRegions.Num() == 0)
+		{
+			PendingSave.Reset();
+		}
+		return true;
+	};
+
+	int32 NumLoaded = 0;
+	for (int32 Index = 0; Index < RegionsToLoad.Num(); Index++)
+	{
+		const int32 RegionIndex = RegionsToLoad[Index];
+		const FVoxelIntBox RegionBounds = Save->GetRegions()[RegionIndex].Bounds;
+		
+		if (!RegionSuccess[Index])
+		{
+			// Retrying would fail the same way
+			if (RemovePendingRegion(RegionIndex))
+			{
+				LOG_VOXEL(Error, TEXT("LoadPendingSaveRegions: the save region %s is corrupted and was not loaded"), *RegionBounds.ToString());
+			}
+			continue;
+		}
+		
+		FVoxelWriteScopeLock Lock(*this, RegionBounds, FUNCTION_FNAME);
+
+		// Removed while holding the write lock: GetSave either still sees the region as pending, or snapshots the loaded leaves
+		if (!RemovePendingRegion(RegionIndex))
+		{
+			continue;
+		}
+		NumLoaded++;
+
+		FVoxelSaveLoader Loader(RegionSaves[Index]);
+		
+		int32 ChunkIndex = 0;
+		FVoxelOctreeUtilities::IterateTreeInBounds(*Octree, RegionBounds, [&](FVoxelDataOctreeBase& Tree)
+		{
+			if (ChunkIndex == Loader.NumChunks())
+			{
+				return;
+			}
+
+			const FIntVector CurrentPosition = Loader.GetChunkPosition(ChunkIndex);
+			if (Tree.IsLeaf())
+			{
+				auto& Leaf = Tree.AsLeaf();
+				if (CurrentPosition == Tree.Position)
+				{
+					// Edits made before the region was loaded win over the saved data, but only for the channel they edited
+					const bool bLoadValues = !Leaf.Values.IsDirty();
+					const bool bLoadMaterials = !Leaf.Materials.IsDirty();
+					if (bLoadValues || bLoadMaterials)
+					{
+						LoadLeafFromSave(Leaf, Loader, ChunkIndex, bLoadValues, bLoadMaterials);
+
+						if (OutBoundsToUpdate)
+						{
+							OutBoundsToUpdate->Add(Tree.GetBounds());
+						}
+					}
+					ChunkIndex++;
+				}
+			}
+			else
+			{
+				auto& Parent = Tree.AsParent();
+				if (Tree.GetBounds().Contains(CurrentPosition) && !Parent.HasChildren())
+				{
+					Parent.CreateChildren();
+				}
+			}
+		});
+		ensure(ChunkIndex == Loader.NumChunks() || RegionSaves[Index].GetDepth() > Depth);
+	}
+
+	return NumLoaded;
+}
+
+void FVoxelData::ClearPendingSaveRegions()
+{
+	FScopeLock Lock(&PendingSaveRegionsSection);
+	PendingSave.Reset();
+	PendingSaveRegions.Reset();
+	NumPendingSaveRegions.Reset();
+}
+
+void FVoxelData::LoadLeafFromSave(FVoxelDataOctreeLeaf& Leaf, const FVoxelSaveLoader& Loader, int32 ChunkIndex, bool bLoadValues, bool bLoadMaterials)
+{
+	if (bLoadValues)
+	{
+		Loader.ExtractValues(ChunkIndex, *this, Leaf.Values);
+	}
+	if (bLoadMaterials)
+	{
+		Loader.ExtractMaterials(ChunkIndex, *this, Leaf.Materials);
+	}
+
+	if (bLoadValues && CVarStoreSpecialValueForGeneratorValuesInSaves.GetValueOnAnyThread() != 0)
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Loading generator values");
+
+		// If we are dirty and we are not a single value, or if we are a single special value
+		if (Leaf.Values.IsDirty() && (!Leaf.Values.IsSingleValue() || Leaf.Values.GetSingleValue() == FVoxelValue::Special()))
+		{
+			if (Leaf.Values.IsSingleValue())
+			{
+				Leaf.Values.ExpandSingleValue(*this);
+			}
+
+			const FVoxelIntBox LeafBounds = Leaf.GetBounds();
+			LeafBounds.Iterate([&](int32 X, int32 Y, int32 Z)
+			{
+				const FVoxelCellIndex Index = FVoxelDataOctreeUtilities::IndexFromGlobalCoordinates(LeafBounds.Min, X, Y, Z);
+				FVoxelValue& Value = Leaf.Values.GetRef(Index);
+
+				if (Value == FVoxelValue::Special())
+				{
+					// Use the generator value, ignoring all assets and items as they are not loaded
+					// The same is done when checking on save
+					Value = Generator->Get<FVoxelValue>(X, Y, Z, 0, FVoxelItemStack::Empty);
+				}
+			});
+
+			Leaf.Values.TryCompressToSingleValue(*this);
+		}
+	}
+
+	// Saves store full buffers: move to a palette if possible
+	if (bLoadValues)
+	{
+		Leaf.Values.Compress(*this);
+	}
+	if (bLoadMaterials)
+	{
+		Leaf.Materials.Compress(*this);
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
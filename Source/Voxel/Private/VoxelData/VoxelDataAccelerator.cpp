@@ -1,7 +1,14 @@
 // Copyright Voxel Plugin SAS. All Rights Reserved.
 
 #include "VoxelData/VoxelDataAccelerator.h"
+#include "VoxelData/VoxelData.h"
+#include "VoxelData/VoxelDataOctree.h"
+#include "VoxelUtilities/VoxelOctreeUtilities.h"
+#include "VoxelUtilities/VoxelIntVectorUtilities.h"
 #include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelDataAcceleratorGridsMemory);
 
 static TAutoConsoleVariable<int32> CVarCacheSize(
 	TEXT("voxel.data.DataAccelerator.CacheSize"),
@@ -18,6 +25,16 @@ static TAutoConsoleVariable<int32> CVarShowStats(
 	0,
 	TEXT("Log stats about accelerators hit/misses"),
 	ECVF_Default);
+static TAutoConsoleVariable<int32> CVarMaxGridSize(
+	TEXT("voxel.data.DataAccelerator.MaxGridSize"),
+	1 << 20,
+	TEXT("Max number of leaves covered by the flat grid of a data accelerator. Bigger bounds use a map instead"),
+	ECVF_Default);
+static TAutoConsoleVariable<int32> CVarParallelGridBuildThreshold(
+	TEXT("voxel.data.DataAccelerator.ParallelGridBuildThreshold"),
+	4096,
+	TEXT("Data accelerator grids covering more leaves than this are filled in parallel. 0 to disable"),
+	ECVF_Default);
 
 int32 FVoxelDataAcceleratorParameters::GetDefaultCacheSize()
 {
@@ -30,4 +47,234 @@ bool FVoxelDataAcceleratorParameters::GetUseAcceleratorMap()
 bool FVoxelDataAcceleratorParameters::GetShowStats()
 {
 	return CVarShowStats.GetValueOnAnyThread() != 0;
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+static FCriticalSection GVoxelDataAcceleratorStatsSection;
+static FVoxelDataAcceleratorStats GVoxelDataAcceleratorStats;
+
+FVoxelDataAcceleratorStats& FVoxelDataAcceleratorStats::operator+=(const FVoxelDataAcceleratorStats& Other)
+{
+	NumGet += Other.NumGet;
+	NumSet += Other.NumSet;
+	NumCacheTopAccess += Other.NumCacheTopAccess;
+	NumCacheTopMiss += Other.NumCacheTopMiss;
+	NumCacheAllAccess += Other.NumCacheAllAccess;
+	NumCacheAllMiss += Other.NumCacheAllMiss;
+	NumMapAccess += Other.NumMapAccess;
+	NumMapMiss += Other.NumMapMiss;
+	NumOutOfWorld += Other.NumOutOfWorld;
+	NumAccelerators += Other.NumAccelerators;
+	NumDenseGrids += Other.NumDenseGrids;
+	NumSparseGrids += Other.NumSparseGrids;
+	NumGridLeaves += Other.NumGridLeaves;
+	GridsBuildTime += Other.GridsBuildTime;
+	return *this;
+}
+
+void FVoxelDataAcceleratorStats::Log(const TCHAR* Name) const
+{
+	const auto HitRate = [](uint64 Access, uint64 Miss)
+	{
+		return Access > 0 ? 100 * double(Access - Miss) / Access : 0;
+	};
+
+	LOG_VOXEL(
+		Log,
+		TEXT("%s: %6llu reads; %6llu writes; %6llu/%6llu top cache miss (%3.2f%% hits); %6llu/%6llu other cache miss (%3.2f%% hits); %6llu/%6llu map miss (%3.2f%% hits); %6llu out of world"),
+		Name,
+		NumGet,
+		NumSet,
+		NumCacheTopMiss,
+		NumCacheTopAccess,
+		HitRate(NumCacheTopAccess, NumCacheTopMiss),
+		NumCacheAllMiss,
+		NumCacheAllAccess,
+		HitRate(NumCacheAllAccess, NumCacheAllMiss),
+		NumMapMiss,
+		NumMapAccess,
+		HitRate(NumMapAccess, NumMapMiss),
+		NumOutOfWorld);
+
+	if (NumDenseGrids > 0 || NumSparseGrids > 0)
+	{
+		LOG_VOXEL(
+			Log,
+			TEXT("%s: %llu grids built (%llu dense, %llu sparse); %llu leaves; %.3fms total, %.3fus per leaf"),
+			Name,
+			NumDenseGrids + NumSparseGrids,
+			NumDenseGrids,
+			NumSparseGrids,
+			NumGridLeaves,
+			GridsBuildTime * 1000,
+			NumGridLeaves > 0 ? GridsBuildTime * 1e6 / NumGridLeaves : 0);
+	}
+}
+
+void FVoxelDataAcceleratorStats::Report(const FVoxelDataAcceleratorStats& Stats)
+{
+	FScopeLock Lock(&GVoxelDataAcceleratorStatsSection);
+	GVoxelDataAcceleratorStats += Stats;
+	GVoxelDataAcceleratorStats.NumAccelerators++;
+}
+
+FVoxelDataAcceleratorStats FVoxelDataAcceleratorStats::GetGlobalStats()
+{
+	FScopeLock Lock(&GVoxelDataAcceleratorStatsSection);
+	return GVoxelDataAcceleratorStats;
+}
+
+void FVoxelDataAcceleratorStats::ResetGlobalStats()
+{
+	FScopeLock Lock(&GVoxelDataAcceleratorStatsSection);
+	GVoxelDataAcceleratorStats = {};
+}
+
+static FAutoConsoleCommand PrintVoxelDataAcceleratorStatsCmd(
+	TEXT("voxel.data.DataAccelerator.PrintStats"),
+	TEXT("Log the hit/miss rates of all the data accelerators destroyed since the last reset, and the cost of building their grids. Per accelerator counters require VOXEL_DATA_ACCELERATOR_STATS"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		const FVoxelDataAcceleratorStats Stats = FVoxelDataAcceleratorStats::GetGlobalStats();
+		LOG_VOXEL(Log, TEXT("%llu data accelerators recorded"), Stats.NumAccelerators);
+		Stats.Log(TEXT("All DataAccelerators"));
+	}));
+
+static FAutoConsoleCommand ResetVoxelDataAcceleratorStatsCmd(
+	TEXT("voxel.data.DataAccelerator.ResetStats"),
+	TEXT("Reset the stats logged by voxel.data.DataAccelerator.PrintStats"),
+	FConsoleCommandDelegate::CreateStatic(&FVoxelDataAcceleratorStats::ResetGlobalStats));
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+TVoxelSharedRef<FVoxelDataAcceleratorGrid> FVoxelDataAcceleratorGrid::Create(const FVoxelData& Data, const FVoxelIntBox& Bounds)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	const double StartTime = FPlatformTime::Seconds();
+	const auto Grid = MakeVoxelShared<FVoxelDataAcceleratorGrid>();
+
+	if (!Bounds.Intersect(Data.WorldBounds))
+	{
+		return Grid;
+	}
+
+	// There are no leaves outside of the world
+	const FVoxelIntBox ClampedBounds = Bounds.Overlap(Data.WorldBounds);
+	const FIntVector LeavesMin = FVoxelUtilities::DivideFloor(ClampedBounds.Min, DATA_CHUNK_SIZE);
+	const FIntVector LeavesMax = FVoxelUtilities::DivideCeil(ClampedBounds.Max, DATA_CHUNK_SIZE);
+	const FIntVector LeavesSize = LeavesMax - LeavesMin;
+	const int64 NumCells = int64(LeavesSize.X) * int64(LeavesSize.Y) * int64(LeavesSize.Z);
+
+	int64 NumLeaves = 0;
+	if (NumCells > CVarMaxGridSize.GetValueOnAnyThread())
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Build Sparse");
+
+		Grid->bIsDense = false;
+		FVoxelOctreeUtilities::IterateLeavesInBounds(Data.GetOctree(), ClampedBounds, [&](FVoxelDataOctreeLeaf& Leaf)
+		{
+			ensureThreadSafe(Leaf.IsLockedForRead());
+			Grid->SparseLeaves.Add(Leaf.GetMin() / DATA_CHUNK_SIZE, &Leaf);
+		});
+		Grid->SparseLeaves.Compact();
+		NumLeaves = Grid->SparseLeaves.Num();
+	}
+	else
+	{
+		Grid->Min = LeavesMin;
+		Grid->Size = LeavesSize;
+		Grid->Leaves.SetNumZeroed(int32(NumCells));
+
+		// Split the octree until there are enough subtrees to keep all the workers busy
+		// Each leaf is written to its own cell, so the subtrees can be iterated concurrently
+		TArray<FVoxelDataOctreeBase*> Subtrees = { &Data.GetOctree() };
+		const int32 ParallelThreshold = CVarParallelGridBuildThreshold.GetValueOnAnyThread();
+		const bool bParallel = ParallelThreshold > 0 && NumCells > ParallelThreshold;
+		if (bParallel)
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Split");
+
+			const int32 NumTasks = 4 * FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+			bool bSplit = true;
+			while (bSplit && Subtrees.Num() < NumTasks)
+			{
+				bSplit = false;
+
+				TArray<FVoxelDataOctreeBase*> NewSubtrees;
+				NewSubtrees.Reserve(8 * Subtrees.Num());
+				for (FVoxelDataOctreeBase* Subtree : Subtrees)
+				{
+					if (Subtree->IsLeafOrHasNoChildren())
+					{
+						NewSubtrees.Add(Subtree);
+						continue;
+					}
+
+					bSplit = true;
+					for (FVoxelDataOctreeBase& Child : Subtree->AsParent().GetChildren())
+					{
+						if (Child.GetBounds().Intersect(ClampedBounds))
+						{
+							NewSubtrees.Add(&Child);
+						}
+					}
+				}
+				Subtrees = MoveTemp(NewSubtrees);
+			}
+		}
+
+		TArray<int32> NumLeavesPerSubtree;
+		NumLeavesPerSubtree.SetNumZeroed(Subtrees.Num());
+
+		ParallelFor(Subtrees.Num(), [&](int32 Index)
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Fill Grid");
+			FVoxelOctreeUtilities::IterateLeavesInBounds(*Subtrees[Index], ClampedBounds, [&](FVoxelDataOctreeLeaf& Leaf)
+			{
+				ensureThreadSafe(Leaf.IsLockedForRead());
+				const FIntVector Local = Leaf.GetMin() / DATA_CHUNK_SIZE - LeavesMin;
+				checkVoxelSlow(0 <= Local.X && Local.X < LeavesSize.X);
+				checkVoxelSlow(0 <= Local.Y && Local.Y < LeavesSize.Y);
+				checkVoxelSlow(0 <= Local.Z && Local.Z < LeavesSize.Z);
+				Grid->Leaves[Grid->GetIndex(Local)] = &Leaf;
+				NumLeavesPerSubtree[Index]++;
+			});
+		}, !bParallel);
+
+		for (const int32 Num : NumLeavesPerSubtree)
+		{
+			NumLeaves += Num;
+		}
+	}
+
+	Grid->UpdateStats();
+
+	FVoxelDataAcceleratorStats BuildStats;
+	(Grid->bIsDense ? BuildStats.NumDenseGrids : BuildStats.NumSparseGrids) = 1;
+	BuildStats.NumGridLeaves = NumLeaves;
+	BuildStats.GridsBuildTime = FPlatformTime::Seconds() - StartTime;
+	{
+		FScopeLock Lock(&GVoxelDataAcceleratorStatsSection);
+		GVoxelDataAcceleratorStats += BuildStats;
+	}
+
+	return Grid;
+}
+
+FVoxelDataAcceleratorGrid::~FVoxelDataAcceleratorGrid()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataAcceleratorGridsMemory, AllocatedSize);
+}
+
+void FVoxelDataAcceleratorGrid::UpdateStats()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataAcceleratorGridsMemory, AllocatedSize);
+	AllocatedSize = Leaves.GetAllocatedSize() + SparseLeaves.GetAllocatedSize();
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataAcceleratorGridsMemory, AllocatedSize);
+}
@@ -0,0 +1,362 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelData/VoxelDataConnectedComponents.h"
+#include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelUtilities/VoxelIntVectorUtilities.h"
+#include "VoxelContainers/VoxelStaticArray.h"
+#include "Async/ParallelFor.h"
+
+namespace FVoxelDataConnectedComponentsImpl
+{
+	constexpr int32 BlockSize = DATA_CHUNK_SIZE;
+	static_assert(BlockSize * BlockSize * BlockSize <= MAX_int16, "Local labels must fit in int16");
+
+	struct FLabelStats
+	{
+		FVoxelIntBox Bounds;
+		int32 NumVoxels = 0;
+		bool bTouchesBorder = false;
+
+		void Add(const FIntVector& Position, bool bOnBorder)
+		{
+			Bounds = NumVoxels == 0 ? FVoxelIntBox(Position) : Bounds + Position;
+			NumVoxels++;
+			bTouchesBorder |= bOnBorder;
+		}
+	};
+
+	// Lock-free union find: roots are always linked to smaller roots, so the root of a set is its smallest label
+	FORCEINLINE int32 AtomicFind(TArray<int32>& Parents, int32 Label)
+	{
+		while (true)
+		{
+			const int32 Parent = FPlatformAtomics::AtomicRead(&Parents[Label]);
+			if (Parent == Label)
+			{
+				return Label;
+			}
+			const int32 GrandParent = FPlatformAtomics::AtomicRead(&Parents[Parent]);
+			if (GrandParent != Parent)
+			{
+				// Path halving. If this fails another thread already changed it
+				FPlatformAtomics::InterlockedCompareExchange(&Parents[Label], GrandParent, Parent);
+			}
+			Label = Parent;
+		}
+	}
+	FORCEINLINE void AtomicUnion(TArray<int32>& Parents, int32 A, int32 B)
+	{
+		while (true)
+		{
+			A = AtomicFind(Parents, A);
+			B = AtomicFind(Parents, B);
+			if (A == B)
+			{
+				return;
+			}
+			if (A < B)
+			{
+				Swap(A, B);
+			}
+			// Only link A if it's still a root
+			if (FPlatformAtomics::InterlockedCompareExchange(&Parents[A], B, A) == A)
+			{
+				return;
+			}
+		}
+	}
+}
+
+FVoxelDataConnectedComponents::FVoxelDataConnectedComponents(const FVoxelData& Data, const FVoxelIntBox& Bounds, bool bMultiThreaded)
+	: Bounds(Bounds)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	using namespace FVoxelDataConnectedComponentsImpl;
+
+	check(Bounds.IsValid());
+
+	BlocksGridMin = FVoxelUtilities::DivideFloor(Bounds.Min, BlockSize) * BlockSize;
+	BlocksGridSize = FVoxelUtilities::DivideCeil(Bounds.Max, BlockSize) - FVoxelUtilities::DivideFloor(Bounds.Min, BlockSize);
+	Blocks.SetNum(BlocksGridSize.X * BlocksGridSize.Y * BlocksGridSize.Z);
+
+	const auto GetBlockPosition = [&](int32 BlockIndex)
+	{
+		return FIntVector(
+			BlockIndex % BlocksGridSize.X,
+			(BlockIndex / BlocksGridSize.X) % BlocksGridSize.Y,
+			BlockIndex / (BlocksGridSize.X * BlocksGridSize.Y));
+	};
+
+	// Voxels on these sides might be connected to voxels outside of the bounds
+	bool bBorderMin[3];
+	bool bBorderMax[3];
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		bBorderMin[Axis] = Bounds.Min[Axis] > Data.WorldBounds.Min[Axis];
+		bBorderMax[Axis] = Bounds.Max[Axis] < Data.WorldBounds.Max[Axis];
+	}
+	const auto IsOnBorder = [&](const FVoxelIntBox& Box)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if ((bBorderMin[Axis] && Box.Min[Axis] == Bounds.Min[Axis]) ||
+				(bBorderMax[Axis] && Box.Max[Axis] == Bounds.Max[Axis]))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	TArray<TArray<FLabelStats>> BlocksLabelsStats;
+	BlocksLabelsStats.SetNum(Blocks.Num());
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Label Blocks");
+		ParallelFor(Blocks.Num(), [&](int32 BlockIndex)
+		{
+			FBlock& Block = Blocks[BlockIndex];
+			TArray<FLabelStats>& LabelsStats = BlocksLabelsStats[BlockIndex];
+
+			const FIntVector BlockMin = BlocksGridMin + GetBlockPosition(BlockIndex) * BlockSize;
+			Block.Bounds = FVoxelIntBox(BlockMin, BlockMin + BlockSize).Overlap(Bounds);
+
+			// Single value leaves & generator ranges: no need to query the values
+			const TVoxelRange<FVoxelValue> Range = Data.GetValueRange(Block.Bounds, 0);
+			if (Range.Min.IsEmpty())
+			{
+				Block.bUniform = true;
+				Block.NumLabels = 0;
+				return;
+			}
+			if (!Range.Max.IsEmpty())
+			{
+				Block.bUniform = true;
+				Block.NumLabels = 1;
+
+				FLabelStats& Stats = LabelsStats.Emplace_GetRef();
+				Stats.Bounds = Block.Bounds;
+				Stats.NumVoxels = int32(Block.Bounds.Count());
+				Stats.bTouchesBorder = IsOnBorder(Block.Bounds);
+				return;
+			}
+
+			const FIntVector Size = Block.Bounds.Size();
+			const int32 Num = Size.X * Size.Y * Size.Z;
+
+			TVoxelStaticArray<FVoxelValue, BlockSize * BlockSize * BlockSize> Values;
+			{
+				TVoxelQueryZone<FVoxelValue> QueryZone(Block.Bounds, Values.GetData());
+				Data.Get<FVoxelValue>(QueryZone, 0);
+			}
+
+			// Local union find on the voxel indices, -1 if empty
+			TVoxelStaticArray<int32, BlockSize * BlockSize * BlockSize> Parents;
+			const auto Find = [&](int32 Index)
+			{
+				while (Parents[Index] != Index)
+				{
+					Parents[Index] = Parents[Parents[Index]];
+					Index = Parents[Index];
+				}
+				return Index;
+			};
+			const auto Union = [&](int32 A, int32 B)
+			{
+				A = Find(A);
+				B = Find(B);
+				if (A != B)
+				{
+					Parents[FMath::Max(A, B)] = FMath::Min(A, B);
+				}
+			};
+
+			const int32 StrideY = Size.X;
+			const int32 StrideZ = Size.X * Size.Y;
+
+			int32 Index = 0;
+			for (int32 Z = 0; Z < Size.Z; Z++)
+			{
+				for (int32 Y = 0; Y < Size.Y; Y++)
+				{
+					for (int32 X = 0; X < Size.X; X++, Index++)
+					{
+						if (Values[Index].IsEmpty())
+						{
+							Parents[Index] = -1;
+							continue;
+						}
+
+						Parents[Index] = Index;
+						if (X > 0 && Parents[Index - 1] != -1)
+						{
+							Union(Index, Index - 1);
+						}
+						if (Y > 0 && Parents[Index - StrideY] != -1)
+						{
+							Union(Index, Index - StrideY);
+						}
+						if (Z > 0 && Parents[Index - StrideZ] != -1)
+						{
+							Union(Index, Index - StrideZ);
+						}
+					}
+				}
+			}
+
+			// Roots are the smallest index of their set, so they are always visited first
+			Block.bUniform = false;
+			Block.NumLabels = 0;
+			Block.LocalLabels.SetNumUninitialized(Num);
+
+			Index = 0;
+			for (int32 Z = 0; Z < Size.Z; Z++)
+			{
+				for (int32 Y = 0; Y < Size.Y; Y++)
+				{
+					for (int32 X = 0; X < Size.X; X++, Index++)
+					{
+						if (Parents[Index] == -1)
+						{
+							Block.LocalLabels[Index] = -1;
+							continue;
+						}
+
+						const int32 Root = Find(Index);
+						if (Root == Index)
+						{
+							Block.LocalLabels[Index] = int16(Block.NumLabels++);
+							LabelsStats.Emplace();
+						}
+						else
+						{
+							Block.LocalLabels[Index] = Block.LocalLabels[Root];
+						}
+
+						const FIntVector Position = Block.Bounds.Min + FIntVector(X, Y, Z);
+						LabelsStats[Block.LocalLabels[Index]].Add(Position, IsOnBorder(FVoxelIntBox(Position)));
+					}
+				}
+			}
+		}, !bMultiThreaded);
+	}
+
+	int32 NumLabels = 0;
+	for (FBlock& Block : Blocks)
+	{
+		Block.FirstLabel = NumLabels;
+		NumLabels += Block.NumLabels;
+	}
+
+	TArray<int32> Parents;
+	Parents.SetNumUninitialized(NumLabels);
+	for (int32 Label = 0; Label < NumLabels; Label++)
+	{
+		Parents[Label] = Label;
+	}
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Merge Blocks");
+		ParallelFor(Blocks.Num(), [&](int32 BlockIndex)
+		{
+			const FBlock& Block = Blocks[BlockIndex];
+			if (Block.NumLabels == 0)
+			{
+				return;
+			}
+
+			const FIntVector BlockPosition = GetBlockPosition(BlockIndex);
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				FIntVector Direction(ForceInit);
+				Direction[Axis] = 1;
+
+				const FIntVector NeighborPosition = BlockPosition + Direction;
+				if (NeighborPosition[Axis] >= BlocksGridSize[Axis])
+				{
+					continue;
+				}
+
+				const FBlock& Neighbor = Blocks[GetBlockIndex(NeighborPosition)];
+				if (Neighbor.NumLabels == 0)
+				{
+					continue;
+				}
+
+				if (Block.bUniform && Neighbor.bUniform)
+				{
+					AtomicUnion(Parents, Block.FirstLabel, Neighbor.FirstLabel);
+					continue;
+				}
+
+				// Merge the labels on both sides of the face
+				FVoxelIntBox Face = Block.Bounds;
+				Face.Min[Axis] = Face.Max[Axis] - 1;
+
+				int32 LastLabel = -1;
+				int32 LastNeighborLabel = -1;
+				Face.Iterate([&](int32 X, int32 Y, int32 Z)
+				{
+					const FIntVector Position(X, Y, Z);
+					const int32 Label = Block.GetLabel(Position);
+					const int32 NeighborLabel = Neighbor.GetLabel(Position + Direction);
+					if (Label == -1 || NeighborLabel == -1 || (Label == LastLabel && NeighborLabel == LastNeighborLabel))
+					{
+						return;
+					}
+					LastLabel = Label;
+					LastNeighborLabel = NeighborLabel;
+
+					AtomicUnion(Parents, Label, NeighborLabel);
+				});
+			}
+		}, !bMultiThreaded);
+	}
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Find Components");
+
+		// Roots are the smallest label of their set, so they are always visited first
+		LabelsComponents.SetNumUninitialized(NumLabels);
+		for (int32 Label = 0; Label < NumLabels; Label++)
+		{
+			const int32 Root = AtomicFind(Parents, Label);
+			LabelsComponents[Label] = Root == Label ? Components.Emplace() : LabelsComponents[Root];
+		}
+		ComponentsBlocks.SetNum(Components.Num());
+
+		for (int32 BlockIndex = 0; BlockIndex < Blocks.Num(); BlockIndex++)
+		{
+			const FBlock& Block = Blocks[BlockIndex];
+			for (int32 LocalLabel = 0; LocalLabel < Block.NumLabels; LocalLabel++)
+			{
+				const FLabelStats& Stats = BlocksLabelsStats[BlockIndex][LocalLabel];
+				const int32 ComponentIndex = LabelsComponents[Block.FirstLabel + LocalLabel];
+
+				FVoxelDataConnectedComponent& Component = Components[ComponentIndex];
+				Component.Bounds = Component.NumVoxels == 0 ? Stats.Bounds : Component.Bounds + Stats.Bounds;
+				Component.NumVoxels += Stats.NumVoxels;
+				Component.bTouchesBorder |= Stats.bTouchesBorder;
+
+				TArray<int32>& ComponentBlocks = ComponentsBlocks[ComponentIndex];
+				if (ComponentBlocks.Num() == 0 || ComponentBlocks.Last() != BlockIndex)
+				{
+					ComponentBlocks.Add(BlockIndex);
+				}
+			}
+		}
+	}
+}
+
+int32 FVoxelDataConnectedComponents::GetComponent(const FIntVector& Position) const
+{
+	if (!Bounds.Contains(Position))
+	{
+		return -1;
+	}
+
+	const FIntVector BlockPosition = FVoxelUtilities::DivideFloor(Position - BlocksGridMin, FVoxelDataConnectedComponentsImpl::BlockSize);
+	const int32 Label = Blocks[GetBlockIndex(BlockPosition)].GetLabel(Position);
+	return Label == -1 ? -1 : LabelsComponents[Label];
+}
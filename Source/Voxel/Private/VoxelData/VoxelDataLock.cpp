@@ -0,0 +1,153 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelData/VoxelDataLock.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarVoxelDataLockStats(
+	TEXT("voxel.data.LockStats"),
+	0,
+	TEXT("If true, count the data locks and the time spent waiting on them. See voxel.data.PrintLockStats"),
+	ECVF_Default);
+
+// Updated by every thread locking a data: no lock, only atomics
+struct FVoxelDataLockAtomicStats
+{
+	struct FLockType
+	{
+		volatile int64 NumLocks = 0;
+		volatile int64 WaitCycles = 0;
+		volatile int64 MaxWaitCycles = 0;
+	};
+	FLockType Read;
+	FLockType Write;
+
+	volatile int64 NumOptimisticLocks = 0;
+	volatile int64 NumOptimisticConflicts = 0;
+	volatile int64 NumOptimisticFallbacks = 0;
+};
+static FVoxelDataLockAtomicStats GVoxelDataLockStats;
+
+inline void AtomicMax(volatile int64& Value, int64 NewValue)
+{
+	int64 OldValue = FPlatformAtomics::AtomicRead(&Value);
+	while (OldValue < NewValue)
+	{
+		const int64 PreviousValue = FPlatformAtomics::InterlockedCompareExchange(&Value, NewValue, OldValue);
+		if (PreviousValue == OldValue)
+		{
+			break;
+		}
+		OldValue = PreviousValue;
+	}
+}
+
+bool FVoxelDataLockStats::IsEnabled()
+{
+	return CVarVoxelDataLockStats.GetValueOnAnyThread() != 0;
+}
+
+void FVoxelDataLockStats::ReportLock(EVoxelLockType LockType, bool bOptimistic, uint64 WaitCycles)
+{
+	if (!IsEnabled())
+	{
+		return;
+	}
+
+	FVoxelDataLockAtomicStats::FLockType& Stats = LockType == EVoxelLockType::Read ? GVoxelDataLockStats.Read : GVoxelDataLockStats.Write;
+	FPlatformAtomics::InterlockedIncrement(&Stats.NumLocks);
+	FPlatformAtomics::InterlockedAdd(&Stats.WaitCycles, int64(WaitCycles));
+	AtomicMax(Stats.MaxWaitCycles, int64(WaitCycles));
+
+	if (bOptimistic)
+	{
+		FPlatformAtomics::InterlockedIncrement(&GVoxelDataLockStats.NumOptimisticLocks);
+	}
+}
+
+void FVoxelDataLockStats::ReportOptimisticConflict()
+{
+	if (IsEnabled())
+	{
+		FPlatformAtomics::InterlockedIncrement(&GVoxelDataLockStats.NumOptimisticConflicts);
+	}
+}
+
+void FVoxelDataLockStats::ReportOptimisticFallback()
+{
+	if (IsEnabled())
+	{
+		FPlatformAtomics::InterlockedIncrement(&GVoxelDataLockStats.NumOptimisticFallbacks);
+	}
+}
+
+FVoxelDataLockStats FVoxelDataLockStats::Get()
+{
+	const auto GetType = [](const FVoxelDataLockAtomicStats::FLockType& TypeStats)
+	{
+		FLockTypeStats Result;
+		Result.NumLocks = FPlatformAtomics::AtomicRead(&TypeStats.NumLocks);
+		Result.WaitTime = FPlatformTime::ToSeconds64(FPlatformAtomics::AtomicRead(&TypeStats.WaitCycles));
+		Result.MaxWaitTime = FPlatformTime::ToSeconds64(FPlatformAtomics::AtomicRead(&TypeStats.MaxWaitCycles));
+		return Result;
+	};
+
+	FVoxelDataLockStats Stats;
+	Stats.Read = GetType(GVoxelDataLockStats.Read);
+	Stats.Write = GetType(GVoxelDataLockStats.Write);
+	Stats.NumOptimisticLocks = FPlatformAtomics::AtomicRead(&GVoxelDataLockStats.NumOptimisticLocks);
+	Stats.NumOptimisticConflicts = FPlatformAtomics::AtomicRead(&GVoxelDataLockStats.NumOptimisticConflicts);
+	Stats.NumOptimisticFallbacks = FPlatformAtomics::AtomicRead(&GVoxelDataLockStats.NumOptimisticFallbacks);
+	return Stats;
+}
+
+void FVoxelDataLockStats::Clear()
+{
+	// Not atomic as a whole: locks reported while clearing might be partially counted
+	for (FVoxelDataLockAtomicStats::FLockType* TypeStats : { &GVoxelDataLockStats.Read, &GVoxelDataLockStats.Write })
+	{
+		FPlatformAtomics::InterlockedExchange(&TypeStats->NumLocks, 0);
+		FPlatformAtomics::InterlockedExchange(&TypeStats->WaitCycles, 0);
+		FPlatformAtomics::InterlockedExchange(&TypeStats->MaxWaitCycles, 0);
+	}
+	FPlatformAtomics::InterlockedExchange(&GVoxelDataLockStats.NumOptimisticLocks, 0);
+	FPlatformAtomics::InterlockedExchange(&GVoxelDataLockStats.NumOptimisticConflicts, 0);
+	FPlatformAtomics::InterlockedExchange(&GVoxelDataLockStats.NumOptimisticFallbacks, 0);
+}
+
+void FVoxelDataLockStats::Print()
+{
+	const FVoxelDataLockStats Stats = Get();
+
+	const auto PrintType = [](const TCHAR* Name, const FLockTypeStats& TypeStats)
+	{
+		LOG_VOXEL(Log, TEXT("\t%-5s: %8llu locks; %8.3fs waiting; %8.3fms avg wait; %8.3fms max wait"),
+			Name,
+			TypeStats.NumLocks,
+			TypeStats.WaitTime,
+			TypeStats.NumLocks > 0 ? TypeStats.WaitTime / TypeStats.NumLocks * 1000 : 0,
+			TypeStats.MaxWaitTime * 1000);
+	};
+
+	if (!IsEnabled())
+	{
+		LOG_VOXEL(Log, TEXT("Voxel data lock stats are disabled: set voxel.data.LockStats 1 to record them"));
+	}
+	LOG_VOXEL(Log, TEXT("Voxel data lock stats:"));
+	PrintType(TEXT("Read"), Stats.Read);
+	PrintType(TEXT("Write"), Stats.Write);
+	LOG_VOXEL(Log, TEXT("\tOptimistic: %8llu locks; %8llu conflicts (%5.2f%%); %8llu fallbacks to regular locks"),
+		Stats.NumOptimisticLocks,
+		Stats.NumOptimisticConflicts,
+		Stats.NumOptimisticLocks > 0 ? 100 * double(Stats.NumOptimisticConflicts) / Stats.NumOptimisticLocks : 0,
+		Stats.NumOptimisticFallbacks);
+}
+
+static FAutoConsoleCommand PrintVoxelDataLockStatsCmd(
+	TEXT("voxel.data.PrintLockStats"),
+	TEXT("Print the number of data locks, the time spent waiting on them per lock type, and the optimistic locks conflicts"),
+	FConsoleCommandDelegate::CreateStatic(&FVoxelDataLockStats::Print));
+
+static FAutoConsoleCommand ClearVoxelDataLockStatsCmd(
+	TEXT("voxel.data.ClearLockStats"),
+	TEXT("Clear the data lock stats"),
+	FConsoleCommandDelegate::CreateStatic(&FVoxelDataLockStats::Clear));
@@ -128,9 +128,28 @@ template VOXEL_API int32 FVoxelDataOctreeBase::GetCustomOutput<int32>(const FVox
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+FVoxelDataOctreeParent::~FVoxelDataOctreeParent()
+{
+	// Free the children here: TVoxelOctreeParent would free them with FMemory
+	if (HasChildren())
+	{
+		FreeChildren();
+	}
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataOctreesMemory, sizeof(FVoxelDataOctreeParent));
+}
+
 void FVoxelDataOctreeParent::CreateChildren()
 {
-	TVoxelOctreeParent::CreateChildren();
+	if (SlabAllocator)
+	{
+		const EVoxelDataSlabPool Pool = Height == 1 ? EVoxelDataSlabPool::LeafChildren : EVoxelDataSlabPool::ParentChildren;
+		checkVoxelSlow(GetChildrenMemorySize() <= uint32(FVoxelDataSlabAllocator::GetBlockSize(Pool)));
+		CreateChildrenInPlace(SlabAllocator->Malloc(Pool));
+	}
+	else
+	{
+		TVoxelOctreeParent::CreateChildren();
+	}
 
 #if DO_THREADSAFE_CHECKS
 	for (auto& Child : AsParent().GetChildren())
@@ -158,9 +177,25 @@ void FVoxelDataOctreeParent::CreateChildren()
 
 void FVoxelDataOctreeParent::DestroyChildren()
 {
-	TVoxelOctreeParent::DestroyChildren();
+	FreeChildren();
 
 	check(!ItemHolder.IsValid());
 	// Always valid on a node with no children
 	ItemHolder = MakeUnique<FVoxelPlaceableItemHolder>();
-}
\ No newline at end of file
+}
+
+void FVoxelDataOctreeParent::FreeChildren()
+{
+	// Read before destroying the children, in case this is a leaf parent
+	const EVoxelDataSlabPool Pool = Height == 1 ? EVoxelDataSlabPool::LeafChildren : EVoxelDataSlabPool::ParentChildren;
+
+	void* const Memory = DestroyChildrenInPlace();
+	if (SlabAllocator)
+	{
+		SlabAllocator->Free(Pool, Memory);
+	}
+	else
+	{
+		FMemory::Free(Memory);
+	}
+}
@@ -0,0 +1,416 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelData/VoxelDataRaycast.h"
+#include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelUtilities/VoxelVectorUtilities.h"
+#include "VoxelUtilities/VoxelIntVectorUtilities.h"
+#include "VoxelContainers/VoxelStaticArray.h"
+#include "Async/ParallelFor.h"
+
+namespace FVoxelDataRaycastImpl
+{
+	// In cells: boxes this size or smaller are queried at once & traversed cell by cell
+	constexpr int32 BlockSize = DATA_CHUNK_SIZE;
+	// Number of samples along the ray in a cell the surface might be in. Features thinner than this are missed
+	constexpr int32 NumCellSamples = 4;
+	// Number of bisections to refine the hits
+	constexpr int32 NumBisections = 8;
+	// To not miss cells on the boundaries of the boxes
+	constexpr v_flt BoxTolerance = 1e-3f;
+
+	FVoxelVector GetInvDirection(const FVoxelDataRay& Ray)
+	{
+		FVoxelVector InvDirection;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			InvDirection[Axis] =
+				FMath::Abs(Ray.Direction[Axis]) > KINDA_SMALL_NUMBER
+				? 1 / Ray.Direction[Axis]
+				: Ray.Direction[Axis] < 0 ? -BIG_NUMBER : BIG_NUMBER;
+		}
+		return InvDirection;
+	}
+
+	// Slab test: clip [InOutT0, InOutT1] to the part of the ray inside [Min, Max]
+	bool ClipToBox(const FVoxelDataRay& Ray, const FVoxelVector& InvDirection, const FVoxelVector& Min, const FVoxelVector& Max, v_flt& InOutT0, v_flt& InOutT1)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			v_flt T0 = (Min[Axis] - Ray.Start[Axis]) * InvDirection[Axis];
+			v_flt T1 = (Max[Axis] - Ray.Start[Axis]) * InvDirection[Axis];
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+			InOutT0 = FMath::Max(InOutT0, T0);
+			InOutT1 = FMath::Min(InOutT1, T1);
+		}
+		return InOutT0 <= InOutT1;
+	}
+
+	// The cells the ray goes through, as [OutCellMin, OutCellMax]. A cell C has its corners in [C, C + 1]
+	bool GetCells(const FVoxelData& Data, const FVoxelDataRay& Ray, FIntVector& OutCellMin, FIntVector& OutCellMax)
+	{
+		const FVoxelIntBox& WorldBounds = Data.WorldBounds;
+
+		v_flt T0 = 0;
+		v_flt T1 = Ray.MaxDistance;
+		if (!ClipToBox(Ray, GetInvDirection(Ray), FVoxelVector(WorldBounds.Min), FVoxelVector(WorldBounds.Max - 1), T0, T1))
+		{
+			return false;
+		}
+
+		const FVoxelVector A = Ray.Start + Ray.Direction * T0;
+		const FVoxelVector B = Ray.Start + Ray.Direction * T1;
+
+		OutCellMin = FVoxelUtilities::Clamp(FVoxelUtilities::FloorToInt(A.ComponentMin(B)), WorldBounds.Min, WorldBounds.Max - 2);
+		OutCellMax = FVoxelUtilities::Clamp(FVoxelUtilities::FloorToInt(A.ComponentMax(B)), WorldBounds.Min, WorldBounds.Max - 2);
+		return true;
+	}
+
+	FORCEINLINE FVoxelIntBox GetCellsBounds(const FIntVector& CellMin, const FIntVector& CellMax)
+	{
+		return FVoxelIntBox(CellMin, CellMax + 2);
+	}
+
+	class FRaycaster
+	{
+	public:
+		FRaycaster(const FVoxelData& Data, const FVoxelDataRay& Ray)
+			: Data(Data)
+			, Ray(Ray)
+			, InvDirection(GetInvDirection(Ray))
+			, BestT(Ray.MaxDistance)
+		{
+		}
+
+		FVoxelDataRayHit Raycast()
+		{
+			FIntVector CellMin;
+			FIntVector CellMax;
+			if (GetCells(Data, Ray, CellMin, CellMax))
+			{
+				VisitNode(CellMin, CellMax);
+			}
+			return Hit;
+		}
+
+	private:
+		const FVoxelData& Data;
+		const FVoxelDataRay& Ray;
+		const FVoxelVector InvDirection;
+
+		v_flt BestT;
+		FVoxelDataRayHit Hit;
+
+		bool ClipToCells(const FIntVector& CellMin, const FIntVector& CellMax, v_flt& OutT0, v_flt& OutT1) const
+		{
+			OutT0 = 0;
+			OutT1 = BestT;
+			return ClipToBox(Ray, InvDirection, FVoxelVector(CellMin) - BoxTolerance, FVoxelVector(CellMax + 1) + BoxTolerance, OutT0, OutT1);
+		}
+
+		void VisitNode(const FIntVector& CellMin, const FIntVector& CellMax)
+		{
+			v_flt T0;
+			v_flt T1;
+			if (!ClipToCells(CellMin, CellMax, T0, T1))
+			{
+				return;
+			}
+
+			// Skip empty space: single value leaves & generator ranges make this cheap for big boxes
+			if (Data.GetValueRange(GetCellsBounds(CellMin, CellMax), 0).Min.IsEmpty())
+			{
+				return;
+			}
+
+			const FIntVector Size = CellMax - CellMin + 1;
+			if (Size.GetMax() <= BlockSize)
+			{
+				VisitBlock(CellMin, CellMax, T0, T1);
+				return;
+			}
+
+			// Split the axes that are too big, aligned to the data chunks so that the children can match leaves
+			// Per axis, the cells ranges of the children
+			int32 Mins[3][2];
+			int32 Maxs[3][2];
+			int32 NumSplits[3];
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				Mins[Axis][0] = CellMin[Axis];
+				Maxs[Axis][0] = CellMax[Axis];
+				NumSplits[Axis] = 1;
+
+				if (Size[Axis] > BlockSize)
+				{
+					int32 Mid = FVoxelUtilities::DivideCeil(CellMin[Axis] + Size[Axis] / 2, BlockSize) * BlockSize;
+					if (Mid <= CellMin[Axis] || Mid > CellMax[Axis])
+					{
+						Mid = CellMin[Axis] + Size[Axis] / 2;
+					}
+
+					Maxs[Axis][0] = Mid - 1;
+					Mins[Axis][1] = Mid;
+					Maxs[Axis][1] = CellMax[Axis];
+					NumSplits[Axis] = 2;
+				}
+			}
+
+			struct FChild
+			{
+				FIntVector CellMin;
+				FIntVector CellMax;
+				v_flt T0;
+			};
+			TArray<FChild, TFixedAllocator<8>> Children;
+			for (int32 X = 0; X < NumSplits[0]; X++)
+			{
+				for (int32 Y = 0; Y < NumSplits[1]; Y++)
+				{
+					for (int32 Z = 0; Z < NumSplits[2]; Z++)
+					{
+						FChild Child;
+						Child.CellMin = FIntVector(Mins[0][X], Mins[1][Y], Mins[2][Z]);
+						Child.CellMax = FIntVector(Maxs[0][X], Maxs[1][Y], Maxs[2][Z]);
+
+						v_flt ChildT1;
+						if (ClipToCells(Child.CellMin, Child.CellMax, Child.T0, ChildT1))
+						{
+							Children.Add(Child);
+						}
+					}
+				}
+			}
+
+			// Front to back, so that we can stop at the first hit
+			Children.Sort([](const FChild& A, const FChild& B) { return A.T0 < B.T0; });
+
+			for (const FChild& Child : Children)
+			{
+				if (Hit.bHit && Child.T0 > BestT)
+				{
+					return;
+				}
+				VisitNode(Child.CellMin, Child.CellMax);
+			}
+		}
+
+		void VisitBlock(const FIntVector& CellMin, const FIntVector& CellMax, v_flt T0, v_flt T1)
+		{
+			constexpr int32 MaxSize = BlockSize + 1;
+
+			const FVoxelIntBox Bounds = GetCellsBounds(CellMin, CellMax);
+			const FIntVector Size = Bounds.Size();
+
+			TVoxelStaticArray<FVoxelValue, MaxSize * MaxSize * MaxSize> Values;
+			{
+				TVoxelQueryZone<FVoxelValue> QueryZone(Bounds, Values.GetData());
+				Data.Get<FVoxelValue>(QueryZone, 0);
+			}
+
+			const auto GetValue = [&](const FIntVector& Position)
+			{
+				const FIntVector Local = Position - Bounds.Min;
+				checkVoxelSlow(FVoxelIntBox(0, Size).Contains(Local));
+				return Values[Local.X + Size.X * Local.Y + Size.X * Size.Y * Local.Z].ToFloat();
+			};
+
+			// Amanatides & Woo
+			v_flt T = FMath::Max<v_flt>(T0, 0);
+			FIntVector Cell = FVoxelUtilities::Clamp(FVoxelUtilities::FloorToInt(Ray.Start + Ray.Direction * T), CellMin, CellMax);
+
+			FIntVector Step;
+			FVoxelVector NextT;
+			FVoxelVector DeltaT;
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				Step[Axis] = Ray.Direction[Axis] < 0 ? -1 : 1;
+				NextT[Axis] = (Cell[Axis] + (Step[Axis] > 0 ? 1 : 0) - Ray.Start[Axis]) * InvDirection[Axis];
+				DeltaT[Axis] = FMath::Abs(InvDirection[Axis]);
+			}
+
+			while (true)
+			{
+				const int32 Axis =
+					NextT.X < NextT.Y
+					? NextT.X < NextT.Z ? 0 : 2
+					: NextT.Y < NextT.Z ? 1 : 2;
+
+				const v_flt CellT1 = FMath::Min(NextT[Axis], T1);
+				if (T <= CellT1 && VisitCell(GetValue, Cell, T, CellT1))
+				{
+					return;
+				}
+				if (CellT1 >= T1)
+				{
+					return;
+				}
+
+				Cell[Axis] += Step[Axis];
+				T = NextT[Axis];
+				NextT[Axis] += DeltaT[Axis];
+
+				if (Cell[Axis] < CellMin[Axis] || Cell[Axis] > CellMax[Axis])
+				{
+					return;
+				}
+			}
+		}
+
+		template<typename TGetValue>
+		bool VisitCell(TGetValue GetValue, const FIntVector& Cell, v_flt T0, v_flt T1)
+		{
+			float Corners[2][2][2];
+			bool bAllEmpty = true;
+			for (int32 X = 0; X < 2; X++)
+			{
+				for (int32 Y = 0; Y < 2; Y++)
+				{
+					for (int32 Z = 0; Z < 2; Z++)
+					{
+						Corners[X][Y][Z] = GetValue(Cell + FIntVector(X, Y, Z));
+						bAllEmpty &= Corners[X][Y][Z] > 0;
+					}
+				}
+			}
+			if (bAllEmpty)
+			{
+				return false;
+			}
+
+			const auto GetLocalPosition = [&](v_flt Time)
+			{
+				const FVoxelVector Local = Ray.Start + Ray.Direction * Time - Cell;
+				return FVector(
+					FMath::Clamp<float>(Local.X, 0, 1),
+					FMath::Clamp<float>(Local.Y, 0, 1),
+					FMath::Clamp<float>(Local.Z, 0, 1));
+			};
+			const auto Sample = [&](v_flt Time)
+			{
+				const FVector P = GetLocalPosition(Time);
+				return FVoxelUtilities::TrilinearInterpolation<float>(
+					Corners[0][0][0], Corners[1][0][0], Corners[0][1][0], Corners[1][1][0],
+					Corners[0][0][1], Corners[1][0][1], Corners[0][1][1], Corners[1][1][1],
+					P.X, P.Y, P.Z);
+			};
+
+			v_flt HitT;
+			if (Sample(T0) <= 0)
+			{
+				// Starts inside the surface
+				HitT = T0;
+			}
+			else
+			{
+				v_flt A = T0;
+				v_flt B = T0;
+				bool bFound = false;
+				for (int32 Index = 1; Index <= NumCellSamples; Index++)
+				{
+					A = B;
+					B = FMath::Lerp(T0, T1, v_flt(Index) / NumCellSamples);
+					if (Sample(B) <= 0)
+					{
+						bFound = true;
+						break;
+					}
+				}
+				if (!bFound)
+				{
+					return false;
+				}
+
+				for (int32 Index = 0; Index < NumBisections; Index++)
+				{
+					const v_flt Mid = (A + B) / 2;
+					if (Sample(Mid) <= 0)
+					{
+						B = Mid;
+					}
+					else
+					{
+						A = Mid;
+					}
+				}
+				HitT = B;
+			}
+
+			// Gradient of the trilinear interpolation
+			const FVector P = GetLocalPosition(HitT);
+			const auto Lerp2 = [](float A, float B, float C, float D, float X, float Y)
+			{
+				return FVoxelUtilities::BilinearInterpolation<float>(A, B, C, D, X, Y);
+			};
+			const auto& V = Corners;
+			const FVector Gradient(
+				Lerp2(V[1][0][0] - V[0][0][0], V[1][1][0] - V[0][1][0], V[1][0][1] - V[0][0][1], V[1][1][1] - V[0][1][1], P.Y, P.Z),
+				Lerp2(V[0][1][0] - V[0][0][0], V[1][1][0] - V[1][0][0], V[0][1][1] - V[0][0][1], V[1][1][1] - V[1][0][1], P.X, P.Z),
+				Lerp2(V[0][0][1] - V[0][0][0], V[1][0][1] - V[1][0][0], V[0][1][1] - V[0][1][0], V[1][1][1] - V[1][1][0], P.X, P.Y));
+
+			BestT = HitT;
+
+			Hit.bHit = true;
+			Hit.Distance = HitT;
+			Hit.Position = Ray.Start + Ray.Direction * HitT;
+			Hit.Normal = Gradient.GetSafeNormal();
+			if (Hit.Normal.IsZero())
+			{
+				Hit.Normal = -Ray.Direction.ToFloat();
+			}
+			Hit.Material = Data.Get<FVoxelMaterial>(FVoxelUtilities::Clamp(FVoxelUtilities::RoundToInt(Hit.Position), Cell, Cell + 1), 0);
+
+			return true;
+		}
+	};
+}
+
+FVoxelIntBox FVoxelDataRaycast::GetBoundsToLock(const FVoxelData& Data, const FVoxelDataRay& Ray)
+{
+	FIntVector CellMin;
+	FIntVector CellMax;
+	if (!FVoxelDataRaycastImpl::GetCells(Data, Ray, CellMin, CellMax))
+	{
+		return {};
+	}
+	return FVoxelDataRaycastImpl::GetCellsBounds(CellMin, CellMax);
+}
+
+FVoxelDataRayHit FVoxelDataRaycast::Raycast(const FVoxelData& Data, const FVoxelDataRay& Ray)
+{
+	ensureVoxelSlow(FMath::IsNearlyEqual(Ray.Direction.SizeSquared(), 1, KINDA_SMALL_NUMBER));
+	return FVoxelDataRaycastImpl::FRaycaster(Data, Ray).Raycast();
+}
+
+void FVoxelDataRaycast::RaycastBatch(const FVoxelData& Data, TArrayView<const FVoxelDataRay> Rays, TArray<FVoxelDataRayHit>& OutHits, bool bMultiThreaded)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	OutHits.Reset();
+	OutHits.SetNum(Rays.Num());
+
+	TOptional<FVoxelIntBox> Bounds;
+	for (const FVoxelDataRay& Ray : Rays)
+	{
+		FIntVector CellMin;
+		FIntVector CellMax;
+		if (FVoxelDataRaycastImpl::GetCells(Data, Ray, CellMin, CellMax))
+		{
+			const FVoxelIntBox RayBounds = FVoxelDataRaycastImpl::GetCellsBounds(CellMin, CellMax);
+			Bounds = Bounds.IsSet() ? Bounds.GetValue() + RayBounds : RayBounds;
+		}
+	}
+	if (!Bounds.IsSet())
+	{
+		return;
+	}
+
+	FVoxelReadScopeLock Lock(Data, Bounds.GetValue(), FUNCTION_FNAME);
+
+	ParallelFor(Rays.Num(), [&](int32 Index)
+	{
+		OutHits[Index] = Raycast(Data, Rays[Index]);
+	}, !bMultiThreaded);
+}
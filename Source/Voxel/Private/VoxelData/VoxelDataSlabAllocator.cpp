@@ -0,0 +1,341 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelData/VoxelDataSlabAllocator.h"
+#include "VoxelData/VoxelDataOctree.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/BinarySearch.h"
+#include "Misc/ScopeRWLock.h"
+#include "HAL/PlatformTLS.h"
+
+#if PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
+
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelDataSlabsOverheadMemory);
+DEFINE_STAT(STAT_VoxelDataSlabsCount);
+
+static TAutoConsoleVariable<int32> CVarUseDataSlabAllocator(
+	TEXT("voxel.data.SlabAllocator"),
+	1,
+	TEXT("If true, the data leaves buffers and octree nodes are allocated from per voxel data slabs instead of the global heap. Only applies to new voxel datas"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDataSlabAllocatorHugePages(
+	TEXT("voxel.data.SlabAllocator.HugePages"),
+	0,
+	TEXT("If true, data slabs are 2MB aligned and backed by transparent huge pages when supported (Linux only). Only applies to new voxel datas"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDataSlabAllocatorMaxEmptySlabs(
+	TEXT("voxel.data.SlabAllocator.MaxEmptySlabs"),
+	1,
+	TEXT("Number of empty slabs kept per pool before returning them to the OS"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDataSlabAllocatorNumShards(
+	TEXT("voxel.data.SlabAllocator.NumShards"),
+	0,
+	TEXT("Number of shards per pool: threads allocate from different shards to avoid contending on the same lock. 0 to use the number of cores, up to 16. Only applies to new voxel datas"),
+	ECVF_Default);
+
+// Same as the huge page size on x64
+constexpr int64 GVoxelDataSlabSize = 2 * 1024 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+TUniquePtr<FVoxelDataSlabAllocator> FVoxelDataSlabAllocator::Create()
+{
+	if (CVarUseDataSlabAllocator.GetValueOnAnyThread() == 0)
+	{
+		return nullptr;
+	}
+
+	int32 NumShards = CVarDataSlabAllocatorNumShards.GetValueOnAnyThread();
+	if (NumShards <= 0)
+	{
+		NumShards = FMath::Min(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 16);
+	}
+	return MakeUnique<FVoxelDataSlabAllocator>(CVarDataSlabAllocatorHugePages.GetValueOnAnyThread() != 0, FMath::Max(1, NumShards));
+}
+
+FVoxelDataSlabAllocator::FVoxelDataSlabAllocator(bool bUseHugePages, int32 NumShards)
+#if PLATFORM_LINUX
+	: bUseHugePages(bUseHugePages)
+#else
+	: bUseHugePages(false)
+#endif
+	, SlabSize(GVoxelDataSlabSize)
+	, Pools(ForceInit)
+{
+	check(NumShards >= 1);
+
+	for (int32 Index = 0; Index < int32(EVoxelDataSlabPool::Num); Index++)
+	{
+		FPool& Pool = Pools[Index];
+		Pool.BlockSize = GetBlockSize(EVoxelDataSlabPool(Index));
+		Pool.BlocksPerSlab = SlabSize / Pool.BlockSize;
+		check(Pool.BlocksPerSlab > 1);
+
+		for (int32 ShardIndex = 0; ShardIndex < NumShards; ShardIndex++)
+		{
+			Pool.Shards.Add(MakeUnique<FShard>());
+		}
+	}
+}
+
+FVoxelDataSlabAllocator::~FVoxelDataSlabAllocator()
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	for (FPool& Pool : Pools)
+	{
+		for (auto& Shard : Pool.Shards)
+		{
+			// All the blocks should have been freed when destroying the octree
+			ensure(Shard->NumUsedBlocks == 0);
+		}
+
+		for (FSlab* Slab : Pool.Slabs)
+		{
+			FreeSlab(Pool, Slab);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void* FVoxelDataSlabAllocator::Malloc(EVoxelDataSlabPool PoolType)
+{
+	VOXEL_SLOW_FUNCTION_COUNTER();
+
+	FPool& Pool = Pools[int32(PoolType)];
+	const int32 ShardIndex = GetShardIndex();
+	FShard& Shard = *Pool.Shards[ShardIndex];
+	FScopeLock Lock(&Shard.Section);
+
+	if (Shard.PartialSlabs.Num() == 0)
+	{
+		FSlab* NewSlab = AllocateSlab(Pool, ShardIndex);
+		NewSlab->PartialIndex = Shard.PartialSlabs.Add(NewSlab);
+		Shard.NumEmptySlabs++;
+	}
+
+	// Allocate from the slab that most recently got free blocks, so that the older ones have a chance to empty out
+	FSlab& Slab = *Shard.PartialSlabs.Last();
+	checkVoxelSlow(Slab.NumUsed < Pool.BlocksPerSlab);
+
+	void* Ptr;
+	if (Slab.FreeList)
+	{
+		Ptr = Slab.FreeList;
+		Slab.FreeList = *static_cast<void**>(Ptr);
+	}
+	else
+	{
+		checkVoxelSlow(Slab.NumCarved < Pool.BlocksPerSlab);
+		Ptr = Slab.Data + int64(Slab.NumCarved) * Pool.BlockSize;
+		Slab.NumCarved++;
+	}
+
+	if (Slab.NumUsed == 0)
+	{
+		Shard.NumEmptySlabs--;
+	}
+	Slab.NumUsed++;
+	Shard.NumUsedBlocks++;
+
+	if (Slab.NumUsed == Pool.BlocksPerSlab)
+	{
+		Shard.PartialSlabs.Pop(UE_505_SWITCH(false, EAllowShrinking::No));
+		Slab.PartialIndex = -1;
+	}
+
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSlabsOverheadMemory, Pool.BlockSize);
+
+	return Ptr;
+}
+
+void FVoxelDataSlabAllocator::Free(EVoxelDataSlabPool PoolType, void* Ptr)
+{
+	VOXEL_SLOW_FUNCTION_COUNTER();
+	check(Ptr);
+
+	FPool& Pool = Pools[int32(PoolType)];
+
+	// The slab can't be removed while we look for it: the block being freed is still counted in its NumUsed
+	FSlab* Slab;
+	{
+		FReadScopeLock Lock(Pool.SlabsLock);
+
+		// Find the last slab starting before Ptr
+		const int32 SlabIndex = Algo::UpperBoundBy(Pool.Slabs, static_cast<uint8*>(Ptr), [](const FSlab* Other) { return Other->Data; }) - 1;
+		check(Pool.Slabs.IsValidIndex(SlabIndex));
+		Slab = Pool.Slabs[SlabIndex];
+	}
+	checkVoxelSlow(static_cast<uint8*>(Ptr) < Slab->Data + int64(Pool.BlocksPerSlab) * Pool.BlockSize);
+	checkVoxelSlow((static_cast<uint8*>(Ptr) - Slab->Data) % Pool.BlockSize == 0);
+
+	FShard& Shard = *Pool.Shards[Slab->ShardIndex];
+	FScopeLock Lock(&Shard.Section);
+
+	checkVoxelSlow(Slab->NumUsed > 0);
+
+	*static_cast<void**>(Ptr) = Slab->FreeList;
+	Slab->FreeList = Ptr;
+
+	if (Slab->PartialIndex == -1)
+	{
+		Slab->PartialIndex = Shard.PartialSlabs.Add(Slab);
+	}
+
+	Slab->NumUsed--;
+	Shard.NumUsedBlocks--;
+
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSlabsOverheadMemory, Pool.BlockSize);
+
+	if (Slab->NumUsed > 0)
+	{
+		return;
+	}
+
+	Shard.NumEmptySlabs++;
+	if (Shard.NumEmptySlabs <= CVarDataSlabAllocatorMaxEmptySlabs.GetValueOnAnyThread())
+	{
+		return;
+	}
+
+	// Return the slab to the OS
+	Shard.NumEmptySlabs--;
+
+	const int32 PartialIndex = Slab->PartialIndex;
+	Shard.PartialSlabs.RemoveAtSwap(PartialIndex, 1, UE_505_SWITCH(false, EAllowShrinking::No));
+	if (Shard.PartialSlabs.IsValidIndex(PartialIndex))
+	{
+		Shard.PartialSlabs[PartialIndex]->PartialIndex = PartialIndex;
+	}
+
+	{
+		FWriteScopeLock SlabsLock(Pool.SlabsLock);
+		Pool.Slabs.RemoveSingle(Slab);
+	}
+
+	FreeSlab(Pool, Slab);
+}
+
+int32 FVoxelDataSlabAllocator::GetBlockSize(EVoxelDataSlabPool Pool)
+{
+	int32 Size;
+	switch (Pool)
+	{
+	default: ensure(false);
+	case EVoxelDataSlabPool::Values: Size = VOXELS_PER_DATA_CHUNK * sizeof(FVoxelValue); break;
+	case EVoxelDataSlabPool::Materials: Size = VOXELS_PER_DATA_CHUNK * sizeof(FVoxelMaterial); break;
+	case EVoxelDataSlabPool::MaterialChannels: Size = VOXELS_PER_DATA_CHUNK * sizeof(uint8); break;
+	case EVoxelDataSlabPool::LeafChildren: Size = 8 * sizeof(FVoxelDataOctreeLeaf); break;
+	case EVoxelDataSlabPool::ParentChildren: Size = 8 * sizeof(FVoxelDataOctreeParent); break;
+	}
+	// Freed blocks store the free list next pointer
+	return Align(FMath::Max<int32>(Size, sizeof(void*)), 16);
+}
+
+FVoxelDataSlabAllocator::FStats FVoxelDataSlabAllocator::GetStats() const
+{
+	FStats Stats;
+	for (const FPool& Pool : Pools)
+	{
+		{
+			FReadScopeLock Lock(Pool.SlabsLock);
+			Stats.NumSlabs += Pool.Slabs.Num();
+			Stats.AllocatedMemory += Pool.Slabs.Num() * SlabSize;
+		}
+		for (const auto& Shard : Pool.Shards)
+		{
+			FScopeLock Lock(&Shard->Section);
+			Stats.NumBlocks += Shard->NumUsedBlocks;
+			Stats.UsedMemory += Shard->NumUsedBlocks * Pool.BlockSize;
+		}
+	}
+	return Stats;
+}
+
+int32 FVoxelDataSlabAllocator::GetShardIndex() const
+{
+	// Hash the thread id, as on some platforms they are all multiples of 4
+	return FVoxelUtilities::MurmurHash32(FPlatformTLS::GetCurrentThreadId()) % uint32(Pools[0].Shards.Num());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+FVoxelDataSlabAllocator::FSlab* FVoxelDataSlabAllocator::AllocateSlab(FPool& Pool, int32 ShardIndex) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	uint8* Data = nullptr;
+	bool bMapped = false;
+#if PLATFORM_LINUX
+	if (bUseHugePages)
+	{
+		// Over-map to be able to align the slab on the huge page size, then unmap the extra
+		uint8* Mapped = static_cast<uint8*>(mmap(nullptr, 2 * SlabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+		if (Mapped != MAP_FAILED)
+		{
+			Data = Align(Mapped, SlabSize);
+			if (Data > Mapped)
+			{
+				munmap(Mapped, Data - Mapped);
+			}
+			munmap(Data + SlabSize, Mapped + SlabSize - Data);
+			madvise(Data, SlabSize, MADV_HUGEPAGE);
+			bMapped = true;
+		}
+	}
+#endif
+	if (!Data)
+	{
+		Data = static_cast<uint8*>(FMemory::Malloc(SlabSize));
+	}
+
+	FSlab* Slab = new FSlab();
+	Slab->Data = Data;
+	Slab->ShardIndex = ShardIndex;
+	Slab->bMapped = bMapped;
+
+	{
+		FWriteScopeLock Lock(Pool.SlabsLock);
+		const int32 Index = Algo::UpperBoundBy(Pool.Slabs, Data, [](const FSlab* Other) { return Other->Data; });
+		Pool.Slabs.Insert(Slab, Index);
+	}
+
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSlabsOverheadMemory, SlabSize);
+	INC_DWORD_STAT_BY(STAT_VoxelDataSlabsCount, 1);
+
+	return Slab;
+}
+
+void FVoxelDataSlabAllocator::FreeSlab(FPool& Pool, FSlab* Slab) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	// Blocks still in use are leaked: only happens if the octree wasn't properly destroyed
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSlabsOverheadMemory, SlabSize - int64(Slab->NumUsed) * Pool.BlockSize);
+	DEC_DWORD_STAT_BY(STAT_VoxelDataSlabsCount, 1);
+
+#if PLATFORM_LINUX
+	if (Slab->bMapped)
+	{
+		munmap(Slab->Data, SlabSize);
+	}
+	else
+#endif
+	{
+		FMemory::Free(Slab->Data);
+	}
+
+	delete Slab;
+}
@@ -0,0 +1,250 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelData/VoxelDataSnapshot.h"
+#include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelData/VoxelDataOctree.h"
+#include "VoxelData/VoxelSaveUtilities.h"
+#include "VoxelData/VoxelSave.h"
+#include "VoxelUtilities/VoxelOctreeUtilities.h"
+#include "Async/ParallelFor.h"
+
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelDataSnapshotsMemory);
+
+FVoxelDataSnapshot::FVoxelDataSnapshot(const FVoxelData& Data)
+	: Data(Data.AsShared())
+{
+}
+
+FVoxelDataSnapshot::~FVoxelDataSnapshot()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	Data->UnregisterSnapshot(*this);
+
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.Captured.IsValid())
+		{
+			Entry.Captured->Values.ClearData(Memory);
+			Entry.Captured->Materials.ClearData(Memory);
+		}
+	}
+
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSnapshotsMemory, ReportedMemory);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelDataSnapshot::IterateLeaves(FIterateLeavesFunction Apply) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	for (int32 LeafIndex = 0; LeafIndex < Entries.Num(); LeafIndex++)
+	{
+		IterateLeaf(LeafIndex, Apply);
+	}
+}
+
+void FVoxelDataSnapshot::ParallelIterateLeaves(FIterateLeavesFunction Apply) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	ParallelFor(Entries.Num(), [&](int32 LeafIndex)
+	{
+		IterateLeaf(LeafIndex, Apply);
+	});
+}
+
+void FVoxelDataSnapshot::IterateLeaf(int32 LeafIndex, FIterateLeavesFunction Apply) const
+{
+	const FEntry& Entry = Entries[LeafIndex];
+
+	// Lock the leaf so that it's not modified nor captured while reading it
+	// This also locks the main lock, making sure the live octree is not cleared
+	FVoxelReadScopeLock Lock(*Data, Entry.Bounds, "Snapshot");
+
+	if (Entry.Captured.IsValid())
+	{
+		Apply(LeafIndex, Entry.Position, Entry.Captured->Values, Entry.Captured->Materials);
+	}
+	else
+	{
+		checkVoxelSlow(Entry.Leaf);
+		Apply(LeafIndex, Entry.Position, Entry.Leaf->Values, Entry.Leaf->Materials);
+	}
+}
+
+void FVoxelDataSnapshot::GetSave(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FVoxelObjectArchiveEntry>& OutObjects) const
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	struct FChunk
+	{
+		FIntVector Position;
+		TUniquePtr<TVoxelDataOctreeLeafData<FVoxelValue>> Values;
+		TUniquePtr<TVoxelDataOctreeLeafData<FVoxelMaterial>> Materials;
+	};
+
+	// Memory of the copies made for this save
+	IVoxelDataOctreeMemory SaveMemory;
+	TArray<FChunk> Chunks;
+	Chunks.SetNum(Entries.Num());
+
+	// Copy the dirty data, only locking one leaf at a time
+	ParallelIterateLeaves([&](int32 LeafIndex, const FIntVector& Position, const TVoxelDataOctreeLeafData<FVoxelValue>& Values, const TVoxelDataOctreeLeafData<FVoxelMaterial>& Materials)
+	{
+		FChunk& Chunk = Chunks[LeafIndex];
+		Chunk.Position = Position;
+
+		if (Values.IsDirty())
+		{
+			Chunk.Values = MakeUnique<TVoxelDataOctreeLeafData<FVoxelValue>>();
+			Chunk.Values->CreateData(SaveMemory, Values);
+			Chunk.Values->SetIsDirty(true, SaveMemory);
+		}
+		if (Materials.IsDirty())
+		{
+			Chunk.Materials = MakeUnique<TVoxelDataOctreeLeafData<FVoxelMaterial>>();
+			Chunk.Materials->CreateData(SaveMemory, Materials);
+			Chunk.Materials->SetIsDirty(true, SaveMemory);
+		}
+	});
+
+	if (CVarStoreSpecialValueForGeneratorValuesInSaves.GetValueOnAnyThread() != 0)
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Diffing with generator");
+
+		// No lock is held: the copies can be diffed in parallel
+		ParallelFor(Chunks.Num(), [&](int32 ChunkIndex)
+		{
+			FChunk& Chunk = Chunks[ChunkIndex];
+
+			// Only if dirty and not compressed to a single value
+			if (!Chunk.Values.IsValid() || Chunk.Values->IsSingleValue())
+			{
+				return;
+			}
+
+			auto Diffed = MakeUnique<TVoxelDataOctreeLeafData<FVoxelValue>>();
+			Diffed->CreateData(SaveMemory);
+			Diffed->SetIsDirty(true, SaveMemory);
+
+			const FVoxelIntBox LeafBounds = FVoxelIntBox(Chunk.Position - DATA_CHUNK_SIZE / 2, Chunk.Position + DATA_CHUNK_SIZE / 2);
+			LeafBounds.Iterate([&](int32 X, int32 Y, int32 Z)
+			{
+				const FVoxelCellIndex Index = FVoxelDataOctreeUtilities::IndexFromGlobalCoordinates(LeafBounds.Min, X, Y, Z);
+				const FVoxelValue Value = Chunk.Values->Get(Index);
+				// Empty stack: items not loaded when loading in LoadFromSave
+				const FVoxelValue GeneratorValue = Data->Generator->Get<FVoxelValue>(X, Y, Z, 0, FVoxelItemStack::Empty);
+
+				Diffed->GetRef(Index) = GeneratorValue == Value ? FVoxelValue::Special() : Value;
+			});
+
+			Diffed->TryCompressToSingleValue(SaveMemory);
+
+			Chunk.Values->ClearData(SaveMemory);
+			Chunk.Values = MoveTemp(Diffed);
+		});
+	}
+
+	// Not dirty: saved as generator data
+	const TVoxelDataOctreeLeafData<FVoxelValue> EmptyValues;
+	const TVoxelDataOctreeLeafData<FVoxelMaterial> EmptyMaterials;
+
+	FVoxelSaveBuilder Builder(Data->Depth);
+	for (const FChunk& Chunk : Chunks)
+	{
+		Builder.AddChunk(
+			Chunk.Position,
+			Chunk.Values.IsValid() ? *Chunk.Values : EmptyValues,
+			Chunk.Materials.IsValid() ? *Chunk.Materials : EmptyMaterials);
+	}
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Items");
+
+		for (const FVoxelAssetItem& AssetItem : AssetItems)
+		{
+			Builder.AddAssetItem(AssetItem);
+		}
+	}
+
+	Builder.Save(OutSave, OutObjects);
+
+	VOXEL_ASYNC_SCOPE_COUNTER("ClearData");
+	for (FChunk& Chunk : Chunks)
+	{
+		// For correct memory reports
+		if (Chunk.Values.IsValid())
+		{
+			Chunk.Values->ClearData(SaveMemory);
+		}
+		if (Chunk.Materials.IsValid())
+		{
+			Chunk.Materials->ClearData(SaveMemory);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelDataSnapshot::CaptureLeaf(const FVoxelDataOctreeLeaf& Leaf)
+{
+	const int32* EntryIndex = PositionToEntry.Find(Leaf.Position);
+	if (!EntryIndex)
+	{
+		// Created after the snapshot
+		return;
+	}
+
+	FEntry& Entry = Entries[*EntryIndex];
+	if (Entry.Captured.IsValid())
+	{
+		return;
+	}
+	checkVoxelSlow(Entry.Leaf == &Leaf);
+
+	VOXEL_ASYNC_SCOPE_COUNTER("FVoxelDataSnapshot::CaptureLeaf");
+
+	Entry.Captured = MakeUnique<FCapturedLeaf>();
+	if (Leaf.Values.IsDirty())
+	{
+		Entry.Captured->Values.CreateData(Memory, Leaf.Values);
+		Entry.Captured->Values.SetIsDirty(true, Memory);
+	}
+	if (Leaf.Materials.IsDirty())
+	{
+		Entry.Captured->Materials.CreateData(Memory, Leaf.Materials);
+		Entry.Captured->Materials.SetIsDirty(true, Memory);
+	}
+	Entry.Leaf = nullptr;
+
+	NumCaptured.Increment();
+}
+
+void FVoxelDataSnapshot::CaptureAll()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	for (FEntry& Entry : Entries)
+	{
+		if (Entry.Leaf)
+		{
+			CaptureLeaf(*Entry.Leaf);
+		}
+	}
+}
+
+void FVoxelDataSnapshot::UpdateStats()
+{
+	const int64 NewMemory =
+		Memory.GetDirtyMemory().Values.GetValue() +
+		Memory.GetDirtyMemory().Materials.GetValue();
+
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataSnapshotsMemory, NewMemory - ReportedMemory);
+	ReportedMemory = NewMemory;
+}
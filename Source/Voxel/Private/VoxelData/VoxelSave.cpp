@@ -4,6 +4,7 @@
 #include "VoxelUtilities/VoxelSerializationUtilities.h"
 #include "VoxelUtilities/VoxelMathUtilities.h"
 #include "VoxelMessages.h"
+#include "VoxelSettings.h"
 
 DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelUncompressedSavesMemory);
 DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelCompressedSavesMemory);
@@ -139,16 +140,46 @@ bool FVoxelUncompressedWorldSaveImpl::Serialize(FArchive& Ar)
 		uint32 MaterialConfigFlag = GVoxelMaterialConfigFlag;
 		Ar << MaterialConfigFlag;
 
+		// Serialize the filter applied to the buffers
+		EVoxelCompressionFilter Filter = EVoxelCompressionFilter::None;
+		if (Version >= FVoxelSaveVersion::FilteredSaveBuffers)
+		{
+			uint8 FilterValue = uint8(GetDefault<UVoxelSettings>()->SaveCompressionFilter);
+			Ar << FilterValue;
+
+			if (!ensureMsgf(FilterValue <= uint8(EVoxelCompressionFilter::SplitMaterialChannels), TEXT("Invalid save filter %u"), FilterValue))
+			{
+				Ar.SetError();
+				return false;
+			}
+			Filter = EVoxelCompressionFilter(FilterValue);
+		}
+
 		// Serialize buffers
 		if (Version >= FVoxelSaveVersion::StoreMaterialChannelsIndividuallyAndRemoveFoliage)
 		{
 			// Serialize value buffers
-			FVoxelSerializationUtilities::SerializeValues(Ar, ValueBuffers, ValueConfigFlag, SerializationVersion);
+			FVoxelSerializationUtilities::SerializeValues(Ar, ValueBuffers, ValueConfigFlag, SerializationVersion, Filter == EVoxelCompressionFilter::DeltaValues);
 			FVoxelSerializationUtilities::SerializeValues(Ar, SingleValues, ValueConfigFlag, SerializationVersion);
 
 			// Serialize material buffers
 			FVoxelSerializationUtilities::SerializeMaterials(Ar, MaterialsIndices, MaterialConfigFlag);
-			MaterialBuffers.BulkSerialize(Ar);
+			if (Filter == EVoxelCompressionFilter::SplitMaterialChannels)
+			{
+				// The material buffers are already split by channel: delta encode each channel
+				int32 NumMaterials = MaterialBuffers.Num();
+				Ar << NumMaterials;
+				if (Ar.IsLoading())
+				{
+					MaterialBuffers.Empty(NumMaterials);
+					MaterialBuffers.SetNumUninitialized(NumMaterials);
+				}
+				FVoxelSerializationUtilities::SerializeDeltaEncoded(Ar, MaterialBuffers.GetData(), NumMaterials, sizeof(uint8));
+			}
+			else
+			{
+				MaterialBuffers.BulkSerialize(Ar);
+			}
 			SingleMaterials.BulkSerialize(Ar);
 
 			// Serialize chunks indices
@@ -356,6 +387,27 @@ bool FVoxelCompressedWorldSaveImpl::Serialize(FArchive& Ar)
 		{
 			Ar << Guid;
 		}
+
+		if (Version >= FVoxelSaveVersion::RegionIndexedSaves)
+		{
+			Ar << RegionSize;
+			if (RegionSize > 0)
+			{
+				Ar << ItemsRegion;
+				Ar << Regions;
+			}
+		}
+		else
+		{
+			RegionSize = 0;
+		}
+
+		if (Ar.IsLoading() && !IsRegionIndexed())
+		{
+			ItemsRegion = {};
+			Regions.Reset();
+		}
+
 		Ar << CompressedData;
 
 		UpdateAllocatedSize();
@@ -367,7 +419,7 @@ bool FVoxelCompressedWorldSaveImpl::Serialize(FArchive& Ar)
 void FVoxelCompressedWorldSaveImpl::UpdateAllocatedSize() const
 {
 	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelCompressedSavesMemory, AllocatedSize);
-	AllocatedSize = CompressedData.GetAllocatedSize();
+	AllocatedSize = CompressedData.GetAllocatedSize() + Regions.GetAllocatedSize();
 	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelCompressedSavesMemory, AllocatedSize);
 }
 
@@ -4,12 +4,26 @@
 #include "VoxelData/VoxelDataOctreeLeafData.h"
 #include "VoxelPlaceableItems/VoxelPlaceableItem.h"
 #include "VoxelMessages.h"
+#include "VoxelSettings.h"
+#include "VoxelWorld.h"
+#include "VoxelData/VoxelData.h"
 #include "VoxelUtilities/VoxelSerializationUtilities.h"
+#include "VoxelUtilities/VoxelIntVectorUtilities.h"
 
 #include "Serialization/LargeMemoryReader.h"
 #include "Serialization/LargeMemoryWriter.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "EngineUtils.h"
+
+static TAutoConsoleVariable<int32> CVarSaveRegionSize(
+	TEXT("voxel.data.SaveRegionSize"),
+	256,
+	TEXT("Size in voxels of the regions of the compressed saves. Each region is compressed separately, allowing to only load the regions around the invokers. ")
+	TEXT("0 to save as a single block like older versions"),
+	ECVF_Default);
 
 FVoxelSaveBuilder::FVoxelSaveBuilder(int32 Depth)
 	: Depth(Depth)
@@ -25,6 +39,9 @@ void FVoxelSaveBuilder::Save(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FV
 	OutSave.Depth = Depth;
 	OutSave.Chunks.Empty(ChunksToSave.Num());
 
+	// Number of values & materials the buffers must hold once the indices are assigned
+	int32 ExpectedNumValues = 0;
+	int32 ExpectedNumMaterials = 0;
 	{
 		uint32 NumValueBuffers = 0;
 		uint32 NumSingleValues = 0;
@@ -37,8 +54,8 @@ void FVoxelSaveBuilder::Save(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FV
 		{
 			if (Chunk.Values->IsDirty())
 			{
-				NumValueBuffers += Chunk.Values->DataPtr != nullptr;
-				NumSingleValues += Chunk.Values->DataPtr == nullptr;
+				NumValueBuffers += !Chunk.Values->bIsSingleValue;
+				NumSingleValues += Chunk.Values->bIsSingleValue;
 			}
 
 			if (Chunk.Materials->IsDirty())
@@ -59,89 +76,152 @@ void FVoxelSaveBuilder::Save(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FV
 			}
 		}
 		
-		OutSave.ValueBuffers.Empty(NumValueBuffers * VOXELS_PER_DATA_CHUNK);
+		ExpectedNumValues = NumValueBuffers * VOXELS_PER_DATA_CHUNK;
+		ExpectedNumMaterials = NumMaterialBuffers * VOXELS_PER_DATA_CHUNK;
+		
+		OutSave.ValueBuffers.Empty(ExpectedNumValues);
 		OutSave.SingleValues.Empty(NumSingleValues);
 		
 		OutSave.MaterialsIndices.Empty(NumMaterialsIndices);
-		OutSave.MaterialBuffers.Empty(NumMaterialBuffers * VOXELS_PER_DATA_CHUNK);
+		OutSave.MaterialBuffers.Empty(ExpectedNumMaterials);
 		OutSave.SingleMaterials.Empty(NumSingleMaterials);
 	}
 
-	for (auto& Chunk : ChunksToSave)
+	// Assign the buffers indices serially, so that the layout is the same as if the chunks were added one by one
+	TArray<TVoxelMaterialStorage<uint32>> ChunksMaterialIndices;
+	ChunksMaterialIndices.SetNumUninitialized(ChunksToSave.Num());
 	{
-		FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave NewChunk;
-		NewChunk.Position = Chunk.Position;
+		VOXEL_ASYNC_SCOPE_COUNTER("Assign indices");
+
+		int32 NumValues = 0;
+		int32 NumMaterials = 0;
 		
-		if (Chunk.Values->IsDirty())
+		for (int32 ChunkIndex = 0; ChunkIndex < ChunksToSave.Num(); ChunkIndex++)
 		{
-			if (Chunk.Values->DataPtr)
+			const FChunkToSave& Chunk = ChunksToSave[ChunkIndex];
+			
+			FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave NewChunk;
+			NewChunk.Position = Chunk.Position;
+
+			if (Chunk.Values->IsDirty())
 			{
-				NewChunk.ValuesIndex = OutSave.ValueBuffers.AddUninitialized(VOXELS_PER_DATA_CHUNK);
-				FMemory::Memcpy(&OutSave.ValueBuffers[NewChunk.ValuesIndex], Chunk.Values->DataPtr, sizeof(FVoxelValue) * VOXELS_PER_DATA_CHUNK);
+				if (Chunk.Values->DataPtr || Chunk.Values->Palette.IsValid())
+				{
+					NewChunk.ValuesIndex = NumValues;
+					NumValues += VOXELS_PER_DATA_CHUNK;
+				}
+				else
+				{
+					check(Chunk.Values->bIsSingleValue);
+
+					NewChunk.ValuesIndex = OutSave.SingleValues.Add(Chunk.Values->SingleValue);
+					NewChunk.bSingleValue = true;
+				}
 			}
 			else
 			{
-				check(Chunk.Values->bIsSingleValue);
+				NewChunk.ValuesIndex = -1;
+			}
+
+			if (Chunk.Materials->IsDirty())
+			{
+				TVoxelMaterialStorage<uint32>& MaterialIndices = ChunksMaterialIndices[ChunkIndex];
 				
-				NewChunk.ValuesIndex = OutSave.SingleValues.Add(Chunk.Values->SingleValue);
-				NewChunk.bSingleValue = true;
+				if (Chunk.Materials->bUseChannels)
+				{
+					for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
+					{
+						if (Chunk.Materials->Channels_DataPtr[Channel])
+						{
+							MaterialIndices.GetRaw(Channel) = NumMaterials;
+							NumMaterials += VOXELS_PER_DATA_CHUNK;
+						}
+						else
+						{
+							MaterialIndices.GetRaw(Channel) = OutSave.SingleMaterials.Add(Chunk.Materials->Channels_SingleValue[Channel]);
+							MaterialIndices.GetRaw(Channel) |= FVoxelUncompressedWorldSaveImpl::MaterialIndexSingleValueFlag;
+						}
+					}
+				}
+				else
+				{
+					check(Chunk.Materials->Main_DataPtr || Chunk.Materials->Palette.IsValid());
+
+					for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
+					{
+						MaterialIndices.GetRaw(Channel) = NumMaterials;
+						NumMaterials += VOXELS_PER_DATA_CHUNK;
+					}
+				}
+
+				NewChunk.MaterialsIndex = OutSave.MaterialsIndices.Add(MaterialIndices);
 			}
+			else
+			{
+				NewChunk.MaterialsIndex = -1;
+			}
+
+			OutSave.Chunks.Add(NewChunk);
 		}
-		else
-		{
-			NewChunk.ValuesIndex = -1;
-		}
-		
-		if (Chunk.Materials->IsDirty())
+
+		check(NumValues == ExpectedNumValues);
+		check(NumMaterials == ExpectedNumMaterials);
+
+		OutSave.ValueBuffers.SetNumUninitialized(NumValues);
+		OutSave.MaterialBuffers.SetNumUninitialized(NumMaterials);
+	}
+
+	// Copy the buffers in parallel
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Copy buffers");
+
+		ParallelFor(ChunksToSave.Num(), [&](int32 ChunkIndex)
 		{
-			TVoxelMaterialStorage<uint32> MaterialIndices;
-			
+			const FChunkToSave& Chunk = ChunksToSave[ChunkIndex];
+			const FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave& NewChunk = OutSave.Chunks[ChunkIndex];
+
+			if (NewChunk.ValuesIndex != -1 && !NewChunk.bSingleValue)
+			{
+				FVoxelValue* RESTRICT ValuesPtr = &OutSave.ValueBuffers[NewChunk.ValuesIndex];
+				if (Chunk.Values->DataPtr)
+				{
+					FMemory::Memcpy(ValuesPtr, Chunk.Values->DataPtr, sizeof(FVoxelValue) * VOXELS_PER_DATA_CHUNK);
+				}
+				else
+				{
+					Chunk.Values->Palette.CopyTo(ValuesPtr);
+				}
+			}
+
+			if (NewChunk.MaterialsIndex == -1)
+			{
+				return;
+			}
+
+			const TVoxelMaterialStorage<uint32>& MaterialIndices = ChunksMaterialIndices[ChunkIndex];
 			if (Chunk.Materials->bUseChannels)
 			{
 				for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
 				{
 					if (auto& DataPtr = Chunk.Materials->Channels_DataPtr[Channel])
 					{
-						const int32 Index = OutSave.MaterialBuffers.AddUninitialized(VOXELS_PER_DATA_CHUNK);
-						FMemory::Memcpy(&OutSave.MaterialBuffers[Index], DataPtr, sizeof(uint8) * VOXELS_PER_DATA_CHUNK);
-
-						MaterialIndices.GetRaw(Channel) = Index;
-					}
-					else
-					{
-						MaterialIndices.GetRaw(Channel) = OutSave.SingleMaterials.Add(Chunk.Materials->Channels_SingleValue[Channel]);
-						MaterialIndices.GetRaw(Channel) |= FVoxelUncompressedWorldSaveImpl::MaterialIndexSingleValueFlag;
+						FMemory::Memcpy(&OutSave.MaterialBuffers[MaterialIndices.GetRaw(Channel)], DataPtr, sizeof(uint8) * VOXELS_PER_DATA_CHUNK);
 					}
 				}
 			}
 			else
 			{
-				check(Chunk.Materials->Main_DataPtr);
-				
-				for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
-				{
-					MaterialIndices.GetRaw(Channel) = OutSave.MaterialBuffers.AddUninitialized(VOXELS_PER_DATA_CHUNK);
-				}
-
 				for (int32 Index = 0; Index < VOXELS_PER_DATA_CHUNK; Index++)
 				{
-					const FVoxelMaterial& Material = Chunk.Materials->Main_DataPtr[Index];
-					
+					const FVoxelMaterial Material = Chunk.Materials->Get(Index);
+
 					for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
 					{
 						OutSave.MaterialBuffers[MaterialIndices.GetRaw(Channel) + Index] = Material.GetRaw(Channel);
 					}
 				}
 			}
-			
-			NewChunk.MaterialsIndex = OutSave.MaterialsIndices.Add(MaterialIndices); 
-		}
-		else
-		{
-			NewChunk.MaterialsIndex = -1;
-		}
-
-		OutSave.Chunks.Add(NewChunk);
+		});
 	}
 
 	ensure(OutSave.Chunks.GetSlack() == 0);
@@ -181,9 +261,14 @@ void FVoxelSaveLoader::ExtractChunk(
 	const IVoxelDataOctreeMemory& Memory,
 	TVoxelDataOctreeLeafData<FVoxelValue>& OutValues,
 	TVoxelDataOctreeLeafData<FVoxelMaterial>& OutMaterials) const
+{
+	ExtractValues(ChunkIndex, Memory, OutValues);
+	ExtractMaterials(ChunkIndex, Memory, OutMaterials);
+}
+
+void FVoxelSaveLoader::ExtractValues(int32 ChunkIndex, const IVoxelDataOctreeMemory& Memory, TVoxelDataOctreeLeafData<FVoxelValue>& OutValues) const
 {
 	OutValues.ClearData(Memory);
-	OutMaterials.ClearData(Memory);
 	
 	auto& Chunk = Save.Chunks[ChunkIndex];
 	if (Chunk.ValuesIndex >= 0)
@@ -202,6 +287,13 @@ void FVoxelSaveLoader::ExtractChunk(
 		}
 		OutValues.SetIsDirty(true, Memory);
 	}
+}
+
+void FVoxelSaveLoader::ExtractMaterials(int32 ChunkIndex, const IVoxelDataOctreeMemory& Memory, TVoxelDataOctreeLeafData<FVoxelMaterial>& OutMaterials) const
+{
+	OutMaterials.ClearData(Memory);
+	
+	auto& Chunk = Save.Chunks[ChunkIndex];
 	if (Chunk.MaterialsIndex >= 0)
 	{
 		const auto& MaterialIndices = Save.MaterialsIndices[Chunk.MaterialsIndex];
@@ -280,6 +372,253 @@ void FVoxelSaveLoader::GetPlaceableItems(const FVoxelPlaceableItemLoadInfo& Load
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+void FVoxelSaveRegionUtilities::GroupChunksByRegion(
+	const FVoxelUncompressedWorldSaveImpl& Save,
+	int32 RegionSize,
+	TArray<FVoxelIntBox>& OutRegionsBounds,
+	TArray<TArray<int32>>& OutRegionsChunks)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(RegionSize > 0 && RegionSize % DATA_CHUNK_SIZE == 0);
+
+	TMap<FIntVector, TArray<int32>> KeyToChunks;
+	for (int32 ChunkIndex = 0; ChunkIndex < Save.Chunks.Num(); ChunkIndex++)
+	{
+		// Chunk positions are the center of the leaves
+		const FIntVector ChunkMin = Save.Chunks[ChunkIndex].Position - DATA_CHUNK_SIZE / 2;
+		KeyToChunks.FindOrAdd(FVoxelUtilities::DivideFloor(ChunkMin, RegionSize)).Add(ChunkIndex);
+	}
+	
+	KeyToChunks.KeySort([](const FIntVector& A, const FIntVector& B)
+	{
+		if (A.Z != B.Z) return A.Z < B.Z;
+		if (A.Y != B.Y) return A.Y < B.Y;
+		return A.X < B.X;
+	});
+
+	OutRegionsBounds.Reset(KeyToChunks.Num());
+	OutRegionsChunks.Reset(KeyToChunks.Num());
+	for (auto& It : KeyToChunks)
+	{
+		OutRegionsBounds.Add(FVoxelIntBox(It.Key * RegionSize, (It.Key + 1) * RegionSize));
+		OutRegionsChunks.Add(MoveTemp(It.Value));
+	}
+}
+
+void FVoxelSaveRegionUtilities::CopyChunks(
+	const FVoxelUncompressedWorldSaveImpl& Save,
+	TConstArrayView<int32> ChunkIndices,
+	bool bCopyPlaceableItems,
+	FVoxelUncompressedWorldSaveImpl& OutSave)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	Init(Save, OutSave);
+	AppendChunks(Save, ChunkIndices, OutSave);
+
+	if (bCopyPlaceableItems)
+	{
+		OutSave.PlaceableItems = Save.PlaceableItems;
+	}
+
+	OutSave.UpdateAllocatedSize();
+}
+
+void FVoxelSaveRegionUtilities::Merge(
+	TConstArrayView<const FVoxelUncompressedWorldSaveImpl*> Saves,
+	FVoxelUncompressedWorldSaveImpl& OutSave)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	if (!ensure(Saves.Num() > 0))
+	{
+		return;
+	}
+
+	Init(*Saves[0], OutSave);
+
+	{
+		int32 NumChunks = 0;
+		for (const FVoxelUncompressedWorldSaveImpl* Save : Saves)
+		{
+			NumChunks += Save->Chunks.Num();
+		}
+		OutSave.Chunks.Reserve(NumChunks);
+	}
+
+	TArray<int32> ChunkIndices;
+	for (const FVoxelUncompressedWorldSaveImpl* Save : Saves)
+	{
+		ensure(Save->Guid == OutSave.Guid && Save->Depth == OutSave.Depth);
+		
+		ChunkIndices.Reset(Save->Chunks.Num());
+		for (int32 ChunkIndex = 0; ChunkIndex < Save->Chunks.Num(); ChunkIndex++)
+		{
+			ChunkIndices.Add(ChunkIndex);
+		}
+		AppendChunks(*Save, ChunkIndices, OutSave);
+
+		if (Save->PlaceableItems.Num() > 0)
+		{
+			ensureMsgf(OutSave.PlaceableItems.Num() == 0, TEXT("Placeable items are in more than one part of the save"));
+			OutSave.PlaceableItems = Save->PlaceableItems;
+		}
+	}
+
+	SortChunks(OutSave);
+
+	OutSave.UpdateAllocatedSize();
+}
+
+void FVoxelSaveRegionUtilities::AddMissingChunks(
+	const FVoxelUncompressedWorldSaveImpl& Save,
+	FVoxelUncompressedWorldSaveImpl& OutSave)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	ensure(Save.Depth == OutSave.Depth);
+
+	TSet<FIntVector> Positions;
+	Positions.Reserve(OutSave.Chunks.Num());
+	for (const auto& Chunk : OutSave.Chunks)
+	{
+		Positions.Add(Chunk.Position);
+	}
+
+	TArray<int32> ChunkIndices;
+	for (int32 ChunkIndex = 0; ChunkIndex < Save.Chunks.Num(); ChunkIndex++)
+	{
+		if (!Positions.Contains(Save.Chunks[ChunkIndex].Position))
+		{
+			ChunkIndices.Add(ChunkIndex);
+		}
+	}
+
+	AppendChunks(Save, ChunkIndices, OutSave);
+	SortChunks(OutSave);
+
+	OutSave.UpdateAllocatedSize();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelSaveRegionUtilities::Init(
+	const FVoxelUncompressedWorldSaveImpl& Save,
+	FVoxelUncompressedWorldSaveImpl& OutSave)
+{
+	OutSave.Version = Save.Version;
+	OutSave.Guid = Save.Guid;
+	OutSave.Depth = Save.Depth;
+	OutSave.UserFlags = Save.UserFlags;
+
+	OutSave.ValueBuffers.Reset();
+	OutSave.SingleValues.Reset();
+	OutSave.MaterialsIndices.Reset();
+	OutSave.MaterialBuffers.Reset();
+	OutSave.SingleMaterials.Reset();
+	OutSave.Chunks.Reset();
+	OutSave.PlaceableItems.Reset();
+}
+
+void FVoxelSaveRegionUtilities::SortChunks(FVoxelUncompressedWorldSaveImpl& Save)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	
+	// FVoxelData::LoadFromSave expects the chunks in the order the octree leaves are iterated
+	// The chunk indices into the buffers stay valid when sorting
+	const int32 Depth = Save.Depth;
+	const int32 HalfSize = (DATA_CHUNK_SIZE << Depth) / 2;
+	const auto GetLeafCoordinates = [&](const FIntVector& Position)
+	{
+		return (Position - DATA_CHUNK_SIZE / 2 + HalfSize) / DATA_CHUNK_SIZE;
+	};
+	
+	Save.Chunks.Sort([&](const FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave& A, const FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave& B)
+	{
+		const FIntVector CoordinatesA = GetLeafCoordinates(A.Position);
+		const FIntVector CoordinatesB = GetLeafCoordinates(B.Position);
+
+		for (int32 Bit = Depth - 1; Bit >= 0; Bit--)
+		{
+			const auto GetChildIndex = [&](const FIntVector& Coordinates)
+			{
+				return
+					((Coordinates.X >> Bit) & 0x1) |
+					(((Coordinates.Y >> Bit) & 0x1) << 1) |
+					(((Coordinates.Z >> Bit) & 0x1) << 2);
+			};
+
+			const int32 ChildIndexA = GetChildIndex(CoordinatesA);
+			const int32 ChildIndexB = GetChildIndex(CoordinatesB);
+			if (ChildIndexA != ChildIndexB)
+			{
+				return ChildIndexA < ChildIndexB;
+			}
+		}
+		return false;
+	});
+}
+
+void FVoxelSaveRegionUtilities::AppendChunks(
+	const FVoxelUncompressedWorldSaveImpl& Save,
+	TConstArrayView<int32> ChunkIndices,
+	FVoxelUncompressedWorldSaveImpl& OutSave)
+{
+	constexpr uint32 SingleValueFlag = FVoxelUncompressedWorldSaveImpl::MaterialIndexSingleValueFlag;
+	
+	for (const int32 ChunkIndex : ChunkIndices)
+	{
+		const FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave& Chunk = Save.Chunks[ChunkIndex];
+		
+		FVoxelUncompressedWorldSaveImpl::FVoxelChunkSave NewChunk;
+		NewChunk.Position = Chunk.Position;
+		NewChunk.bSingleValue = Chunk.bSingleValue;
+
+		if (Chunk.ValuesIndex >= 0)
+		{
+			if (Chunk.bSingleValue)
+			{
+				NewChunk.ValuesIndex = OutSave.SingleValues.Add(Save.SingleValues[Chunk.ValuesIndex]);
+			}
+			else
+			{
+				check(Save.ValueBuffers.Num() >= Chunk.ValuesIndex + VOXELS_PER_DATA_CHUNK);
+				NewChunk.ValuesIndex = OutSave.ValueBuffers.Num();
+				OutSave.ValueBuffers.Append(&Save.ValueBuffers[Chunk.ValuesIndex], VOXELS_PER_DATA_CHUNK);
+			}
+		}
+
+		if (Chunk.MaterialsIndex >= 0)
+		{
+			const TVoxelMaterialStorage<uint32>& MaterialIndices = Save.MaterialsIndices[Chunk.MaterialsIndex];
+			
+			TVoxelMaterialStorage<uint32> NewMaterialIndices;
+			for (int32 Channel = 0; Channel < FVoxelMaterial::NumChannels; Channel++)
+			{
+				const uint32 ChannelIndex = MaterialIndices.GetRaw(Channel);
+				if (ChannelIndex & SingleValueFlag)
+				{
+					NewMaterialIndices.GetRaw(Channel) = OutSave.SingleMaterials.Add(Save.SingleMaterials[ChannelIndex & ~SingleValueFlag]) | SingleValueFlag;
+				}
+				else
+				{
+					check(uint32(Save.MaterialBuffers.Num()) >= ChannelIndex + VOXELS_PER_DATA_CHUNK);
+					NewMaterialIndices.GetRaw(Channel) = OutSave.MaterialBuffers.Num();
+					OutSave.MaterialBuffers.Append(&Save.MaterialBuffers[ChannelIndex], VOXELS_PER_DATA_CHUNK);
+				}
+			}
+			NewChunk.MaterialsIndex = OutSave.MaterialsIndices.Add(NewMaterialIndices);
+		}
+
+		OutSave.Chunks.Add(NewChunk);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 void UVoxelSaveUtilities::CompressVoxelSave(const FVoxelUncompressedWorldSave& UncompressedSave, FVoxelCompressedWorldSave& OutCompressedSave)
 {
 	OutCompressedSave.Objects = UncompressedSave.Objects;
@@ -290,13 +629,28 @@ void UVoxelSaveUtilities::CompressVoxelSave(const FVoxelUncompressedWorldSaveImp
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 	
+	const int32 RegionSize = CVarSaveRegionSize.GetValueOnAnyThread();
+	if (RegionSize > 0)
+	{
+		CompressVoxelSaveByRegions(UncompressedSave, OutCompressedSave, RegionSize);
+		return;
+	}
+	
 	OutCompressedSave.Depth = UncompressedSave.GetDepth();
 	OutCompressedSave.Guid = UncompressedSave.GetGuid();
+	OutCompressedSave.RegionSize = 0;
+	OutCompressedSave.ItemsRegion = {};
+	OutCompressedSave.Regions.Reset();
+
+	// The filter is applied to the buffers by the save serialization
+	FVoxelCompressionOptions Options;
+	Options.Codec = GetDefault<UVoxelSettings>()->SaveCompressionCodec;
 
-	FLargeMemoryWriter MemoryWriter(UncompressedSave.GetAllocatedSize());
-	const_cast<FVoxelUncompressedWorldSaveImpl&>(UncompressedSave).Serialize(MemoryWriter);
+	// Compress while serializing, without copying the whole save into a memory writer first
+	FVoxelCompressedWriter Writer(Options);
+	const_cast<FVoxelUncompressedWorldSaveImpl&>(UncompressedSave).Serialize(Writer);
 	
-	FVoxelSerializationUtilities::CompressData(MemoryWriter, OutCompressedSave.CompressedData);
+	ensure(Writer.Finish(OutCompressedSave.CompressedData));
 	
 	OutCompressedSave.UpdateAllocatedSize();
 }
@@ -315,6 +669,15 @@ bool UVoxelSaveUtilities::DecompressVoxelSave(const FVoxelCompressedWorldSaveImp
 	{
 		return false;
 	}
+	else if (CompressedSave.IsRegionIndexed())
+	{
+		TArray<int32> RegionIndices;
+		for (int32 RegionIndex = 0; RegionIndex < CompressedSave.Regions.Num(); RegionIndex++)
+		{
+			RegionIndices.Add(RegionIndex);
+		}
+		return DecompressVoxelSaveRegions(CompressedSave, RegionIndices, OutUncompressedSave);
+	}
 	else
 	{
 		TArray64<uint8> UncompressedData;
@@ -330,4 +693,210 @@ bool UVoxelSaveUtilities::DecompressVoxelSave(const FVoxelCompressedWorldSaveImp
 
 		return true;
 	}
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void UVoxelSaveUtilities::CompressVoxelSaveByRegions(const FVoxelUncompressedWorldSaveImpl& UncompressedSave, FVoxelCompressedWorldSaveImpl& OutCompressedSave, int32 RegionSize)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	RegionSize = FMath::Max(1, FVoxelUtilities::DivideCeil(RegionSize, DATA_CHUNK_SIZE)) * DATA_CHUNK_SIZE;
+	
+	OutCompressedSave.Depth = UncompressedSave.GetDepth();
+	OutCompressedSave.Guid = UncompressedSave.GetGuid();
+	OutCompressedSave.RegionSize = RegionSize;
+
+	TArray<FVoxelIntBox> RegionsBounds;
+	TArray<TArray<int32>> RegionsChunks;
+	FVoxelSaveRegionUtilities::GroupChunksByRegion(UncompressedSave, RegionSize, RegionsBounds, RegionsChunks);
+
+	// The filter is applied to the buffers by the save serialization
+	FVoxelCompressionOptions Options;
+	Options.Codec = GetDefault<UVoxelSettings>()->SaveCompressionCodec;
+	// Would log once per region
+	Options.bLog = false;
+	
+	// Index 0 is the items region
+	TArray<TArray<uint8>> CompressedRegions;
+	CompressedRegions.SetNum(RegionsChunks.Num() + 1);
+	
+	ParallelFor(CompressedRegions.Num(), [&](int32 Index)
+	{
+		FVoxelUncompressedWorldSaveImpl RegionSave;
+		if (Index == 0)
+		{
+			FVoxelSaveRegionUtilities::CopyChunks(UncompressedSave, {}, true, RegionSave);
+		}
+		else
+		{
+			FVoxelSaveRegionUtilities::CopyChunks(UncompressedSave, RegionsChunks[Index - 1], false, RegionSave);
+		}
+		
+		// Already running in parallel with the other regions: compress the chunks inline instead of waiting on the task graph from a worker
+		FVoxelCompressedWriter Writer(Options, false);
+		RegionSave.Serialize(Writer);
+		ensure(Writer.Finish(CompressedRegions[Index]));
+	});
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Concatenate");
+		
+		int64 TotalSize = 0;
+		for (const TArray<uint8>& CompressedRegion : CompressedRegions)
+		{
+			TotalSize += CompressedRegion.Num();
+		}
+		check(TotalSize <= MAX_int32);
+
+		OutCompressedSave.CompressedData.Reset(TotalSize);
+		OutCompressedSave.Regions.Reset(RegionsBounds.Num());
+		
+		for (int32 Index = 0; Index < CompressedRegions.Num(); Index++)
+		{
+			FVoxelSaveRegion Region;
+			Region.Offset = OutCompressedSave.CompressedData.Num();
+			Region.Size = CompressedRegions[Index].Num();
+			OutCompressedSave.CompressedData.Append(CompressedRegions[Index]);
+
+			if (Index == 0)
+			{
+				OutCompressedSave.ItemsRegion = Region;
+			}
+			else
+			{
+				Region.Bounds = RegionsBounds[Index - 1];
+				Region.NumChunks = RegionsChunks[Index - 1].Num();
+				OutCompressedSave.Regions.Add(Region);
+			}
+		}
+	}
+
+	LOG_VOXEL(Log, TEXT("Compressed save in %d regions of %d voxels: %f MB"), CompressedRegions.Num() - 1, RegionSize, OutCompressedSave.CompressedData.Num() / double(1 << 20));
+
+	OutCompressedSave.UpdateAllocatedSize();
+}
+
+bool UVoxelSaveUtilities::DecompressVoxelSaveRegions(const FVoxelCompressedWorldSaveImpl& CompressedSave, TConstArrayView<int32> RegionIndices, FVoxelUncompressedWorldSaveImpl& OutUncompressedSave, bool bDecompressPlaceableItems)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	if (!ensure(CompressedSave.IsRegionIndexed()))
+	{
+		return false;
+	}
+
+	TArray<FVoxelSaveRegion> RegionsToDecompress;
+	if (bDecompressPlaceableItems)
+	{
+		RegionsToDecompress.Add(CompressedSave.ItemsRegion);
+	}
+	for (const int32 RegionIndex : RegionIndices)
+	{
+		if (!ensure(CompressedSave.Regions.IsValidIndex(RegionIndex)))
+		{
+			return false;
+		}
+		RegionsToDecompress.Add(CompressedSave.Regions[RegionIndex]);
+	}
+	if (!ensure(RegionsToDecompress.Num() > 0))
+	{
+		return false;
+	}
+
+	TArray<FVoxelUncompressedWorldSaveImpl> RegionSaves;
+	RegionSaves.SetNum(RegionsToDecompress.Num());
+	FThreadSafeBool bSuccess = true;
+	
+	ParallelFor(RegionsToDecompress.Num(), [&](int32 Index)
+	{
+		const FVoxelSaveRegion& Region = RegionsToDecompress[Index];
+		if (Region.Offset < 0 || Region.Size <= 0 || Region.Offset + int64(Region.Size) > CompressedSave.CompressedData.Num())
+		{
+			bSuccess = false;
+			return;
+		}
+
+		const TArray<uint8> CompressedData(CompressedSave.CompressedData.GetData() + Region.Offset, Region.Size);
+		TArray64<uint8> UncompressedData;
+		if (!FVoxelSerializationUtilities::DecompressData(CompressedData, UncompressedData, false))
+		{
+			bSuccess = false;
+			return;
+		}
+
+		FLargeMemoryReader Reader(UncompressedData.GetData(), UncompressedData.Num());
+		RegionSaves[Index].Serialize(Reader);
+		if (!Reader.AtEnd() || Reader.IsError())
+		{
+			bSuccess = false;
+		}
+	});
+
+	if (!bSuccess)
+	{
+		if (IsInGameThread())
+		{
+			FVoxelMessages::Error("DecompressVoxelSaveRegions failed: Corrupted data");
+		}
+		else
+		{
+			// Regions are also decompressed by the async saves & by the pending regions loading
+			LOG_VOXEL(Error, TEXT("DecompressVoxelSaveRegions failed: Corrupted data"));
+		}
+		return false;
+	}
+
+	TArray<const FVoxelUncompressedWorldSaveImpl*> RegionSavesPtrs;
+	for (const FVoxelUncompressedWorldSaveImpl& RegionSave : RegionSaves)
+	{
+		RegionSavesPtrs.Add(&RegionSave);
+	}
+	FVoxelSaveRegionUtilities::Merge(RegionSavesPtrs, OutUncompressedSave);
+
+	return true;
+}
+
+void UVoxelSaveUtilities::GetSaveRegionsInBounds(const FVoxelCompressedWorldSaveImpl& CompressedSave, const FVoxelIntBox& Bounds, TArray<int32>& OutRegionIndices)
+{
+	for (int32 RegionIndex = 0; RegionIndex < CompressedSave.Regions.Num(); RegionIndex++)
+	{
+		if (CompressedSave.Regions[RegionIndex].Bounds.Intersect(Bounds))
+		{
+			OutRegionIndices.Add(RegionIndex);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+static void BenchmarkVoxelSaveCompression(UWorld* World)
+{
+	for (TActorIterator<AVoxelWorld> It(World); It; ++It)
+	{
+		AVoxelWorld* VoxelWorld = *It;
+		if (!VoxelWorld->IsCreated())
+		{
+			continue;
+		}
+
+		FVoxelUncompressedWorldSaveImpl Save;
+		TArray<FVoxelObjectArchiveEntry> Objects;
+		VoxelWorld->GetData().GetSave(Save, Objects);
+
+		FLargeMemoryWriter Writer;
+		Save.Serialize(Writer);
+
+		LOG_VOXEL(Log, TEXT("Benchmarking the compression of the save of %s"), *VoxelWorld->GetName());
+		FVoxelSerializationUtilities::BenchmarkCompression(Writer.GetData(), Writer.Tell());
+	}
+}
+
+static FAutoConsoleCommandWithWorld BenchmarkVoxelSaveCompressionCmd(
+	TEXT("voxel.data.BenchmarkCompression"),
+	TEXT("Save all the voxel worlds, and log the compression & decompression speed and ratio of every codec and filter on their saves"),
+	FConsoleCommandWithWorldDelegate::CreateStatic(&BenchmarkVoxelSaveCompression));
@@ -138,6 +138,28 @@ static FAutoConsoleCommandWithWorldAndArgs ClearChunksEmptyStatesCmd(
 	TEXT("Clear the empty states debug"),
 	CreateCommandWithVoxelWorldDelegateNoArgs([](AVoxelWorld& World) { World.GetDebugManager().ClearChunksEmptyStates(); }));
 
+static FAutoConsoleCommandWithWorldAndArgs LogSlabStatsCmd(
+	TEXT("voxel.data.LogSlabStats"),
+	TEXT("Log the memory used by the data slab allocator of every voxel world"),
+	CreateCommandWithVoxelWorldDelegateNoArgs([](AVoxelWorld& World)
+	{
+		const FVoxelDataSlabAllocator* SlabAllocator = World.GetData().GetSlabAllocator();
+		if (!SlabAllocator)
+		{
+			LOG_VOXEL(Log, TEXT("%s: slab allocator disabled"), *World.GetName());
+			return;
+		}
+
+		const FVoxelDataSlabAllocator::FStats Stats = SlabAllocator->GetStats();
+		LOG_VOXEL(Log, TEXT("%s: %d slabs, %lld blocks, %fMB allocated, %fMB used (%.1f%%)"),
+			*World.GetName(),
+			Stats.NumSlabs,
+			Stats.NumBlocks,
+			Stats.AllocatedMemory / double(1 << 20),
+			Stats.UsedMemory / double(1 << 20),
+			Stats.AllocatedMemory > 0 ? 100. * Stats.UsedMemory / Stats.AllocatedMemory : 0.);
+	}));
+
 static FAutoConsoleCommandWithWorldAndArgs UpdateAllCmd(
 	TEXT("voxel.renderer.UpdateAll"),
 	TEXT("Update all the chunks in all the voxel world in the scene"),
@@ -10,13 +10,16 @@ FVoxelDefaultPool::FVoxelDefaultPool(
 	int32 ThreadCount,
 	bool bConstantPriorities,
 	const TMap<EVoxelTaskType, int32>& InPriorityCategories,
-	const TMap<EVoxelTaskType, int32>& InPriorityOffsets)
+	const TMap<EVoxelTaskType, int32>& InPriorityOffsets,
+	int32 NumEditThreads)
 	: Pool(FVoxelQueuedThreadPool::Create(FVoxelQueuedThreadPoolSettings(
 		FString::Printf(TEXT("Voxel Pool %llu"), UNIQUE_ID()),
 		ThreadCount,
 		1024 * 1024,
 		EThreadPriority::TPri_Normal,
-		bConstantPriorities)))
+		bConstantPriorities,
+		NumEditThreads,
+		InPriorityCategories.FindChecked(EVoxelTaskType::EditChunksMeshing))))
 {
 	for (int32 Index = 0; Index < 256; Index++)
 	{
@@ -33,13 +36,15 @@ TVoxelSharedRef<FVoxelDefaultPool> FVoxelDefaultPool::Create(
 	int32 ThreadCount,
 	bool bConstantPriorities,
 	const TMap<EVoxelTaskType, int32>& PriorityCategories,
-	const TMap<EVoxelTaskType, int32>& PriorityOffsets)
+	const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+	int32 NumEditThreads)
 {
-	LOG_VOXEL(Log, TEXT("Creating pool with %d threads"), ThreadCount);
+	LOG_VOXEL(Log, TEXT("Creating pool with %d threads and %d edit threads"), ThreadCount, NumEditThreads);
 	if (!ensureMsgf(ThreadCount >= 1, TEXT("Invalid MeshThreadCount: %d"), ThreadCount))
 	{
 		ThreadCount = 1;
 	}
+	NumEditThreads = FMath::Max(0, NumEditThreads);
 	
 	auto FixedPriorityCategories = PriorityCategories;
 	auto FixedPriorityOffsets = PriorityOffsets;
@@ -50,7 +55,8 @@ TVoxelSharedRef<FVoxelDefaultPool> FVoxelDefaultPool::Create(
 		ThreadCount,
 		bConstantPriorities,
 		FixedPriorityCategories,
-		FixedPriorityOffsets));
+		FixedPriorityOffsets,
+		NumEditThreads));
 }
 
 void FVoxelDefaultPool::QueueTask(EVoxelTaskType Type, IVoxelQueuedWork* Task)
@@ -68,6 +74,11 @@ int32 FVoxelDefaultPool::GetNumTasks() const
 	return Pool->GetNumPendingWorks();
 }
 
+void FVoxelDefaultPool::InvalidatePriorities()
+{
+	Pool->InvalidatePriorities();
+}
+
 void FVoxelDefaultPool::FixPriorityCategories(TMap<EVoxelTaskType, int32>& PriorityCategories)
 {
 	for (auto& It : PriorityCategories)
@@ -85,6 +96,8 @@ void FVoxelDefaultPool::FixPriorityCategories(TMap<EVoxelTaskType, int32>& Prior
 	FIX(AsyncEditFunctions);
 	FIX(MeshMerge);
 	FIX(RenderOctree);
+	FIX(EditChunksMeshing);
+	FIX(DataPrefetch);
 #undef FIX
 }
 
@@ -101,5 +114,7 @@ void FVoxelDefaultPool::FixPriorityOffsets(TMap<EVoxelTaskType, int32>& Priority
 	FIX(AsyncEditFunctions);
 	FIX(RenderOctree);
 	FIX(MeshMerge);
+	FIX(EditChunksMeshing);
+	FIX(DataPrefetch);
 #undef FIX
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "VoxelData/VoxelData.h"
 #include "VoxelMessages.h"
 #include "VoxelPriorityHandler.h"
+#include "IVoxelPool.h"
 #include "VoxelWorld.h"
 #include "VoxelUniqueError.h"
 #include "VoxelUtilities/VoxelMaterialUtilities.h"
@@ -45,6 +46,7 @@ FVoxelRendererSettingsBase::FVoxelRendererSettingsBase(
 
 	, RenderType(InWorld->RenderType)
 	, RenderSharpness(FMath::Max(0, InWorld->RenderSharpness))
+	, bGreedyCubicMeshing(InWorld->bGreedyCubicMeshing)
 	, bCreateMaterialInstances(InPlayType == EVoxelPlayType::Game
 		? InWorld->bCreateMaterialInstances && !InWorld->bMergeChunks
 		: false /* we don't want to created dynamic material instances in editor */)
@@ -52,6 +54,14 @@ FVoxelRendererSettingsBase::FVoxelRendererSettingsBase(
 	, ChunksDitheringDuration(InWorld->ChunksDitheringDuration)
 
 	, bOptimizeIndices(InWorld->bOptimizeIndices)
+	, bPackVertices(InWorld->bPackVertices)
+
+	, bSimplifyMeshes(InWorld->bSimplifyMeshes)
+	, SimplificationMinLOD(InWorld->SimplificationMinLOD)
+	, SimplificationMaxError(FMath::Max(0.f, InWorld->SimplificationMaxError))
+	, SimplificationMaxErrorPerLOD(InWorld->SimplificationMaxErrorPerLOD)
+
+	, IncrementalRemeshMaxLOD(InWorld->bIncrementalRemesh && InWorld->RenderType == EVoxelRenderType::MarchingCubes ? InWorld->IncrementalRemeshMaxLOD : -1)
 
 	, MaxDistanceFieldLOD(InWorld->bGenerateDistanceFields ? InWorld->MaxDistanceFieldLOD : -1)
 	, DistanceFieldBoundsExtension(InWorld->DistanceFieldBoundsExtension)
@@ -118,7 +128,10 @@ void IVoxelRenderer::SetInvokersPositionsForPriorities(const TArray<FIntVector>&
 	{
 		InvokersPositionsForPriorities = MakeVoxelShared<FInvokerPositionsArray>(2 * InvokersPositionsForPriorities->GetMax());
 	}
-	InvokersPositionsForPriorities->Set(NewInvokersPositionsForPriorities);
+	if (InvokersPositionsForPriorities->Set(NewInvokersPositionsForPriorities))
+	{
+		Settings.Pool->InvalidatePriorities();
+	}
 }
 
 inline UObject* GetRootOwner(const TWeakObjectPtr<UPrimitiveComponent>& RootComponent)
@@ -126,6 +139,19 @@ inline UObject* GetRootOwner(const TWeakObjectPtr<UPrimitiveComponent>& RootComp
 	return RootComponent.IsValid() ? RootComponent->GetOwner() : nullptr;
 }
 
+float FVoxelRendererSettingsBase::GetSimplificationMaxError(int32 LOD) const
+{
+	if (!bSimplifyMeshes)
+	{
+		return 0.f;
+	}
+	if (const float* MaxError = SimplificationMaxErrorPerLOD.Find(LOD))
+	{
+		return FMath::Max(0.f, *MaxError);
+	}
+	return LOD >= SimplificationMinLOD ? SimplificationMaxError : 0.f;
+}
+
 UMaterialInterface* FVoxelRendererSettingsBase::GetVoxelMaterial(int32 LOD, const FVoxelMaterialIndices& MaterialIndices) const
 {
 	auto* MaterialCollection = DynamicSettings->LODData[LOD].MaterialCollection.Get();
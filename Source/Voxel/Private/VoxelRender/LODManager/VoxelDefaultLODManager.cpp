@@ -2,6 +2,7 @@
 
 #include "VoxelRender/LODManager/VoxelDefaultLODManager.h"
 #include "VoxelRender/LODManager/VoxelRenderOctree.h"
+#include "VoxelRender/LODManager/VoxelLODPrefetcher.h"
 #include "VoxelRender/IVoxelRenderer.h"
 #include "VoxelIntBox.h"
 #include "IVoxelPool.h"
@@ -16,16 +17,24 @@ static TAutoConsoleVariable<int32> CVarFreezeLODs(
 	TEXT("Stops LOD manager tick"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarParallelRenderOctree(
+	TEXT("voxel.lod.ParallelRenderOctree"),
+	1,
+	TEXT("If true, the render octree updates will process the subtrees of the top nodes in parallel"),
+	ECVF_Default);
+
 TVoxelSharedRef<FVoxelDefaultLODManager> FVoxelDefaultLODManager::Create(
 	const FVoxelLODSettings& LODSettings,
 	TWeakObjectPtr<const AVoxelWorldInterface> VoxelWorldInterface,
-	const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings)
+	const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings,
+	const TVoxelSharedPtr<FVoxelData>& Data)
 {
 	TVoxelSharedRef<FVoxelDefaultLODManager> Result = MakeShareable(
 		new FVoxelDefaultLODManager(
 			LODSettings,
 			VoxelWorldInterface,
-			DynamicSettings));
+			DynamicSettings,
+			Data));
 
 	UVoxelInvokerComponentBase::OnForceRefreshInvokers.AddThreadSafeSP(Result, &FVoxelDefaultLODManager::ClearInvokerComponents);
 	return Result;
@@ -34,13 +43,18 @@ TVoxelSharedRef<FVoxelDefaultLODManager> FVoxelDefaultLODManager::Create(
 FVoxelDefaultLODManager::FVoxelDefaultLODManager(
 	const FVoxelLODSettings& LODSettings,
 	TWeakObjectPtr<const AVoxelWorldInterface> VoxelWorldInterface,
-	const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings)
+	const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings,
+	const TVoxelSharedPtr<FVoxelData>& Data)
 	: IVoxelLODManager(LODSettings) 
 	, VoxelWorldInterface(VoxelWorldInterface)
 	, DynamicSettings(DynamicSettings)
 	, Task(TUniquePtr<FVoxelRenderOctreeAsyncBuilder, TVoxelAsyncWorkDelete<FVoxelRenderOctreeAsyncBuilder>>(
 		new FVoxelRenderOctreeAsyncBuilder(LODSettings.OctreeDepth, LODSettings.WorldBounds)))
 {
+	if (Data.IsValid())
+	{
+		Prefetcher = MakeUnique<FVoxelLODPrefetcher>(Data.ToSharedRef(), LODSettings.Pool);
+	}
 }
 
 FVoxelDefaultLODManager::~FVoxelDefaultLODManager()
@@ -261,6 +275,9 @@ void FVoxelDefaultLODManager::UpdateInvokers()
 		}
 	}
 
+	// Before updating the priorities, as it computes the predicted positions
+	UpdatePrefetcher(NewInvokerComponentsInfos);
+
 	if (bNeedUpdate)
 	{
 		if (!Settings.bConstantLOD)
@@ -279,6 +296,11 @@ void FVoxelDefaultLODManager::UpdateInvokers()
 				InvokersPositionsForPriorities.Add(It.Value.LocalPosition);
 			}
 		}
+		if (Prefetcher.IsValid())
+		{
+			// Mesh the chunks where the invokers are going first
+			InvokersPositionsForPriorities.Append(Prefetcher->GetPredictedPositions());
+		}
 		Settings.Renderer->SetInvokersPositionsForPriorities(InvokersPositionsForPriorities);
 	}
 
@@ -293,6 +315,40 @@ void FVoxelDefaultLODManager::UpdateInvokers()
 	}
 }
 
+void FVoxelDefaultLODManager::UpdatePrefetcher(const TMap<TWeakObjectPtr<UVoxelInvokerComponentBase>, FVoxelInvokerInfo>& NewInvokerComponentsInfos)
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	if (!Prefetcher.IsValid())
+	{
+		return;
+	}
+
+	if (!DynamicSettings->bEnablePrefetch || Settings.bConstantLOD || Settings.bStaticWorld)
+	{
+		Prefetcher->Reset();
+		return;
+	}
+
+	TArray<FVoxelLODPrefetcher::FInvoker> Invokers;
+	Invokers.Reserve(NewInvokerComponentsInfos.Num());
+	for (auto& It : NewInvokerComponentsInfos)
+	{
+		FVoxelLODPrefetcher::FInvoker& Invoker = Invokers.Emplace_GetRef();
+		Invoker.Component = It.Key;
+		Invoker.Position = It.Value.LocalPosition;
+		Invoker.bUseForLOD = It.Value.Settings.bUseForLOD;
+		Invoker.LODBounds = It.Value.Settings.LODBounds;
+	}
+
+	FVoxelLODPrefetchSettings PrefetchSettings;
+	PrefetchSettings.Horizon = DynamicSettings->PrefetchHorizon;
+	PrefetchSettings.MinSpeed = DynamicSettings->PrefetchMinSpeed / Settings.VoxelSize;
+	PrefetchSettings.Radius = FMath::CeilToInt(DynamicSettings->PrefetchRadius / Settings.VoxelSize);
+
+	Prefetcher->Update(FPlatformTime::Seconds(), PrefetchSettings, Invokers);
+}
+
 void FVoxelDefaultLODManager::UpdateLODs()
 {
 	VOXEL_FUNCTION_COUNTER();
@@ -329,6 +385,8 @@ void FVoxelDefaultLODManager::UpdateLODs()
 	OctreeSettings.bComputeVisibleChunksNavmesh = DynamicSettings->bComputeVisibleChunksNavmesh;
 	OctreeSettings.VisibleChunksNavmeshMaxLOD = DynamicSettings->VisibleChunksNavmeshMaxLOD;
 
+	OctreeSettings.bParallelBuild = CVarParallelRenderOctree.GetValueOnGameThread() != 0;
+
 	Task->Init(OctreeSettings, Octree);
 	Settings.Pool->QueueTask(EVoxelTaskType::RenderOctree, Task.Get());
 	bAsyncTaskWorking = true;
@@ -11,6 +11,8 @@
 
 class FVoxelRenderOctreeAsyncBuilder;
 class FVoxelRenderOctree;
+class FVoxelLODPrefetcher;
+class FVoxelData;
 class UVoxelInvokerComponentBase;
 class AVoxelWorldInterface;
 
@@ -33,6 +35,14 @@ struct FVoxelLODDynamicSettings
 	bool bEnableNavmesh;
 	bool bComputeVisibleChunksNavmesh;
 	int32 VisibleChunksNavmeshMaxLOD;
+
+	bool bEnablePrefetch = false;
+	// In seconds
+	float PrefetchHorizon = 0;
+	// In world space per second
+	float PrefetchMinSpeed = 0;
+	// In world space
+	float PrefetchRadius = 0;
 };
 
 class FVoxelDefaultLODManager : public IVoxelLODManager, public FVoxelTickable, public TVoxelSharedFromThis<FVoxelDefaultLODManager>
@@ -41,7 +51,9 @@ public:
 	static TVoxelSharedRef<FVoxelDefaultLODManager> Create(
 		const FVoxelLODSettings& LODSettings,
 		TWeakObjectPtr<const AVoxelWorldInterface> VoxelWorldInterface,
-		const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings);
+		const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings,
+		// Needed for the LOD prefetch
+		const TVoxelSharedPtr<FVoxelData>& Data = nullptr);
 	~FVoxelDefaultLODManager();
 
 	//~ Begin IVoxelLODManager Interface
@@ -63,7 +75,8 @@ private:
 	FVoxelDefaultLODManager(
 		const FVoxelLODSettings& LODSettings,
 		TWeakObjectPtr<const AVoxelWorldInterface> VoxelWorldInterface,
-		const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings);
+		const TVoxelSharedRef<FVoxelLODDynamicSettings>& DynamicSettings,
+		const TVoxelSharedPtr<FVoxelData>& Data);
 
 	const TWeakObjectPtr<const AVoxelWorldInterface> VoxelWorldInterface;
 	const TVoxelSharedRef<FVoxelLODDynamicSettings> DynamicSettings;
@@ -72,6 +85,9 @@ private:
 	
 	TVoxelSharedPtr<FVoxelRenderOctree> Octree;
 
+	// Null if no data was given
+	TUniquePtr<FVoxelLODPrefetcher> Prefetcher;
+
 	struct FVoxelInvokerInfo
 	{
 		FIntVector LocalPosition{ForceInit};
@@ -86,6 +102,7 @@ private:
 	double LastInvokersUpdateTime = 0;
 
 	void UpdateInvokers();
+	void UpdatePrefetcher(const TMap<TWeakObjectPtr<UVoxelInvokerComponentBase>, FVoxelInvokerInfo>& NewInvokerComponentsInfos);
 	void UpdateLODs();
 
 	void ClearInvokerComponents();
@@ -0,0 +1,119 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelRender/LODManager/VoxelInvokerBoundsTree.h"
+
+FVoxelInvokerBoundsTree::FVoxelInvokerBoundsTree(TArray<FElement>&& InElements)
+	: Elements(MoveTemp(InElements))
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	if (Elements.Num() == 0)
+	{
+		return;
+	}
+
+	Nodes.Reserve(2 * FMath::DivideAndRoundUp(Elements.Num(), MaxElementsPerLeaf));
+	Build(0, Elements.Num());
+}
+
+bool FVoxelInvokerBoundsTree::Intersect(const FVoxelIntBox& Bounds, int32 LOD) const
+{
+	if (Nodes.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<int32, TInlineAllocator<64>> Stack;
+	Stack.Add(0);
+
+	while (Stack.Num() > 0)
+	{
+		const FNode& Node = Nodes[Stack.Pop(UE_505_SWITCH(false, EAllowShrinking::No))];
+		if (Node.MinLOD >= LOD || !Node.Bounds.Intersect(Bounds))
+		{
+			continue;
+		}
+
+		if (Node.NumElements > 0)
+		{
+			for (int32 Index = Node.First; Index < Node.First + Node.NumElements; Index++)
+			{
+				const FElement& Element = Elements[Index];
+				if (Element.LOD < LOD && Element.Bounds.Intersect(Bounds))
+				{
+					return true;
+				}
+			}
+		}
+		else
+		{
+			Stack.Add(Node.First);
+			Stack.Add(Node.Second);
+		}
+	}
+
+	return false;
+}
+
+int32 FVoxelInvokerBoundsTree::Build(int32 First, int32 Num)
+{
+	check(Num > 0);
+
+	FNode Node;
+	Node.Bounds = Elements[First].Bounds;
+	Node.MinLOD = Elements[First].LOD;
+	for (int32 Index = First + 1; Index < First + Num; Index++)
+	{
+		Node.Bounds = Node.Bounds + Elements[Index].Bounds;
+		Node.MinLOD = FMath::Min(Node.MinLOD, Elements[Index].LOD);
+	}
+
+	const int32 NodeIndex = Nodes.Add(Node);
+
+	if (Num <= MaxElementsPerLeaf)
+	{
+		Nodes[NodeIndex].First = First;
+		Nodes[NodeIndex].NumElements = Num;
+		return NodeIndex;
+	}
+
+	// Split at the median along the axis along which the elements are the most spread
+	// Centers are doubled to stay in integers, in int64 as the sums might overflow
+	const auto GetCenter = [](const FElement& Element, int32 Axis)
+	{
+		return int64(Element.Bounds.Min[Axis]) + int64(Element.Bounds.Max[Axis]);
+	};
+
+	int32 SplitAxis = 0;
+	int64 MaxSpread = -1;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		int64 Min = MAX_int64;
+		int64 Max = MIN_int64;
+		for (int32 Index = First; Index < First + Num; Index++)
+		{
+			const int64 Center = GetCenter(Elements[Index], Axis);
+			Min = FMath::Min(Min, Center);
+			Max = FMath::Max(Max, Center);
+		}
+		if (Max - Min > MaxSpread)
+		{
+			MaxSpread = Max - Min;
+			SplitAxis = Axis;
+		}
+	}
+
+	Sort(Elements.GetData() + First, Num, [&](const FElement& A, const FElement& B)
+	{
+		return GetCenter(A, SplitAxis) < GetCenter(B, SplitAxis);
+	});
+
+	const int32 NumFirst = Num / 2;
+	const int32 FirstChild = Build(First, NumFirst);
+	const int32 SecondChild = Build(First + NumFirst, Num - NumFirst);
+
+	// Nodes might have been reallocated
+	Nodes[NodeIndex].First = FirstChild;
+	Nodes[NodeIndex].Second = SecondChild;
+	return NodeIndex;
+}
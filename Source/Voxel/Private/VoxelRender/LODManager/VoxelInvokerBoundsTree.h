@@ -0,0 +1,52 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelIntBox.h"
+#include "VoxelMinimal.h"
+
+/**
+ * Bounding volume hierarchy over the bounds of a set of invokers
+ * Used by the render octree to find if a node is in range of any invoker without iterating all of them:
+ * queries are logarithmic in the number of invokers, instead of linear
+ *
+ * Built once per render octree update, immutable afterwards: safe to query from several threads
+ */
+class FVoxelInvokerBoundsTree
+{
+public:
+	struct FElement
+	{
+		FVoxelIntBox Bounds;
+		// Only nodes with a LOD strictly higher than this are in range of this element
+		int32 LOD = -1;
+	};
+
+	FVoxelInvokerBoundsTree() = default;
+	explicit FVoxelInvokerBoundsTree(TArray<FElement>&& InElements);
+
+	int32 Num() const { return Elements.Num(); }
+
+	// Whether any element intersects Bounds and has a LOD strictly lower than LOD
+	bool Intersect(const FVoxelIntBox& Bounds, int32 LOD = MAX_int32) const;
+
+private:
+	static constexpr int32 MaxElementsPerLeaf = 4;
+
+	struct FNode
+	{
+		// Union of the bounds of the elements below this node
+		FVoxelIntBox Bounds;
+		// Min LOD of the elements below this node
+		int32 MinLOD = 0;
+		// If leaf, the elements are [First, First + NumElements[. Else, the children nodes are First and Second
+		int32 First = -1;
+		int32 Second = -1;
+		int32 NumElements = 0;
+	};
+	TArray<FNode> Nodes;
+	TArray<FElement> Elements;
+
+	int32 Build(int32 First, int32 Num);
+};
@@ -0,0 +1,286 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelRender/LODManager/VoxelLODPrefetcher.h"
+#include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelUtilities/VoxelIntVectorUtilities.h"
+#include "VoxelAsyncWork.h"
+#include "IVoxelPool.h"
+
+struct FVoxelLODPrefetchStats
+{
+	FThreadSafeCounter NumPrefetches;
+	// The invoker got into the prefetched bounds
+	FThreadSafeCounter NumHits;
+	// The invoker didn't get into the prefetched bounds in time
+	FThreadSafeCounter NumExpired;
+	// The invoker turned away from the prefetched bounds, or was removed
+	FThreadSafeCounter NumCanceled;
+
+	void Log() const
+	{
+		const int32 NumFinished = NumHits.GetValue() + NumExpired.GetValue() + NumCanceled.GetValue();
+		LOG_VOXEL(Log, TEXT("LOD prefetch stats: %d prefetches; %d hits; %d expired; %d canceled; hit rate: %f%%"),
+			NumPrefetches.GetValue(),
+			NumHits.GetValue(),
+			NumExpired.GetValue(),
+			NumCanceled.GetValue(),
+			NumFinished > 0 ? 100. * NumHits.GetValue() / NumFinished : 0.);
+	}
+	void Clear()
+	{
+		NumPrefetches.Reset();
+		NumHits.Reset();
+		NumExpired.Reset();
+		NumCanceled.Reset();
+	}
+};
+static FVoxelLODPrefetchStats GVoxelLODPrefetchStats;
+
+static FAutoConsoleCommand PrintLODPrefetchStatsCmd(
+	TEXT("voxel.lod.PrintPrefetchStats"),
+	TEXT("Log the LOD prefetches hit rate, for all worlds"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelLODPrefetchStats.Log();
+	}));
+
+static FAutoConsoleCommand ClearLODPrefetchStatsCmd(
+	TEXT("voxel.lod.ClearPrefetchStats"),
+	TEXT("Clear the stats logged by voxel.lod.PrintPrefetchStats"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelLODPrefetchStats.Clear();
+	}));
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+class FVoxelLODPrefetchWork : public FVoxelAsyncWork
+{
+public:
+	FVoxelLODPrefetchWork(const TVoxelSharedRef<FVoxelData>& Data, const FVoxelIntBox& Bounds, const TVoxelSharedRef<FVoxelLODPrefetchCache>& Cache)
+		: FVoxelAsyncWork(STATIC_FNAME("LOD Prefetch"), 1e9, true)
+		, Data(Data)
+		, Bounds(Bounds)
+		, Cache(Cache)
+	{
+	}
+
+	//~ Begin FVoxelAsyncWork Interface
+	virtual void DoWork() override
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+
+		// Cache a few leaves at a time, so that we can be canceled
+		TArray<FVoxelIntBox> Children;
+		Bounds.Subdivide(4 * DATA_CHUNK_SIZE, Children);
+
+		for (const FVoxelIntBox& Child : Children)
+		{
+			if (Cache->IsCanceled())
+			{
+				return;
+			}
+
+			// Leaves locked by meshers or edits are skipped: they are being used anyways
+			TArray<FVoxelIntBox> CachedLeaves;
+			Data->TryCacheBounds<FVoxelValue>(Child.Overlap(Bounds), CachedLeaves);
+
+			if (!Cache->AddCachedLeaves(CachedLeaves))
+			{
+				// Canceled while caching: the clear task doesn't know about these leaves
+				Data->TryClearCache<FVoxelValue>(CachedLeaves);
+				return;
+			}
+		}
+	}
+	virtual uint32 GetPriority() const override
+	{
+		// Lowest priority: after the other tasks of the same priority category that have a higher one
+		return 0;
+	}
+	//~ End FVoxelAsyncWork Interface
+
+private:
+	const TVoxelSharedRef<FVoxelData> Data;
+	const FVoxelIntBox Bounds;
+	const TVoxelSharedRef<FVoxelLODPrefetchCache> Cache;
+};
+
+class FVoxelLODPrefetchClearWork : public FVoxelAsyncWork
+{
+public:
+	FVoxelLODPrefetchClearWork(const TVoxelSharedRef<FVoxelData>& Data, TArray<FVoxelIntBox>&& Leaves)
+		: FVoxelAsyncWork(STATIC_FNAME("LOD Prefetch Clear"), 1e9, true)
+		, Data(Data)
+		, Leaves(MoveTemp(Leaves))
+	{
+	}
+
+	//~ Begin FVoxelAsyncWork Interface
+	virtual void DoWork() override
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+
+		// Only clears the values that are not dirty. Leaves that are locked keep their cache
+		Data->TryClearCache<FVoxelValue>(Leaves);
+	}
+	virtual uint32 GetPriority() const override
+	{
+		return 0;
+	}
+	//~ End FVoxelAsyncWork Interface
+
+private:
+	const TVoxelSharedRef<FVoxelData> Data;
+	const TArray<FVoxelIntBox> Leaves;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+FVoxelLODPrefetcher::FVoxelLODPrefetcher(const TVoxelSharedRef<FVoxelData>& Data, const TVoxelSharedRef<IVoxelPool>& Pool)
+	: Data(Data)
+	, Pool(Pool)
+{
+}
+
+FVoxelLODPrefetcher::~FVoxelLODPrefetcher()
+{
+	// Don't bother clearing the cache, the data is most likely being destroyed too
+	for (const FPrefetch& Prefetch : Prefetches)
+	{
+		Prefetch.Cache->Cancel();
+	}
+}
+
+void FVoxelLODPrefetcher::Update(double Time, const FVoxelLODPrefetchSettings& Settings, const TArray<FInvoker>& Invokers)
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	PredictedPositions.Reset();
+
+	// Bounds swept by the invokers until their predicted positions
+	TMap<TWeakObjectPtr<UVoxelInvokerComponentBase>, FVoxelIntBox> PredictedPaths;
+
+	TMap<TWeakObjectPtr<UVoxelInvokerComponentBase>, FInvokerState> NewInvokerStates;
+	NewInvokerStates.Reserve(Invokers.Num());
+	for (const FInvoker& Invoker : Invokers)
+	{
+		FInvokerState State;
+		State.Position = Invoker.Position;
+		State.Time = Time;
+
+		if (const FInvokerState* OldState = InvokerStates.Find(Invoker.Component))
+		{
+			const double DeltaTime = Time - OldState->Time;
+			if (DeltaTime > 0)
+			{
+				// Smooth out the jitter of the positions
+				const FVector Velocity = FVector(Invoker.Position - OldState->Position) / DeltaTime;
+				State.Velocity = FMath::Lerp(OldState->Velocity, Velocity, 0.5f);
+			}
+			else
+			{
+				State.Velocity = OldState->Velocity;
+			}
+		}
+		NewInvokerStates.Add(Invoker.Component, State);
+
+		if (!Invoker.bUseForLOD || State.Velocity.Size() < Settings.MinSpeed)
+		{
+			continue;
+		}
+
+		const FIntVector PredictedPosition = Invoker.Position + FVoxelUtilities::RoundToInt(State.Velocity * Settings.Horizon);
+		PredictedPositions.Add(PredictedPosition);
+		PredictedPaths.Add(Invoker.Component, FVoxelIntBox::SafeConstruct(Invoker.Position, PredictedPosition).Extend(Settings.Radius));
+
+		const FVoxelIntBox Bounds = FVoxelIntBox(PredictedPosition - Settings.Radius, PredictedPosition + Settings.Radius).MakeMultipleOfBigger(DATA_CHUNK_SIZE);
+		if (!Bounds.Intersect(Data->WorldBounds) ||
+			// Already meshed
+			Invoker.LODBounds.Contains(Bounds) ||
+			// Already prefetched
+			Prefetches.ContainsByPredicate([&](const FPrefetch& Prefetch) { return Prefetch.Component == Invoker.Component && !Prefetch.bHit && Prefetch.Bounds.Contains(PredictedPosition); }))
+		{
+			continue;
+		}
+
+		FPrefetch& Prefetch = Prefetches.Emplace_GetRef();
+		Prefetch.Component = Invoker.Component;
+		Prefetch.Bounds = Bounds.Overlap(Data->WorldBounds);
+		Prefetch.ExpirationTime = Time + 2 * Settings.Horizon;
+
+		Pool->QueueTask(EVoxelTaskType::DataPrefetch, new FVoxelLODPrefetchWork(Data, Prefetch.Bounds, Prefetch.Cache));
+		GVoxelLODPrefetchStats.NumPrefetches.Increment();
+	}
+	InvokerStates = MoveTemp(NewInvokerStates);
+
+	for (int32 Index = 0; Index < Prefetches.Num(); Index++)
+	{
+		FPrefetch& Prefetch = Prefetches[Index];
+		const FInvoker* Invoker = Invokers.FindByPredicate([&](const FInvoker& It) { return It.Component == Prefetch.Component; });
+
+		bool bRemove = false;
+		if (!Prefetch.bHit)
+		{
+			if (Invoker && Prefetch.Bounds.Contains(Invoker->Position))
+			{
+				Prefetch.bHit = true;
+				GVoxelLODPrefetchStats.NumHits.Increment();
+			}
+			else
+			{
+				// If the invoker slowed down there's no path, rely on the expiration time
+				const FVoxelIntBox* PredictedPath = PredictedPaths.Find(Prefetch.Component);
+				if (!Invoker || (PredictedPath && !PredictedPath->Intersect(Prefetch.Bounds)))
+				{
+					GVoxelLODPrefetchStats.NumCanceled.Increment();
+					bRemove = true;
+				}
+				else if (Time > Prefetch.ExpirationTime)
+				{
+					GVoxelLODPrefetchStats.NumExpired.Increment();
+					bRemove = true;
+				}
+			}
+		}
+
+		if (Prefetch.bHit)
+		{
+			// Keep the cache as long as chunks using it might be meshed
+			bRemove = !Invokers.ContainsByPredicate([&](const FInvoker& It) { return It.bUseForLOD && It.LODBounds.Intersect(Prefetch.Bounds); });
+		}
+
+		if (bRemove)
+		{
+			Cancel(Prefetch);
+			Prefetches.RemoveAtSwap(Index);
+			Index--;
+		}
+	}
+}
+
+void FVoxelLODPrefetcher::Reset()
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	for (FPrefetch& Prefetch : Prefetches)
+	{
+		Cancel(Prefetch);
+	}
+	Prefetches.Reset();
+	InvokerStates.Reset();
+	PredictedPositions.Reset();
+}
+
+void FVoxelLODPrefetcher::Cancel(FPrefetch& Prefetch)
+{
+	TArray<FVoxelIntBox> CachedLeaves = Prefetch.Cache->Cancel();
+	if (CachedLeaves.Num() > 0)
+	{
+		Pool->QueueTask(EVoxelTaskType::DataPrefetch, new FVoxelLODPrefetchClearWork(Data, MoveTemp(CachedLeaves)));
+	}
+}
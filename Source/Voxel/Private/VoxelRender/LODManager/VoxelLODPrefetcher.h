@@ -0,0 +1,119 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelIntBox.h"
+#include "VoxelMinimal.h"
+#include "Misc/ScopeLock.h"
+
+class FVoxelData;
+class IVoxelPool;
+class UVoxelInvokerComponentBase;
+
+// Leaves cached by a prefetch task, so that only these are cleared when it's canceled
+class FVoxelLODPrefetchCache
+{
+public:
+	bool IsCanceled() const
+	{
+		FScopeLock Lock(&Section);
+		return bCanceled;
+	}
+	// Returns false if canceled: the leaves must then be cleared by the caller
+	bool AddCachedLeaves(const TArray<FVoxelIntBox>& Leaves)
+	{
+		FScopeLock Lock(&Section);
+		if (bCanceled)
+		{
+			return false;
+		}
+		CachedLeaves.Append(Leaves);
+		return true;
+	}
+	// Returns the leaves cached so far, to be cleared
+	TArray<FVoxelIntBox> Cancel()
+	{
+		FScopeLock Lock(&Section);
+		bCanceled = true;
+		return MoveTemp(CachedLeaves);
+	}
+
+private:
+	mutable FCriticalSection Section;
+	bool bCanceled = false;
+	TArray<FVoxelIntBox> CachedLeaves;
+};
+
+struct FVoxelLODPrefetchSettings
+{
+	// In seconds: how far in the future the invokers positions are predicted
+	float Horizon = 0;
+	// In voxels per second: slower invokers are not prefetched for
+	float MinSpeed = 0;
+	// In voxels: half size of the prefetched bounds, around the predicted positions
+	int32 Radius = 0;
+};
+
+/**
+ * Caches the data in front of fast invokers, so that it's ready to be meshed when the LODs are updated
+ *
+ * The invokers velocities are estimated from their positions at each update, and extrapolated over the horizon.
+ * The generator values around the predicted positions are cached by DataPrefetch tasks, skipping the leaves that are locked.
+ *
+ * Prefetches are speculative: if the invoker turns away or doesn't reach the prefetched bounds in time,
+ * their tasks are canceled and the values they cached are cleared. Once the invoker got there, the cache is kept
+ * until the bounds are out of all the invokers LOD bounds.
+ */
+class FVoxelLODPrefetcher
+{
+public:
+	struct FInvoker
+	{
+		TWeakObjectPtr<UVoxelInvokerComponentBase> Component;
+		FIntVector Position;
+		bool bUseForLOD = false;
+		FVoxelIntBox LODBounds;
+	};
+
+	FVoxelLODPrefetcher(const TVoxelSharedRef<FVoxelData>& Data, const TVoxelSharedRef<IVoxelPool>& Pool);
+	~FVoxelLODPrefetcher();
+
+	UE_NONCOPYABLE(FVoxelLODPrefetcher);
+
+	// Called on the game thread every time the invokers positions are queried
+	void Update(double Time, const FVoxelLODPrefetchSettings& Settings, const TArray<FInvoker>& Invokers);
+	// Cancel all the prefetches and clear their cache
+	void Reset();
+
+	// Positions the invokers are predicted to be at, to mesh the chunks there first
+	const TArray<FIntVector>& GetPredictedPositions() const { return PredictedPositions; }
+
+private:
+	const TVoxelSharedRef<FVoxelData> Data;
+	const TVoxelSharedRef<IVoxelPool> Pool;
+
+	struct FInvokerState
+	{
+		FIntVector Position{ForceInit};
+		double Time = 0;
+		FVector Velocity{ForceInit};
+	};
+	TMap<TWeakObjectPtr<UVoxelInvokerComponentBase>, FInvokerState> InvokerStates;
+
+	struct FPrefetch
+	{
+		TWeakObjectPtr<UVoxelInvokerComponentBase> Component;
+		FVoxelIntBox Bounds;
+		// Missed if the invoker isn't in Bounds by then
+		double ExpirationTime = 0;
+		TVoxelSharedRef<FVoxelLODPrefetchCache> Cache = MakeVoxelShared<FVoxelLODPrefetchCache>();
+		// True once the invoker got into Bounds
+		bool bHit = false;
+	};
+	TArray<FPrefetch> Prefetches;
+
+	TArray<FIntVector> PredictedPositions;
+
+	void Cancel(FPrefetch& Prefetch);
+};
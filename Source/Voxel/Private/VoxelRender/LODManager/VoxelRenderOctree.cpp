@@ -4,6 +4,8 @@
 #include "VoxelDebug/VoxelDebugManager.h"
 #include "VoxelMessages.h"
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
 
 DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Voxel Render Octrees Count"), STAT_VoxelRenderOctreesCount, STATGROUP_VoxelCounters);
 DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelRenderOctreesMemory);
@@ -20,6 +22,236 @@ static TAutoConsoleVariable<int32> CVarLogRenderOctreeBuildTime(
 	TEXT("If true, will log the render octree build times"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarIncrementalRenderOctree(
+	TEXT("voxel.renderer.IncrementalRenderOctree"),
+	1,
+	TEXT("If true, render octree updates will only revisit the nodes that can be affected by the invokers changes, instead of the whole octree"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarCompareRenderOctreeBuilds(
+	TEXT("voxel.renderer.CompareRenderOctreeBuilds"),
+	0,
+	TEXT("If true, every incremental render octree update will also do a full update and check that they give the same chunk updates. Slow, for debugging"),
+	ECVF_Default);
+
+struct FVoxelRenderOctreeBuildStats
+{
+	struct FModeStats
+	{
+		int32 Num = 0;
+		double TotalTime = 0;
+		double MaxTime = 0;
+
+		void Add(double Time)
+		{
+			Num++;
+			TotalTime += Time;
+			MaxTime = FMath::Max(MaxTime, Time);
+		}
+		void Log(const TCHAR* Name) const
+		{
+			LOG_VOXEL(Log, TEXT("\t%s: %d builds; average %fms; max %fms"), Name, Num, Num > 0 ? TotalTime / Num * 1000 : 0., MaxTime * 1000);
+		}
+	};
+
+	FCriticalSection Section;
+	FModeStats Full;
+	FModeStats Incremental;
+
+	// Builds done in both modes with voxel.renderer.CompareRenderOctreeBuilds
+	int32 NumCompared = 0;
+	int32 NumMismatches = 0;
+	double ComparedFullTime = 0;
+	double ComparedIncrementalTime = 0;
+
+	void Add(bool bFull, double Time)
+	{
+		FScopeLock Lock(&Section);
+		(bFull ? Full : Incremental).Add(Time);
+	}
+	void AddComparison(double FullTime, double IncrementalTime, bool bMismatch)
+	{
+		FScopeLock Lock(&Section);
+		NumCompared++;
+		NumMismatches += bMismatch;
+		ComparedFullTime += FullTime;
+		ComparedIncrementalTime += IncrementalTime;
+	}
+	void Log()
+	{
+		FScopeLock Lock(&Section);
+		LOG_VOXEL(Log, TEXT("Render octree build stats:"));
+		Full.Log(TEXT("Full"));
+		Incremental.Log(TEXT("Incremental"));
+		if (NumCompared > 0)
+		{
+			LOG_VOXEL(Log, TEXT("\tCompared: %d builds; full %fms; incremental %fms; speedup x%f; %d mismatches"),
+				NumCompared,
+				ComparedFullTime / NumCompared * 1000,
+				ComparedIncrementalTime / NumCompared * 1000,
+				ComparedFullTime / FMath::Max(ComparedIncrementalTime, 1e-9),
+				NumMismatches);
+		}
+	}
+	void Clear()
+	{
+		FScopeLock Lock(&Section);
+		Full = {};
+		Incremental = {};
+		NumCompared = 0;
+		NumMismatches = 0;
+		ComparedFullTime = 0;
+		ComparedIncrementalTime = 0;
+	}
+};
+static FVoxelRenderOctreeBuildStats GVoxelRenderOctreeBuildStats;
+
+static FAutoConsoleCommand PrintRenderOctreeBuildStatsCmd(
+	TEXT("voxel.renderer.PrintRenderOctreeBuildStats"),
+	TEXT("Log the render octree build times of the full and incremental updates, for all worlds"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelRenderOctreeBuildStats.Log();
+	}));
+
+static FAutoConsoleCommand ClearRenderOctreeBuildStatsCmd(
+	TEXT("voxel.renderer.ClearRenderOctreeBuildStats"),
+	TEXT("Clear the stats logged by voxel.renderer.PrintRenderOctreeBuildStats"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelRenderOctreeBuildStats.Clear();
+	}));
+
+// Margins around the dirty LOD bounds, in multiples of the node size
+// The neighbors subdivision of a node only depends on the distance subdivisions less than 2 node sizes away:
+// the chain of neighbors forcing it to subdivide is made of smaller and smaller nodes, each at most one of its size away from the previous one
+constexpr int32 RENDER_OCTREE_STRUCTURE_MARGIN = 2;
+// The transitions of a node depend on the subdivision of its adjacent node and of the adjacent node parent, less than 2 node sizes away
+constexpr int32 RENDER_OCTREE_TRANSITIONS_MARGIN = 2 + 2 * RENDER_OCTREE_STRUCTURE_MARGIN;
+
+// Number of levels below the root whose children are processed in parallel: 8^2 subtrees
+constexpr int32 RENDER_OCTREE_PARALLEL_DEPTH = 2;
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+inline void AddDirtyInvokerBounds(
+	bool bOldUsed, const FVoxelIntBox& OldBounds,
+	bool bNewUsed, const FVoxelIntBox& NewBounds,
+	bool bSameParameters,
+	TArray<FVoxelIntBox>& OutBounds)
+{
+	if (bOldUsed && bNewUsed && bSameParameters)
+	{
+		// Nodes intersecting both or none of the bounds are not affected
+		if (OldBounds != NewBounds)
+		{
+			OutBounds.Append(OldBounds.Difference(NewBounds));
+			OutBounds.Append(NewBounds.Difference(OldBounds));
+		}
+	}
+	else
+	{
+		if (bOldUsed)
+		{
+			OutBounds.Add(OldBounds);
+		}
+		if (bNewUsed)
+		{
+			OutBounds.Add(NewBounds);
+		}
+	}
+}
+
+FVoxelRenderOctreeDirtyRegion FVoxelRenderOctreeDirtyRegion::Compute(const FVoxelRenderOctreeSettings& OldSettings, const FVoxelRenderOctreeSettings& NewSettings)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	FVoxelRenderOctreeDirtyRegion Result;
+
+	const auto& A = OldSettings;
+	const auto& B = NewSettings;
+	if (A.MinLOD != B.MinLOD ||
+		A.MaxLOD != B.MaxLOD ||
+		A.WorldBounds != B.WorldBounds ||
+		A.ChunksCullingLOD != B.ChunksCullingLOD ||
+		A.bEnableRender != B.bEnableRender ||
+		A.bEnableTransitions != B.bEnableTransitions ||
+		A.bInvertTransitions != B.bInvertTransitions ||
+		A.bEnableCollisions != B.bEnableCollisions ||
+		A.bComputeVisibleChunksCollisions != B.bComputeVisibleChunksCollisions ||
+		A.VisibleChunksCollisionsMaxLOD != B.VisibleChunksCollisionsMaxLOD ||
+		A.bEnableNavmesh != B.bEnableNavmesh ||
+		A.bComputeVisibleChunksNavmesh != B.bComputeVisibleChunksNavmesh ||
+		A.VisibleChunksNavmeshMaxLOD != B.VisibleChunksNavmeshMaxLOD)
+	{
+		return Result;
+	}
+
+	Result.bAll = false;
+
+	// The subdivision predicates are ORs over all the invokers, so the order of the invokers doesn't matter:
+	// comparing them index by index is enough, even if the invokers array was reordered
+	const FVoxelInvokerSettings Disabled;
+	const int32 NumInvokers = FMath::Max(A.Invokers.Num(), B.Invokers.Num());
+	for (int32 Index = 0; Index < NumInvokers; Index++)
+	{
+		const bool bOldValid = A.Invokers.IsValidIndex(Index);
+		const bool bNewValid = B.Invokers.IsValidIndex(Index);
+		const FVoxelInvokerSettings& Old = bOldValid ? A.Invokers[Index] : Disabled;
+		const FVoxelInvokerSettings& New = bNewValid ? B.Invokers[Index] : Disabled;
+
+		AddDirtyInvokerBounds(
+			Old.bUseForLOD, Old.LODBounds,
+			New.bUseForLOD, New.LODBounds,
+			Old.LODToSet == New.LODToSet,
+			Result.LODBounds);
+
+		AddDirtyInvokerBounds(
+			Old.bUseForCollisions, Old.CollisionsBounds,
+			New.bUseForCollisions, New.CollisionsBounds,
+			true,
+			Result.OthersBounds);
+
+		AddDirtyInvokerBounds(
+			Old.bUseForNavmesh, Old.NavmeshBounds,
+			New.bUseForNavmesh, New.NavmeshBounds,
+			true,
+			Result.OthersBounds);
+	}
+
+	return Result;
+}
+
+void FVoxelRenderOctreeSettings::BuildInvokersTrees()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	TArray<FVoxelInvokerBoundsTree::FElement> LODElements;
+	TArray<FVoxelInvokerBoundsTree::FElement> CollisionsElements;
+	TArray<FVoxelInvokerBoundsTree::FElement> NavmeshElements;
+	for (const FVoxelInvokerSettings& Invoker : Invokers)
+	{
+		if (Invoker.bUseForLOD)
+		{
+			LODElements.Add({ Invoker.LODBounds, Invoker.LODToSet });
+		}
+		if (Invoker.bUseForCollisions)
+		{
+			CollisionsElements.Add({ Invoker.CollisionsBounds });
+		}
+		if (Invoker.bUseForNavmesh)
+		{
+			NavmeshElements.Add({ Invoker.NavmeshBounds });
+		}
+	}
+
+	LODInvokersTree = FVoxelInvokerBoundsTree(MoveTemp(LODElements));
+	CollisionsInvokersTree = FVoxelInvokerBoundsTree(MoveTemp(CollisionsElements));
+	NavmeshInvokersTree = FVoxelInvokerBoundsTree(MoveTemp(NavmeshElements));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -91,23 +323,117 @@ void FVoxelRenderOctreeAsyncBuilder::DoWork()
 		NewOctree.Reset();
 		LOG_TIME("Resetting arrays");
 	}
+
+	OctreeSettings.BuildInvokersTrees();
+	LOG_TIME("Building invokers trees");
+
+	FVoxelRenderOctreeDirtyRegion DirtyRegion;
+	// The octree we get must be the last one we built, else we don't know what changed since
+	if (CVarIncrementalRenderOctree.GetValueOnAnyThread() != 0 &&
+		OldOctree.IsValid() &&
+		bHasLastOctreeSettings &&
+		OldOctree->UpdateIndex == LastOctreeUpdateIndex)
+	{
+		DirtyRegion = FVoxelRenderOctreeDirtyRegion::Compute(LastOctreeSettings, OctreeSettings);
+		LOG_TIME("Computing dirty region");
+	}
+
+	if (DirtyRegion.bAll)
+	{
+		Log += "\n\tFull build:";
+	}
+	else
+	{
+		Log += FString::Printf(TEXT("\n\tIncremental build: %d dirty LOD bounds, %d dirty collisions/navmesh bounds:"), DirtyRegion.LODBounds.Num(), DirtyRegion.OthersBounds.Num());
+	}
+
+	const double BuildStartTime = FPlatformTime::Seconds();
+	NewOctree = BuildOctree(DirtyRegion, ChunkUpdates);
+	const double BuildTime = FPlatformTime::Seconds() - BuildStartTime;
+
+	bTooManyChunks = NewOctree->IsCanceled();
+
+	if (!bTooManyChunks)
+	{
+		GVoxelRenderOctreeBuildStats.Add(DirtyRegion.bAll, BuildTime);
+
+		if (!DirtyRegion.bAll && CVarCompareRenderOctreeBuilds.GetValueOnAnyThread() != 0)
+		{
+			CompareWithFullBuild(BuildTime);
+		}
+	}
 	
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Sort By LODs");
+		// Make sure that LOD 0 chunks are processed first
+		ChunkUpdates.Sort([](const auto& A, const auto& B) { return A.LOD < B.LOD; });
+		LOG_TIME("Sort By LODs");
+	}
+
+	if (OldOctree.IsValid())
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Find previous chunks");
+		ParallelFor(ChunkUpdates.Num(), [&](int32 Index)
+		{
+			FVoxelChunkUpdate& ChunkUpdate = ChunkUpdates[Index];
+			if (ChunkUpdate.NewSettings.bVisible && !ChunkUpdate.OldSettings.bVisible)
+			{
+				OldOctree->GetVisibleChunksOverlappingBounds(ChunkUpdate.Bounds, ChunkUpdate.PreviousChunks);
+			}
+		}, !OctreeSettings.bParallelBuild);
+	}
+	LOG_TIME("Find previous chunks");
+	
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Deleting old octree");
+		OldOctree.Reset();
+		LOG_TIME("Deleting old octree");
+	}
+
+	NumberOfChunks = NewOctree->CurrentChunksCount.GetValue();
+
+	if (bTooManyChunks)
+	{
+		NewOctree.Reset();
+		bHasLastOctreeSettings = false;
+	}
+	else
+	{
+		bHasLastOctreeSettings = true;
+		LastOctreeUpdateIndex = NewOctree->UpdateIndex;
+		LastOctreeSettings = OctreeSettings;
+	}
+
+	LOG_TIME_IMPL("Total time working", WorkStartTime);
+}
+
+uint32 FVoxelRenderOctreeAsyncBuilder::GetPriority() const
+{
+	return 0;
+}
+
+TVoxelSharedRef<FVoxelRenderOctree> FVoxelRenderOctreeAsyncBuilder::BuildOctree(const FVoxelRenderOctreeDirtyRegion& DirtyRegion, TArray<FVoxelChunkUpdate>& OutChunkUpdates)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	TVoxelSharedPtr<FVoxelRenderOctree> Octree;
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("Cloning octree");
-		NewOctree = OldOctree.IsValid() ? MakeVoxelShared<FVoxelRenderOctree>(&*OldOctree) : MakeVoxelShared<FVoxelRenderOctree>(OctreeDepth);
+		Octree = OldOctree.IsValid() ? MakeVoxelShared<FVoxelRenderOctree>(&*OldOctree) : MakeVoxelShared<FVoxelRenderOctree>(OctreeDepth);
 		LOG_TIME("Cloning octree");
 	}
+	Octree->bParallelBuild = OctreeSettings.bParallelBuild;
 	
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("ResetDivisionType");
-		NewOctree->ResetDivisionType();
+		Octree->ResetDivisionType(DirtyRegion);
 		LOG_TIME("ResetDivisionType");
 	}
 
 	bool bChanged;
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("UpdateSubdividedByDistance");
-		bChanged = NewOctree->UpdateSubdividedByDistance(OctreeSettings);
+		bChanged = Octree->UpdateSubdividedByDistance(OctreeSettings, DirtyRegion);
 		LOG_TIME("UpdateSubdividedByDistance");
 		Log += "; Need to recompute neighbors: " + FString(bChanged ? "true" : "false");
 	}
@@ -116,74 +442,85 @@ void FVoxelRenderOctreeAsyncBuilder::DoWork()
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("UpdateSubdividedByNeighbors");
 		int32 UpdateSubdividedByNeighborsCounter = 0;
-		while (NewOctree->UpdateSubdividedByNeighbors(OctreeSettings)) { UpdateSubdividedByNeighborsCounter++; }
+		while (Octree->UpdateSubdividedByNeighbors(OctreeSettings, DirtyRegion)) { UpdateSubdividedByNeighborsCounter++; }
 		LOG_TIME("UpdateSubdividedByNeighbors");
 		Log += "; Iterations: " + FString::FromInt(UpdateSubdividedByNeighborsCounter);
 	}
 	else
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("ReuseOldNeighbors");
-		NewOctree->ReuseOldNeighbors();
+		Octree->ReuseOldNeighbors(DirtyRegion);
 	}
 	
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("UpdateSubdividedByOthers");
-		NewOctree->UpdateSubdividedByOthers(OctreeSettings);
+		Octree->UpdateSubdividedByOthers(OctreeSettings, DirtyRegion);
 		LOG_TIME("UpdateSubdividedByOthers");
 	}
 	
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("DeleteChunks");
-		NewOctree->DeleteChunks(ChunkUpdates);
+		Octree->DeleteChunks(OutChunkUpdates, DirtyRegion);
 		LOG_TIME("DeleteChunks");
 	}
 	
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("GetUpdates");
-		NewOctree->GetUpdates(NewOctree->UpdateIndex + 1, bChanged, OctreeSettings, ChunkUpdates);
+		Octree->GetUpdates(Octree->UpdateIndex + 1, bChanged, OctreeSettings, DirtyRegion, OutChunkUpdates);
 		LOG_TIME("GetUpdates");
 	}
-	
+
+	return Octree.ToSharedRef();
+}
+
+void FVoxelRenderOctreeAsyncBuilder::CompareWithFullBuild(double IncrementalBuildTime)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	Log += "\n\tFull build for comparison:";
+
+	TArray<FVoxelChunkUpdate> FullChunkUpdates;
+	const double StartTime = FPlatformTime::Seconds();
+	const TVoxelSharedRef<FVoxelRenderOctree> FullOctree = BuildOctree({}, FullChunkUpdates);
+	const double FullBuildTime = FPlatformTime::Seconds() - StartTime;
+
+	if (FullOctree->IsCanceled())
 	{
-		VOXEL_ASYNC_SCOPE_COUNTER("Sort By LODs");
-		// Make sure that LOD 0 chunks are processed first
-		ChunkUpdates.Sort([](const auto& A, const auto& B) { return A.LOD < B.LOD; });
-		LOG_TIME("Sort By LODs");
+		return;
 	}
 
-	if (OldOctree.IsValid())
+	// Chunks are identified by their bounds and not their ids: new chunks might be created in a different order
+	TMap<FVoxelIntBox, const FVoxelChunkUpdate*> FullChunkUpdatesMap;
+	FullChunkUpdatesMap.Reserve(FullChunkUpdates.Num());
+	for (const FVoxelChunkUpdate& ChunkUpdate : FullChunkUpdates)
 	{
-		VOXEL_ASYNC_SCOPE_COUNTER("Find previous chunks");
-		for (auto& ChunkUpdate : ChunkUpdates)
-		{
-			if (ChunkUpdate.NewSettings.bVisible && !ChunkUpdate.OldSettings.bVisible)
-			{
-				OldOctree->GetVisibleChunksOverlappingBounds(ChunkUpdate.Bounds, ChunkUpdate.PreviousChunks);
-			}
-		}
+		FullChunkUpdatesMap.Add(ChunkUpdate.Bounds, &ChunkUpdate);
 	}
-	LOG_TIME("Find previous chunks");
-	
+
+	int32 NumMismatches = FMath::Abs(FullChunkUpdates.Num() - ChunkUpdates.Num());
+	for (const FVoxelChunkUpdate& ChunkUpdate : ChunkUpdates)
 	{
-		VOXEL_ASYNC_SCOPE_COUNTER("Deleting old octree");
-		OldOctree.Reset();
-		LOG_TIME("Deleting old octree");
+		const FVoxelChunkUpdate* const* FullChunkUpdate = FullChunkUpdatesMap.Find(ChunkUpdate.Bounds);
+		if (!FullChunkUpdate ||
+			(**FullChunkUpdate).LOD != ChunkUpdate.LOD ||
+			(**FullChunkUpdate).OldSettings != ChunkUpdate.OldSettings ||
+			(**FullChunkUpdate).NewSettings != ChunkUpdate.NewSettings)
+		{
+			NumMismatches++;
+		}
 	}
 
-	NumberOfChunks = NewOctree->CurrentChunksCount;
-	bTooManyChunks = NewOctree->IsCanceled();
+	GVoxelRenderOctreeBuildStats.Add(true, FullBuildTime);
+	GVoxelRenderOctreeBuildStats.AddComparison(FullBuildTime, IncrementalBuildTime, NumMismatches > 0);
 
-	if (bTooManyChunks)
+	Log += FString::Printf(TEXT("\n\tIncremental build: %fms; Full build: %fms; Mismatches: %d"), IncrementalBuildTime * 1000, FullBuildTime * 1000, NumMismatches);
+
+	if (NumMismatches > 0)
 	{
-		NewOctree.Reset();
+		LOG_VOXEL(Error, TEXT("Incremental render octree build gave %d chunk updates different from a full build, using the full build instead"), NumMismatches);
+		NewOctree = FullOctree;
+		ChunkUpdates = MoveTemp(FullChunkUpdates);
 	}
-
-	LOG_TIME_IMPL("Total time working", WorkStartTime);
-}
-
-uint32 FVoxelRenderOctreeAsyncBuilder::GetPriority() const
-{
-	return 0;
 }
 
 #undef LOG_TIME
@@ -203,8 +540,8 @@ FVoxelRenderOctree::FVoxelRenderOctree(uint8 LOD)
 	, OctreeBounds(GetBounds())
 {
 	check(LOD > 0);
-	check(ChunkId <= Root->RootIdCounter);
-	Root->CurrentChunksCount++;
+	check(ChunkId <= uint64(Root->RootIdCounter.GetValue()));
+	Root->CurrentChunksCount.Increment();
 
 	INC_DWORD_STAT_BY(STAT_VoxelRenderOctreesCount, 1);
 	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelRenderOctreesMemory, sizeof(FVoxelRenderOctree));
@@ -212,14 +549,14 @@ FVoxelRenderOctree::FVoxelRenderOctree(uint8 LOD)
 
 FVoxelRenderOctree::FVoxelRenderOctree(const FVoxelRenderOctree* Source)
 	: TSimpleVoxelOctree(Source->Height)
-	, RootIdCounter(Source->RootIdCounter)
+	, RootIdCounter(Source->RootIdCounter.GetValue())
 	, Root(this)
 	, ChunkId(Source->ChunkId)
 	, OctreeBounds(GetBounds())
 	, UpdateIndex(Source->UpdateIndex)
 {
-	check(ChunkId <= Root->RootIdCounter);
-	Root->CurrentChunksCount++;
+	check(ChunkId <= uint64(Root->RootIdCounter.GetValue()));
+	Root->CurrentChunksCount.Increment();
 	ChunkSettings = Source->ChunkSettings;
 	if (Source->HasChildren())
 	{
@@ -238,8 +575,8 @@ FVoxelRenderOctree::FVoxelRenderOctree(const FVoxelRenderOctree& Parent, uint8 C
 	, OctreeBounds(GetBounds())
 	, UpdateIndex(Parent.UpdateIndex)
 {
-	check(ChunkId <= Root->RootIdCounter);
-	Root->CurrentChunksCount++;
+	check(ChunkId <= uint64(Root->RootIdCounter.GetValue()));
+	Root->CurrentChunksCount.Increment();
 
 	INC_DWORD_STAT_BY(STAT_VoxelRenderOctreesCount, 1);
 	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelRenderOctreesMemory, sizeof(FVoxelRenderOctree));
@@ -253,7 +590,7 @@ FVoxelRenderOctree::FVoxelRenderOctree(const FVoxelRenderOctree& Parent, uint8 C
 	, OctreeBounds(GetBounds())
 	, UpdateIndex(Parent.UpdateIndex)
 {
-	Root->CurrentChunksCount++;
+	Root->CurrentChunksCount.Increment();
 
 	auto& Source = SourceChildren[ChildIndex];
 	ChunkSettings = Source.ChunkSettings;
@@ -268,14 +605,14 @@ FVoxelRenderOctree::FVoxelRenderOctree(const FVoxelRenderOctree& Parent, uint8 C
 
 FVoxelRenderOctree::~FVoxelRenderOctree()
 {
-	Root->CurrentChunksCount--;
+	Root->CurrentChunksCount.Decrement();
 	DEC_DWORD_STAT_BY(STAT_VoxelRenderOctreesCount, 1);
 	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelRenderOctreesMemory, sizeof(FVoxelRenderOctree));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-void FVoxelRenderOctree::ResetDivisionType()
+void FVoxelRenderOctree::ResetDivisionType(const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	ChunkSettings.OldDivisionType = ChunkSettings.DivisionType;
 	ChunkSettings.DivisionType = EDivisionType::Uninitialized;
@@ -284,12 +621,15 @@ void FVoxelRenderOctree::ResetDivisionType()
 	{
 		for (auto& Child : GetChildren())
 		{
-			Child.ResetDivisionType();
+			if (Child.IsDirty(Dirty, RENDER_OCTREE_STRUCTURE_MARGIN))
+			{
+				Child.ResetDivisionType(Dirty);
+			}
 		}
 	}
 }
 
-bool FVoxelRenderOctree::UpdateSubdividedByDistance(const FVoxelRenderOctreeSettings& Settings)
+bool FVoxelRenderOctree::UpdateSubdividedByDistance(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	CHECK_MAX_CHUNKS_COUNT_BOOL();
 	
@@ -302,12 +642,20 @@ bool FVoxelRenderOctree::UpdateSubdividedByDistance(const FVoxelRenderOctreeSett
 			CreateChildren();
 		}
 		
+		bool bChildrenChanged[8] = {};
+		IterateChildren([&](int32 ChildIndex, FVoxelRenderOctree& Child)
+		{
+			if (ShouldVisitChild(Dirty, Child))
+			{
+				bChildrenChanged[ChildIndex] = Child.UpdateSubdividedByDistance(Settings, Dirty);
+			}
+		});
+
 		bool bChanged = ChunkSettings.OldDivisionType != EDivisionType::ByDistance;
-		for (auto& Child : GetChildren())
+		for (const bool bChildChanged : bChildrenChanged)
 		{
-			bChanged |= Child.UpdateSubdividedByDistance(Settings);
+			bChanged |= bChildChanged;
 		}
-	
 		return bChanged;
 	}
 	else
@@ -316,7 +664,7 @@ bool FVoxelRenderOctree::UpdateSubdividedByDistance(const FVoxelRenderOctreeSett
 	}
 }
 
-bool FVoxelRenderOctree::UpdateSubdividedByNeighbors(const FVoxelRenderOctreeSettings& Settings)
+bool FVoxelRenderOctree::UpdateSubdividedByNeighbors(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	CHECK_MAX_CHUNKS_COUNT_BOOL();
 
@@ -338,14 +686,17 @@ bool FVoxelRenderOctree::UpdateSubdividedByNeighbors(const FVoxelRenderOctreeSet
 	{
 		for (auto& Child : GetChildren())
 		{
-			bShouldContinue |= Child.UpdateSubdividedByNeighbors(Settings);
+			if (ShouldVisitChild(Dirty, Child))
+			{
+				bShouldContinue |= Child.UpdateSubdividedByNeighbors(Settings, Dirty);
+			}
 		}
 	}
 
 	return bShouldContinue;
 }
 
-void FVoxelRenderOctree::ReuseOldNeighbors()
+void FVoxelRenderOctree::ReuseOldNeighbors(const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	if (ChunkSettings.OldDivisionType == EDivisionType::ByNeighbors)
 	{
@@ -356,12 +707,15 @@ void FVoxelRenderOctree::ReuseOldNeighbors()
 	{
 		for (auto& Child : GetChildren())
 		{
-			Child.ReuseOldNeighbors();
+			if (ShouldVisitChild(Dirty, Child))
+			{
+				Child.ReuseOldNeighbors(Dirty);
+			}
 		}
 	}
 }
 
-void FVoxelRenderOctree::UpdateSubdividedByOthers(const FVoxelRenderOctreeSettings& Settings)
+void FVoxelRenderOctree::UpdateSubdividedByOthers(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	CHECK_MAX_CHUNKS_COUNT();
 
@@ -377,14 +731,17 @@ void FVoxelRenderOctree::UpdateSubdividedByOthers(const FVoxelRenderOctreeSettin
 
 	if (ChunkSettings.DivisionType != EDivisionType::Uninitialized)
 	{
-		for (auto& Child : GetChildren())
+		IterateChildren([&](int32 ChildIndex, FVoxelRenderOctree& Child)
 		{
-			Child.UpdateSubdividedByOthers(Settings);
-		}
+			if (ShouldVisitChild(Dirty, Child))
+			{
+				Child.UpdateSubdividedByOthers(Settings, Dirty);
+			}
+		});
 	}
 }
 
-void FVoxelRenderOctree::DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates)
+void FVoxelRenderOctree::DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates, const FVoxelRenderOctreeDirtyRegion& Dirty)
 {
 	CHECK_MAX_CHUNKS_COUNT();
 
@@ -392,16 +749,16 @@ void FVoxelRenderOctree::DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates)
 	{		
 		if (HasChildren())
 		{
-			for (auto& Child : GetChildren())
+			IterateChildren(ChunkUpdates, [&](FVoxelRenderOctree& Child, TArray<FVoxelChunkUpdate>& ChildChunkUpdates)
 			{
 				ensure(Child.ChunkSettings.DivisionType == EDivisionType::Uninitialized);
 				
-				Child.DeleteChunks(ChunkUpdates);
+				Child.DeleteChunks(ChildChunkUpdates, Dirty);
 				
 				if (Child.ChunkSettings.Settings.HasRenderChunk())
 				{
 					//ensureVoxelSlowNoSideEffects(!ChunkUpdates.FindByPredicate([&](const FVoxelChunkUpdate& ChunkUpdate) { return ChunkUpdate.Id == Child.ChunkId; }));
-					ChunkUpdates.Emplace(
+					ChildChunkUpdates.Emplace(
 						FVoxelChunkUpdate
 						{
 							Child.ChunkId,
@@ -412,16 +769,19 @@ void FVoxelRenderOctree::DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates)
 							{}
 						});
 				}
-			}
+			});
 			DestroyChildren();
 		}
 	}
 	else
 	{
-		for (auto& Child : GetChildren())
+		IterateChildren(ChunkUpdates, [&](FVoxelRenderOctree& Child, TArray<FVoxelChunkUpdate>& ChildChunkUpdates)
 		{
-			Child.DeleteChunks(ChunkUpdates);
-		}
+			if (ShouldVisitChild(Dirty, Child))
+			{
+				Child.DeleteChunks(ChildChunkUpdates, Dirty);
+			}
+		});
 	}
 }
 
@@ -431,13 +791,15 @@ void FVoxelRenderOctree::GetUpdates(
 	uint32 InUpdateIndex,
 	bool bRecomputeTransitionMasks,
 	const FVoxelRenderOctreeSettings& Settings,
+	const FVoxelRenderOctreeDirtyRegion& Dirty,
 	TArray<FVoxelChunkUpdate>& ChunkUpdates,
 	bool bInVisible)
 {
 	CHECK_MAX_CHUNKS_COUNT();
 
-	UpdateIndex++;
-	check(UpdateIndex == InUpdateIndex);
+	// Nodes skipped by incremental updates keep an older index
+	check(UpdateIndex < InUpdateIndex);
+	UpdateIndex = InUpdateIndex;
 
 	if (!OctreeBounds.Intersect(Settings.WorldBounds))
 	{
@@ -469,30 +831,29 @@ void FVoxelRenderOctree::GetUpdates(
 			bChildrenVisible = false;
 		}
 
-		for (auto& Child : GetChildren())
+		// If our division type changed, the children visibility might have changed too
+		const bool bVisitAllChildren = ChunkSettings.DivisionType != ChunkSettings.OldDivisionType;
+		const int32 LODMargin = bRecomputeTransitionMasks ? RENDER_OCTREE_TRANSITIONS_MARGIN : RENDER_OCTREE_STRUCTURE_MARGIN;
+		// Safe to do in parallel: the adjacent chunks used for the transitions are found using the division types, which are not modified here
+		IterateChildren(ChunkUpdates, [&](FVoxelRenderOctree& Child, TArray<FVoxelChunkUpdate>& ChildChunkUpdates)
 		{
-			Child.GetUpdates(UpdateIndex, bRecomputeTransitionMasks, Settings, ChunkUpdates, bChildrenVisible);
-		}
+			if (bVisitAllChildren || Child.IsDirty(Dirty, LODMargin))
+			{
+				Child.GetUpdates(UpdateIndex, bRecomputeTransitionMasks, Settings, Dirty, ChildChunkUpdates, bChildrenVisible);
+			}
+		});
 	}
 
 	NewSettings.bEnableCollisions =
 		Settings.bEnableCollisions &&
-		((Height == 0 &&
-			IsInvokerInRange(Settings.Invokers,
-				[](const FVoxelInvokerSettings& Invoker) { return Invoker.bUseForCollisions; },
-				[](const FVoxelInvokerSettings& Invoker) { return Invoker.CollisionsBounds; })
-		 )
+		((Height == 0 && Settings.CollisionsInvokersTree.Intersect(OctreeBounds))
 		 ||
 		 (NewSettings.bVisible && Settings.bComputeVisibleChunksCollisions && Height <= Settings.VisibleChunksCollisionsMaxLOD)
 	    );
 		
 	NewSettings.bEnableNavmesh = 
 		Settings.bEnableNavmesh &&
-		((Height == 0 &&
-			IsInvokerInRange(Settings.Invokers,
-				[](const FVoxelInvokerSettings& Invoker) { return Invoker.bUseForNavmesh; },
-				[](const FVoxelInvokerSettings& Invoker) { return Invoker.NavmeshBounds; })
-		)
+		((Height == 0 && Settings.NavmeshInvokersTree.Intersect(OctreeBounds))
 		||
 		(NewSettings.bVisible && Settings.bComputeVisibleChunksNavmesh && Height <= Settings.VisibleChunksNavmeshMaxLOD)
 		);
@@ -545,6 +906,8 @@ void FVoxelRenderOctree::GetUpdates(
 	}
 	
 	ChunkSettings.Settings = NewSettings;
+	// So that nodes skipped by the next incremental update are up to date
+	ChunkSettings.OldDivisionType = ChunkSettings.DivisionType;
 }
 
 void FVoxelRenderOctree::GetChunksToUpdateForBounds(const FVoxelIntBox& Bounds, TArray<uint64>& ChunksToUpdate, const FVoxelOnChunkUpdate& OnChunkUpdate) const
@@ -593,7 +956,7 @@ void FVoxelRenderOctree::GetVisibleChunksOverlappingBounds(const FVoxelIntBox& B
 
 FORCEINLINE bool FVoxelRenderOctree::IsCanceled() const
 {
-	return Root->CurrentChunksCount >= CVarMaxRenderOctreeChunks.GetValueOnAnyThread();
+	return Root->CurrentChunksCount.GetValue() >= CVarMaxRenderOctreeChunks.GetValueOnAnyThread();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -621,15 +984,7 @@ bool FVoxelRenderOctree::ShouldSubdivideByDistance(const FVoxelRenderOctreeSetti
 		return true;
 	}
 
-	for (auto& Invoker : Settings.Invokers)
-	{
-		if (Invoker.bUseForLOD && OctreeBounds.Intersect(Invoker.LODBounds) && Height > Invoker.LODToSet)
-		{
-			return true;
-		}
-	}
-
-	return false;
+	return Settings.LODInvokersTree.Intersect(OctreeBounds, Height);
 }
 
 
@@ -684,22 +1039,56 @@ bool FVoxelRenderOctree::ShouldSubdivideByOthers(const FVoxelRenderOctreeSetting
 		return false;
 	}
 
-	if (Settings.bEnableCollisions && IsInvokerInRange(Settings.Invokers,
-		[](const FVoxelInvokerSettings& Invoker) { return Invoker.bUseForCollisions; },
-		[](const FVoxelInvokerSettings& Invoker) { return Invoker.CollisionsBounds; }))
+	if (Settings.bEnableCollisions && Settings.CollisionsInvokersTree.Intersect(OctreeBounds))
 	{
 		return true;
 	}
-	if (Settings.bEnableNavmesh && IsInvokerInRange(Settings.Invokers,
-		[](const FVoxelInvokerSettings& Invoker) { return Invoker.bUseForNavmesh; },
-		[](const FVoxelInvokerSettings& Invoker) { return Invoker.NavmeshBounds; }))
+	if (Settings.bEnableNavmesh && Settings.NavmeshInvokersTree.Intersect(OctreeBounds))
+	{
+		return true;
+	}
+
+	return false;
+}
+
+bool FVoxelRenderOctree::IsDirty(const FVoxelRenderOctreeDirtyRegion& Dirty, int32 LODMargin) const
+{
+	if (Dirty.bAll)
 	{
 		return true;
 	}
 
+	for (const FVoxelIntBox& Bounds : Dirty.OthersBounds)
+	{
+		if (OctreeBounds.Intersect(Bounds))
+		{
+			return true;
+		}
+	}
+
+	// In int64, as the margin of the top nodes doesn't fit in an int32
+	const int64 Margin = int64(LODMargin) * Size();
+	for (const FVoxelIntBox& Bounds : Dirty.LODBounds)
+	{
+		if (OctreeBounds.Min.X - Margin < Bounds.Max.X && Bounds.Min.X < OctreeBounds.Max.X + Margin &&
+			OctreeBounds.Min.Y - Margin < Bounds.Max.Y && Bounds.Min.Y < OctreeBounds.Max.Y + Margin &&
+			OctreeBounds.Min.Z - Margin < Bounds.Max.Z && Bounds.Min.Z < OctreeBounds.Max.Z + Margin)
+		{
+			return true;
+		}
+	}
+
 	return false;
 }
 
+bool FVoxelRenderOctree::ShouldVisitChild(const FVoxelRenderOctreeDirtyRegion& Dirty, const FVoxelRenderOctree& Child) const
+{
+	// If we were not subdivided, our children were just created and need to be computed
+	return
+		ChunkSettings.OldDivisionType == EDivisionType::Uninitialized ||
+		Child.IsDirty(Dirty, RENDER_OCTREE_STRUCTURE_MARGIN);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 inline bool IsVisibleParent(const FVoxelRenderOctree* Chunk)
@@ -776,25 +1165,166 @@ const FVoxelRenderOctree* FVoxelRenderOctree::GetVisibleAdjacentChunk(EVoxelDire
 	}
 }
 
-template<typename T1, typename T2>
-bool FVoxelRenderOctree::IsInvokerInRange(const TArray<FVoxelInvokerSettings>& Invokers, T1 SelectInvoker, T2 GetInvokerBounds) const
+FORCEINLINE bool FVoxelRenderOctree::ShouldIterateChildrenInParallel() const
 {
-	for (auto& Invoker : Invokers)
+	return Root->bParallelBuild && Height + RENDER_OCTREE_PARALLEL_DEPTH > Root->Height;
+}
+
+template<typename T>
+FORCEINLINE void FVoxelRenderOctree::IterateChildren(T Lambda)
+{
+	ChildrenArray& Children = GetChildren();
+	if (ShouldIterateChildrenInParallel())
 	{
-		if (SelectInvoker(Invoker))
+		ParallelFor(8, [&](int32 ChildIndex)
 		{
-			if (OctreeBounds.Intersect(GetInvokerBounds(Invoker)))
-			{
-				return true;
-			}
+			VOXEL_ASYNC_SCOPE_COUNTER("Render Octree Subtree");
+			Lambda(ChildIndex, Children[ChildIndex]);
+		});
+	}
+	else
+	{
+		for (int32 ChildIndex = 0; ChildIndex < 8; ChildIndex++)
+		{
+			Lambda(ChildIndex, Children[ChildIndex]);
+		}
+	}
+}
+
+template<typename T>
+FORCEINLINE void FVoxelRenderOctree::IterateChildren(TArray<FVoxelChunkUpdate>& ChunkUpdates, T Lambda)
+{
+	ChildrenArray& Children = GetChildren();
+	if (ShouldIterateChildrenInParallel())
+	{
+		TArray<FVoxelChunkUpdate> ChildrenChunkUpdates[8];
+		ParallelFor(8, [&](int32 ChildIndex)
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Render Octree Subtree");
+			Lambda(Children[ChildIndex], ChildrenChunkUpdates[ChildIndex]);
+		});
+		for (TArray<FVoxelChunkUpdate>& ChildChunkUpdates : ChildrenChunkUpdates)
+		{
+			ChunkUpdates.Append(MoveTemp(ChildChunkUpdates));
+		}
+	}
+	else
+	{
+		for (FVoxelRenderOctree& Child : Children)
+		{
+			Lambda(Child, ChunkUpdates);
 		}
 	}
-	return false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 uint64 FVoxelRenderOctree::GetId()
 {
-	return ++Root->RootIdCounter;
-}
\ No newline at end of file
+	return Root->RootIdCounter.Increment();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Full render octree builds for an increasing number of synthetic invokers, single threaded and parallel
+static void BenchmarkRenderOctree(const TArray<FString>& Args)
+{
+	const int32 MaxNumInvokers = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 256;
+	const int32 LODRadius = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 128;
+	const int32 OctreeDepth = FVoxelUtilities::ClampDepth<RENDER_CHUNK_SIZE>(Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 12);
+	const int32 NumIterations = 3;
+
+	const FVoxelIntBox WorldBounds = FVoxelUtilities::GetBoundsFromDepth<RENDER_CHUNK_SIZE>(OctreeDepth);
+
+	LOG_VOXEL(Log, TEXT("Render octree benchmark: up to %d invokers, LOD 0 radius: %d voxels, octree depth: %d, %d worker threads"),
+		MaxNumInvokers,
+		LODRadius,
+		OctreeDepth,
+		FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+	TUniquePtr<FVoxelRenderOctreeAsyncBuilder, TVoxelAsyncWorkDelete<FVoxelRenderOctreeAsyncBuilder>> Builder(new FVoxelRenderOctreeAsyncBuilder(OctreeDepth, WorldBounds));
+
+	for (int32 NumInvokers = 1; ; NumInvokers = FMath::Min(4 * NumInvokers, MaxNumInvokers))
+	{
+		FVoxelRenderOctreeSettings Settings{};
+		Settings.MinLOD = 0;
+		Settings.MaxLOD = FVoxelUtilities::ClampMesherDepth(32);
+		Settings.WorldBounds = WorldBounds;
+		Settings.ChunksCullingLOD = FVoxelUtilities::ClampDepth<RENDER_CHUNK_SIZE>(32);
+		Settings.bEnableRender = true;
+		Settings.bEnableTransitions = true;
+		Settings.bInvertTransitions = false;
+		Settings.bEnableCollisions = true;
+		Settings.bComputeVisibleChunksCollisions = false;
+		Settings.VisibleChunksCollisionsMaxLOD = 0;
+		Settings.bEnableNavmesh = false;
+		Settings.bComputeVisibleChunksNavmesh = false;
+		Settings.VisibleChunksNavmeshMaxLOD = 0;
+
+		// Same seed for all the counts, so that the invokers of a run are a subset of the next ones
+		FRandomStream Stream(0);
+		const int32 Spread = WorldBounds.Size().X / 4;
+		for (int32 Index = 0; Index < NumInvokers; Index++)
+		{
+			const FIntVector Position(
+				Stream.RandRange(-Spread, Spread),
+				Stream.RandRange(-Spread, Spread),
+				Stream.RandRange(-Spread, Spread));
+
+			FVoxelInvokerSettings& Invoker = Settings.Invokers.Emplace_GetRef();
+			Invoker.bUseForLOD = true;
+			Invoker.LODToSet = 0;
+			Invoker.LODBounds = FVoxelIntBox(Position - LODRadius, Position + LODRadius);
+			Invoker.bUseForCollisions = true;
+			Invoker.CollisionsBounds = FVoxelIntBox(Position - LODRadius / 2, Position + LODRadius / 2);
+		}
+
+		double Times[2];
+		int32 NumChunks = 0;
+		for (int32 Parallel = 0; Parallel < 2; Parallel++)
+		{
+			Settings.bParallelBuild = Parallel != 0;
+
+			double TotalTime = 0;
+			for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+			{
+				// Full build every time
+				Builder->Init(Settings, nullptr);
+
+				const double StartTime = FPlatformTime::Seconds();
+				Builder->DoThreadedWork();
+				TotalTime += FPlatformTime::Seconds() - StartTime;
+
+				if (!Builder->NewOctree.IsValid())
+				{
+					LOG_VOXEL(Warning, TEXT("Render octree benchmark stopped: more than voxel.renderer.MaxRenderOctreeChunks chunks"));
+					return;
+				}
+				NumChunks = Builder->NewOctree->CurrentChunksCount.GetValue();
+
+				// Outside of the timings
+				Builder->NewOctree.Reset();
+			}
+			Times[Parallel] = TotalTime / NumIterations;
+		}
+
+		LOG_VOXEL(Log, TEXT("%5d invokers: %8d nodes; single threaded: %9.2fms; parallel: %9.2fms; speedup: x%.2f"),
+			NumInvokers,
+			NumChunks,
+			Times[0] * 1000,
+			Times[1] * 1000,
+			Times[0] / FMath::Max(Times[1], 1e-9));
+
+		if (NumInvokers == MaxNumInvokers)
+		{
+			break;
+		}
+	}
+}
+
+static FAutoConsoleCommand BenchmarkRenderOctreeCmd(
+	TEXT("voxel.renderer.BenchmarkRenderOctree"),
+	TEXT("Measure the render octree build times for an increasing number of synthetic invokers. Args: [MaxNumInvokers=256] [LODRadius=128] [OctreeDepth=12]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkRenderOctree));
@@ -10,6 +10,7 @@
 #include "VoxelAsyncWork.h"
 #include "VoxelInvokerSettings.h"
 #include "VoxelRender/VoxelChunkToUpdate.h"
+#include "VoxelRender/LODManager/VoxelInvokerBoundsTree.h"
 
 #include "HAL/ThreadSafeBool.h"
 
@@ -41,6 +42,32 @@ struct FVoxelRenderOctreeSettings
 	bool bEnableNavmesh;
 	bool bComputeVisibleChunksNavmesh;
 	int32 VisibleChunksNavmeshMaxLOD;
+
+	// If true, the subtrees of the top nodes are processed in parallel
+	bool bParallelBuild;
+
+	// Built from Invokers by BuildInvokersTrees, to test the invokers ranges
+	FVoxelInvokerBoundsTree LODInvokersTree;
+	FVoxelInvokerBoundsTree CollisionsInvokersTree;
+	FVoxelInvokerBoundsTree NavmeshInvokersTree;
+
+	void BuildInvokersTrees();
+};
+
+/**
+ * Parts of the world in which the render octree can change between two builds, used by incremental builds
+ * Computed from the invokers bounds that changed: nodes far enough from them keep their previous state and are skipped
+ */
+struct FVoxelRenderOctreeDirtyRegion
+{
+	// If true, the whole octree is rebuilt
+	bool bAll = true;
+	// Parts of the invokers LOD bounds that were added or removed
+	TArray<FVoxelIntBox> LODBounds;
+	// Parts of the invokers collisions & navmesh bounds that were added or removed
+	TArray<FVoxelIntBox> OthersBounds;
+
+	static FVoxelRenderOctreeDirtyRegion Compute(const FVoxelRenderOctreeSettings& OldSettings, const FVoxelRenderOctreeSettings& NewSettings);
 };
 
 class FVoxelRenderOctreeAsyncBuilder : public FVoxelAsyncWork
@@ -72,12 +99,22 @@ private:
 	virtual uint32 GetPriority() const override;
 	//~ End FVoxelAsyncWork Interface
 
+	// Clone OldOctree and update it
+	TVoxelSharedRef<FVoxelRenderOctree> BuildOctree(const FVoxelRenderOctreeDirtyRegion& DirtyRegion, TArray<FVoxelChunkUpdate>& OutChunkUpdates);
+	// Run a full build and check that it gives the same updates as the incremental one. Uses the full build if not
+	void CompareWithFullBuild(double IncrementalBuildTime);
+
 private:
 	const uint8 OctreeDepth;
 	const FVoxelIntBox WorldBounds;
 
 	FVoxelRenderOctreeSettings OctreeSettings{};
 
+	// Settings of the last octree we built, to find what changed since
+	bool bHasLastOctreeSettings = false;
+	uint64 LastOctreeUpdateIndex = 0;
+	FVoxelRenderOctreeSettings LastOctreeSettings{};
+
 	bool bTooManyChunks = false;
 	double Counter = 0;
 	FString Log;
@@ -88,7 +125,8 @@ class FVoxelRenderOctree : public TSimpleVoxelOctree<RENDER_CHUNK_SIZE, FVoxelRe
 {
 private:
 	// Important: must be the first variable to be initialized, else GetId does the wrong thing for the root!
-	uint64 RootIdCounter = 0;
+	// Atomic as nodes can be created from several threads by parallel builds
+	FThreadSafeCounter64 RootIdCounter;
 	
 public:
 	FVoxelRenderOctree* const Root;
@@ -110,8 +148,10 @@ public:
 		EDivisionType OldDivisionType = EDivisionType::Uninitialized;
 	}; 
 	FChunkSettings ChunkSettings;
-	int32 CurrentChunksCount = 0;
+	FThreadSafeCounter CurrentChunksCount;
 	uint64 UpdateIndex = 0;
+	// Only used on the root
+	bool bParallelBuild = false;
 
 	inline const FVoxelChunkSettings& GetSettings() const { return ChunkSettings.Settings; }
 
@@ -123,17 +163,19 @@ public:
 
 	~FVoxelRenderOctree();
 
-	void ResetDivisionType();
-	bool UpdateSubdividedByDistance(const FVoxelRenderOctreeSettings& Settings);
-	bool UpdateSubdividedByNeighbors(const FVoxelRenderOctreeSettings& Settings);
-	void ReuseOldNeighbors();
-	void UpdateSubdividedByOthers(const FVoxelRenderOctreeSettings& Settings);
-	void DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates);
+	// Nodes outside of the dirty region keep their previous state and are skipped
+	void ResetDivisionType(const FVoxelRenderOctreeDirtyRegion& Dirty);
+	bool UpdateSubdividedByDistance(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty);
+	bool UpdateSubdividedByNeighbors(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty);
+	void ReuseOldNeighbors(const FVoxelRenderOctreeDirtyRegion& Dirty);
+	void UpdateSubdividedByOthers(const FVoxelRenderOctreeSettings& Settings, const FVoxelRenderOctreeDirtyRegion& Dirty);
+	void DeleteChunks(TArray<FVoxelChunkUpdate>& ChunkUpdates, const FVoxelRenderOctreeDirtyRegion& Dirty);
 
 	void GetUpdates(
 		uint32 InUpdateIndex,
 		bool bRecomputeTransitionMasks,
 		const FVoxelRenderOctreeSettings& Settings, 
+		const FVoxelRenderOctreeDirtyRegion& Dirty,
 		TArray<FVoxelChunkUpdate>& ChunkUpdates, 
 		bool bVisible = true);
 
@@ -146,11 +188,20 @@ private:
 	bool ShouldSubdivideByDistance(const FVoxelRenderOctreeSettings& Settings) const;
 	bool ShouldSubdivideByNeighbors(const FVoxelRenderOctreeSettings& Settings) const;
 	bool ShouldSubdivideByOthers(const FVoxelRenderOctreeSettings& Settings) const;
+
+	// Whether this node can be different from the previous build. LODMargin is in multiples of the node size
+	bool IsDirty(const FVoxelRenderOctreeDirtyRegion& Dirty, int32 LODMargin) const;
+	bool ShouldVisitChild(const FVoxelRenderOctreeDirtyRegion& Dirty, const FVoxelRenderOctree& Child) const;
 	
 	const FVoxelRenderOctree* GetVisibleAdjacentChunk(EVoxelDirectionFlag::Type Direction, int32 Index) const;
 
-	template<typename T1, typename T2>
-	bool IsInvokerInRange(const TArray<FVoxelInvokerSettings>& Invokers, T1 SelectInvoker, T2 GetInvokerBounds) const;
+	bool ShouldIterateChildrenInParallel() const;
+	// Lambda(ChildIndex, Child). Each child must only write to its own subtree
+	template<typename T>
+	void IterateChildren(T Lambda);
+	// Lambda(Child, ChildChunkUpdates). The chunk updates are appended in the children order, so that the result doesn't depend on the threads
+	template<typename T>
+	void IterateChildren(TArray<FVoxelChunkUpdate>& ChunkUpdates, T Lambda);
 
 	uint64 GetId();
 };
\ No newline at end of file
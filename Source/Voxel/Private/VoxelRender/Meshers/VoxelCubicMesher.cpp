@@ -69,7 +69,9 @@ template<EVoxelDirectionFlag::Type Direction, typename TVertex, typename TMesher
 FORCEINLINE void AddFace(
 	TMesher& Mesher, int32 Step, FVoxelMaterial Material, 
 	int32 X, int32 Y, int32 Z, 
-	TArray<uint32>& Indices, TArray<TVertex>& Vertices)
+	TArray<uint32>& Indices, TArray<TVertex>& Vertices,
+	// Size of the quad in voxels, when merging faces. Must be 1 along the face normal
+	const FIntVector& QuadSize = FIntVector(1))
 {
 	if (TVertex::bComputeMaterial && Mesher.Settings.bOneMaterialPerCubeSide)
 	{
@@ -162,8 +164,8 @@ FORCEINLINE void AddFace(
 	int32 PositionsIndices[4];
 	for (int32 Index = 0; Index < 4; Index++)
 	{
-		const FVector VertexPositionInCube = Positions[Index];
-		const FVector VertexPosition = (VertexPositionInCube + FVector(X, Y, Z)) * Step - FVector(0.5f);
+		const FVector VertexPositionInQuad = Positions[Index] * FVector(QuadSize);
+		const FVector VertexPosition = (VertexPositionInQuad + FVector(X, Y, Z)) * Step - FVector(0.5f);
 		
 		TVertex Vertex;
 		Vertex.SetPosition(VertexPosition);
@@ -204,12 +206,14 @@ FORCEINLINE void AddFace(
 			}
 			else if (Mesher.Settings.UVConfig == EVoxelUVConfig::PackWorldUpInUVs)
 			{
-				TextureCoordinate = FVoxelMesherUtilities::GetUVs(Mesher, FVector(X, Y, Z));
+				// Center of the quad
+				TextureCoordinate = FVoxelMesherUtilities::GetUVs(Mesher, FVector(X, Y, Z) + FVector(QuadSize - FIntVector(1)) / 2);
 			}
 			else
 			{
 				check(Mesher.Settings.UVConfig == EVoxelUVConfig::PerVoxelUVs);
-				const auto& V = VertexPositionInCube;
+				// Tiled on merged quads
+				const auto& V = VertexPositionInQuad;
 				switch (Direction)
 				{
 				case EVoxelDirectionFlag::XMin:
@@ -266,8 +270,10 @@ FVoxelIntBox FVoxelCubicMesher::GetBoundsToLock() const
 
 TVoxelSharedPtr<FVoxelChunkMesh> FVoxelCubicMesher::CreateFullChunkImpl(FVoxelMesherTimes& Times)
 {
-	TArray<FVoxelCubicFullVertex> Vertices;
-	TArray<uint32> Indices;
+	TArray<FVoxelCubicFullVertex>& Vertices = reinterpret_cast<TArray<FVoxelCubicFullVertex>&>(Scratch.Vertices);
+	TArray<uint32>& Indices = Scratch.Indices;
+	Vertices.Reset();
+	Indices.Reset();
 
 	CreateGeometryTemplate(Times, Indices, Vertices);
 
@@ -276,8 +282,8 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelCubicMesher::CreateFullChunkImpl(FVoxelMe
 	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(
 		Settings,
 		LOD,
-		MoveTemp(Indices),
-		MoveTemp(reinterpret_cast<TArray<FVoxelMesherVertex>&>(Vertices))));
+		Indices,
+		Scratch.Vertices));
 }
 
 
@@ -301,6 +307,12 @@ void FVoxelCubicMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TArray<
 
 	TVoxelQueryZone<FVoxelValue> QueryZone(GetBoundsToCheckIsEmptyOn(), FIntVector(CUBIC_CHUNK_SIZE_WITH_NEIGHBORS), LOD, CachedValues);
 	MESHER_TIME_VALUES(CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS, Data.Get<FVoxelValue>(QueryZone, LOD));
+
+	if (Settings.bGreedyCubicMeshing)
+	{
+		CreateGreedyGeometry(Times, Indices, Vertices);
+		return;
+	}
 	
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("Iteration");
@@ -347,6 +359,167 @@ void FVoxelCubicMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TArray<
 	}
 }
 
+template<typename T>
+void FVoxelCubicMesher::CreateGreedyGeometry(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<T>& Vertices)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	FVoxelCubicMesherBuffers& Buffers = Scratch.GetCubicBuffers();
+	
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Find Faces");
+		for (int32 Z = 0; Z < RENDER_CHUNK_SIZE; Z++)
+		{
+			for (int32 Y = 0; Y < RENDER_CHUNK_SIZE; Y++)
+			{
+				for (int32 X = 0; X < RENDER_CHUNK_SIZE; X++)
+				{
+					const int32 Index = X + Y * RENDER_CHUNK_SIZE + Z * RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE;
+					
+					uint8 Flag = 0;
+					if (!GetValue(X, Y, Z).IsEmpty())
+					{
+						Flag =
+							(GetValue(X - 1, Y, Z).IsEmpty() << 0) |
+							(GetValue(X + 1, Y, Z).IsEmpty() << 1) |
+							(GetValue(X, Y - 1, Z).IsEmpty() << 2) |
+							(GetValue(X, Y + 1, Z).IsEmpty() << 3) |
+							(GetValue(X, Y, Z - 1).IsEmpty() << 4) |
+							(GetValue(X, Y, Z + 1).IsEmpty() << 5);
+					}
+					Buffers.FaceFlags[Index] = Flag;
+
+					if (T::bComputeMaterial && Flag)
+					{
+						Buffers.Materials[Index] = MESHER_TIME_RETURN_MATERIALS(1, Accelerator->GetMaterial(
+							X + ChunkPosition.X,
+							Y + ChunkPosition.Y,
+							Z + ChunkPosition.Z,
+							LOD));
+					}
+				}
+			}
+		}
+	}
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Merge Faces");
+		MergeFacesForDirection<EVoxelDirectionFlag::XMin>(Indices, Vertices);
+		MergeFacesForDirection<EVoxelDirectionFlag::XMax>(Indices, Vertices);
+		MergeFacesForDirection<EVoxelDirectionFlag::YMin>(Indices, Vertices);
+		MergeFacesForDirection<EVoxelDirectionFlag::YMax>(Indices, Vertices);
+		MergeFacesForDirection<EVoxelDirectionFlag::ZMin>(Indices, Vertices);
+		MergeFacesForDirection<EVoxelDirectionFlag::ZMax>(Indices, Vertices);
+	}
+}
+
+template<EVoxelDirectionFlag::Type Direction, typename T>
+void FVoxelCubicMesher::MergeFacesForDirection(TArray<uint32>& Indices, TArray<T>& Vertices)
+{
+	FVoxelCubicMesherBuffers& Buffers = Scratch.GetCubicBuffers();
+	
+	// Faces are merged in slices orthogonal to the normal
+	constexpr int32 NormalAxis =
+		Direction == EVoxelDirectionFlag::XMin || Direction == EVoxelDirectionFlag::XMax
+		? 0
+		: Direction == EVoxelDirectionFlag::YMin || Direction == EVoxelDirectionFlag::YMax
+		? 1
+		: 2;
+	constexpr int32 AxisU = NormalAxis == 0 ? 1 : 0;
+	constexpr int32 AxisV = NormalAxis == 2 ? 1 : 2;
+
+	const auto GetVoxelIndex = [&](int32 Slice, int32 U, int32 V)
+	{
+		FIntVector Position;
+		Position[NormalAxis] = Slice;
+		Position[AxisU] = U;
+		Position[AxisV] = V;
+		return Position.X + Position.Y * RENDER_CHUNK_SIZE + Position.Z * RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE;
+	};
+
+	bool* RESTRICT const SliceMask = Buffers.SliceMask.GetData();
+
+	for (int32 Slice = 0; Slice < RENDER_CHUNK_SIZE; Slice++)
+	{
+		bool bHasFaces = false;
+		for (int32 V = 0; V < RENDER_CHUNK_SIZE; V++)
+		{
+			for (int32 U = 0; U < RENDER_CHUNK_SIZE; U++)
+			{
+				const bool bHasFace = Buffers.FaceFlags[GetVoxelIndex(Slice, U, V)] & Direction;
+				SliceMask[U + V * RENDER_CHUNK_SIZE] = bHasFace;
+				bHasFaces |= bHasFace;
+			}
+		}
+		if (!bHasFaces)
+		{
+			continue;
+		}
+
+		for (int32 V = 0; V < RENDER_CHUNK_SIZE; V++)
+		{
+			for (int32 U = 0; U < RENDER_CHUNK_SIZE;)
+			{
+				if (!SliceMask[U + V * RENDER_CHUNK_SIZE])
+				{
+					U++;
+					continue;
+				}
+
+				const FVoxelMaterial Material = T::bComputeMaterial ? Buffers.Materials[GetVoxelIndex(Slice, U, V)] : FVoxelMaterial();
+				const auto CanMerge = [&](int32 OtherU, int32 OtherV)
+				{
+					return
+						SliceMask[OtherU + OtherV * RENDER_CHUNK_SIZE] &&
+						(!T::bComputeMaterial || Buffers.Materials[GetVoxelIndex(Slice, OtherU, OtherV)] == Material);
+				};
+
+				int32 Width = 1;
+				while (U + Width < RENDER_CHUNK_SIZE && CanMerge(U + Width, V))
+				{
+					Width++;
+				}
+
+				int32 Height = 1;
+				while (V + Height < RENDER_CHUNK_SIZE)
+				{
+					bool bCanMergeRow = true;
+					for (int32 Offset = 0; Offset < Width && bCanMergeRow; Offset++)
+					{
+						bCanMergeRow = CanMerge(U + Offset, V + Height);
+					}
+					if (!bCanMergeRow)
+					{
+						break;
+					}
+					Height++;
+				}
+
+				for (int32 OffsetV = 0; OffsetV < Height; OffsetV++)
+				{
+					for (int32 OffsetU = 0; OffsetU < Width; OffsetU++)
+					{
+						SliceMask[(U + OffsetU) + (V + OffsetV) * RENDER_CHUNK_SIZE] = false;
+					}
+				}
+
+				FIntVector Position;
+				Position[NormalAxis] = Slice;
+				Position[AxisU] = U;
+				Position[AxisV] = V;
+
+				FIntVector QuadSize(1);
+				QuadSize[AxisU] = Width;
+				QuadSize[AxisV] = Height;
+
+				AddFace<Direction>(*this, Step, Material, Position.X, Position.Y, Position.Z, Indices, Vertices, QuadSize);
+
+				U += Width;
+			}
+		}
+	}
+}
+
 FORCEINLINE FVoxelValue FVoxelCubicMesher::GetValue(int32 X, int32 Y, int32 Z) const
 {
 	checkVoxelSlow(
@@ -381,8 +554,10 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelCubicTransitionsMesher::CreateFullChunkIm
 {
 	Accelerator = MakeUnique<FVoxelConstDataAccelerator>(Data, GetBoundsToLock());
 
-	TArray<FVoxelCubicFullVertex> Vertices;
-	TArray<uint32> Indices;
+	TArray<FVoxelCubicFullVertex>& Vertices = reinterpret_cast<TArray<FVoxelCubicFullVertex>&>(Scratch.Vertices);
+	TArray<uint32>& Indices = Scratch.Indices;
+	Vertices.Reset();
+	Indices.Reset();
 
 	CreateTransitionsForDirection<EVoxelDirectionFlag::XMin>(Times, Indices, Vertices);
 	CreateTransitionsForDirection<EVoxelDirectionFlag::XMax>(Times, Indices, Vertices);
@@ -396,8 +571,8 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelCubicTransitionsMesher::CreateFullChunkIm
 	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(
 		Settings,
 		LOD,
-		MoveTemp(Indices),
-		MoveTemp(reinterpret_cast<TArray<FVoxelMesherVertex>&>(Vertices))));
+		Indices,
+		Scratch.Vertices));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
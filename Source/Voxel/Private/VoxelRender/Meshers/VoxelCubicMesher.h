@@ -7,9 +7,23 @@
 #include "VoxelContainers/VoxelStaticArray.h"
 #include "VoxelData/VoxelDataAccelerator.h"
 #include "VoxelRender/Meshers/VoxelMesher.h"
+#include "VoxelRender/Meshers/VoxelMesherScratch.h"
 
 #define CUBIC_CHUNK_SIZE_WITH_NEIGHBORS (RENDER_CHUNK_SIZE + 2)
 
+// Stored in a FVoxelMesherScratch
+struct FVoxelCubicMesherBuffers
+{
+	TVoxelStaticArray<FVoxelValue, CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS> CachedValues;
+
+	// Greedy meshing only
+	// Visible faces of each voxel as EVoxelDirectionFlags, and the material of the voxels with at least one visible face
+	TVoxelStaticArray<uint8, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE> FaceFlags;
+	TVoxelStaticArray<FVoxelMaterial, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE> Materials;
+	// Faces of the slice being merged
+	TVoxelStaticArray<bool, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE> SliceMask;
+};
+
 class FVoxelCubicMesher : public FVoxelMesher
 {
 public:
@@ -23,11 +37,15 @@ protected:
 	
 private:
 	TUniquePtr<FVoxelConstDataAccelerator> Accelerator;
-	TVoxelStaticArray<FVoxelValue, CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS * CUBIC_CHUNK_SIZE_WITH_NEIGHBORS> CachedValues;
+	FVoxelValue* RESTRICT const CachedValues = Scratch.GetCubicBuffers().CachedValues.GetData();
 
 private:
 	template<typename T>
 	void CreateGeometryTemplate(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<T>& Vertices);
+	template<typename T>
+	void CreateGreedyGeometry(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<T>& Vertices);
+	template<EVoxelDirectionFlag::Type Direction, typename T>
+	void MergeFacesForDirection(TArray<uint32>& Indices, TArray<T>& Vertices);
 
 private:
 	FVoxelValue GetValue(int32 X, int32 Y, int32 Z) const;
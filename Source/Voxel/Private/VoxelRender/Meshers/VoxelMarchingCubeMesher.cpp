@@ -2,10 +2,12 @@
 
 #include "VoxelRender/Meshers/VoxelMarchingCubeMesher.h"
 #include "VoxelRender/Meshers/VoxelMesherUtilities.h"
+#include "VoxelRender/Meshers/VoxelMesherChunkCache.h"
 #include "VoxelRender/IVoxelRenderer.h"
 #include "VoxelData/VoxelDataIncludes.h"
 #include "Transvoxel.h"
 #include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
 
 #define checkError(x) if(!(x)) { return false; }
 
@@ -21,23 +23,60 @@ static TAutoConsoleVariable<int32> CVarRandomizeTangents(
 	TEXT("If true, will randomize voxel tangents to help debug materials that should not be using them"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarParallelVertexPasses(
+	TEXT("voxel.mesher.ParallelVertexPasses"),
+	1,
+	TEXT("Split the per vertex passes of a chunk (materials, normals, UVs) across worker threads. 0: never. 1: only for high priority chunks, eg LOD 0 chunks being edited. 2: always"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarParallelVertexPassesBatchSize(
+	TEXT("voxel.mesher.ParallelVertexPassesBatchSize"),
+	2048,
+	TEXT("Number of vertices processed by each worker thread when splitting the per vertex passes of a chunk"),
+	ECVF_Default);
+
 class FMarchingCubeHelpers
 {
 public:
 	template<typename T>
-	static TArray<FVoxelMesherVertex> CreateMesherVertices(TArray<T>& Vertices)
+	static void CreateMesherVertices(TArray<FVoxelMesherVertex>& MesherVertices, TArray<T>& Vertices)
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 
-		TArray<FVoxelMesherVertex> MesherVertices;
-		MesherVertices.SetNumUninitialized(Vertices.Num());
+		MesherVertices.SetNumUninitialized(Vertices.Num(), UE_505_SWITCH(false, EAllowShrinking::No));
 		for (int32 Index = 0; Index < Vertices.Num(); Index++)
 		{
 			auto& Vertex = Vertices[Index];
 			auto& MesherVertex = MesherVertices[Index];
 			MesherVertex.Position = Vertex.Position;
 		}
-		return MesherVertices;
+	}
+
+	// Calls Lambda(StartIndex, EndIndex, Accelerator) on ranges covering [0, Num)
+	// For high priority chunks, the ranges are processed by worker threads: accelerators aren't thread safe,
+	// so each range gets its own, sharing the accelerator map of the mesher
+	template<typename TMesher, typename TLambda>
+	static void IterateVertices(TMesher& Mesher, int32 Num, TLambda&& Lambda)
+	{
+		const int32 Mode = CVarParallelVertexPasses.GetValueOnAnyThread();
+		const int32 BatchSize = FMath::Max(1, CVarParallelVertexPassesBatchSize.GetValueOnAnyThread());
+		const int32 NumBatches = FMath::DivideAndRoundUp(Num, BatchSize);
+
+		if (NumBatches <= 1 || Mode == 0 || (Mode == 1 && !Mesher.bHighPriority))
+		{
+			Lambda(0, Num, *Mesher.Accelerator);
+			return;
+		}
+
+		ParallelFor(NumBatches, [&](int32 BatchIndex)
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("IterateVertices Batch");
+
+			const int32 StartIndex = BatchIndex * BatchSize;
+			const int32 EndIndex = FMath::Min(StartIndex + BatchSize, Num);
+			const FVoxelConstDataAccelerator BatchAccelerator(Mesher.Data, Mesher.Accelerator->Bounds, Mesher.Accelerator.Get());
+			Lambda(StartIndex, EndIndex, BatchAccelerator);
+		});
 	}
 	
 	template<typename T, typename TMesher>
@@ -45,82 +84,85 @@ public:
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 	
-		const auto GetMaterial = [&](const FIntVector& P)
-		{
-			return Mesher.Accelerator->GetMaterial(
-				P.X + Mesher.ChunkPosition.X,
-				P.Y + Mesher.ChunkPosition.Y, 
-				P.Z + Mesher.ChunkPosition.Z, 
-				Mesher.LOD);
-		};
-		if (Mesher.Settings.bInterpolateColors || Mesher.Settings.bInterpolateUVs)
+		IterateVertices(Mesher, Vertices.Num(), [&](int32 StartIndex, int32 EndIndex, const FVoxelConstDataAccelerator& Accelerator)
 		{
-			for (int32 Index = 0; Index < Vertices.Num(); Index++)
+			const auto GetMaterial = [&](const FIntVector& P)
 			{
-				auto& Vertex = Vertices[Index];
-				auto& MesherVertex = MesherVertices[Index];
-
-				const auto PositionA = FVoxelUtilities::FloorToInt(MesherVertex.Position);
-				const auto PositionB = FVoxelUtilities::CeilToInt(MesherVertex.Position);
-
-				const auto MaterialA = GetMaterial(PositionA);
-				const auto MaterialB = GetMaterial(PositionB);
-				
-				ensureVoxelSlowNoSideEffects(Vertex.MaterialPosition == PositionA || Vertex.MaterialPosition == PositionB);
-				MesherVertex.Material = Vertex.MaterialPosition == PositionA ? MaterialA : MaterialB;
-				
-				const FVector Difference = MesherVertex.Position - FVector(PositionA);
-				const float Alpha = Difference.X + Difference.Y + Difference.Z;
-				ensureVoxelSlowNoSideEffects(0 <= Alpha && Alpha <= 1);
-
-				if (Mesher.Settings.bInterpolateUVs)
-				{
-					if (Mesher.Settings.MaterialConfig != EVoxelMaterialConfig::MultiIndex)
-					{
-						MesherVertex.Material.SetU0_AsFloat(FMath::Lerp(MaterialA.GetU0_AsFloat(), MaterialB.GetU0_AsFloat(), Alpha));
-						MesherVertex.Material.SetV0_AsFloat(FMath::Lerp(MaterialA.GetV0_AsFloat(), MaterialB.GetV0_AsFloat(), Alpha));
-						MesherVertex.Material.SetU1_AsFloat(FMath::Lerp(MaterialA.GetU1_AsFloat(), MaterialB.GetU1_AsFloat(), Alpha));
-						MesherVertex.Material.SetV1_AsFloat(FMath::Lerp(MaterialA.GetV1_AsFloat(), MaterialB.GetV1_AsFloat(), Alpha));
-					}
-					MesherVertex.Material.SetU2_AsFloat(FMath::Lerp(MaterialA.GetU2_AsFloat(), MaterialB.GetU2_AsFloat(), Alpha));
-					MesherVertex.Material.SetV2_AsFloat(FMath::Lerp(MaterialA.GetV2_AsFloat(), MaterialB.GetV2_AsFloat(), Alpha));
-					MesherVertex.Material.SetU3_AsFloat(FMath::Lerp(MaterialA.GetU3_AsFloat(), MaterialB.GetU3_AsFloat(), Alpha));
-					MesherVertex.Material.SetV3_AsFloat(FMath::Lerp(MaterialA.GetV3_AsFloat(), MaterialB.GetV3_AsFloat(), Alpha));
-				}
-				
-				if (Mesher.Settings.bInterpolateColors)
+				return Accelerator.GetMaterial(
+					P.X + Mesher.ChunkPosition.X,
+					P.Y + Mesher.ChunkPosition.Y, 
+					P.Z + Mesher.ChunkPosition.Z, 
+					Mesher.LOD);
+			};
+			if (Mesher.Settings.bInterpolateColors || Mesher.Settings.bInterpolateUVs)
+			{
+				for (int32 Index = StartIndex; Index < EndIndex; Index++)
 				{
-					if (Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::RGB)
-					{
-						MesherVertex.Material.SetColor(FMath::Lerp(MaterialA.GetLinearColor(), MaterialB.GetLinearColor(), Alpha));
-					}
-					else if (Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::SingleIndex)
+					auto& Vertex = Vertices[Index];
+					auto& MesherVertex = MesherVertices[Index];
+
+					const auto PositionA = FVoxelUtilities::FloorToInt(MesherVertex.Position);
+					const auto PositionB = FVoxelUtilities::CeilToInt(MesherVertex.Position);
+
+					const auto MaterialA = GetMaterial(PositionA);
+					const auto MaterialB = GetMaterial(PositionB);
+					
+					ensureVoxelSlowNoSideEffects(Vertex.MaterialPosition == PositionA || Vertex.MaterialPosition == PositionB);
+					MesherVertex.Material = Vertex.MaterialPosition == PositionA ? MaterialA : MaterialB;
+					
+					const FVector Difference = MesherVertex.Position - FVector(PositionA);
+					const float Alpha = Difference.X + Difference.Y + Difference.Z;
+					ensureVoxelSlowNoSideEffects(0 <= Alpha && Alpha <= 1);
+
+					if (Mesher.Settings.bInterpolateUVs)
 					{
-						MesherVertex.Material.SetR_AsFloat(FMath::Lerp(MaterialA.GetR_AsFloat(), MaterialB.GetR_AsFloat(), Alpha));
-						MesherVertex.Material.SetG_AsFloat(FMath::Lerp(MaterialA.GetG_AsFloat(), MaterialB.GetG_AsFloat(), Alpha));
-						MesherVertex.Material.SetB_AsFloat(FMath::Lerp(MaterialA.GetB_AsFloat(), MaterialB.GetB_AsFloat(), Alpha));
+						if (Mesher.Settings.MaterialConfig != EVoxelMaterialConfig::MultiIndex)
+						{
+							MesherVertex.Material.SetU0_AsFloat(FMath::Lerp(MaterialA.GetU0_AsFloat(), MaterialB.GetU0_AsFloat(), Alpha));
+							MesherVertex.Material.SetV0_AsFloat(FMath::Lerp(MaterialA.GetV0_AsFloat(), MaterialB.GetV0_AsFloat(), Alpha));
+							MesherVertex.Material.SetU1_AsFloat(FMath::Lerp(MaterialA.GetU1_AsFloat(), MaterialB.GetU1_AsFloat(), Alpha));
+							MesherVertex.Material.SetV1_AsFloat(FMath::Lerp(MaterialA.GetV1_AsFloat(), MaterialB.GetV1_AsFloat(), Alpha));
+						}
+						MesherVertex.Material.SetU2_AsFloat(FMath::Lerp(MaterialA.GetU2_AsFloat(), MaterialB.GetU2_AsFloat(), Alpha));
+						MesherVertex.Material.SetV2_AsFloat(FMath::Lerp(MaterialA.GetV2_AsFloat(), MaterialB.GetV2_AsFloat(), Alpha));
+						MesherVertex.Material.SetU3_AsFloat(FMath::Lerp(MaterialA.GetU3_AsFloat(), MaterialB.GetU3_AsFloat(), Alpha));
+						MesherVertex.Material.SetV3_AsFloat(FMath::Lerp(MaterialA.GetV3_AsFloat(), MaterialB.GetV3_AsFloat(), Alpha));
 					}
-					else
+					
+					if (Mesher.Settings.bInterpolateColors)
 					{
-						checkVoxelSlow(Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::MultiIndex);
-						MesherVertex.Material.SetMultiIndex_Blend0_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend0_AsFloat(), MaterialB.GetMultiIndex_Blend0_AsFloat(), Alpha));
-						MesherVertex.Material.SetMultiIndex_Blend1_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend1_AsFloat(), MaterialB.GetMultiIndex_Blend1_AsFloat(), Alpha));
-						MesherVertex.Material.SetMultiIndex_Blend2_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend2_AsFloat(), MaterialB.GetMultiIndex_Blend2_AsFloat(), Alpha));
-						MesherVertex.Material.SetMultiIndex_Wetness_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Wetness_AsFloat(), MaterialB.GetMultiIndex_Wetness_AsFloat(), Alpha));
+						if (Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::RGB)
+						{
+							MesherVertex.Material.SetColor(FMath::Lerp(MaterialA.GetLinearColor(), MaterialB.GetLinearColor(), Alpha));
+						}
+						else if (Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::SingleIndex)
+						{
+							MesherVertex.Material.SetR_AsFloat(FMath::Lerp(MaterialA.GetR_AsFloat(), MaterialB.GetR_AsFloat(), Alpha));
+							MesherVertex.Material.SetG_AsFloat(FMath::Lerp(MaterialA.GetG_AsFloat(), MaterialB.GetG_AsFloat(), Alpha));
+							MesherVertex.Material.SetB_AsFloat(FMath::Lerp(MaterialA.GetB_AsFloat(), MaterialB.GetB_AsFloat(), Alpha));
+						}
+						else
+						{
+							checkVoxelSlow(Mesher.Settings.MaterialConfig == EVoxelMaterialConfig::MultiIndex);
+							MesherVertex.Material.SetMultiIndex_Blend0_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend0_AsFloat(), MaterialB.GetMultiIndex_Blend0_AsFloat(), Alpha));
+							MesherVertex.Material.SetMultiIndex_Blend1_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend1_AsFloat(), MaterialB.GetMultiIndex_Blend1_AsFloat(), Alpha));
+							MesherVertex.Material.SetMultiIndex_Blend2_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Blend2_AsFloat(), MaterialB.GetMultiIndex_Blend2_AsFloat(), Alpha));
+							MesherVertex.Material.SetMultiIndex_Wetness_AsFloat(FMath::Lerp(MaterialA.GetMultiIndex_Wetness_AsFloat(), MaterialB.GetMultiIndex_Wetness_AsFloat(), Alpha));
+						}
 					}
 				}
 			}
-		}
-		else
-		{
-			for (int32 Index = 0; Index < Vertices.Num(); Index++)
+			else
 			{
-				auto& Vertex = Vertices[Index];
-				auto& MesherVertex = MesherVertices[Index];
+				for (int32 Index = StartIndex; Index < EndIndex; Index++)
+				{
+					auto& Vertex = Vertices[Index];
+					auto& MesherVertex = MesherVertices[Index];
 
-				MesherVertex.Material = GetMaterial(Vertex.MaterialPosition);
+					MesherVertex.Material = GetMaterial(Vertex.MaterialPosition);
+				}
 			}
-		}
+		});
 	}
 
 	static void FixupTangents(TArray<FVoxelMesherVertex>& MesherVertices)
@@ -134,11 +176,12 @@ public:
 		}
 	}
 	
-	static void ComputeFlatNormals(TArray<FVoxelMesherVertex>& Vertices, TArray<uint32>& Indices)
+	// NewVertices is a temporary array, swapped with Vertices
+	static void ComputeFlatNormals(TArray<FVoxelMesherVertex>& Vertices, TArray<FVoxelMesherVertex>& NewVertices, TArray<uint32>& Indices)
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 
-		TArray<FVoxelMesherVertex> NewVertices;
+		NewVertices.Reset(Indices.Num());
 		for (int32 I = 0; I < Indices.Num(); I += 3)
 		{
 			uint32& IndexA = Indices[I + 0];
@@ -158,16 +201,64 @@ public:
 			IndexB = NewVertices.Add(VertexB);
 			IndexC = NewVertices.Add(VertexC);
 		}
-		Vertices = MoveTemp(NewVertices);
+		Swap(Vertices, NewVertices);
+	}
+	// Same as GetGradientFromGetValue on the bilinear interpolated cached values, for positions on a grid edge:
+	// each of the 6 samples is then a lerp of 2 cached values along the edge instead of a trilinear interpolation of 8
+	static FVector GetCachedValuesEdgeGradient(const FVoxelMarchingCubeMesher& Mesher, const FIntVector& Min, int32 Axis, v_flt Alpha)
+	{
+		checkVoxelSlow(Mesher.LOD == 0);
+		
+		// Axis is -1 for positions on a voxel: no need to interpolate
+		const FIntVector AxisOffset(Axis == 0, Axis == 1, Axis == 2);
+
+		const FIntVector SamplePositions[6] =
+		{
+			Min - FIntVector(1, 0, 0),
+			Min + FIntVector(1, 0, 0),
+			Min - FIntVector(0, 1, 0),
+			Min + FIntVector(0, 1, 0),
+			Min - FIntVector(0, 0, 1),
+			Min + FIntVector(0, 0, 1)
+		};
+
+		// Gather first, then interpolate: lets the compiler vectorize the lerps
+		v_flt ValuesA[6];
+		v_flt ValuesB[6];
+		for (int32 Index = 0; Index < 6; Index++)
+		{
+			const FIntVector& P = SamplePositions[Index];
+			ValuesA[Index] = Mesher.GetValue(P.X, P.Y, P.Z, 0).ToFloat();
+			ValuesB[Index] = Mesher.GetValue(P.X + AxisOffset.X, P.Y + AxisOffset.Y, P.Z + AxisOffset.Z, 0).ToFloat();
+		}
+
+		v_flt Samples[6];
+		for (int32 Index = 0; Index < 6; Index++)
+		{
+			Samples[Index] = ValuesA[Index] + Alpha * (ValuesB[Index] - ValuesA[Index]);
+		}
+
+		return FVector(Samples[1] - Samples[0], Samples[3] - Samples[2], Samples[5] - Samples[4]).GetSafeNormal();
 	}
 	static void ComputeNormals(FVoxelMarchingCubeMesher& Mesher, TArray<FVoxelMesherVertex>& MesherVertices, TArray<uint32>& Indices)
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 
-		const auto GetGradient = [&](const FVector& Position)
+		const auto GetGradient = [&](const FVector& Position, const FVoxelConstDataAccelerator& Accelerator)
 		{
 			if (Mesher.LOD == 0)
 			{
+				// Marching cubes vertices are on the edges of the grid: at most one of their coordinates isn't an integer
+				const FIntVector Min = FVoxelUtilities::FloorToInt(Position);
+				const FVector Fraction = Position - FVector(Min);
+				const int32 NumFractional = (Fraction.X != 0) + (Fraction.Y != 0) + (Fraction.Z != 0);
+				if (NumFractional <= 1)
+				{
+					const int32 Axis = Fraction.X != 0 ? 0 : Fraction.Y != 0 ? 1 : Fraction.Z != 0 ? 2 : -1;
+					return GetCachedValuesEdgeGradient(Mesher, Min, Axis, Axis == -1 ? 0 : Fraction[Axis]);
+				}
+				
+				// Vertex moved off the edges, eg by the simplification
 				// For LOD 0, we used the cached data
 				// One downside: might not look as great as using the float value from the generator
 				// However, the generator at LOD 0 should have small enough values to generate nice normals from them even if they are FVoxelValues
@@ -184,7 +275,7 @@ public:
 			else
 			{
 				return FVoxelDataUtilities::GetGradientFromGetFloatValue<v_flt>(
-					*Mesher.Accelerator,
+					Accelerator,
 					v_flt(Position.X) + Mesher.ChunkPosition.X,
 					v_flt(Position.Y) + Mesher.ChunkPosition.Y,
 					v_flt(Position.Z) + Mesher.ChunkPosition.Z,
@@ -195,15 +286,19 @@ public:
 		
 		if (Mesher.Settings.NormalConfig == EVoxelNormalConfig::GradientNormal)
 		{
-			for (auto& Vertex : MesherVertices)
+			IterateVertices(Mesher, MesherVertices.Num(), [&](int32 StartIndex, int32 EndIndex, const FVoxelConstDataAccelerator& Accelerator)
 			{
-				Vertex.Normal = GetGradient(Vertex.Position);
-				Vertex.Tangent = FVoxelProcMeshTangent();
-			}
+				for (int32 Index = StartIndex; Index < EndIndex; Index++)
+				{
+					auto& Vertex = MesherVertices[Index];
+					Vertex.Normal = GetGradient(Vertex.Position, Accelerator);
+					Vertex.Tangent = FVoxelProcMeshTangent();
+				}
+			});
 		}
 		else if (Mesher.Settings.NormalConfig == EVoxelNormalConfig::FlatNormal)
 		{
-			ComputeFlatNormals(MesherVertices, Indices);
+			ComputeFlatNormals(MesherVertices, Mesher.Scratch.TempVertices, Indices);
 		}
 		else if (Mesher.Settings.NormalConfig == EVoxelNormalConfig::MeshNormal)
 		{
@@ -232,7 +327,7 @@ public:
 					Vertex.Position.Z > (RENDER_CHUNK_SIZE - 1) * Mesher.Step)
 				{
 					// Can't use mesh normals on edges, as it looks like crap because of the missing neighbor vertices
-					Vertex.Normal = GetGradient(Vertex.Position);
+					Vertex.Normal = GetGradient(Vertex.Position, *Mesher.Accelerator);
 				}
 				else
 				{
@@ -272,7 +367,7 @@ public:
 		}
 		else if (Mesher.Settings.NormalConfig == EVoxelNormalConfig::FlatNormal)
 		{
-			ComputeFlatNormals(MesherVertices, Indices);
+			ComputeFlatNormals(MesherVertices, Mesher.Scratch.TempVertices, Indices);
 		}
 		else
 		{
@@ -292,10 +387,25 @@ public:
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 
-		for (auto& Vertex : MesherVertices)
+		if (Mesher.Settings.UVConfig != EVoxelUVConfig::PackWorldUpInUVs)
 		{
-			Vertex.TextureCoordinate = FVoxelMesherUtilities::GetUVs(Mesher, Vertex.Position);
+			// Too cheap to be worth splitting
+			for (auto& Vertex : MesherVertices)
+			{
+				Vertex.TextureCoordinate = FVoxelMesherUtilities::GetUVs(Mesher, Vertex.Position);
+			}
+			return;
 		}
+
+		// Calls the generator. The accelerator is unused
+		IterateVertices(Mesher, MesherVertices.Num(), [&](int32 StartIndex, int32 EndIndex, const FVoxelConstDataAccelerator&)
+		{
+			for (int32 Index = StartIndex; Index < EndIndex; Index++)
+			{
+				auto& Vertex = MesherVertices[Index];
+				Vertex.TextureCoordinate = FVoxelMesherUtilities::GetUVs(Mesher, Vertex.Position);
+			}
+		});
 	}
 };
 
@@ -318,28 +428,61 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMarchingCubeMesher::CreateFullChunkImpl(F
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 
-	struct FLocalVertex
+	if (ChunkCache)
 	{
-		FVector Position;
-		FIntVector MaterialPosition;
-
-		FLocalVertex() = default;
-		FORCEINLINE FLocalVertex(const FVector& Position, const FIntVector& MaterialPosition)
-			: Position(Position)
-			, MaterialPosition(MaterialPosition)
+		if (CanRemeshIncrementally())
 		{
+			return CreateIncrementalChunkImpl(Times);
 		}
-	};
+		ChunkCache->Invalidate();
+	}
+
+	TArray<uint32>& Indices = Scratch.Indices;
+	TArray<FVoxelMarchingCubeMesherBuffers::FVertex>& Vertices = Buffers.Vertices;
+	TArray<FVoxelMesherVertex>& MesherVertices = Scratch.Vertices;
+	// Might be called again after a lock conflict
+	Indices.Reset();
+	Vertices.Reset();
+	MesherVertices.Reset();
 	
-	TArray<uint32> Indices;
-	TArray<FLocalVertex> Vertices;
 	CreateGeometryTemplate(Times, Indices, Vertices);
+	if (AbortIfLockConflict())
+	{
+		return {};
+	}
 
 	FVoxelMesherUtilities::SanitizeMesh(Indices, Vertices);
 
-	TArray<FVoxelMesherVertex> MesherVertices = FMarchingCubeHelpers::CreateMesherVertices(Vertices);
+	if (const float MaxError = Settings.GetSimplificationMaxError(LOD))
+	{
+		MESHER_TIME_SCOPE(Simplification);
+		
+		TArray<FVector> Positions;
+		TBitArray<> LockedVertices;
+		Positions.SetNumUninitialized(Vertices.Num());
+		LockedVertices.Init(false, Vertices.Num());
+		for (int32 Index = 0; Index < Vertices.Num(); Index++)
+		{
+			const FVector& Position = Vertices[Index].Position;
+			Positions[Index] = Position;
+			// Lock the vertices that can be moved by transitions or that are shared with the neighbors,
+			// so that the chunk still stitches with its neighbors and its transitions
+			LockedVertices[Index] =
+				Position.GetMin() <= Step ||
+				Position.GetMax() >= Size - Step;
+		}
+
+		Times._TrianglesRemoved += FVoxelMesherUtilities::SimplifyMesh(Indices, Positions, LockedVertices, MaxError * Step);
+		FVoxelMesherUtilities::RemoveUnusedVertices(Indices, Vertices);
+	}
+
+	FMarchingCubeHelpers::CreateMesherVertices(MesherVertices, Vertices);
 
 	MESHER_TIME_MATERIALS(MesherVertices.Num(), FMarchingCubeHelpers::ComputeMaterials(*this, MesherVertices, Vertices));
+	if (AbortIfLockConflict())
+	{
+		return {};
+	}
 	MESHER_TIME(Normals, FMarchingCubeHelpers::ComputeNormals(*this, MesherVertices, Indices));
 
 	UnlockData();
@@ -414,8 +557,119 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMarchingCubeMesher::CreateFullChunkImpl(F
 	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(
 		Settings,
 		LOD,
-		MoveTemp(Indices),
-		MoveTemp(MesherVertices)));
+		Indices,
+		MesherVertices));
+}
+
+bool FVoxelMarchingCubeMesher::CanRemeshIncrementally() const
+{
+	// Mesh normals need the neighbor triangles, and simplification & unique UVs work on the whole mesh
+	return
+		Settings.NormalConfig != EVoxelNormalConfig::MeshNormal &&
+		Settings.GetSimplificationMaxError(LOD) == 0 &&
+		CVarEnableUniqueUVs.GetValueOnAnyThread() == 0;
+}
+
+TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMarchingCubeMesher::CreateIncrementalChunkImpl(FVoxelMesherTimes& Times)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(ChunkCache);
+
+	constexpr int32 SlabSize = FVoxelMesherChunkCache::SlabSize;
+	constexpr int32 NumSlabs = FVoxelMesherChunkCache::NumSlabs;
+	
+	int32 StartSlab = 0;
+	int32 EndSlab = NumSlabs;
+	if (ChunkCache->IsValid() && ChunkCacheDirtyBounds.IsValid())
+	{
+		const FVoxelIntBox& DirtyBounds = ChunkCacheDirtyBounds.GetBox();
+
+		// An edited voxel is used by the cells on both of its sides,
+		// and by the gradient normals of the vertices of the cells next to these
+		const int32 StartLZ = FVoxelUtilities::DivideFloor(DirtyBounds.Min.Z - ChunkPosition.Z, Step) - 2;
+		const int32 EndLZ = FVoxelUtilities::DivideFloor(DirtyBounds.Max.Z - 1 - ChunkPosition.Z, Step) + 3;
+
+		StartSlab = FMath::Clamp(FVoxelUtilities::DivideFloor(StartLZ, SlabSize), 0, NumSlabs);
+		EndSlab = FMath::Clamp(FVoxelUtilities::DivideCeil(EndLZ, SlabSize), 0, NumSlabs);
+	}
+
+	TArray<uint32>& Indices = Scratch.Indices;
+	TArray<FVoxelMarchingCubeMesherBuffers::FVertex>& Vertices = Buffers.Vertices;
+	TArray<FVoxelMesherVertex>& MesherVertices = Scratch.Vertices;
+
+	if (StartSlab < EndSlab)
+	{
+		if (!QueryValues(Times, StartSlab * SlabSize, EndSlab * SlabSize))
+		{
+			return {};
+		}
+
+		for (int32 SlabIndex = StartSlab; SlabIndex < EndSlab; SlabIndex++)
+		{
+			Indices.Reset();
+			Vertices.Reset();
+			MesherVertices.Reset();
+
+			// Each slab has its own vertices, so that they can be remeshed independently
+			if (!Polygonize(Times, SlabIndex * SlabSize, (SlabIndex + 1) * SlabSize, Indices, Vertices) ||
+				AbortIfLockConflict())
+			{
+				return {};
+			}
+
+			FVoxelMesherUtilities::SanitizeMesh(Indices, Vertices);
+			FMarchingCubeHelpers::CreateMesherVertices(MesherVertices, Vertices);
+
+			MESHER_TIME_MATERIALS(MesherVertices.Num(), FMarchingCubeHelpers::ComputeMaterials(*this, MesherVertices, Vertices));
+			MESHER_TIME(Normals, FMarchingCubeHelpers::ComputeNormals(*this, MesherVertices, Indices));
+			MESHER_TIME(UVs, FMarchingCubeHelpers::ComputeUVs(*this, MesherVertices));
+
+			FVoxelMesherChunkCache::FSlab& Slab = ChunkCache->GetSlab(SlabIndex);
+			Slab.Indices = Indices;
+			Slab.Vertices = MesherVertices;
+		}
+		
+		if (AbortIfLockConflict())
+		{
+			return {};
+		}
+	}
+
+	UnlockData();
+
+	ChunkCache->SetValid();
+
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Merge Slabs");
+
+		int32 NumIndices = 0;
+		int32 NumVertices = 0;
+		for (int32 SlabIndex = 0; SlabIndex < NumSlabs; SlabIndex++)
+		{
+			NumIndices += ChunkCache->GetSlab(SlabIndex).Indices.Num();
+			NumVertices += ChunkCache->GetSlab(SlabIndex).Vertices.Num();
+		}
+
+		Indices.Reset(NumIndices);
+		MesherVertices.Reset(NumVertices);
+		for (int32 SlabIndex = 0; SlabIndex < NumSlabs; SlabIndex++)
+		{
+			const FVoxelMesherChunkCache::FSlab& Slab = ChunkCache->GetSlab(SlabIndex);
+			
+			const uint32 IndexOffset = MesherVertices.Num();
+			MesherVertices.Append(Slab.Vertices);
+			for (uint32 Index : Slab.Indices)
+			{
+				Indices.Add(IndexOffset + Index);
+			}
+		}
+	}
+
+	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(
+		Settings,
+		LOD,
+		Indices,
+		MesherVertices));
 }
 
 void FVoxelMarchingCubeMesher::CreateGeometryImpl(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<FVector>& Vertices)
@@ -431,6 +685,10 @@ void FVoxelMarchingCubeMesher::CreateGeometryImpl(FVoxelMesherTimes& Times, TArr
 		}
 	};
 	CreateGeometryTemplate(Times, Indices, reinterpret_cast<TArray<FVectorVertex>&>(Vertices));
+	if (AbortIfLockConflict())
+	{
+		return;
+	}
 	UnlockData();
 }
 
@@ -443,6 +701,16 @@ bool FVoxelMarchingCubeMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times,
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 
+	return
+		QueryValues(Times, 0, RENDER_CHUNK_SIZE) &&
+		Polygonize(Times, 0, RENDER_CHUNK_SIZE, Indices, Vertices);
+}
+
+bool FVoxelMarchingCubeMesher::QueryValues(FVoxelMesherTimes& Times, int32 StartLZ, int32 EndLZ)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(0 <= StartLZ && StartLZ < EndLZ && EndLZ <= RENDER_CHUNK_SIZE);
+
 	const int32 DataSize = LOD == 0 ? CHUNK_SIZE_WITH_NORMALS : CHUNK_SIZE_WITH_END_EDGE;
 
 	FVoxelIntBox BoundsToQuery(ChunkPosition, ChunkPosition + CHUNK_SIZE_WITH_END_EDGE * Step);
@@ -452,22 +720,79 @@ bool FVoxelMarchingCubeMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times,
 		BoundsToQuery = BoundsToQuery.Extend(1);
 	}
 	TVoxelQueryZone<FVoxelValue> QueryZone(BoundsToQuery, FIntVector(DataSize), LOD, CachedValues);
-	MESHER_TIME_VALUES(DataSize * DataSize * DataSize, Data.Get<FVoxelValue>(QueryZone, LOD));
+	
+	if (StartLZ == 0 && EndLZ == RENDER_CHUNK_SIZE)
+	{
+		MESHER_TIME_VALUES(DataSize * DataSize * DataSize, Data.Get<FVoxelValue>(QueryZone, LOD));
+	}
+	else
+	{
+		// The cells use the voxels up to EndLZ included, and the normals one more voxel on each side
+		const int32 Margin = LOD == 0 ? 1 : 0;
+		FVoxelIntBox SlabsBounds = BoundsToQuery;
+		SlabsBounds.Min.Z = ChunkPosition.Z + (StartLZ - Margin) * Step;
+		SlabsBounds.Max.Z = ChunkPosition.Z + (EndLZ + 1 + Margin) * Step;
+
+		// Values outside of the slabs are left as is, and aren't used
+		const auto SlabsQueryZone = QueryZone.ShrinkTo(SlabsBounds);
+		MESHER_TIME_VALUES(DataSize * DataSize * (EndLZ - StartLZ + 1 + 2 * Margin), Data.Get<FVoxelValue>(SlabsQueryZone, LOD));
+	}
+
+	if (AbortIfLockConflict())
+	{
+		return false;
+	}
 	
 	Accelerator = MakeUnique<FVoxelConstDataAccelerator>(Data, GetBoundsToLock());
 
-	uint32 VoxelIndex = 0;
-	if (LOD == 0) VoxelIndex += DataSize * DataSize; // Additional voxel for normals
-	for (int32 LZ = 0; LZ < RENDER_CHUNK_SIZE; LZ++)
+	// Pack the signs of the values, so that only the cells crossing the surface are visited
+	Buffers.SignBitmask.Build(CachedValues, DataSize);
+
+	return true;
+}
+
+template<typename T>
+bool FVoxelMarchingCubeMesher::Polygonize(FVoxelMesherTimes& Times, int32 StartLZ, int32 EndLZ, TArray<uint32>& Indices, TArray<T>& Vertices)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(0 <= StartLZ && StartLZ < EndLZ && EndLZ <= RENDER_CHUNK_SIZE);
+	
+	const int32 DataSize = LOD == 0 ? CHUNK_SIZE_WITH_NORMALS : CHUNK_SIZE_WITH_END_EDGE;
+
+	// Cells are offset by one at LOD 0: additional voxel for normals
+	const int32 Offset = LOD == 0 ? 1 : 0;
+	constexpr uint64 ChunkCellsMask = (uint64(1) << RENDER_CHUNK_SIZE) - 1;
+
+	for (int32 LZ = StartLZ; LZ < EndLZ; LZ++)
 	{
-		if (LOD == 0) VoxelIndex += DataSize; // Additional voxel for normals
+		// Lock free, a few atomic loads per slice
+		if (AbortIfLockConflict())
+		{
+			return false;
+		}
+
+		// Set EdgeIndex 0 to -1 for all the cells, as cells that aren't voxelized (eg all corners = 0) are skipped
 		for (int32 LY = 0; LY < RENDER_CHUNK_SIZE; LY++)
 		{
-			if (LOD == 0) VoxelIndex += 1; // Additional voxel for normals
 			for (int32 LX = 0; LX < RENDER_CHUNK_SIZE; LX++)
 			{
+				CurrentCache[GetCacheIndex(0, LX, LY)] = -1;
+			}
+		}
+
+		if (Buffers.SignBitmask.HasSurfaceInSlab(LZ + Offset))
+		{
+			for (int32 LY = 0; LY < RENDER_CHUNK_SIZE; LY++)
+			{
+				uint64 SurfaceCells = (Buffers.SignBitmask.GetSurfaceCells(LY + Offset, LZ + Offset) >> Offset) & ChunkCellsMask;
+
+				// Cells must be visited in increasing X order for the cache
+				while (SurfaceCells)
 				{
-					CurrentCache[GetCacheIndex(0, LX, LY)] = -1; // Set EdgeIndex 0 to -1 if the cell isn't voxelized, eg all corners = 0
+					const int32 LX = FPlatformMath::CountTrailingZeros64(SurfaceCells);
+					SurfaceCells &= SurfaceCells - 1;
+
+					const uint32 VoxelIndex = (LX + Offset) + (LY + Offset) * DataSize + (LZ + Offset) * DataSize * DataSize;
 
 					uint32 CubeIndices[8];
 					CubeIndices[0] = VoxelIndex;
@@ -479,257 +804,242 @@ bool FVoxelMarchingCubeMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times,
 					CubeIndices[6] = VoxelIndex     + DataSize + DataSize * DataSize;
 					CubeIndices[7] = VoxelIndex + 1 + DataSize + DataSize * DataSize;
 
-					checkVoxelSlow(CubeIndices[0] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[1] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[2] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[3] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[4] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[5] < uint32(DataSize * DataSize * DataSize));
-					checkVoxelSlow(CubeIndices[6] < uint32(DataSize * DataSize * DataSize));
 					checkVoxelSlow(CubeIndices[7] < uint32(DataSize * DataSize * DataSize));
 
-					const uint32 CaseCode =
-						(CachedValues[CubeIndices[0]].IsEmpty() << 0) |
-						(CachedValues[CubeIndices[1]].IsEmpty() << 1) |
-						(CachedValues[CubeIndices[2]].IsEmpty() << 2) |
-						(CachedValues[CubeIndices[3]].IsEmpty() << 3) |
-						(CachedValues[CubeIndices[4]].IsEmpty() << 4) |
-						(CachedValues[CubeIndices[5]].IsEmpty() << 5) |
-						(CachedValues[CubeIndices[6]].IsEmpty() << 6) |
-						(CachedValues[CubeIndices[7]].IsEmpty() << 7);
-
-					if (CaseCode != 0 && CaseCode != 255)
+					const uint32 CaseCode = Buffers.SignBitmask.GetCaseCode(LX + Offset, LY + Offset, LZ + Offset);
+					checkVoxelSlow(CaseCode ==
+						((CachedValues[CubeIndices[0]].IsEmpty() << 0) |
+						 (CachedValues[CubeIndices[1]].IsEmpty() << 1) |
+						 (CachedValues[CubeIndices[2]].IsEmpty() << 2) |
+						 (CachedValues[CubeIndices[3]].IsEmpty() << 3) |
+						 (CachedValues[CubeIndices[4]].IsEmpty() << 4) |
+						 (CachedValues[CubeIndices[5]].IsEmpty() << 5) |
+						 (CachedValues[CubeIndices[6]].IsEmpty() << 6) |
+						 (CachedValues[CubeIndices[7]].IsEmpty() << 7)));
+					// Cell has a nontrivial triangulation
+					checkVoxelSlow(CaseCode != 0 && CaseCode != 255);
+
+					const uint8 ValidityMask = (LX != 0) + 2 * (LY != 0) + 4 * (LZ != StartLZ);
+
+					checkVoxelSlow(0 <= CaseCode && CaseCode < 256);
+					const uint8 CellClass = Transvoxel::regularCellClass[CaseCode];
+					const uint16* RESTRICT VertexData = Transvoxel::regularVertexData[CaseCode];
+					checkVoxelSlow(0 <= CellClass && CellClass < 16);
+					Transvoxel::RegularCellData CellData = Transvoxel::regularCellData[CellClass];
+
+					// Indices of the vertices used in this cube
+					TVoxelStaticArray<int32, 16> VertexIndices;
+					for (int32 I = 0; I < CellData.GetVertexCount(); I++)
 					{
-						// Cell has a nontrivial triangulation
+						int32 VertexIndex = -2;
+						const uint16 EdgeCode = VertexData[I];
 
-						const uint8 ValidityMask = (LX != 0) + 2 * (LY != 0) + 4 * (LZ != 0);
+						// A: low point / B: high point
+						const uint8 LocalIndexA = (EdgeCode >> 4) & 0x0F;
+						const uint8 LocalIndexB = EdgeCode & 0x0F;
 
-						checkVoxelSlow(0 <= CaseCode && CaseCode < 256);
-						const uint8 CellClass = Transvoxel::regularCellClass[CaseCode];
-						const uint16* RESTRICT VertexData = Transvoxel::regularVertexData[CaseCode];
-						checkVoxelSlow(0 <= CellClass && CellClass < 16);
-						Transvoxel::RegularCellData CellData = Transvoxel::regularCellData[CellClass];
+						checkVoxelSlow(0 <= LocalIndexA && LocalIndexA < 8);
+						checkVoxelSlow(0 <= LocalIndexB && LocalIndexB < 8);
 
-						// Indices of the vertices used in this cube
-						TVoxelStaticArray<int32, 16> VertexIndices;
-						for (int32 I = 0; I < CellData.GetVertexCount(); I++)
-						{
-							int32 VertexIndex = -2;
-							const uint16 EdgeCode = VertexData[I];
-
-							// A: low point / B: high point
-							const uint8 LocalIndexA = (EdgeCode >> 4) & 0x0F;
-							const uint8 LocalIndexB = EdgeCode & 0x0F;
+						const uint32 IndexA = CubeIndices[LocalIndexA];
+						const uint32 IndexB = CubeIndices[LocalIndexB];
 
-							checkVoxelSlow(0 <= LocalIndexA && LocalIndexA < 8);
-							checkVoxelSlow(0 <= LocalIndexB && LocalIndexB < 8);
+						const FVoxelValue& ValueAtA = CachedValues[IndexA];
+						const FVoxelValue& ValueAtB = CachedValues[IndexB];
 
-							const uint32 IndexA = CubeIndices[LocalIndexA];
-							const uint32 IndexB = CubeIndices[LocalIndexB];
+						checkVoxelSlow(ValueAtA.IsEmpty() != ValueAtB.IsEmpty());
 
-							const FVoxelValue& ValueAtA = CachedValues[IndexA];
-							const FVoxelValue& ValueAtB = CachedValues[IndexB];
+						uint8 EdgeIndex = ((EdgeCode >> 8) & 0x0F);
+						checkVoxelSlow(1 <= EdgeIndex && EdgeIndex < 4);
 
-							checkVoxelSlow(ValueAtA.IsEmpty() != ValueAtB.IsEmpty());
+						// Direction to go to use an already created vertex: 
+						// first bit:  x is different
+						// second bit: y is different
+						// third bit:  z is different
+						// fourth bit: vertex isn't cached
+						uint8 CacheDirection = EdgeCode >> 12;
 
-							uint8 EdgeIndex = ((EdgeCode >> 8) & 0x0F);
-							checkVoxelSlow(1 <= EdgeIndex && EdgeIndex < 4);
+						if (ValueAtA.IsNull())
+						{
+							EdgeIndex = 0;
+							CacheDirection = LocalIndexA ^ 7;
+						}
+						if (ValueAtB.IsNull())
+						{
+							checkVoxelSlow(!ValueAtA.IsNull());
+							EdgeIndex = 0;
+							CacheDirection = LocalIndexB ^ 7;
+						}
 
-							// Direction to go to use an already created vertex: 
-							// first bit:  x is different
-							// second bit: y is different
-							// third bit:  z is different
-							// fourth bit: vertex isn't cached
-							uint8 CacheDirection = EdgeCode >> 12;
+						const bool bIsVertexCached = ((ValidityMask & CacheDirection) == CacheDirection) && CacheDirection; // CacheDirection == 0 => LocalIndexB = 0 (as only B can be = 7) and ValueAtB = 0
 
-							if (ValueAtA.IsNull())
-							{
-								EdgeIndex = 0;
-								CacheDirection = LocalIndexA ^ 7;
-							}
-							if (ValueAtB.IsNull())
-							{
-								checkVoxelSlow(!ValueAtA.IsNull());
-								EdgeIndex = 0;
-								CacheDirection = LocalIndexB ^ 7;
-							}
+						if (bIsVertexCached)
+						{
+							checkVoxelSlow(!(CacheDirection & 0x08));
 
-							const bool bIsVertexCached = ((ValidityMask & CacheDirection) == CacheDirection) && CacheDirection; // CacheDirection == 0 => LocalIndexB = 0 (as only B can be = 7) and ValueAtB = 0
+							bool XIsDifferent = !!(CacheDirection & 0x01);
+							bool YIsDifferent = !!(CacheDirection & 0x02);
+							bool ZIsDifferent = !!(CacheDirection & 0x04);
+							
+							VertexIndex = (ZIsDifferent ? OldCache : CurrentCache)[GetCacheIndex(EdgeIndex, LX - XIsDifferent, LY - YIsDifferent)];
+							ensureVoxelSlowNoSideEffects(-1 <= VertexIndex && VertexIndex < Vertices.Num()); // Can happen if the generator is returning different values
+						}
 
-							if (bIsVertexCached)
-							{
-								checkVoxelSlow(!(CacheDirection & 0x08));
+						if (!bIsVertexCached || VertexIndex == -1)
+						{
+							// We are on one the lower edges of the chunk. Compute vertex
+						
+							const FIntVector PositionA((LX + (LocalIndexA & 0x01)) * Step, (LY + ((LocalIndexA & 0x02) >> 1)) * Step, (LZ + ((LocalIndexA & 0x04) >> 2)) * Step);
+							const FIntVector PositionB((LX + (LocalIndexB & 0x01)) * Step, (LY + ((LocalIndexB & 0x02) >> 1)) * Step, (LZ + ((LocalIndexB & 0x04) >> 2)) * Step);
 
-								bool XIsDifferent = !!(CacheDirection & 0x01);
-								bool YIsDifferent = !!(CacheDirection & 0x02);
-								bool ZIsDifferent = !!(CacheDirection & 0x04);
-								
-								VertexIndex = (ZIsDifferent ? OldCache : CurrentCache)[GetCacheIndex(EdgeIndex, LX - XIsDifferent, LY - YIsDifferent)];
-								ensureVoxelSlowNoSideEffects(-1 <= VertexIndex && VertexIndex < Vertices.Num()); // Can happen if the generator is returning different values
-							}
+							FVector IntersectionPoint;
+							FIntVector MaterialPosition;
 
-							if (!bIsVertexCached || VertexIndex == -1)
+							if (EdgeIndex == 0)
 							{
-								// We are on one the lower edges of the chunk. Compute vertex
-							
-								const FIntVector PositionA((LX + (LocalIndexA & 0x01)) * Step, (LY + ((LocalIndexA & 0x02) >> 1)) * Step, (LZ + ((LocalIndexA & 0x04) >> 2)) * Step);
-								const FIntVector PositionB((LX + (LocalIndexB & 0x01)) * Step, (LY + ((LocalIndexB & 0x02) >> 1)) * Step, (LZ + ((LocalIndexB & 0x04) >> 2)) * Step);
-
-								FVector IntersectionPoint;
-								FIntVector MaterialPosition;
-
-								if (EdgeIndex == 0)
+								if (ValueAtA.IsNull())
 								{
-									if (ValueAtA.IsNull())
-									{
-										IntersectionPoint = FVector(PositionA);
-										MaterialPosition = PositionA;
-									}
-									else 
-									{
-										checkVoxelSlow(ValueAtB.IsNull());
-										IntersectionPoint = FVector(PositionB);
-										MaterialPosition = PositionB;
-									}
+									IntersectionPoint = FVector(PositionA);
+									MaterialPosition = PositionA;
 								}
-								else if (LOD == 0)
+								else 
 								{
-									// Full resolution
-
-									const float Alpha = ValueAtA.ToFloat() / (ValueAtA.ToFloat() - ValueAtB.ToFloat());
-									checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
-									
-									switch (EdgeIndex)
-									{
-									case 2: // X
-										IntersectionPoint = FVector(FMath::Lerp<float>(PositionA.X, PositionB.X, Alpha), PositionA.Y, PositionA.Z);
-										break;
-									case 1: // Y
-										IntersectionPoint = FVector(PositionA.X, FMath::Lerp<float>(PositionA.Y, PositionB.Y, Alpha), PositionA.Z);
-										break;
-									case 3: // Z
-										IntersectionPoint = FVector(PositionA.X, PositionA.Y, FMath::Lerp<float>(PositionA.Z, PositionB.Z, Alpha));
-										break;
-									default:
-										checkVoxelSlow(false);
-									}
-
-									// Use the material of the point inside
-									MaterialPosition = !ValueAtA.IsEmpty() ? PositionA : PositionB;
+									checkVoxelSlow(ValueAtB.IsNull());
+									IntersectionPoint = FVector(PositionB);
+									MaterialPosition = PositionB;
 								}
-								else
+							}
+							else if (LOD == 0)
+							{
+								// Full resolution
+
+								const float Alpha = ValueAtA.ToFloat() / (ValueAtA.ToFloat() - ValueAtB.ToFloat());
+								checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
+								
+								switch (EdgeIndex)
 								{
-									// Interpolate
+								case 2: // X
+									IntersectionPoint = FVector(FMath::Lerp<float>(PositionA.X, PositionB.X, Alpha), PositionA.Y, PositionA.Z);
+									break;
+								case 1: // Y
+									IntersectionPoint = FVector(PositionA.X, FMath::Lerp<float>(PositionA.Y, PositionB.Y, Alpha), PositionA.Z);
+									break;
+								case 3: // Z
+									IntersectionPoint = FVector(PositionA.X, PositionA.Y, FMath::Lerp<float>(PositionA.Z, PositionB.Z, Alpha));
+									break;
+								default:
+									checkVoxelSlow(false);
+								}
 
-									const bool bIsAlongX = (EdgeIndex == 2);
-									const bool bIsAlongY = (EdgeIndex == 1);
-									const bool bIsAlongZ = (EdgeIndex == 3);
+								// Use the material of the point inside
+								MaterialPosition = !ValueAtA.IsEmpty() ? PositionA : PositionB;
+							}
+							else
+							{
+								// Interpolate
 
-									checkVoxelSlow(!bIsAlongX || (PositionA.Y == PositionB.Y && PositionA.Z == PositionB.Z));
-									checkVoxelSlow(!bIsAlongY || (PositionA.X == PositionB.X && PositionA.Z == PositionB.Z));
-									checkVoxelSlow(!bIsAlongZ || (PositionA.X == PositionB.X && PositionA.Y == PositionB.Y));
+								const bool bIsAlongX = (EdgeIndex == 2);
+								const bool bIsAlongY = (EdgeIndex == 1);
+								const bool bIsAlongZ = (EdgeIndex == 3);
 
-									int32 Min = bIsAlongX ? PositionA.X : bIsAlongY ? PositionA.Y : PositionA.Z;
-									int32 Max = bIsAlongX ? PositionB.X : bIsAlongY ? PositionB.Y : PositionB.Z;
+								checkVoxelSlow(!bIsAlongX || (PositionA.Y == PositionB.Y && PositionA.Z == PositionB.Z));
+								checkVoxelSlow(!bIsAlongY || (PositionA.X == PositionB.X && PositionA.Z == PositionB.Z));
+								checkVoxelSlow(!bIsAlongZ || (PositionA.X == PositionB.X && PositionA.Y == PositionB.Y));
 
-									FVoxelValue ValueAtACopy = ValueAtA;
-									FVoxelValue ValueAtBCopy = ValueAtB;
+								int32 Min = bIsAlongX ? PositionA.X : bIsAlongY ? PositionA.Y : PositionA.Z;
+								int32 Max = bIsAlongX ? PositionB.X : bIsAlongY ? PositionB.Y : PositionB.Z;
 
-									while (Max - Min != 1)
-									{
-										checkError((Max + Min) % 2 == 0);
-										const int32 Middle = (Max + Min) / 2;
-
-										FVoxelValue ValueAtMiddle = MESHER_TIME_RETURN_VALUES(1, Accelerator->Get<FVoxelValue>(
-											(bIsAlongX ? Middle : PositionA.X) + ChunkPosition.X,
-											(bIsAlongY ? Middle : PositionA.Y) + ChunkPosition.Y,
-											(bIsAlongZ ? Middle : PositionA.Z) + ChunkPosition.Z, LOD));
-
-										if (ValueAtACopy.IsEmpty() == ValueAtMiddle.IsEmpty())
-										{
-											// If min and middle have same sign
-											Min = Middle;
-											ValueAtACopy = ValueAtMiddle;
-										}
-										else
-										{
-											// If max and middle have same sign
-											Max = Middle;
-											ValueAtBCopy = ValueAtMiddle;
-										}
-
-										checkError(Min <= Max);
-									}
+								FVoxelValue ValueAtACopy = ValueAtA;
+								FVoxelValue ValueAtBCopy = ValueAtB;
 
-									const float Alpha = ValueAtACopy.ToFloat() / (ValueAtACopy.ToFloat() - ValueAtBCopy.ToFloat());
-									checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
+								while (Max - Min != 1)
+								{
+									checkError((Max + Min) % 2 == 0);
+									const int32 Middle = (Max + Min) / 2;
 
-									const float R = FMath::Lerp<float>(Min, Max, Alpha);
-									IntersectionPoint = FVector(
-										bIsAlongX ? R : PositionA.X,
-										bIsAlongY ? R : PositionA.Y,
-										bIsAlongZ ? R : PositionA.Z);
+									FVoxelValue ValueAtMiddle = MESHER_TIME_RETURN_VALUES(1, Accelerator->Get<FVoxelValue>(
+										(bIsAlongX ? Middle : PositionA.X) + ChunkPosition.X,
+										(bIsAlongY ? Middle : PositionA.Y) + ChunkPosition.Y,
+										(bIsAlongZ ? Middle : PositionA.Z) + ChunkPosition.Z, LOD));
 
-									// Get intersection material
-									if (!ValueAtACopy.IsEmpty())
+									if (ValueAtACopy.IsEmpty() == ValueAtMiddle.IsEmpty())
 									{
-										checkVoxelSlow(ValueAtBCopy.IsEmpty());
-										MaterialPosition = FIntVector(
-											bIsAlongX ? Min : PositionA.X,
-											bIsAlongY ? Min : PositionA.Y,
-											bIsAlongZ ? Min : PositionA.Z);
+										// If min and middle have same sign
+										Min = Middle;
+										ValueAtACopy = ValueAtMiddle;
 									}
 									else
 									{
-										checkVoxelSlow(!ValueAtBCopy.IsEmpty());
-										MaterialPosition = FIntVector(
-											bIsAlongX ? Max : PositionA.X,
-											bIsAlongY ? Max : PositionA.Y,
-											bIsAlongZ ? Max : PositionA.Z);
+										// If max and middle have same sign
+										Max = Middle;
+										ValueAtBCopy = ValueAtMiddle;
 									}
-								}
-
-								VertexIndex = Vertices.Num();
 
-								if (Settings.RenderSharpness != 0)
-								{
-									IntersectionPoint = FVector(FVoxelUtilities::RoundToInt(IntersectionPoint * Settings.RenderSharpness)) / Settings.RenderSharpness;
+									checkError(Min <= Max);
 								}
 
-								Vertices.Add(T(IntersectionPoint, MaterialPosition));
+								const float Alpha = ValueAtACopy.ToFloat() / (ValueAtACopy.ToFloat() - ValueAtBCopy.ToFloat());
+								checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
 
-								checkVoxelSlow((ValueAtB.IsNull() && LocalIndexB == 7) == !CacheDirection);
-								checkVoxelSlow(CacheDirection || EdgeIndex == 0);
+								const float R = FMath::Lerp<float>(Min, Max, Alpha);
+								IntersectionPoint = FVector(
+									bIsAlongX ? R : PositionA.X,
+									bIsAlongY ? R : PositionA.Y,
+									bIsAlongZ ? R : PositionA.Z);
 
-								// Save vertex if not on edge
-								if (CacheDirection & 0x08 || !CacheDirection) // ValueAtB.IsNull() && LocalIndexB == 7 => !CacheDirection
+								// Get intersection material
+								if (!ValueAtACopy.IsEmpty())
+								{
+									checkVoxelSlow(ValueAtBCopy.IsEmpty());
+									MaterialPosition = FIntVector(
+										bIsAlongX ? Min : PositionA.X,
+										bIsAlongY ? Min : PositionA.Y,
+										bIsAlongZ ? Min : PositionA.Z);
+								}
+								else
 								{
-									CurrentCache[GetCacheIndex(EdgeIndex, LX, LY)] = VertexIndex;
+									checkVoxelSlow(!ValueAtBCopy.IsEmpty());
+									MaterialPosition = FIntVector(
+										bIsAlongX ? Max : PositionA.X,
+										bIsAlongY ? Max : PositionA.Y,
+										bIsAlongZ ? Max : PositionA.Z);
 								}
 							}
 
-							VertexIndices[I] = VertexIndex;
-							checkVoxelSlow(0 <= VertexIndex && VertexIndex < Vertices.Num());
-						}
+							VertexIndex = Vertices.Num();
 
-						// Add triangles
-						// 3 vertex per triangle
-						for (int32 Index = 0; Index < 3 * CellData.GetTriangleCount(); Index += 3)
-						{
-							Indices.Add(VertexIndices[CellData.vertexIndex[Index + 0]]);
-							Indices.Add(VertexIndices[CellData.vertexIndex[Index + 1]]);
-							Indices.Add(VertexIndices[CellData.vertexIndex[Index + 2]]);
+							if (Settings.RenderSharpness != 0)
+							{
+								IntersectionPoint = FVector(FVoxelUtilities::RoundToInt(IntersectionPoint * Settings.RenderSharpness)) / Settings.RenderSharpness;
+							}
+
+							Vertices.Add(T(IntersectionPoint, MaterialPosition));
+
+							checkVoxelSlow((ValueAtB.IsNull() && LocalIndexB == 7) == !CacheDirection);
+							checkVoxelSlow(CacheDirection || EdgeIndex == 0);
+
+							// Save vertex if not on edge
+							if (CacheDirection & 0x08 || !CacheDirection) // ValueAtB.IsNull() && LocalIndexB == 7 => !CacheDirection
+							{
+								CurrentCache[GetCacheIndex(EdgeIndex, LX, LY)] = VertexIndex;
+							}
 						}
+
+						VertexIndices[I] = VertexIndex;
+						checkVoxelSlow(0 <= VertexIndex && VertexIndex < Vertices.Num());
 					}
-				}
 
-				VoxelIndex++;
+					// Add triangles
+					// 3 vertex per triangle
+					for (int32 Index = 0; Index < 3 * CellData.GetTriangleCount(); Index += 3)
+					{
+						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 0]]);
+						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 1]]);
+						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 2]]);
+					}
+				}
 			}
-			VoxelIndex += 1; // End edge voxel
-			if (LOD == 0) VoxelIndex += 1; // Additional voxel for normals
 		}
-		VoxelIndex += DataSize; // End edge voxel
-		if (LOD == 0) VoxelIndex += DataSize; // Additional voxel for normals
 
 		// Can't use Unreal Swap on restrict ptrs with clang
 		std::swap(CurrentCache, OldCache);
@@ -789,9 +1099,14 @@ template<uint8 Direction, typename T>
 bool FVoxelMarchingCubeTransitionsMesher::CreateGeometryForDirection(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<T>& Vertices)
 {
 	if (!(TransitionsMask & Direction)) return true;
+
+	if (AbortIfLockConflict())
+	{
+		return false;
+	}
 	
 #if VOXEL_DEBUG
-	for (auto& Value : Cache2D)
+	for (auto& Value : Buffers.Cache2D)
 	{
 		Value = -100;
 	}
@@ -802,25 +1117,79 @@ bool FVoxelMarchingCubeTransitionsMesher::CreateGeometryForDirection(FVoxelMeshe
 		for (int32 LY = 0; LY < RENDER_CHUNK_SIZE; LY++)
 		{
 			// Set EdgeIndex 0, 1, 2 and 7 to -1 for when the cell aren't polygonized (0 on all corners)
-			Cache2D[GetCacheIndex(0, LX, LY)] = -1;
-			Cache2D[GetCacheIndex(1, LX, LY)] = -1;
-			Cache2D[GetCacheIndex(2, LX, LY)] = -1;
-			Cache2D[GetCacheIndex(7, LX, LY)] = -1;
+			Buffers.Cache2D[GetCacheIndex(0, LX, LY)] = -1;
+			Buffers.Cache2D[GetCacheIndex(1, LX, LY)] = -1;
+			Buffers.Cache2D[GetCacheIndex(2, LX, LY)] = -1;
+			Buffers.Cache2D[GetCacheIndex(7, LX, LY)] = -1;
+		}
+	}
+
+	{
+		MESHER_TIME_SCOPE_VALUES(TRANSITION_FACE_SIZE * TRANSITION_FACE_SIZE);
+
+		for (int32 Y = 0; Y < TRANSITION_FACE_SIZE; Y++)
+		{
+			for (int32 X = 0; X < TRANSITION_FACE_SIZE; X++)
+			{
+				Buffers.FaceValues[X + Y * TRANSITION_FACE_SIZE] = GetValue<Direction>(X * HalfStep, Y * HalfStep, HalfLOD);
+			}
+		}
+	}
+
+	// Pack the signs of the high resolution values per cell: bit LX of CellsAnyEmpty[Y] is set
+	// if any of the values at 2 * LX, 2 * LX + 1 and 2 * LX + 2 on the row Y is empty
+	uint64 CellsAnyEmpty[TRANSITION_FACE_SIZE];
+	uint64 CellsAllEmpty[TRANSITION_FACE_SIZE];
+	for (int32 Y = 0; Y < TRANSITION_FACE_SIZE; Y++)
+	{
+		const FVoxelValue* RESTRICT RowValues = &Buffers.FaceValues[Y * TRANSITION_FACE_SIZE];
+
+		uint64 AnyEmpty = 0;
+		uint64 AllEmpty = 0;
+		for (int32 LX = 0; LX < RENDER_CHUNK_SIZE; LX++)
+		{
+			const uint64 A = RowValues[2 * LX + 0].IsEmpty();
+			const uint64 B = RowValues[2 * LX + 1].IsEmpty();
+			const uint64 C = RowValues[2 * LX + 2].IsEmpty();
+			AnyEmpty |= (A | B | C) << LX;
+			AllEmpty |= (A & B & C) << LX;
+		}
+		CellsAnyEmpty[Y] = AnyEmpty;
+		CellsAllEmpty[Y] = AllEmpty;
+	}
+
+	// Cells must be visited after their X and Y neighbors for the cache
+	for (int32 LY = 0; LY < RENDER_CHUNK_SIZE; LY++)
+	{
+		// Only visit the cells with both empty and full high resolution values
+		uint64 SurfaceCells =
+			(CellsAnyEmpty[2 * LY + 0] | CellsAnyEmpty[2 * LY + 1] | CellsAnyEmpty[2 * LY + 2]) &
+			~(CellsAllEmpty[2 * LY + 0] & CellsAllEmpty[2 * LY + 1] & CellsAllEmpty[2 * LY + 2]);
+
+		while (SurfaceCells)
+		{
+			const int32 LX = FPlatformMath::CountTrailingZeros64(SurfaceCells);
+			SurfaceCells &= SurfaceCells - 1;
+
+			const auto GetFaceValue = [&](int32 X, int32 Y)
+			{
+				return Buffers.FaceValues[(2 * LX + X) + (2 * LY + Y) * TRANSITION_FACE_SIZE];
+			};
 
 			FVoxelValue CornerValues[13];
 
+			CornerValues[0] = GetFaceValue(0, 0);
+			CornerValues[1] = GetFaceValue(1, 0);
+			CornerValues[2] = GetFaceValue(2, 0);
+			CornerValues[3] = GetFaceValue(0, 1);
+			CornerValues[4] = GetFaceValue(1, 1);
+			CornerValues[5] = GetFaceValue(2, 1);
+			CornerValues[6] = GetFaceValue(0, 2);
+			CornerValues[7] = GetFaceValue(1, 2);
+			CornerValues[8] = GetFaceValue(2, 2);
+
 			{
-				MESHER_TIME_SCOPE_VALUES(13);
-				
-				CornerValues[0] = GetValue<Direction>((2 * LX + 0) * HalfStep, (2 * LY + 0) * HalfStep, HalfLOD);
-				CornerValues[1] = GetValue<Direction>((2 * LX + 1) * HalfStep, (2 * LY + 0) * HalfStep, HalfLOD);
-				CornerValues[2] = GetValue<Direction>((2 * LX + 2) * HalfStep, (2 * LY + 0) * HalfStep, HalfLOD);
-				CornerValues[3] = GetValue<Direction>((2 * LX + 0) * HalfStep, (2 * LY + 1) * HalfStep, HalfLOD);
-				CornerValues[4] = GetValue<Direction>((2 * LX + 1) * HalfStep, (2 * LY + 1) * HalfStep, HalfLOD);
-				CornerValues[5] = GetValue<Direction>((2 * LX + 2) * HalfStep, (2 * LY + 1) * HalfStep, HalfLOD);
-				CornerValues[6] = GetValue<Direction>((2 * LX + 0) * HalfStep, (2 * LY + 2) * HalfStep, HalfLOD);
-				CornerValues[7] = GetValue<Direction>((2 * LX + 1) * HalfStep, (2 * LY + 2) * HalfStep, HalfLOD);
-				CornerValues[8] = GetValue<Direction>((2 * LX + 2) * HalfStep, (2 * LY + 2) * HalfStep, HalfLOD);
+				MESHER_TIME_SCOPE_VALUES(4);
 
 				CornerValues[9] = GetValue<Direction>((LX + 0) * Step, (LY + 0) * Step, LOD);
 				CornerValues[10] = GetValue<Direction>((LX + 1) * Step, (LY + 0) * Step, LOD);
@@ -856,217 +1225,217 @@ bool FVoxelMarchingCubeTransitionsMesher::CreateGeometryForDirection(FVoxelMeshe
 				| (CornerValues[3].IsEmpty() << 7)
 				| (CornerValues[4].IsEmpty() << 8);
 
-			if (!(CaseCode == 0 || CaseCode == 511))
+			// Cell has a nontrivial triangulation
+			checkVoxelSlow(!(CaseCode == 0 || CaseCode == 511));
+
+			const uint8 ValidityMask = (LX != 0) + 2 * (LY != 0);
+
+			FIntVector Positions[13] = {
+				FIntVector(2 * LX + 0, 2 * LY + 0, 0) * HalfStep,
+				FIntVector(2 * LX + 1, 2 * LY + 0, 0) * HalfStep,
+				FIntVector(2 * LX + 2, 2 * LY + 0, 0) * HalfStep,
+				FIntVector(2 * LX + 0, 2 * LY + 1, 0) * HalfStep,
+				FIntVector(2 * LX + 1, 2 * LY + 1, 0) * HalfStep,
+				FIntVector(2 * LX + 2, 2 * LY + 1, 0) * HalfStep,
+				FIntVector(2 * LX + 0, 2 * LY + 2, 0) * HalfStep,
+				FIntVector(2 * LX + 1, 2 * LY + 2, 0) * HalfStep,
+				FIntVector(2 * LX + 2, 2 * LY + 2, 0) * HalfStep,
+
+				FIntVector(2 * LX + 0, 2 * LY + 0, 1) * HalfStep,
+				FIntVector(2 * LX + 2, 2 * LY + 0, 1) * HalfStep,
+				FIntVector(2 * LX + 0, 2 * LY + 2, 1) * HalfStep,
+				FIntVector(2 * LX + 2, 2 * LY + 2, 1) * HalfStep
+			};
+
+			checkVoxelSlow(0 <= CaseCode && CaseCode < 512);
+			const uint8 CellClass = Transvoxel::transitionCellClass[CaseCode];
+			const uint16* VertexData = Transvoxel::transitionVertexData[CaseCode];
+			checkVoxelSlow(0 <= (CellClass & 0x7F) && (CellClass & 0x7F) < 56);
+			const Transvoxel::TransitionCellData CellData = Transvoxel::transitionCellData[CellClass & 0x7F];
+			const bool bFlip = ((CellClass >> 7) != 0);
+
+			TArray<int32, TFixedAllocator<64>> VertexIndices; // Not sure how many indices max, let's just say 64
+			VertexIndices.SetNumUninitialized(CellData.GetVertexCount());
+
+			for (int32 i = 0; i < CellData.GetVertexCount(); i++)
 			{
-				const uint8 ValidityMask = (LX != 0) + 2 * (LY != 0);
-
-				FIntVector Positions[13] = {
-					FIntVector(2 * LX + 0, 2 * LY + 0, 0) * HalfStep,
-					FIntVector(2 * LX + 1, 2 * LY + 0, 0) * HalfStep,
-					FIntVector(2 * LX + 2, 2 * LY + 0, 0) * HalfStep,
-					FIntVector(2 * LX + 0, 2 * LY + 1, 0) * HalfStep,
-					FIntVector(2 * LX + 1, 2 * LY + 1, 0) * HalfStep,
-					FIntVector(2 * LX + 2, 2 * LY + 1, 0) * HalfStep,
-					FIntVector(2 * LX + 0, 2 * LY + 2, 0) * HalfStep,
-					FIntVector(2 * LX + 1, 2 * LY + 2, 0) * HalfStep,
-					FIntVector(2 * LX + 2, 2 * LY + 2, 0) * HalfStep,
-
-					FIntVector(2 * LX + 0, 2 * LY + 0, 1) * HalfStep,
-					FIntVector(2 * LX + 2, 2 * LY + 0, 1) * HalfStep,
-					FIntVector(2 * LX + 0, 2 * LY + 2, 1) * HalfStep,
-					FIntVector(2 * LX + 2, 2 * LY + 2, 1) * HalfStep
-				};
-
-				checkVoxelSlow(0 <= CaseCode && CaseCode < 512);
-				const uint8 CellClass = Transvoxel::transitionCellClass[CaseCode];
-				const uint16* VertexData = Transvoxel::transitionVertexData[CaseCode];
-				checkVoxelSlow(0 <= (CellClass & 0x7F) && (CellClass & 0x7F) < 56);
-				const Transvoxel::TransitionCellData CellData = Transvoxel::transitionCellData[CellClass & 0x7F];
-				const bool bFlip = ((CellClass >> 7) != 0);
-
-				TArray<int32, TFixedAllocator<64>> VertexIndices; // Not sure how many indices max, let's just say 64
-				VertexIndices.SetNumUninitialized(CellData.GetVertexCount());
-
-				for (int32 i = 0; i < CellData.GetVertexCount(); i++)
+				int32 VertexIndex = -1;
+				const uint16& EdgeCode = VertexData[i];
+
+				// A: low point / B: high point
+				const uint8 IndexVertexA = (EdgeCode >> 4) & 0x0F;
+				const uint8 IndexVertexB = EdgeCode & 0x0F;
+
+				checkVoxelSlow(0 <= IndexVertexA && IndexVertexA < 13);
+				checkVoxelSlow(0 <= IndexVertexB && IndexVertexB < 13);
+
+				const FIntVector& PositionA = Positions[IndexVertexA];
+				const FIntVector& PositionB = Positions[IndexVertexB];
+					
+				const FVoxelValue& ValueAtA = CornerValues[IndexVertexA];
+				const FVoxelValue& ValueAtB = CornerValues[IndexVertexB];
+
+				uint8 EdgeIndex = (EdgeCode >> 8) & 0x0F;
+				checkVoxelSlow(EdgeIndex < 10);
+				// Direction to go to use an already created vertex
+				// First bit: x is different
+				// Second bit: y is different
+				// Third bit: interior edge, never cached
+				// Fourth bit: own edge, need to create
+				uint8 CacheDirection = EdgeCode >> 12;
+
+				if (!(CacheDirection & 0x04)) // If not interior edge
 				{
-					int32 VertexIndex = -1;
-					const uint16& EdgeCode = VertexData[i];
+					static uint8 CacheDirectionMap[13] = {3, 2, 2, 1, 4, 8, 1, 8, 8, 3, 2, 1, 8};
+					if (ValueAtA.IsNull())
+					{
+						static uint8 EdgeIndexMap[10] = {0, 1, 2, 0, 1, 0, 2, 7, 7, 7};
+						EdgeIndex = EdgeIndexMap[EdgeIndex];
+						CacheDirection = CacheDirectionMap[IndexVertexA];
+					}
+					if (ValueAtB.IsNull())
+					{
+						checkVoxelSlow(!ValueAtA.IsNull());
+						static uint8 EdgeIndexMap[10] = {0, 1, 2, 1, 0, 2, 0, 7, 7, 7};
+						EdgeIndex = EdgeIndexMap[EdgeIndex];
+						CacheDirection = CacheDirectionMap[IndexVertexB];
+					}
+				}
+				const bool bIsVertexCached = ((ValidityMask & CacheDirection) == CacheDirection);
 
-					// A: low point / B: high point
-					const uint8 IndexVertexA = (EdgeCode >> 4) & 0x0F;
-					const uint8 IndexVertexB = EdgeCode & 0x0F;
+				if (bIsVertexCached)
+				{
+					checkVoxelSlow(!(CacheDirection & 0x08) && !(CacheDirection & 0x04));
 
-					checkVoxelSlow(0 <= IndexVertexA && IndexVertexA < 13);
-					checkVoxelSlow(0 <= IndexVertexB && IndexVertexB < 13);
+					const bool XIsDifferent = !!(CacheDirection & 0x01);
+					const bool YIsDifferent = !!(CacheDirection & 0x02);
+					
+					VertexIndex = Buffers.Cache2D[GetCacheIndex(EdgeIndex, LX - XIsDifferent, LY - YIsDifferent)];
+					checkVoxelSlow(-1 <= VertexIndex && VertexIndex < Vertices.Num());
+				}
 
-					const FIntVector& PositionA = Positions[IndexVertexA];
-					const FIntVector& PositionB = Positions[IndexVertexB];
-						
-					const FVoxelValue& ValueAtA = CornerValues[IndexVertexA];
-					const FVoxelValue& ValueAtB = CornerValues[IndexVertexB];
-
-					uint8 EdgeIndex = (EdgeCode >> 8) & 0x0F;
-					checkVoxelSlow(EdgeIndex < 10);
-					// Direction to go to use an already created vertex
-					// First bit: x is different
-					// Second bit: y is different
-					// Third bit: interior edge, never cached
-					// Fourth bit: own edge, need to create
-					uint8 CacheDirection = EdgeCode >> 12;
-
-					if (!(CacheDirection & 0x04)) // If not interior edge
+				if (!bIsVertexCached || VertexIndex == -1)
+				{
+					FVector IntersectionPoint;
+					FIntVector MaterialPosition;
+					
+					const bool bIsLowResChunk = EdgeIndex == 7 || EdgeIndex == 8 || EdgeIndex == 9;
+
+					if (EdgeIndex == 0 || EdgeIndex == 1 || EdgeIndex == 2 || EdgeIndex == 7)
 					{
-						static uint8 CacheDirectionMap[13] = {3, 2, 2, 1, 4, 8, 1, 8, 8, 3, 2, 1, 8};
 						if (ValueAtA.IsNull())
 						{
-							static uint8 EdgeIndexMap[10] = {0, 1, 2, 0, 1, 0, 2, 7, 7, 7};
-							EdgeIndex = EdgeIndexMap[EdgeIndex];
-							CacheDirection = CacheDirectionMap[IndexVertexA];
+							const auto P = Local2DToGlobal<Direction>(PositionA.X, PositionA.Y, 0);
+							IntersectionPoint = FVector(P);
+							MaterialPosition = P;
 						}
-						if (ValueAtB.IsNull())
+						else
 						{
-							checkVoxelSlow(!ValueAtA.IsNull());
-							static uint8 EdgeIndexMap[10] = {0, 1, 2, 1, 0, 2, 0, 7, 7, 7};
-							EdgeIndex = EdgeIndexMap[EdgeIndex];
-							CacheDirection = CacheDirectionMap[IndexVertexB];
+							checkVoxelSlow(ValueAtB.IsNull());
+							const auto P = Local2DToGlobal<Direction>(PositionB.X, PositionB.Y, 0);
+							IntersectionPoint = FVector(P);
+							MaterialPosition = P;
 						}
 					}
-					const bool bIsVertexCached = ((ValidityMask & CacheDirection) == CacheDirection);
-
-					if (bIsVertexCached)
+					else
 					{
-						checkVoxelSlow(!(CacheDirection & 0x08) && !(CacheDirection & 0x04));
+						const bool bIsAlongX = EdgeIndex == 3 || EdgeIndex == 4 || EdgeIndex == 8;
+						const bool bIsAlongY = EdgeIndex == 5 || EdgeIndex == 6 || EdgeIndex == 9;
 
-						const bool XIsDifferent = !!(CacheDirection & 0x01);
-						const bool YIsDifferent = !!(CacheDirection & 0x02);
-						
-						VertexIndex = Cache2D[GetCacheIndex(EdgeIndex, LX - XIsDifferent, LY - YIsDifferent)];
-						checkVoxelSlow(-1 <= VertexIndex && VertexIndex < Vertices.Num());
-					}
+						checkVoxelSlow((bIsAlongX && !bIsAlongY) || (!bIsAlongX && bIsAlongY));
 
-					if (!bIsVertexCached || VertexIndex == -1)
-					{
-						FVector IntersectionPoint;
-						FIntVector MaterialPosition;
+						int32 Min = bIsAlongX ? PositionA.X : PositionA.Y;
+						int32 Max = bIsAlongX ? PositionB.X : PositionB.Y;
 						
-						const bool bIsLowResChunk = EdgeIndex == 7 || EdgeIndex == 8 || EdgeIndex == 9;
+						FVoxelValue ValueAtACopy = ValueAtA;
+						FVoxelValue ValueAtBCopy = ValueAtB;
 
-						if (EdgeIndex == 0 || EdgeIndex == 1 || EdgeIndex == 2 || EdgeIndex == 7)
+						while (Max - Min != 1)
 						{
-							if (ValueAtA.IsNull())
+							checkError((Max + Min) % 2 == 0);
+							const int32 Middle = (Max + Min) / 2;
+
+							FVoxelValue ValueAtMiddle = MESHER_TIME_RETURN_VALUES(1, GetValue<Direction>(
+								bIsAlongX ? Middle : PositionA.X,
+								bIsAlongY ? Middle : PositionA.Y,
+								bIsLowResChunk ? LOD : HalfLOD));
+
+							if (ValueAtACopy.IsEmpty() == ValueAtMiddle.IsEmpty())
 							{
-								const auto P = Local2DToGlobal<Direction>(PositionA.X, PositionA.Y, 0);
-								IntersectionPoint = FVector(P);
-								MaterialPosition = P;
+								// If min and middle have same sign
+								Min = Middle;
+								ValueAtACopy = ValueAtMiddle;
 							}
 							else
 							{
-								checkVoxelSlow(ValueAtB.IsNull());
-								const auto P = Local2DToGlobal<Direction>(PositionB.X, PositionB.Y, 0);
-								IntersectionPoint = FVector(P);
-								MaterialPosition = P;
+								// If max and middle have same sign
+								Max = Middle;
+								ValueAtBCopy = ValueAtMiddle;
 							}
-						}
-						else
-						{
-							const bool bIsAlongX = EdgeIndex == 3 || EdgeIndex == 4 || EdgeIndex == 8;
-							const bool bIsAlongY = EdgeIndex == 5 || EdgeIndex == 6 || EdgeIndex == 9;
-
-							checkVoxelSlow((bIsAlongX && !bIsAlongY) || (!bIsAlongX && bIsAlongY));
-
-							int32 Min = bIsAlongX ? PositionA.X : PositionA.Y;
-							int32 Max = bIsAlongX ? PositionB.X : PositionB.Y;
-							
-							FVoxelValue ValueAtACopy = ValueAtA;
-							FVoxelValue ValueAtBCopy = ValueAtB;
-
-							while (Max - Min != 1)
-							{
-								checkError((Max + Min) % 2 == 0);
-								const int32 Middle = (Max + Min) / 2;
-
-								FVoxelValue ValueAtMiddle = MESHER_TIME_RETURN_VALUES(1, GetValue<Direction>(
-									bIsAlongX ? Middle : PositionA.X,
-									bIsAlongY ? Middle : PositionA.Y,
-									bIsLowResChunk ? LOD : HalfLOD));
-
-								if (ValueAtACopy.IsEmpty() == ValueAtMiddle.IsEmpty())
-								{
-									// If min and middle have same sign
-									Min = Middle;
-									ValueAtACopy = ValueAtMiddle;
-								}
-								else
-								{
-									// If max and middle have same sign
-									Max = Middle;
-									ValueAtBCopy = ValueAtMiddle;
-								}
 
-								checkError(Min <= Max);
-							}
+							checkError(Min <= Max);
+						}
 
-							const float Alpha = ValueAtACopy.ToFloat() / (ValueAtACopy.ToFloat() - ValueAtBCopy.ToFloat());
-							checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
+						const float Alpha = ValueAtACopy.ToFloat() / (ValueAtACopy.ToFloat() - ValueAtBCopy.ToFloat());
+						checkError(!FMath::IsNaN(Alpha) && FMath::IsFinite(Alpha));
 
-							const FIntVector GlobalMin = Local2DToGlobal<Direction>(
-								bIsAlongX ? Min : PositionA.X,
-								bIsAlongY ? Min : PositionA.Y,
-								0);
-							const FIntVector GlobalMax = Local2DToGlobal<Direction>(
-								bIsAlongX ? Max : PositionA.X,
-								bIsAlongY ? Max : PositionA.Y,
-								0);
+						const FIntVector GlobalMin = Local2DToGlobal<Direction>(
+							bIsAlongX ? Min : PositionA.X,
+							bIsAlongY ? Min : PositionA.Y,
+							0);
+						const FIntVector GlobalMax = Local2DToGlobal<Direction>(
+							bIsAlongX ? Max : PositionA.X,
+							bIsAlongY ? Max : PositionA.Y,
+							0);
 
-							IntersectionPoint = FMath::Lerp(FVector(GlobalMin), FVector(GlobalMax), Alpha);
+						IntersectionPoint = FMath::Lerp(FVector(GlobalMin), FVector(GlobalMax), Alpha);
 
-							// Get intersection material
-							if (!ValueAtACopy.IsEmpty())
-							{
-								checkVoxelSlow(ValueAtBCopy.IsEmpty());
-								MaterialPosition = GlobalMin;
-							}
-							else
-							{
-								checkVoxelSlow(!ValueAtBCopy.IsEmpty());
-								MaterialPosition = GlobalMax;
-							}
+						// Get intersection material
+						if (!ValueAtACopy.IsEmpty())
+						{
+							checkVoxelSlow(ValueAtBCopy.IsEmpty());
+							MaterialPosition = GlobalMin;
 						}
-
-						VertexIndex = Vertices.Num();								
-						Vertices.Emplace(T(IntersectionPoint, MaterialPosition, bIsLowResChunk));
-
-						// If own vertex, save it
-						if (CacheDirection & 0x08)
+						else
 						{
-							Cache2D[GetCacheIndex(EdgeIndex, LX, LY)] = VertexIndex;
+							checkVoxelSlow(!ValueAtBCopy.IsEmpty());
+							MaterialPosition = GlobalMax;
 						}
 					}
 
-					VertexIndices[i] = VertexIndex;
-					checkVoxelSlow(0 <= VertexIndex && VertexIndex < Vertices.Num());
-				}
-				
-				// Add triangles
-				// 3 vertex per triangle
-				const int32 NumIndices = 3 * CellData.GetTriangleCount();
-				if (bFlip)
-				{
-					for (int32 Index = 0; Index < NumIndices; Index += 3)
+					VertexIndex = Vertices.Num();								
+					Vertices.Emplace(T(IntersectionPoint, MaterialPosition, bIsLowResChunk));
+
+					// If own vertex, save it
+					if (CacheDirection & 0x08)
 					{
-						Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 0)]]);
-						Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 1)]]);
-						Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 2)]]);
+						Buffers.Cache2D[GetCacheIndex(EdgeIndex, LX, LY)] = VertexIndex;
 					}
 				}
-				else
+
+				VertexIndices[i] = VertexIndex;
+				checkVoxelSlow(0 <= VertexIndex && VertexIndex < Vertices.Num());
+			}
+			
+			// Add triangles
+			// 3 vertex per triangle
+			const int32 NumIndices = 3 * CellData.GetTriangleCount();
+			if (bFlip)
+			{
+				for (int32 Index = 0; Index < NumIndices; Index += 3)
 				{
-					for (int32 Index = 0; Index < NumIndices; Index += 3)
-					{
-						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 0]]);
-						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 1]]);
-						Indices.Add(VertexIndices[CellData.vertexIndex[Index + 2]]);
-					}
+					Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 0)]]);
+					Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 1)]]);
+					Indices.Add(VertexIndices[CellData.vertexIndex[NumIndices - 1 - (Index + 2)]]);
+				}
+			}
+			else
+			{
+				for (int32 Index = 0; Index < NumIndices; Index += 3)
+				{
+					Indices.Add(VertexIndices[CellData.vertexIndex[Index + 0]]);
+					Indices.Add(VertexIndices[CellData.vertexIndex[Index + 1]]);
+					Indices.Add(VertexIndices[CellData.vertexIndex[Index + 2]]);
 				}
 			}
 		}
@@ -1078,32 +1447,25 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMarchingCubeTransitionsMesher::CreateFull
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 	
-	struct FLocalVertex
-	{
-		FVector Position;
-		FIntVector MaterialPosition;
-		bool bNeedToTranslateVertex;
-
-		FLocalVertex() = default;
-		FORCEINLINE FLocalVertex(const FVector& Position, const FIntVector& MaterialPosition, bool bNeedToTranslateVertex)
-			: Position(Position)
-			, MaterialPosition(MaterialPosition)
-			, bNeedToTranslateVertex(bNeedToTranslateVertex)
-		{
-		}
-	};
-
-	TArray<uint32> Indices;
-	TArray<FLocalVertex> Vertices;
+	TArray<uint32>& Indices = Scratch.Indices;
+	TArray<FVoxelMarchingCubeTransitionsMesherBuffers::FVertex>& Vertices = Buffers.Vertices;
+	TArray<FVoxelMesherVertex>& MesherVertices = Scratch.Vertices;
+	Indices.Reset();
+	Vertices.Reset();
+	MesherVertices.Reset();
 
 	if (!CreateGeometryTemplate(Times, Indices, Vertices))
 	{
 		return {};
 	}
 
-	TArray<FVoxelMesherVertex> MesherVertices = FMarchingCubeHelpers::CreateMesherVertices(Vertices);
+	FMarchingCubeHelpers::CreateMesherVertices(MesherVertices, Vertices);
 
 	MESHER_TIME_MATERIALS(MesherVertices.Num(), FMarchingCubeHelpers::ComputeMaterials(*this, MesherVertices, Vertices));
+	if (AbortIfLockConflict())
+	{
+		return {};
+	}
 	MESHER_TIME(Normals, FMarchingCubeHelpers::ComputeNormals(*this, MesherVertices, Indices));
 
 	UnlockData();
@@ -1128,7 +1490,7 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMarchingCubeTransitionsMesher::CreateFull
 	// Important: sanitize AFTER translating!
 	FVoxelMesherUtilities::SanitizeMesh(Indices, MesherVertices);
 
-	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(Settings, LOD, MoveTemp(Indices), MoveTemp(MesherVertices)));
+	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(Settings, LOD, Indices, MesherVertices));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
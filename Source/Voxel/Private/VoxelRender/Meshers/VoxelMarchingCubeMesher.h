@@ -6,12 +6,51 @@
 #include "VoxelContainers/VoxelStaticArray.h"
 #include "VoxelData/VoxelDataAccelerator.h"
 #include "VoxelRender/Meshers/VoxelMesher.h"
+#include "VoxelRender/Meshers/VoxelMesherUtilities.h"
+#include "VoxelRender/Meshers/VoxelMesherScratch.h"
 
 #define CHUNK_SIZE_WITH_END_EDGE (RENDER_CHUNK_SIZE + 1)
 #define CHUNK_SIZE_WITH_NORMALS (RENDER_CHUNK_SIZE + 3)
 
 #define EDGE_INDEX_COUNT 4
 
+static_assert(RENDER_CHUNK_SIZE < 64, "Cells of a row are packed in an uint64");
+
+// Stored in a FVoxelMesherScratch
+struct FVoxelMarchingCubeMesherBuffers
+{
+	struct FVertex
+	{
+		FVector Position;
+		FIntVector MaterialPosition;
+
+		FVertex() = default;
+		FORCEINLINE FVertex(const FVector& Position, const FIntVector& MaterialPosition)
+			: Position(Position)
+			, MaterialPosition(MaterialPosition)
+		{
+		}
+	};
+
+	// Use LOD0 size as it's bigger
+	TVoxelStaticArray<FVoxelValue, CHUNK_SIZE_WITH_NORMALS * CHUNK_SIZE_WITH_NORMALS * CHUNK_SIZE_WITH_NORMALS> CachedValues;
+	TVoxelStaticArray<int32, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * EDGE_INDEX_COUNT> CacheA;
+	TVoxelStaticArray<int32, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * EDGE_INDEX_COUNT> CacheB;
+	TVoxelSignBitmask<CHUNK_SIZE_WITH_NORMALS> SignBitmask;
+
+	TArray<FVertex> Vertices;
+	int32 LearnedNumVertices = 0;
+
+	void Release()
+	{
+		FVoxelMesherScratch::ResetArray(Vertices, LearnedNumVertices);
+	}
+	int64 GetAllocatedSize() const
+	{
+		return sizeof(*this) + Vertices.GetAllocatedSize();
+	}
+};
+
 class FVoxelMarchingCubeMesher : public FVoxelMesher
 {
 public:
@@ -37,27 +76,32 @@ public:
 	}
 
 private:
-	// Use LOD0 size as it's bigger
-	using FCachedValues = TVoxelStaticArray<FVoxelValue, CHUNK_SIZE_WITH_NORMALS * CHUNK_SIZE_WITH_NORMALS * CHUNK_SIZE_WITH_NORMALS>;
-	using FCache = TVoxelStaticArray<int32, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * EDGE_INDEX_COUNT>;
-
-	TUniquePtr<FCachedValues> CachedValuesStorage = MakeUnique<FCachedValues>();
-	TUniquePtr<FCache> CacheStorageA = MakeUnique<FCache>();
-	TUniquePtr<FCache> CacheStorageB = MakeUnique<FCache>();
+	FVoxelMarchingCubeMesherBuffers& Buffers = Scratch.GetMarchingCubeBuffers();
 	
 	TUniquePtr<FVoxelConstDataAccelerator> Accelerator;
 
-	FVoxelValue* RESTRICT const CachedValues = CachedValuesStorage->GetData();
+	FVoxelValue* RESTRICT const CachedValues = Buffers.CachedValues.GetData();
 
 	// Cache to get index of already created vertices
-	int32* RESTRICT CurrentCache = CacheStorageA->GetData();
-	int32* RESTRICT OldCache = CacheStorageB->GetData();
+	int32* RESTRICT CurrentCache = Buffers.CacheA.GetData();
+	int32* RESTRICT OldCache = Buffers.CacheB.GetData();
 
 private:
 	// T: will be created as T(IntersectionPoint, MaterialPosition)
 	template<typename T>
 	bool CreateGeometryTemplate(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<T>& Vertices);
 
+	// Query the values needed to polygonize the cells with LZ in [StartLZ, EndLZ)
+	bool QueryValues(FVoxelMesherTimes& Times, int32 StartLZ, int32 EndLZ);
+	// Polygonize the cells with LZ in [StartLZ, EndLZ). Vertices are not shared with the cells below StartLZ
+	template<typename T>
+	bool Polygonize(FVoxelMesherTimes& Times, int32 StartLZ, int32 EndLZ, TArray<uint32>& Indices, TArray<T>& Vertices);
+
+private:
+	// Only remesh the slabs of ChunkCache touched by ChunkCacheDirtyBounds
+	bool CanRemeshIncrementally() const;
+	TVoxelSharedPtr<FVoxelChunkMesh> CreateIncrementalChunkImpl(FVoxelMesherTimes& Times);
+
 private:
 	static int32 GetCacheIndex(int32 EdgeIndex, int32 LX, int32 LY);
 	
@@ -65,6 +109,42 @@ private:
 };
 
 #define TRANSITION_EDGE_INDEX_COUNT 10
+#define TRANSITION_FACE_SIZE (2 * RENDER_CHUNK_SIZE + 1)
+
+// Stored in a FVoxelMesherScratch
+struct FVoxelMarchingCubeTransitionsMesherBuffers
+{
+	struct FVertex
+	{
+		FVector Position;
+		FIntVector MaterialPosition;
+		bool bNeedToTranslateVertex;
+
+		FVertex() = default;
+		FORCEINLINE FVertex(const FVector& Position, const FIntVector& MaterialPosition, bool bNeedToTranslateVertex)
+			: Position(Position)
+			, MaterialPosition(MaterialPosition)
+			, bNeedToTranslateVertex(bNeedToTranslateVertex)
+		{
+		}
+	};
+
+	TVoxelStaticArray<int32, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * TRANSITION_EDGE_INDEX_COUNT> Cache2D;
+	// High resolution values of the face being polygonized
+	TVoxelStaticArray<FVoxelValue, TRANSITION_FACE_SIZE * TRANSITION_FACE_SIZE> FaceValues;
+
+	TArray<FVertex> Vertices;
+	int32 LearnedNumVertices = 0;
+
+	void Release()
+	{
+		FVoxelMesherScratch::ResetArray(Vertices, LearnedNumVertices);
+	}
+	int64 GetAllocatedSize() const
+	{
+		return sizeof(*this) + Vertices.GetAllocatedSize();
+	}
+};
 
 class FVoxelMarchingCubeTransitionsMesher : public FVoxelTransitionsMesher
 {
@@ -77,8 +157,8 @@ protected:
 	virtual TVoxelSharedPtr<FVoxelChunkMesh> CreateFullChunkImpl(FVoxelMesherTimes& Times) override final;
 
 private:
+	FVoxelMarchingCubeTransitionsMesherBuffers& Buffers = Scratch.GetMarchingCubeTransitionsBuffers();
 	TUniquePtr<FVoxelConstDataAccelerator> Accelerator;
-	TVoxelStaticArray<int32, RENDER_CHUNK_SIZE * RENDER_CHUNK_SIZE * TRANSITION_EDGE_INDEX_COUNT> Cache2D;
 
 private:
 	// T: will be created as T(IntersectionPoint, MaterialPosition, bNeedToTranslate)
@@ -1,10 +1,12 @@
 // Copyright Voxel Plugin SAS. All Rights Reserved.
 
 #include "VoxelRender/Meshers/VoxelMesher.h"
+#include "VoxelRender/Meshers/VoxelMesherChunkCache.h"
 #include "VoxelRender/VoxelMesherAsyncWork.h"
 #include "VoxelRender/VoxelChunkMesh.h"
 #include "VoxelRender/IVoxelRenderer.h"
 #include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelData/VoxelDataLock.h"
 #include "VoxelDebug/VoxelDebugManager.h"
 #include "VoxelUtilities/VoxelStatsUtilities.h"
 
@@ -17,6 +19,18 @@ static TAutoConsoleVariable<int32> CVarDoNotSkipEmptyChunks(
 	TEXT("If true, all chunks will be computed"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarOptimisticLocks(
+	TEXT("voxel.mesher.OptimisticLocks"),
+	1,
+	TEXT("If true, meshers release their data locks early when an edit is waiting on them, and mesh the chunk again once the edit is done"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMaxOptimisticLockRetries(
+	TEXT("voxel.mesher.MaxOptimisticLockRetries"),
+	4,
+	TEXT("Number of times a mesher can be preempted by edits before using a regular lock"),
+	ECVF_Default);
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -75,6 +89,8 @@ struct FVoxelMesherStats
 		uint64 TotalMaterialsAccesses = 0;
 
 		double TotalDistanceFieldsTime = 0;
+		double TotalSimplificationTime = 0;
+		uint64 TotalTrianglesRemoved = 0;
 		
 		const auto Print = [&](const TArray<FChunkStats>& Stats)
 		{
@@ -89,12 +105,14 @@ struct FVoxelMesherStats
 				double NormalsTime = 0;
 				double UVsTime = 0;
 				double CreateChunkTime = 0;
+				double SimplificationTime = 0;
 
 				double FinishCreatingChunkTime = 0;
 				double DistanceFieldTime = 0;
 
 				uint64 ValuesAccesses = 0;
 				uint64 MaterialsAccesses = 0;
+				uint64 TrianglesRemoved = 0;
 			};
 			TMap<int32, FMean> LODToMeans;
 			double GlobalTotalTime = 0;
@@ -110,19 +128,21 @@ struct FVoxelMesherStats
 				Mean.NormalsTime += FPlatformTime::ToSeconds64(Stat.Times.Normals);
 				Mean.UVsTime += FPlatformTime::ToSeconds64(Stat.Times.UVs);
 				Mean.CreateChunkTime += FPlatformTime::ToSeconds64(Stat.Times.CreateChunk);
+				Mean.SimplificationTime += FPlatformTime::ToSeconds64(Stat.Times.Simplification);
 				
 				Mean.FinishCreatingChunkTime += FPlatformTime::ToSeconds64(Stat.Times.FinishCreatingChunk);
 				Mean.DistanceFieldTime += FPlatformTime::ToSeconds64(Stat.Times.DistanceField);
 
 				Mean.ValuesAccesses += Stat.Times._ValuesAccesses;
 				Mean.MaterialsAccesses += Stat.Times._MaterialsAccesses;
+				Mean.TrianglesRemoved += Stat.Times._TrianglesRemoved;
 				
 				GlobalTotalTime += Stat.Time;
 			}
 
 			LODToMeans.KeySort(TLess<int32>());
 
-			LOG_VOXEL(Log, TEXT("\tLOD; Chunks (%%)     ; Total (%%)         ; Avg       ; Values (%%)        , Per Voxel ; Materials (%%)     , Per Voxel ; Normals (%%)       ; UVs (%%)           ; CreateChunk (%%)   ; FinishCreatingChunk (%%); DistanceFields (%%)"));
+			LOG_VOXEL(Log, TEXT("\tLOD; Chunks (%%)     ; Total (%%)         ; Avg       ; Values (%%)        , Per Voxel ; Materials (%%)     , Per Voxel ; Normals (%%)       ; UVs (%%)           ; CreateChunk (%%)   ; Simplification (%%), Tris Removed; FinishCreatingChunk (%%); DistanceFields (%%)"));
 			for (auto& It : LODToMeans)
 			{
 				auto& V = It.Value;
@@ -133,8 +153,10 @@ struct FVoxelMesherStats
 				TotalMaterialsAccesses += V.MaterialsAccesses;
 
 				TotalDistanceFieldsTime += V.DistanceFieldTime;
+				TotalSimplificationTime += V.SimplificationTime;
+				TotalTrianglesRemoved += V.TrianglesRemoved;
 				
-				LOG_VOXEL(Log, TEXT("\t %2d: %6d (%5.2f%%); %8.3fs (%5.2f%%); %8.3fms; %8.3fs (%5.2f%%), %8.1fns; %8.3fs (%5.2f%%), %8.1fns; %8.3fs (%5.2f%%); %8.3fs (%5.2f%%); %8.3fs (%5.2f%%);      %8.3fs (%5.2f%%); %8.3fs (%5.2f%%)"),
+				LOG_VOXEL(Log, TEXT("\t %2d: %6d (%5.2f%%); %8.3fs (%5.2f%%); %8.3fms; %8.3fs (%5.2f%%), %8.1fns; %8.3fs (%5.2f%%), %8.1fns; %8.3fs (%5.2f%%); %8.3fs (%5.2f%%); %8.3fs (%5.2f%%), %12llu;      %8.3fs (%5.2f%%); %8.3fs (%5.2f%%)"),
 					It.Key,
 					V.Count,
 					V.Count / double(Stats.Num()) * 100,
@@ -159,6 +181,10 @@ struct FVoxelMesherStats
 					V.CreateChunkTime,
 					V.CreateChunkTime / V.TotalTime * 100,
 					
+					V.SimplificationTime,
+					V.SimplificationTime / V.TotalTime * 100,
+					V.TrianglesRemoved,
+					
 					V.FinishCreatingChunkTime,
 					V.FinishCreatingChunkTime / V.TotalTime * 100,
 					
@@ -191,6 +217,7 @@ struct FVoxelMesherStats
 		LOG_VOXEL(Log, TEXT("Total Time: %fs"), TotalTime);
 		LOG_VOXEL(Log, TEXT("Values Time: %3.2f%% of total time (%fs)"), 100 * TotalValuesTime / TotalTime, TotalValuesTime);
 		LOG_VOXEL(Log, TEXT("Distance Fields Time: %3.2f%% of total time (%fs)"), 100 * TotalDistanceFieldsTime / TotalTime, TotalDistanceFieldsTime);
+		LOG_VOXEL(Log, TEXT("Simplification Time: %3.2f%% of total time (%fs), %llu triangles removed"), 100 * TotalSimplificationTime / TotalTime, TotalSimplificationTime, TotalTrianglesRemoved);
 		LOG_VOXEL(Log, TEXT("Transitions Time: %3.2f%% of Main + Transitions"), 100 * TransitionsTime / (NormalTime + TransitionsTime));
 		LOG_VOXEL(Log, TEXT("------------------------------"));
 		LOG_VOXEL(Log, TEXT("Values: %llu reads in %fs, avg %.1fns/voxel"), TotalValuesAccesses, TotalValuesTime, TotalValuesTime / TotalValuesAccesses * 1e9);
@@ -218,6 +245,7 @@ FVoxelMesherBase::FVoxelMesherBase(
 	int32 LOD,
 	const FIntVector& ChunkPosition,
 	const FVoxelRendererSettings& Settings,
+	FVoxelMesherScratch& Scratch,
 	bool bIsTransitions)
 	: LOD(LOD)
 	, Step(1 << LOD)
@@ -226,6 +254,7 @@ FVoxelMesherBase::FVoxelMesherBase(
 	, Settings(Settings)
 	, Data(*Settings.Data)
 	, bIsTransitions(bIsTransitions)
+	, Scratch(Scratch)
 {
 }
 
@@ -240,7 +269,42 @@ void FVoxelMesherBase::UnlockData()
 
 void FVoxelMesherBase::LockData()
 {
-	LockInfo = Data.Lock(EVoxelLockType::Read, GetBoundsToLock(), "Mesher");
+	bLockConflict = false;
+
+	if (CVarOptimisticLocks.GetValueOnAnyThread() == 0)
+	{
+		LockInfo = Data.Lock(EVoxelLockType::Read, GetBoundsToLock(), "Mesher");
+	}
+	else if (NumLockConflicts >= CVarMaxOptimisticLockRetries.GetValueOnAnyThread())
+	{
+		// Make sure we make progress if the area is continuously edited
+		FVoxelDataLockStats::ReportOptimisticFallback();
+		LockInfo = Data.Lock(EVoxelLockType::Read, GetBoundsToLock(), "Mesher");
+	}
+	else
+	{
+		LockInfo = Data.LockOptimistic(GetBoundsToLock(), "Mesher");
+	}
+}
+
+bool FVoxelMesherBase::AbortIfLockConflict()
+{
+	if (bLockConflict)
+	{
+		return true;
+	}
+	if (Data.IsLockValid(*LockInfo))
+	{
+		return false;
+	}
+
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	FVoxelDataLockStats::ReportOptimisticConflict();
+
+	bLockConflict = true;
+	NumLockConflicts++;
+	UnlockData();
+	return true;
 }
 
 bool FVoxelMesherBase::IsEmpty() const
@@ -300,8 +364,9 @@ void FVoxelMesherBase::FinishCreatingChunk(FVoxelChunkMesh& Chunk) const
 FVoxelMesher::FVoxelMesher(
 	int32 LOD,
 	const FIntVector& ChunkPosition,
-	const FVoxelRendererSettings& Settings)
-	: FVoxelMesherBase(LOD, ChunkPosition, Settings, false)
+	const FVoxelRendererSettings& Settings,
+	FVoxelMesherScratch& Scratch)
+	: FVoxelMesherBase(LOD, ChunkPosition, Settings, Scratch, false)
 {
 }
 
@@ -319,6 +384,10 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesher::CreateFullChunk()
 	TVoxelSharedPtr<FVoxelChunkMesh> Chunk;
 	if (IsEmpty())
 	{
+		if (ChunkCache)
+		{
+			ChunkCache->SetEmpty();
+		}
 		Chunk = CreateEmptyChunk();
 		FinishCreatingChunk(*Chunk);
 		UnlockData();
@@ -331,6 +400,15 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesher::CreateFullChunk()
 		Chunk = CreateFullChunkImpl(Times);
 		check(!LockInfo.IsValid());
 
+		// An edit preempted the lock: mesh again with the edited data
+		while (bLockConflict)
+		{
+			Times = {};
+			LockData();
+			Chunk = CreateFullChunkImpl(Times);
+			check(!LockInfo.IsValid());
+		}
+
 		if (Chunk.IsValid())
 		{
 			{
@@ -373,6 +451,17 @@ void FVoxelMesher::CreateGeometry(TArray<uint32>& Indices, TArray<FVector>& Vert
 		FVoxelMesherTimes Times;
 		CreateGeometryImpl(Times, Indices, Vertices);
 		check(!LockInfo.IsValid());
+
+		// An edit preempted the lock: mesh again with the edited data
+		while (bLockConflict)
+		{
+			Times = {};
+			Indices.Reset();
+			Vertices.Reset();
+			LockData();
+			CreateGeometryImpl(Times, Indices, Vertices);
+			check(!LockInfo.IsValid());
+		}
 		const double EndTime = FPlatformTime::Seconds();
 		FVoxelMesherStats::Report(Settings.World, LOD, EndTime - StartTime, Times, false, true);
 	}
@@ -386,8 +475,9 @@ FVoxelTransitionsMesher::FVoxelTransitionsMesher(
 	int32 LOD,
 	const FIntVector& ChunkPosition,
 	const FVoxelRendererSettings& Settings,
+	FVoxelMesherScratch& Scratch,
 	uint8 TransitionsMask)
-	: FVoxelMesherBase(LOD, ChunkPosition, Settings, true)
+	: FVoxelMesherBase(LOD, ChunkPosition, Settings, Scratch, true)
 	, TransitionsMask(TransitionsMask)
 	, HalfLOD(LOD - 1)
 	, HalfStep(Step / 2)
@@ -417,6 +507,15 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelTransitionsMesher::CreateFullChunk()
 		Chunk = CreateFullChunkImpl(Times);
 		check(!LockInfo.IsValid());
 
+		// An edit preempted the lock: mesh again with the edited data
+		while (bLockConflict)
+		{
+			Times = {};
+			LockData();
+			Chunk = CreateFullChunkImpl(Times);
+			check(!LockInfo.IsValid());
+		}
+
 		if (Chunk.IsValid())
 		{
 			MESHER_TIME_SCOPE(FinishCreatingChunk)
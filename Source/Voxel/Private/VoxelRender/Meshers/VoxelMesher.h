@@ -9,6 +9,8 @@
 struct FVoxelRendererSettings;
 struct FVoxelChunkMesh;
 class FVoxelData;
+class FVoxelMesherScratch;
+class FVoxelMesherChunkCache;
 class FVoxelDataLockInfo;
 
 #if ENABLE_MESHER_STATS
@@ -63,6 +65,8 @@ struct FVoxelMesherTimes
 	uint64 Normals = 0;
 	uint64 UVs = 0;
 	uint64 CreateChunk = 0;
+	uint64 Simplification = 0;
+	uint64 _TrianglesRemoved = 0;
 	
 	uint64 FinishCreatingChunk = 0;
 	uint64 DistanceField = 0;
@@ -78,11 +82,16 @@ public:
 	const FVoxelRendererSettings& Settings;
 	const FVoxelData& Data;
 	const bool bIsTransitions;
+	// Buffers reused between chunks. Only used by this mesher while it's alive
+	FVoxelMesherScratch& Scratch;
+	// Set for chunks an edit is waiting on: the mesher can use worker threads to finish them sooner
+	bool bHighPriority = false;
 
 	FVoxelMesherBase(
 		int32 LOD,
 		const FIntVector& ChunkPosition,
 		const FVoxelRendererSettings& Settings,
+		FVoxelMesherScratch& Scratch,
 		bool bIsTransitions);
 	virtual ~FVoxelMesherBase();
 
@@ -96,9 +105,16 @@ protected:
 	virtual FVoxelIntBox GetBoundsToLock() const = 0;
 
 	void UnlockData();
+
+	// Meshers lock the data optimistically: an edit waiting on the lock bumps the locked octrees versions
+	// In that case, this unlocks the data and returns true: the mesher must return early, and will be run again once the edit is done
+	// Returns true if the lock was already released because of a conflict
+	bool AbortIfLockConflict();
 	
 private:
 	TUniquePtr<FVoxelDataLockInfo> LockInfo;
+	bool bLockConflict = false;
+	int32 NumLockConflicts = 0;
 
 	void LockData();
 	bool IsEmpty() const;
@@ -114,12 +130,24 @@ public:
 	FVoxelMesher(
 		int32 LOD,
 		const FIntVector& ChunkPosition,
-		const FVoxelRendererSettings& Settings);
+		const FVoxelRendererSettings& Settings,
+		FVoxelMesherScratch& Scratch);
 
 	virtual TVoxelSharedPtr<FVoxelChunkMesh> CreateFullChunk() override final;
 	virtual void CreateGeometry(TArray<uint32>& Indices, TArray<FVector>& Vertices) override final;
 
+	// Use the previous mesh of the chunk to only remesh the parts of it in DirtyBounds. If DirtyBounds is invalid, everything is remeshed
+	// The cache is updated with the new mesh. Ignored by meshers not supporting incremental remeshing
+	void SetChunkCache(FVoxelMesherChunkCache* InChunkCache, const FVoxelIntBoxWithValidity& InDirtyBounds)
+	{
+		ChunkCache = InChunkCache;
+		ChunkCacheDirtyBounds = InDirtyBounds;
+	}
+
 protected:
+	FVoxelMesherChunkCache* ChunkCache = nullptr;
+	FVoxelIntBoxWithValidity ChunkCacheDirtyBounds;
+	
 	// Need to call UnlockData
 	virtual TVoxelSharedPtr<FVoxelChunkMesh> CreateFullChunkImpl(FVoxelMesherTimes& Times) = 0;
 	// Need to call UnlockData
@@ -137,6 +165,7 @@ public:
 		int32 LOD,
 		const FIntVector& ChunkPosition,
 		const FVoxelRendererSettings& Settings,
+		FVoxelMesherScratch& Scratch,
 		uint8 TransitionsMask);
 
 	virtual TVoxelSharedPtr<FVoxelChunkMesh> CreateFullChunk() override final;
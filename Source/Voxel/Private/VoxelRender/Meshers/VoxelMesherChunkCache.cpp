@@ -0,0 +1,48 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelRender/Meshers/VoxelMesherChunkCache.h"
+
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelMesherChunkCacheMemory);
+
+FVoxelMesherChunkCache::~FVoxelMesherChunkCache()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherChunkCacheMemory, AllocatedSize);
+}
+
+void FVoxelMesherChunkCache::SetValid()
+{
+	bIsValid = true;
+	UpdateStats();
+}
+
+void FVoxelMesherChunkCache::Invalidate()
+{
+	for (FSlab& Slab : Slabs)
+	{
+		Slab.Indices.Empty();
+		Slab.Vertices.Empty();
+	}
+
+	bIsValid = false;
+	UpdateStats();
+}
+
+void FVoxelMesherChunkCache::SetEmpty()
+{
+	Invalidate();
+	bIsValid = true;
+}
+
+void FVoxelMesherChunkCache::UpdateStats()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherChunkCacheMemory, AllocatedSize);
+
+	AllocatedSize = 0;
+	for (const FSlab& Slab : Slabs)
+	{
+		AllocatedSize += Slab.Indices.GetAllocatedSize();
+		AllocatedSize += Slab.Vertices.GetAllocatedSize();
+	}
+
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherChunkCacheMemory, AllocatedSize);
+}
@@ -0,0 +1,68 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelRender/Meshers/VoxelMesherUtilities.h"
+
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Mesher Chunk Cache Memory"), STAT_VoxelMesherChunkCacheMemory, STATGROUP_VoxelMemory, VOXEL_API);
+
+/**
+ * Mesh of a chunk kept by the renderer between remeshes, when FVoxelRendererSettings::IncrementalRemeshMaxLOD allows it
+ *
+ * The chunk cells are split in slabs along Z, each slab being meshed independently.
+ * When the chunk is updated because of an edit, only the slabs near the edit are remeshed:
+ * the other slabs are reused as is, and all the slabs are then concatenated into the new chunk mesh
+ *
+ * Owned by the chunk, and moved to its main mesher task while it's running
+ */
+class FVoxelMesherChunkCache
+{
+public:
+	static constexpr int32 SlabSize = 4;
+	static constexpr int32 NumSlabs = RENDER_CHUNK_SIZE / SlabSize;
+	static_assert(RENDER_CHUNK_SIZE % SlabSize == 0, "");
+
+	struct FSlab
+	{
+		// Relative to the slab vertices
+		TArray<uint32> Indices;
+		// Fully built vertices, with materials, normals and UVs
+		TArray<FVoxelMesherVertex> Vertices;
+	};
+
+	FVoxelMesherChunkCache() = default;
+	~FVoxelMesherChunkCache();
+
+	UE_NONCOPYABLE(FVoxelMesherChunkCache);
+
+	// If false, all the slabs need to be built
+	bool IsValid() const { return bIsValid; }
+
+	FSlab& GetSlab(int32 Index)
+	{
+		check(0 <= Index && Index < NumSlabs);
+		return Slabs[Index];
+	}
+	const FSlab& GetSlab(int32 Index) const
+	{
+		check(0 <= Index && Index < NumSlabs);
+		return Slabs[Index];
+	}
+
+	// Call once all the slabs are built
+	void SetValid();
+	// Frees the slabs: they will all be rebuilt by the next remesh
+	void Invalidate();
+	// Valid with no triangles, used when the chunk is empty
+	void SetEmpty();
+
+private:
+	bool bIsValid = false;
+	FSlab Slabs[NumSlabs];
+
+	int64 AllocatedSize = 0;
+
+	void UpdateStats();
+};
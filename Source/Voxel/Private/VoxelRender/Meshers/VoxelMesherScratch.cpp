@@ -0,0 +1,127 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelRender/Meshers/VoxelMesherScratch.h"
+#include "VoxelRender/Meshers/VoxelMarchingCubeMesher.h"
+#include "VoxelRender/Meshers/VoxelSurfaceNetMesher.h"
+#include "VoxelRender/Meshers/VoxelCubicMesher.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelMesherScratchMemory);
+
+FVoxelMesherScratch::~FVoxelMesherScratch()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherScratchMemory, AllocatedSize);
+}
+
+FVoxelMarchingCubeMesherBuffers& FVoxelMesherScratch::GetMarchingCubeBuffers()
+{
+	if (!MarchingCubeBuffers.IsValid())
+	{
+		MarchingCubeBuffers = MakeUnique<FVoxelMarchingCubeMesherBuffers>();
+	}
+	return *MarchingCubeBuffers;
+}
+
+FVoxelMarchingCubeTransitionsMesherBuffers& FVoxelMesherScratch::GetMarchingCubeTransitionsBuffers()
+{
+	if (!MarchingCubeTransitionsBuffers.IsValid())
+	{
+		MarchingCubeTransitionsBuffers = MakeUnique<FVoxelMarchingCubeTransitionsMesherBuffers>();
+	}
+	return *MarchingCubeTransitionsBuffers;
+}
+
+FVoxelSurfaceNetMesherBuffers& FVoxelMesherScratch::GetSurfaceNetBuffers()
+{
+	if (!SurfaceNetBuffers.IsValid())
+	{
+		SurfaceNetBuffers = MakeUnique<FVoxelSurfaceNetMesherBuffers>();
+	}
+	return *SurfaceNetBuffers;
+}
+
+FVoxelCubicMesherBuffers& FVoxelMesherScratch::GetCubicBuffers()
+{
+	if (!CubicBuffers.IsValid())
+	{
+		CubicBuffers = MakeUnique<FVoxelCubicMesherBuffers>();
+	}
+	return *CubicBuffers;
+}
+
+void FVoxelMesherScratch::Release()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	ResetArray(Indices, LearnedNumIndices);
+	ResetArray(Vertices, LearnedNumVertices);
+	ResetArray(TempVertices, LearnedNumTempVertices);
+
+	if (MarchingCubeBuffers.IsValid())
+	{
+		MarchingCubeBuffers->Release();
+	}
+	if (MarchingCubeTransitionsBuffers.IsValid())
+	{
+		MarchingCubeTransitionsBuffers->Release();
+	}
+
+	UpdateAllocatedSize();
+}
+
+void FVoxelMesherScratch::UpdateAllocatedSize()
+{
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherScratchMemory, AllocatedSize);
+
+	AllocatedSize = 0;
+	AllocatedSize += Indices.GetAllocatedSize();
+	AllocatedSize += Vertices.GetAllocatedSize();
+	AllocatedSize += TempVertices.GetAllocatedSize();
+	if (MarchingCubeBuffers.IsValid())
+	{
+		AllocatedSize += MarchingCubeBuffers->GetAllocatedSize();
+	}
+	if (MarchingCubeTransitionsBuffers.IsValid())
+	{
+		AllocatedSize += MarchingCubeTransitionsBuffers->GetAllocatedSize();
+	}
+	if (SurfaceNetBuffers.IsValid())
+	{
+		AllocatedSize += sizeof(FVoxelSurfaceNetMesherBuffers);
+	}
+	if (CubicBuffers.IsValid())
+	{
+		AllocatedSize += sizeof(FVoxelCubicMesherBuffers);
+	}
+
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelMesherScratchMemory, AllocatedSize);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+TUniquePtr<FVoxelMesherScratch> FVoxelMesherScratchPool::Allocate()
+{
+	{
+		FScopeLock Lock(&Section);
+		if (FreeScratches.Num() > 0)
+		{
+			return FreeScratches.Pop(UE_505_SWITCH(false, EAllowShrinking::No));
+		}
+	}
+
+	VOXEL_ASYNC_SCOPE_COUNTER("FVoxelMesherScratchPool::Allocate New");
+	return MakeUnique<FVoxelMesherScratch>();
+}
+
+void FVoxelMesherScratchPool::Free(TUniquePtr<FVoxelMesherScratch> Scratch)
+{
+	check(Scratch.IsValid());
+
+	// Outside of the lock, can be expensive if freeing memory
+	Scratch->Release();
+
+	FScopeLock Lock(&Section);
+	FreeScratches.Add(MoveTemp(Scratch));
+}
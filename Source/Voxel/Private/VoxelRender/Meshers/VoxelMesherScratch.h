@@ -0,0 +1,117 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelRender/Meshers/VoxelMesherUtilities.h"
+
+struct FVoxelMarchingCubeMesherBuffers;
+struct FVoxelMarchingCubeTransitionsMesherBuffers;
+struct FVoxelSurfaceNetMesherBuffers;
+struct FVoxelCubicMesherBuffers;
+
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Mesher Scratch Memory"), STAT_VoxelMesherScratchMemory, STATGROUP_VoxelMemory, VOXEL_API);
+
+/**
+ * Buffers reused by the meshers between chunks, so that meshing doesn't allocate in steady state
+ * A scratch is used by a single mesher at a time: they are checked out from a FVoxelMesherScratchPool for the duration of a mesher task
+ *
+ * Arrays keep their allocation between chunks. Their size is learned from the recent chunks,
+ * and the memory of outliers is freed when the scratch is released
+ */
+class FVoxelMesherScratch
+{
+public:
+	// Reset by the meshers before being used
+	TArray<uint32> Indices;
+	TArray<FVoxelMesherVertex> Vertices;
+	// Used when the vertices need to be rebuilt, eg for flat normals
+	TArray<FVoxelMesherVertex> TempVertices;
+
+	FVoxelMesherScratch() = default;
+	~FVoxelMesherScratch();
+
+	UE_NONCOPYABLE(FVoxelMesherScratch);
+
+	// Fixed size buffers of each mesher type, allocated the first time a mesher of that type uses this scratch
+	FVoxelMarchingCubeMesherBuffers& GetMarchingCubeBuffers();
+	FVoxelMarchingCubeTransitionsMesherBuffers& GetMarchingCubeTransitionsBuffers();
+	FVoxelSurfaceNetMesherBuffers& GetSurfaceNetBuffers();
+	FVoxelCubicMesherBuffers& GetCubicBuffers();
+
+	// Called when a mesher is done with this scratch
+	void Release();
+
+public:
+	// Reset Array, freeing its memory if it's a lot bigger than the recent arrays
+	template<typename T>
+	static void ResetArray(TArray<T>& Array, int32& LearnedNum)
+	{
+		// Decaying max of the recent sizes
+		LearnedNum = FMath::Max(Array.Num(), LearnedNum - LearnedNum / 8);
+
+		if (Array.Max() > 2 * LearnedNum)
+		{
+			Array.Empty(LearnedNum);
+		}
+		else
+		{
+			Array.Reset();
+		}
+	}
+
+private:
+	TUniquePtr<FVoxelMarchingCubeMesherBuffers> MarchingCubeBuffers;
+	TUniquePtr<FVoxelMarchingCubeTransitionsMesherBuffers> MarchingCubeTransitionsBuffers;
+	TUniquePtr<FVoxelSurfaceNetMesherBuffers> SurfaceNetBuffers;
+	TUniquePtr<FVoxelCubicMesherBuffers> CubicBuffers;
+
+	int32 LearnedNumIndices = 0;
+	int32 LearnedNumVertices = 0;
+	int32 LearnedNumTempVertices = 0;
+
+	int64 AllocatedSize = 0;
+
+	void UpdateAllocatedSize();
+};
+
+// Free list of scratches. Since a scratch is only checked out while a mesher task is running,
+// there ends up being one scratch per thread running mesher tasks
+class FVoxelMesherScratchPool
+{
+public:
+	FVoxelMesherScratchPool() = default;
+	~FVoxelMesherScratchPool() = default;
+
+	UE_NONCOPYABLE(FVoxelMesherScratchPool);
+
+	class FScope
+	{
+	public:
+		explicit FScope(FVoxelMesherScratchPool& Pool)
+			: Pool(Pool)
+			, Scratch(Pool.Allocate())
+		{
+		}
+		~FScope()
+		{
+			Pool.Free(MoveTemp(Scratch));
+		}
+
+		UE_NONCOPYABLE(FScope);
+
+		FVoxelMesherScratch& Get() const { return *Scratch; }
+
+	private:
+		FVoxelMesherScratchPool& Pool;
+		TUniquePtr<FVoxelMesherScratch> Scratch;
+	};
+
+private:
+	FCriticalSection Section;
+	TArray<TUniquePtr<FVoxelMesherScratch>> FreeScratches;
+
+	TUniquePtr<FVoxelMesherScratch> Allocate();
+	void Free(TUniquePtr<FVoxelMesherScratch> Scratch);
+};
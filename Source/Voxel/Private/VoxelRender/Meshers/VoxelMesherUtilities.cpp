@@ -12,7 +12,16 @@ FORCEINLINE int32 AddVertexToBuffer(
 	const FColor* Color = nullptr,
 	const FVector2D* UV = nullptr)
 {
-	const int32 Index = Buffer.Positions.Emplace(Vertex.Position);
+	if (Buffer.bPackedVertices)
+	{
+		Buffer.PackedVertices.Emplace(FVoxelPackedVertex::Pack(Buffer.PackedFormat, Vertex.Position, Vertex.Normal, Vertex.Tangent));
+	}
+	else
+	{
+		Buffer.Positions.Emplace(Vertex.Position);
+	}
+	const int32 Index = Buffer.GetNumVertices() - 1;
+	
 	if (Settings.bRenderWorld)
 	{
 		const auto GetColor = [&](FColor InColor)
@@ -29,8 +38,11 @@ FORCEINLINE int32 AddVertexToBuffer(
 			}
 		};
 		
-		Buffer.Normals.Emplace(Vertex.Normal);
-		Buffer.Tangents.Emplace(Vertex.Tangent);
+		if (!Buffer.bPackedVertices)
+		{
+			Buffer.Normals.Emplace(Vertex.Normal);
+			Buffer.Tangents.Emplace(Vertex.Tangent);
+		}
 		Buffer.TextureCoordinates[0].Emplace(Vertex.TextureCoordinate);
 
 		if (MaterialConfig == EVoxelMaterialConfig::MultiIndex)
@@ -56,16 +68,32 @@ FORCEINLINE int32 AddVertexToBuffer(
 inline void ReserveBuffer(
 	FVoxelChunkMeshBuffers& Buffer,
 	int32 Num,
+	int32 LOD,
 	const FVoxelRendererSettings& Settings,
 	EVoxelMaterialConfig MaterialConfig)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	// Only when rendering: the packed vertices always have normals & tangents
+	if (Settings.bPackVertices && Settings.bRenderWorld)
+	{
+		Buffer.bPackedVertices = true;
+		Buffer.PackedFormat.LOD = LOD;
+		Buffer.PackedFormat.bTangentIsPosition = Settings.RenderType == EVoxelRenderType::SurfaceNets;
+		Buffer.PackedVertices.Reserve(Num);
+	}
+	else
+	{
+		Buffer.Positions.Reserve(Num);
+	}
 	
-	Buffer.Positions.Reserve(Num);
 	if (Settings.bRenderWorld)
 	{
-		Buffer.Normals.Reserve(Num);
-		Buffer.Tangents.Reserve(Num);
+		if (!Buffer.bPackedVertices)
+		{
+			Buffer.Normals.Reserve(Num);
+			Buffer.Tangents.Reserve(Num);
+		}
 		Buffer.Colors.Reserve(Num);
 
 		if (MaterialConfig == EVoxelMaterialConfig::MultiIndex)
@@ -92,8 +120,8 @@ inline void ReserveBuffer(
 TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesherUtilities::CreateChunkFromVertices(
 	const FVoxelRendererSettings& Settings, 
 	int32 LOD,
-	TArray<uint32>&& Indices, 
-	TArray<FVoxelMesherVertex>&& Vertices)
+	TArray<uint32>& Indices, 
+	TArray<FVoxelMesherVertex>& Vertices)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 
@@ -181,9 +209,10 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesherUtilities::CreateChunkFromVertices(
 		Chunk->SetIsSingle(true);
 		FVoxelChunkMeshBuffers& Buffers = Chunk->CreateSingleBuffers();
 
-		Buffers.Indices = MoveTemp(Indices);
+		// Copy: Indices are owned by the mesher scratch
+		Buffers.Indices = Indices;
 
-		ReserveBuffer(Buffers, Vertices.Num(), Settings, EVoxelMaterialConfig::RGB);
+		ReserveBuffer(Buffers, Vertices.Num(), LOD, Settings, EVoxelMaterialConfig::RGB);
 		for (auto& Vertex : Vertices)
 		{
 			AddVertexToBuffer(Vertex, Buffers, Settings, EVoxelMaterialConfig::RGB);
@@ -218,7 +247,7 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesherUtilities::CreateChunkFromVertices(
 			FVoxelChunkMeshBuffers& Buffer = Chunk->FindOrAddBuffer(MaterialIndices, bAdded);
 			if (bAdded)
 			{
-				ReserveBuffer(Buffer, Vertices.Num(), Settings, EVoxelMaterialConfig::SingleIndex);
+				ReserveBuffer(Buffer, Vertices.Num(), LOD, Settings, EVoxelMaterialConfig::SingleIndex);
 			}
 			
 			TMap<int32, int32>& IndicesMap = IndicesMaps[MaterialIndexToUse];
@@ -327,13 +356,13 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesherUtilities::CreateChunkFromVertices(
 				bool bAdded;
 				FVoxelChunkMeshBuffers& Buffer = Chunk->FindOrAddBuffer(VoxelMaterialIndices, bAdded);
 				check(bAdded);
-				ReserveBuffer(Buffer, Vertices.Num(), Settings, EVoxelMaterialConfig::MultiIndex);
+				ReserveBuffer(Buffer, Vertices.Num(), LOD, Settings, EVoxelMaterialConfig::MultiIndex);
 
 				return Buffer;
 			};
 			FVoxelChunkMeshBuffers& Buffer = MakeBuffer();
 
-			Buffer.Indices = MoveTemp(Indices);
+			Buffer.Indices = Indices;
 
 			for (const FVoxelMesherVertex& Vertex : Vertices)
 			{
@@ -379,4 +408,287 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelMesherUtilities::CreateChunkFromVertices(
 	}
 
 	return Chunk;
-}
\ No newline at end of file
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+struct FVoxelQuadric
+{
+	// Symmetric matrix A, vector B and constant C of the squared distance to planes
+	double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+	double B0 = 0, B1 = 0, B2 = 0;
+	double C = 0;
+
+	FVoxelQuadric() = default;
+	// Plane Normal.P + Distance = 0
+	FVoxelQuadric(const FVector& Normal, double Distance)
+		: A00(Normal.X * Normal.X), A01(Normal.X * Normal.Y), A02(Normal.X * Normal.Z)
+		, A11(Normal.Y * Normal.Y), A12(Normal.Y * Normal.Z)
+		, A22(Normal.Z * Normal.Z)
+		, B0(Normal.X * Distance), B1(Normal.Y * Distance), B2(Normal.Z * Distance)
+		, C(Distance * Distance)
+	{
+	}
+
+	FORCEINLINE FVoxelQuadric& operator+=(const FVoxelQuadric& Other)
+	{
+		A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+		A11 += Other.A11; A12 += Other.A12;
+		A22 += Other.A22;
+		B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+		C += Other.C;
+		return *this;
+	}
+	FORCEINLINE FVoxelQuadric operator+(const FVoxelQuadric& Other) const
+	{
+		FVoxelQuadric Result = *this;
+		Result += Other;
+		return Result;
+	}
+
+	FORCEINLINE double Evaluate(const FVector& P) const
+	{
+		const double X = P.X;
+		const double Y = P.Y;
+		const double Z = P.Z;
+		const double Error =
+			A00 * X * X + 2 * A01 * X * Y + 2 * A02 * X * Z +
+			A11 * Y * Y + 2 * A12 * Y * Z +
+			A22 * Z * Z +
+			2 * (B0 * X + B1 * Y + B2 * Z) +
+			C;
+		return FMath::Max(Error, 0.);
+	}
+};
+
+int32 FVoxelMesherUtilities::SimplifyMesh(TArray<uint32>& Indices, TArrayView<const FVector> Positions, const TBitArray<>& LockedVertices, float MaxError)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	check(Indices.Num() % 3 == 0);
+	check(LockedVertices.Num() == Positions.Num());
+
+	const int32 NumVertices = Positions.Num();
+	const int32 NumTrianglesBefore = Indices.Num() / 3;
+	// Quadrics are not weighted: the error is the sum of the squared distances to the planes of the merged triangles
+	const double MaxQuadricError = FMath::Square(double(MaxError));
+	// Collapses rotating a triangle normal by more than ~75 degrees are rejected
+	const double MinNormalDot = 0.25;
+	// Each pass collapses at most one edge per vertex
+	const int32 MaxPasses = 8;
+
+	const auto GetTriangleNormal = [&](uint32 IndexA, uint32 IndexB, uint32 IndexC)
+	{
+		return FVector::CrossProduct(Positions[IndexB] - Positions[IndexA], Positions[IndexC] - Positions[IndexA]);
+	};
+
+	TArray<FVoxelQuadric> Quadrics;
+	Quadrics.SetNum(NumVertices);
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Quadrics");
+		for (int32 Index = 0; Index < Indices.Num(); Index += 3)
+		{
+			const FVector Normal = GetTriangleNormal(Indices[Index + 0], Indices[Index + 1], Indices[Index + 2]).GetSafeNormal();
+			if (Normal.IsZero())
+			{
+				continue;
+			}
+
+			const FVoxelQuadric Quadric(Normal, -FVector::DotProduct(Normal, Positions[Indices[Index]]));
+			Quadrics[Indices[Index + 0]] += Quadric;
+			Quadrics[Indices[Index + 1]] += Quadric;
+			Quadrics[Indices[Index + 2]] += Quadric;
+		}
+	}
+
+	struct FCollapse
+	{
+		uint32 From;
+		uint32 To;
+		double Error;
+	};
+	TArray<FCollapse> Collapses;
+
+	// Vertex to triangles adjacency
+	TArray<int32> TrianglesOffsets;
+	TArray<int32> TrianglesCounts;
+	TArray<int32> AdjacentTriangles;
+
+	TBitArray<> TouchedVertices;
+
+	for (int32 Pass = 0; Pass < MaxPasses; Pass++)
+	{
+		VOXEL_ASYNC_SCOPE_COUNTER("Pass");
+
+		const int32 NumTriangles = Indices.Num() / 3;
+
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Adjacency");
+
+			TrianglesCounts.Reset();
+			TrianglesCounts.SetNumZeroed(NumVertices);
+			for (uint32 Index : Indices)
+			{
+				TrianglesCounts[Index]++;
+			}
+
+			TrianglesOffsets.Reset();
+			TrianglesOffsets.SetNumUninitialized(NumVertices);
+			int32 Offset = 0;
+			for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+			{
+				TrianglesOffsets[Vertex] = Offset;
+				Offset += TrianglesCounts[Vertex];
+				TrianglesCounts[Vertex] = 0;
+			}
+
+			AdjacentTriangles.Reset();
+			AdjacentTriangles.SetNumUninitialized(Offset);
+			for (int32 Index = 0; Index < Indices.Num(); Index++)
+			{
+				const uint32 Vertex = Indices[Index];
+				AdjacentTriangles[TrianglesOffsets[Vertex] + TrianglesCounts[Vertex]++] = Index / 3;
+			}
+		}
+
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Find Collapses");
+
+			Collapses.Reset();
+			for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+			{
+				for (int32 Edge = 0; Edge < 3; Edge++)
+				{
+					const uint32 A = Indices[3 * Triangle + Edge];
+					const uint32 B = Indices[3 * Triangle + (Edge + 1) % 3];
+
+					// Shared edges are visited by both triangles: only add them once
+					// Border edges are only visited once, but can't be collapsed as their vertices are locked
+					if (A > B)
+					{
+						continue;
+					}
+
+					const FVoxelQuadric Quadric = Quadrics[A] + Quadrics[B];
+					if (!LockedVertices[A])
+					{
+						const double Error = Quadric.Evaluate(Positions[B]);
+						if (Error <= MaxQuadricError)
+						{
+							Collapses.Add({ A, B, Error });
+						}
+					}
+					if (!LockedVertices[B])
+					{
+						const double Error = Quadric.Evaluate(Positions[A]);
+						if (Error <= MaxQuadricError)
+						{
+							Collapses.Add({ B, A, Error });
+						}
+					}
+				}
+			}
+		}
+
+		if (Collapses.Num() == 0)
+		{
+			break;
+		}
+
+		Collapses.Sort([](const FCollapse& A, const FCollapse& B) { return A.Error < B.Error; });
+
+		const auto IsCollapseValid = [&](uint32 From, uint32 To)
+		{
+			for (int32 Offset = 0; Offset < TrianglesCounts[From]; Offset++)
+			{
+				const int32 Triangle = AdjacentTriangles[TrianglesOffsets[From] + Offset];
+				uint32 Vertices[3] = { Indices[3 * Triangle + 0], Indices[3 * Triangle + 1], Indices[3 * Triangle + 2] };
+				if (Vertices[0] == To || Vertices[1] == To || Vertices[2] == To)
+				{
+					// Will be removed
+					continue;
+				}
+
+				const FVector OldNormal = GetTriangleNormal(Vertices[0], Vertices[1], Vertices[2]);
+				for (uint32& Vertex : Vertices)
+				{
+					if (Vertex == From)
+					{
+						Vertex = To;
+					}
+				}
+				const FVector NewNormal = GetTriangleNormal(Vertices[0], Vertices[1], Vertices[2]);
+
+				const double OldSize = OldNormal.Size();
+				const double NewSize = NewNormal.Size();
+				if (NewSize < 1e-4 || FVector::DotProduct(OldNormal, NewNormal) < MinNormalDot * OldSize * NewSize)
+				{
+					return false;
+				}
+			}
+			return true;
+		};
+
+		int32 NumCollapsed = 0;
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Collapse");
+
+			TouchedVertices.Init(false, NumVertices);
+			for (const FCollapse& Collapse : Collapses)
+			{
+				if (TouchedVertices[Collapse.From] ||
+					TouchedVertices[Collapse.To] ||
+					!IsCollapseValid(Collapse.From, Collapse.To))
+				{
+					continue;
+				}
+
+				for (int32 Offset = 0; Offset < TrianglesCounts[Collapse.From]; Offset++)
+				{
+					const int32 Triangle = AdjacentTriangles[TrianglesOffsets[Collapse.From] + Offset];
+					for (int32 Corner = 0; Corner < 3; Corner++)
+					{
+						uint32& Vertex = Indices[3 * Triangle + Corner];
+						// The adjacency of the neighbors is now outdated
+						TouchedVertices[Vertex] = true;
+						if (Vertex == Collapse.From)
+						{
+							Vertex = Collapse.To;
+						}
+					}
+				}
+
+				Quadrics[Collapse.To] += Quadrics[Collapse.From];
+				NumCollapsed++;
+			}
+		}
+
+		if (NumCollapsed == 0)
+		{
+			break;
+		}
+
+		{
+			VOXEL_ASYNC_SCOPE_COUNTER("Remove Degenerate Triangles");
+
+			int32 WriteIndex = 0;
+			for (int32 Index = 0; Index < Indices.Num(); Index += 3)
+			{
+				const uint32 IndexA = Indices[Index + 0];
+				const uint32 IndexB = Indices[Index + 1];
+				const uint32 IndexC = Indices[Index + 2];
+				if (IndexA != IndexB && IndexA != IndexC && IndexB != IndexC)
+				{
+					Indices[WriteIndex++] = IndexA;
+					Indices[WriteIndex++] = IndexB;
+					Indices[WriteIndex++] = IndexC;
+				}
+			}
+			Indices.SetNum(WriteIndex, UE_505_SWITCH(false, EAllowShrinking::No));
+		}
+	}
+
+	return NumTrianglesBefore - Indices.Num() / 3;
+}
@@ -4,9 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "VoxelEnums.h"
+#include "VoxelValue.h"
 #include "VoxelMaterial.h"
 #include "VoxelDirection.h"
 #include "VoxelRender/VoxelProcMeshTangent.h"
+#include "VoxelContainers/VoxelStaticArray.h"
 
 struct FVoxelRendererSettings;
 struct FVoxelChunkMesh;
@@ -20,13 +22,109 @@ struct FVoxelMesherVertex
 	FVoxelMaterial Material;
 };
 
+/**
+ * Signs of a cube of values, packed in one mask per row along X: bit X is set if the value is empty
+ * Lets the meshers find the cells crossing the surface with a few bit operations per row of cells,
+ * instead of reading the 8 corners of every cell
+ */
+template<int32 MaxSize>
+class TVoxelSignBitmask
+{
+public:
+	static_assert(MaxSize <= 64, "Rows are packed in an uint64");
+
+	// Values: Size * Size * Size, X first
+	void Build(const FVoxelValue* RESTRICT Values, int32 InSize)
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+		check(1 < InSize && InSize <= MaxSize);
+
+		Size = InSize;
+		CellsMask = (uint64(1) << (Size - 1)) - 1;
+
+		const uint64 RowMask = CellsMask | (uint64(1) << (Size - 1));
+		for (int32 Z = 0; Z < Size; Z++)
+		{
+			uint64 AnyEmpty = 0;
+			uint64 AllEmpty = RowMask;
+			for (int32 Y = 0; Y < Size; Y++)
+			{
+				const FVoxelValue* RESTRICT RowValues = Values + Size * (Y + Size * Z);
+
+				uint64 Row = 0;
+				for (int32 X = 0; X < Size; X++)
+				{
+					// Branchless so that it can be vectorized
+					Row |= uint64(RowValues[X].IsEmpty()) << X;
+				}
+				Rows[Y + Size * Z] = Row;
+
+				AnyEmpty |= Row;
+				AllEmpty &= Row;
+			}
+			SliceSigns[Z] = AnyEmpty == 0 ? ESliceSign::Full : AllEmpty == RowMask ? ESliceSign::Empty : ESliceSign::Mixed;
+		}
+	}
+
+	FORCEINLINE uint64 GetRow(int32 Y, int32 Z) const
+	{
+		checkVoxelSlow(0 <= Y && Y < Size);
+		checkVoxelSlow(0 <= Z && Z < Size);
+		return Rows[Y + Size * Z];
+	}
+	// Whether some cells between the slices Z and Z + 1 have both empty and full corners
+	FORCEINLINE bool HasSurfaceInSlab(int32 Z) const
+	{
+		checkVoxelSlow(0 <= Z && Z < Size - 1);
+		return SliceSigns[Z] == ESliceSign::Mixed || SliceSigns[Z] != SliceSigns[Z + 1];
+	}
+	// Bit X is set if the cell between (X, Y, Z) and (X + 1, Y + 1, Z + 1) has both empty and full corners
+	FORCEINLINE uint64 GetSurfaceCells(int32 Y, int32 Z) const
+	{
+		const uint64 A = GetRow(Y + 0, Z + 0);
+		const uint64 B = GetRow(Y + 1, Z + 0);
+		const uint64 C = GetRow(Y + 0, Z + 1);
+		const uint64 D = GetRow(Y + 1, Z + 1);
+
+		const uint64 AnyEmpty = A | B | C | D;
+		const uint64 AllEmpty = A & B & C & D;
+
+		return ((AnyEmpty | (AnyEmpty >> 1)) & ~(AllEmpty & (AllEmpty >> 1))) & CellsMask;
+	}
+	// Marching cubes case code of the cell between (X, Y, Z) and (X + 1, Y + 1, Z + 1)
+	// Corner I is at (I & 1, (I >> 1) & 1, (I >> 2) & 1)
+	FORCEINLINE uint32 GetCaseCode(int32 X, int32 Y, int32 Z) const
+	{
+		checkVoxelSlow(0 <= X && X < Size - 1);
+		return
+			(((GetRow(Y + 0, Z + 0) >> X) & 0x3) << 0) |
+			(((GetRow(Y + 1, Z + 0) >> X) & 0x3) << 2) |
+			(((GetRow(Y + 0, Z + 1) >> X) & 0x3) << 4) |
+			(((GetRow(Y + 1, Z + 1) >> X) & 0x3) << 6);
+	}
+
+private:
+	enum class ESliceSign : uint8
+	{
+		Full,
+		Empty,
+		Mixed
+	};
+
+	int32 Size = 0;
+	uint64 CellsMask = 0;
+	TVoxelStaticArray<uint64, MaxSize * MaxSize> Rows;
+	TVoxelStaticArray<ESliceSign, MaxSize> SliceSigns;
+};
+
 namespace FVoxelMesherUtilities
 {
+	// Indices and Vertices might be modified
 	TVoxelSharedPtr<FVoxelChunkMesh> CreateChunkFromVertices(
 		const FVoxelRendererSettings& Settings,
 		int32 LOD,
-		TArray<uint32>&& Indices,
-		TArray<FVoxelMesherVertex>&& Vertices);
+		TArray<uint32>& Indices,
+		TArray<FVoxelMesherVertex>& Vertices);
 
 	inline FVector GetTranslatedTransvoxel(const FVector& Vertex, const FVector& Normal, uint8 TransitionsMask, uint8 LOD)
 	{
@@ -121,8 +219,8 @@ namespace FVoxelMesherUtilities
 	{
 		VOXEL_ASYNC_FUNCTION_COUNTER();
 		
-		TArray<uint32> NewIndices;
-		NewIndices.Reserve(Indices.Num());
+		// Done in place to not allocate
+		int32 WriteIndex = 0;
 		check(Indices.Num() % 3 == 0);
 		for (int32 Index = 0; Index < Indices.Num(); Index += 3)
 		{
@@ -139,12 +237,12 @@ namespace FVoxelMesherUtilities
 			const FVector Cross = FVector::CrossProduct(BA, CA);
 			if (Cross.Size() > 1e-4) // See Chaos::FConvexBuilder::IsValidTriangle
 			{
-				NewIndices.Emplace(IndexA);
-				NewIndices.Emplace(IndexB);
-				NewIndices.Emplace(IndexC);
+				Indices[WriteIndex++] = IndexA;
+				Indices[WriteIndex++] = IndexB;
+				Indices[WriteIndex++] = IndexC;
 			}
 		}
-		Indices = MoveTemp(NewIndices);
+		Indices.SetNum(WriteIndex, UE_505_SWITCH(false, EAllowShrinking::No));
 	}
 	
 	template<typename T>
@@ -186,4 +284,12 @@ namespace FVoxelMesherUtilities
 			checkVoxelSlow(Index != -1);
 		}
 	}
+
+	/**
+	 * Quadric error simplification: collapses the edges moving the surface by less than MaxError
+	 * Vertices are only collapsed onto other vertices, so their attributes stay valid. Call RemoveUnusedVertices afterwards
+	 * LockedVertices are never moved
+	 * Returns the number of triangles removed
+	 */
+	int32 SimplifyMesh(TArray<uint32>& Indices, TArrayView<const FVector> Positions, const TBitArray<>& LockedVertices, float MaxError);
 }
\ No newline at end of file
@@ -115,6 +115,9 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 
 	Accelerator = MakeUnique<FVoxelConstDataAccelerator>(Data, GetBoundsToLock());
 
+	// Pack the signs of the values, so that only the edges and cells crossing the surface are visited
+	SignBitmask.Build(CachedValues, SN_EXTENDED_CHUNK_SIZE);
+
 	constexpr uint32 EdgeIndexOffsets[12] =
 	{
 		0,
@@ -186,6 +189,7 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 		{2,2,2}
 	};
 	constexpr uint32 Offsets[3] = { 1, SN_EXTENDED_CHUNK_SIZE, SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE };
+	constexpr uint64 SNEdgesMask = (uint64(1) << (SN_EXTENDED_CHUNK_SIZE - 1)) - 1;
 	const FIntVector icorners[3] = { {1,0,0},{0,1,0},{0,0,1} };
 
 	{
@@ -196,56 +200,68 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 		{
 			for (int32 LY = 0; LY < SN_EXTENDED_CHUNK_SIZE; LY++)
 			{
+				// Bit LX is set if the edge starting at LX in that direction crosses the surface
+				// Edges going outside of the cached area are never crossing
+				const uint64 Row = SignBitmask.GetRow(LY, LZ);
+				const uint64 CrossingEdges[3] =
+				{
+					(Row ^ (Row >> 1)) & SNEdgesMask,
+					LY + 1 < SN_EXTENDED_CHUNK_SIZE ? Row ^ SignBitmask.GetRow(LY + 1, LZ) : 0,
+					LZ + 1 < SN_EXTENDED_CHUNK_SIZE ? Row ^ SignBitmask.GetRow(LY, LZ + 1) : 0
+				};
+				const uint64 SurfaceCells =
+					LY + 1 < SN_EXTENDED_CHUNK_SIZE && LZ + 1 < SN_EXTENDED_CHUNK_SIZE
+					? SignBitmask.GetSurfaceCells(LY, LZ)
+					: 0;
+
 				for (int32 LX = 0; LX < SN_EXTENDED_CHUNK_SIZE; LX++)
 				{
 					const uint32 VoxelIndex = LX + LY * SN_EXTENDED_CHUNK_SIZE + LZ * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE;
-					const FVoxelValue MinCornerValue = CachedValues[VoxelIndex];
 					FIntVector MinCornerPosition = FIntVector(LX, LY, LZ) * Step;
-					FIntVector MaxCornerPositions = FIntVector(LX + 1, LY + 1, LZ + 1);
 
 					for (uint32 Direction = 0; Direction < 3; Direction++)
 					{
 						float Factor = -1; // empty value, valid factor should be between 0 and 1
-						if (MaxCornerPositions[Direction] < SN_EXTENDED_CHUNK_SIZE) // don't go outside of the cached area
+						if (CrossingEdges[Direction] & (uint64(1) << LX))
 						{
+							const FVoxelValue MinCornerValue = CachedValues[VoxelIndex];
 							const FVoxelValue MaxCornerInDirectionValue = CachedValues[VoxelIndex + Offsets[Direction]];
-							if (MinCornerValue.IsEmpty() != MaxCornerInDirectionValue.IsEmpty())
-							{
-								FVoxelValue MinValue = MinCornerValue;
-								FVoxelValue MaxValue = MaxCornerInDirectionValue;
+							checkVoxelSlow(MinCornerValue.IsEmpty() != MaxCornerInDirectionValue.IsEmpty());
 
-								if (LOD != 0)
+							FVoxelValue MinValue = MinCornerValue;
+							FVoxelValue MaxValue = MaxCornerInDirectionValue;
+
+							if (LOD != 0)
+							{
+								// for LOD chunks, search along the edge for the actual intersecting segment
+								FIntVector MinPosition = MinCornerPosition;
+								FIntVector MaxPosition = MinCornerPosition + icorners[Direction] * Step;
+								float c1 = 0;
+								float c2 = 1;
+								for (int iStep = Step; iStep > 1; iStep >>= 1)
 								{
-									// for LOD chunks, search along the edge for the actual intersecting segment
-									FIntVector MinPosition = MinCornerPosition;
-									FIntVector MaxPosition = MinCornerPosition + icorners[Direction] * Step;
-									float c1 = 0;
-									float c2 = 1;
-									for (int iStep = Step; iStep > 1; iStep >>= 1)
+									const float cmid = (c1 + c2) * 0.5f;
+									const FIntVector MidPosition = (MinPosition + MaxPosition) / 2;
+									const FVoxelValue MidValue = MESHER_TIME_RETURN_VALUES(1, Accelerator->Get<FVoxelValue>(MidPosition + ChunkPosition, LOD));
+									if (MinValue.IsEmpty() != MidValue.IsEmpty())//intersection is between c1 and cmid
 									{
-										const float cmid = (c1 + c2) * 0.5f;
-										const FIntVector MidPosition = (MinPosition + MaxPosition) / 2;
-										const FVoxelValue MidValue = MESHER_TIME_RETURN_VALUES(1, Accelerator->Get<FVoxelValue>(MidPosition + ChunkPosition, LOD));
-										if (MinValue.IsEmpty() != MidValue.IsEmpty())//intersection is between c1 and cmid
-										{
-											c2 = cmid;
-											MaxValue = MidValue;
-											MaxPosition = MidPosition;
-										}
-										else //intersection is between cmid and c2
-										{
-											c1 = cmid;
-											MinValue = MidValue;
-											MinPosition = MidPosition;
-										}
+										c2 = cmid;
+										MaxValue = MidValue;
+										MaxPosition = MidPosition;
+									}
+									else //intersection is between cmid and c2
+									{
+										c1 = cmid;
+										MinValue = MidValue;
+										MinPosition = MidPosition;
 									}
-									// TODO is this needed
-									Factor = c1 + (c2 - c1) * MinValue.ToFloat() / (MinValue.ToFloat() - MaxValue.ToFloat());
-								}
-								else
-								{
-									Factor = MinValue.ToFloat() / (MinValue.ToFloat() - MaxValue.ToFloat());
 								}
+								// TODO is this needed
+								Factor = c1 + (c2 - c1) * MinValue.ToFloat() / (MinValue.ToFloat() - MaxValue.ToFloat());
+							}
+							else
+							{
+								Factor = MinValue.ToFloat() / (MinValue.ToFloat() - MaxValue.ToFloat());
 							}
 						}
 						EdgeFactors[3 * VoxelIndex + Direction] = Factor;
@@ -254,9 +270,8 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 					if (TVertex::bComputeMaterial)
 					{
 						// We need to find the min value that's a surface value
-						if (LX < SN_EXTENDED_CHUNK_SIZE - 1 && 
-							LY < SN_EXTENDED_CHUNK_SIZE - 1 &&
-							LZ < SN_EXTENDED_CHUNK_SIZE - 1)
+						// Cells not crossing the surface have none, and use their min corner
+						if (SurfaceCells & (uint64(1) << LX))
 						{
 							FVoxelValue VoxelValues[8];
 							VoxelValues[0] = CachedValues[VoxelIndex];
@@ -320,11 +335,21 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 		{
 			for (uint32 LY = 0; LY < SN_CHUNK_SIZE; LY++)
 			{
+				const uint64 SurfaceCells = SignBitmask.GetSurfaceCells(LY, LZ);
+
 				for (uint32 LX = 0; LX < SN_CHUNK_SIZE; LX++)
 				{
 					const uint32 VoxelIndex = LX + LY * SN_EXTENDED_CHUNK_SIZE + LZ * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE;
 					const uint32 VertexIndex = LX + LY * SN_CHUNK_SIZE + LZ * SN_CHUNK_SIZE * SN_CHUNK_SIZE;
 
+					if (!(SurfaceCells & (uint64(1) << LX))) //cell is empty
+					{
+						// Surface nets case is either 0 or 15: no quads
+						VertexSNCases[VertexIndex] = 0;
+						VertexIndices[VertexIndex] = -1;
+						continue;
+					}
+
 					uint32 VoxelIndices[8];
 					VoxelIndices[0] = VoxelIndex;
 					VoxelIndices[1] = VoxelIndex + 1;
@@ -355,30 +380,18 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 					VoxelFloats[6] = VoxelValues[6].ToFloat();
 					VoxelFloats[7] = VoxelValues[7].ToFloat();
 
-					const uint32 MarchingCubesCase =
-						(VoxelValues[0].IsEmpty() << 0) |
-						(VoxelValues[1].IsEmpty() << 1) |
-						(VoxelValues[2].IsEmpty() << 2) |
-						(VoxelValues[3].IsEmpty() << 3) |
-						(VoxelValues[4].IsEmpty() << 4) |
-						(VoxelValues[5].IsEmpty() << 5) |
-						(VoxelValues[6].IsEmpty() << 6) |
-						(VoxelValues[7].IsEmpty() << 7);
+					const uint32 MarchingCubesCase = SignBitmask.GetCaseCode(LX, LY, LZ);
+					checkVoxelSlow(MarchingCubesCase != 0 && MarchingCubesCase != 255);
 
+					// Corners 3, 5, 6 and 7
 					const uint8 SurfaceNetsCase =
-						(VoxelValues[3].IsEmpty() << 0) |
-						(VoxelValues[5].IsEmpty() << 1) |
-						(VoxelValues[6].IsEmpty() << 2) |
-						(VoxelValues[7].IsEmpty() << 3);
+						(((MarchingCubesCase >> 3) & 0x1) << 0) |
+						(((MarchingCubesCase >> 5) & 0x1) << 1) |
+						(((MarchingCubesCase >> 6) & 0x1) << 2) |
+						(((MarchingCubesCase >> 7) & 0x1) << 3);
 
 					VertexSNCases[VertexIndex] = SurfaceNetsCase;
 
-					if ((MarchingCubesCase == 0) || (MarchingCubesCase == 255)) //cell is empty
-					{
-						VertexIndices[VertexIndex] = -1;
-						continue;
-					}
-
 					VertexIndices[VertexIndex] = Vertices.Num();
 
 
@@ -470,8 +483,14 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 		{
 			for (uint32 LY = 0; LY < RENDER_CHUNK_SIZE; LY++)
 			{
-				for (uint32 LX = 0; LX < RENDER_CHUNK_SIZE; LX++)
+				// Cells not crossing the surface have no quads
+				uint64 SurfaceCells = SignBitmask.GetSurfaceCells(LY, LZ) & ((uint64(1) << RENDER_CHUNK_SIZE) - 1);
+
+				while (SurfaceCells)
 				{
+					const uint32 LX = FPlatformMath::CountTrailingZeros64(SurfaceCells);
+					SurfaceCells &= SurfaceCells - 1;
+
 					const uint32 VoxelIndex = LX + LY * SN_CHUNK_SIZE + LZ * SN_CHUNK_SIZE * SN_CHUNK_SIZE;
 					const uint8 SurfaceNetCase = VertexSNCases[VoxelIndex];
 
@@ -544,8 +563,11 @@ void FVoxelSurfaceNetMesher::CreateGeometryTemplate(FVoxelMesherTimes& Times, TA
 
 TVoxelSharedPtr<FVoxelChunkMesh> FVoxelSurfaceNetMesher::CreateFullChunkImpl(FVoxelMesherTimes& Times)
 {
-	TArray<uint32> Indices;
-	TArray<FVoxelSurfaceNetFullVertex> Vertices;
+	TArray<uint32>& Indices = Scratch.Indices;
+	TArray<FVoxelSurfaceNetFullVertex>& Vertices = reinterpret_cast<TArray<FVoxelSurfaceNetFullVertex>&>(Scratch.Vertices);
+	Indices.Reset();
+	Vertices.Reset();
+	
 	CreateGeometryTemplate(Times, Indices, Vertices);
 
 	FVoxelMesherUtilities::SanitizeMesh(Indices, Vertices);
@@ -553,8 +575,8 @@ TVoxelSharedPtr<FVoxelChunkMesh> FVoxelSurfaceNetMesher::CreateFullChunkImpl(FVo
 	return MESHER_TIME_RETURN(CreateChunk, FVoxelMesherUtilities::CreateChunkFromVertices(
 		Settings,
 		LOD,
-		MoveTemp(Indices),
-		MoveTemp(reinterpret_cast<TArray<FVoxelMesherVertex>&>(Vertices))));
+		Indices,
+		Scratch.Vertices));
 }
 
 void FVoxelSurfaceNetMesher::CreateGeometryImpl(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<FVector>& Vertices)
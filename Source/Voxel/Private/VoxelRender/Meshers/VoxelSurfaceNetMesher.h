@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "VoxelData/VoxelDataAccelerator.h"
 #include "VoxelRender/Meshers/VoxelMesher.h"
+#include "VoxelRender/Meshers/VoxelMesherUtilities.h"
+#include "VoxelRender/Meshers/VoxelMesherScratch.h"
 
 /**
  * This code is based on an original implementation kindly provided by Dexyfex
@@ -14,6 +16,19 @@
 #define SN_CHUNK_SIZE (RENDER_CHUNK_SIZE + 1) /* +1 since SN vertices are within cells */
 #define SN_EXTENDED_CHUNK_SIZE (RENDER_CHUNK_SIZE + 3) /* +3 to get parent's outer edge */
 
+// Stored in a FVoxelMesherScratch
+struct FVoxelSurfaceNetMesherBuffers
+{
+	FVoxelValue CachedValues[SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE];
+	float EdgeFactors[SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * 3]; // edge blending factors for each cell, X,Y,Z
+	uint32 VertexIndices[SN_CHUNK_SIZE * SN_CHUNK_SIZE * SN_CHUNK_SIZE]; // final vertex indices, per voxel. 65535 if no vertex
+	uint8 VertexSNCases[SN_CHUNK_SIZE * SN_CHUNK_SIZE * SN_CHUNK_SIZE]; // surface net voxel cases for each cell
+	TVoxelSignBitmask<SN_EXTENDED_CHUNK_SIZE> SignBitmask; // signs of CachedValues
+
+	// The material position is detected in a first step
+	TVoxelStaticArray<FIntVector, SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE> MaterialPositions;
+};
+
 class FVoxelSurfaceNetMesher : public FVoxelMesher
 {
 public:
@@ -28,13 +43,14 @@ protected:
 private:
 	TUniquePtr<FVoxelConstDataAccelerator> Accelerator;
 
-	FVoxelValue CachedValues[SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE];
-	float EdgeFactors[SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * 3]; // edge blending factors for each cell, X,Y,Z
-	uint32 VertexIndices[SN_CHUNK_SIZE * SN_CHUNK_SIZE * SN_CHUNK_SIZE]; // final vertex indices, per voxel. 65535 if no vertex
-	uint8 VertexSNCases[SN_CHUNK_SIZE * SN_CHUNK_SIZE * SN_CHUNK_SIZE]; // surface net voxel cases for each cell
+	FVoxelSurfaceNetMesherBuffers& Buffers = Scratch.GetSurfaceNetBuffers();
 
-	// The material position is detected in a first step
-	TVoxelStaticArray<FIntVector, SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE * SN_EXTENDED_CHUNK_SIZE> MaterialPositions;
+	FVoxelValue* RESTRICT const CachedValues = Buffers.CachedValues;
+	float* RESTRICT const EdgeFactors = Buffers.EdgeFactors;
+	uint32* RESTRICT const VertexIndices = Buffers.VertexIndices;
+	uint8* RESTRICT const VertexSNCases = Buffers.VertexSNCases;
+	FIntVector* RESTRICT const MaterialPositions = Buffers.MaterialPositions.GetData();
+	TVoxelSignBitmask<SN_EXTENDED_CHUNK_SIZE>& SignBitmask = Buffers.SignBitmask;
 	
 	template<typename TVertex>
 	void CreateGeometryTemplate(FVoxelMesherTimes& Times, TArray<uint32>& Indices, TArray<TVertex>& Vertices);
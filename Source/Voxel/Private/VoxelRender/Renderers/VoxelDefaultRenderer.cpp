@@ -23,6 +23,116 @@ static TAutoConsoleVariable<int32> CVarFreezeRenderer(
 	TEXT("Stops renderer tick"),
 	ECVF_Default);
 
+static TAutoConsoleVariable<int32> CVarEditLane(
+	TEXT("voxel.renderer.EditLane"),
+	1,
+	TEXT("If true, chunks an edit is waiting on are meshed by EditChunksMeshing tasks, and their meshes are applied before the other ones in the mesh updates budget"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarEditLaneMaxLOD(
+	TEXT("voxel.renderer.EditLaneMaxLOD"),
+	0,
+	TEXT("Max LOD of the chunks using the edit lane. Edits of chunks with a higher LOD are meshed like any other update"),
+	ECVF_Default);
+
+// Game thread only
+static FVoxelEditLatencyHistogram GVoxelEditLatencies;
+
+static FAutoConsoleCommand PrintEditLatenciesCmd(
+	TEXT("voxel.renderer.PrintEditLatencies"),
+	TEXT("Log the histogram of the time between edits and the updated chunks meshes being sent to the mesh handler, for all renderers"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelEditLatencies.Log("All renderers");
+	}));
+
+static FAutoConsoleCommand ClearEditLatenciesCmd(
+	TEXT("voxel.renderer.ClearEditLatencies"),
+	TEXT("Clear the histogram logged by voxel.renderer.PrintEditLatencies"),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		GVoxelEditLatencies = {};
+	}));
+
+double FVoxelEditLatencyHistogram::GetBucketMax(int32 Bucket)
+{
+	return Bucket == NumBuckets - 1 ? MAX_dbl : double(1 << Bucket) / 1000;
+}
+
+void FVoxelEditLatencyHistogram::Add(double Time)
+{
+	int32 Bucket = 0;
+	while (Bucket < NumBuckets - 1 && Time >= GetBucketMax(Bucket))
+	{
+		Bucket++;
+	}
+
+	Counts[Bucket]++;
+	Num++;
+	TotalTime += Time;
+	MaxTime = FMath::Max(MaxTime, Time);
+}
+
+void FVoxelEditLatencyHistogram::Append(const FVoxelEditLatencyHistogram& Other)
+{
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		Counts[Bucket] += Other.Counts[Bucket];
+	}
+	Num += Other.Num;
+	TotalTime += Other.TotalTime;
+	MaxTime = FMath::Max(MaxTime, Other.MaxTime);
+}
+
+double FVoxelEditLatencyHistogram::GetPercentile(double Percentile) const
+{
+	const uint64 Target = FMath::CeilToInt(Percentile * Num);
+
+	uint64 Count = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		Count += Counts[Bucket];
+		if (Count >= Target)
+		{
+			return FMath::Min(GetBucketMax(Bucket), MaxTime);
+		}
+	}
+	return MaxTime;
+}
+
+void FVoxelEditLatencyHistogram::Log(const FString& Name) const
+{
+	LOG_VOXEL(Log, TEXT("%s: %llu chunk updates. Average %.2fms, p50 < %.2fms, p95 < %.2fms, p99 < %.2fms, max %.2fms"),
+		*Name,
+		Num,
+		Num > 0 ? TotalTime / Num * 1000 : 0.,
+		GetPercentile(0.5) * 1000,
+		GetPercentile(0.95) * 1000,
+		GetPercentile(0.99) * 1000,
+		MaxTime * 1000);
+
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		if (Counts[Bucket] == 0)
+		{
+			continue;
+		}
+
+		const FString Range = Bucket == NumBuckets - 1
+			? FString::Printf(TEXT(">= %dms"), 1 << (Bucket - 1))
+			: FString::Printf(TEXT("< %dms"), 1 << Bucket);
+		LOG_VOXEL(Log, TEXT("\t%10s: %6llu (%5.1f%%) %s"),
+			*Range,
+			Counts[Bucket],
+			100. * Counts[Bucket] / Num,
+			*FString::ChrN(FMath::CeilToInt(50. * Counts[Bucket] / Num), TEXT('#')));
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 FVoxelDefaultRenderer::FVoxelDefaultRenderer(const FVoxelRendererSettings& Settings)
 	: IVoxelRenderer(Settings)
 	, MeshHandler(Settings.bMergeChunks ? Settings.bDoNotMergeCollisionsAndNavmesh
@@ -102,6 +212,7 @@ int32 FVoxelDefaultRenderer::UpdateChunks(
 	{
 		auto& Chunk = ChunksMap.FindChecked(ChunkId);
 		Chunk.PendingUpdates.Add({ Time, FinishDelegate });
+		Chunk.DirtyBounds += Bounds;
 		// Trigger tasks if not already triggered: if they are, they will trigger new ones when their callback will be processed in Tick
 		StartTask<EMainOrTransitions::Main, EIfTaskExists::DoNothing>(Chunk);
 		StartTask<EMainOrTransitions::Transitions, EIfTaskExists::DoNothing>(Chunk);
@@ -720,7 +831,7 @@ void FVoxelDefaultRenderer::Tick(float)
 	ProcessMeshUpdates(MaxTime);
 	FlushQueuedTasks();
 
-	if (!OnWorldLoadedFired && UpdateIndex > 0 && TaskCount.GetValue() == 0 && TasksCallbacksQueue.IsEmpty())
+	if (!OnWorldLoadedFired && UpdateIndex > 0 && TaskCount.GetValue() == 0 && TasksCallbacksQueue.IsEmpty() && EditTasksCallbacksQueue.IsEmpty())
 	{
 		OnWorldLoaded.Broadcast();
 		OnWorldLoadedFired = true;
@@ -729,7 +840,7 @@ void FVoxelDefaultRenderer::Tick(float)
 	UpdateAllocatedSize();
 	
 	Settings.DebugManager->ReportMeshTaskCount(TaskCount.GetValue());
-	Settings.DebugManager->ReportMeshTasksCallbacksQueueNum(TasksCallbacksQueue.Num());
+	Settings.DebugManager->ReportMeshTasksCallbacksQueueNum(TasksCallbacksQueue.Num() + EditTasksCallbacksQueue.Num());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -800,7 +911,41 @@ void FVoxelDefaultRenderer::StartTask(FChunk& Chunk)
 		Chunk.Bounds,
 		MainOrTransitions == EMainOrTransitions::Transitions,
 		MainOrTransitions == EMainOrTransitions::Transitions ? Chunk.Settings.TransitionsMask : 0));
-	QueuedTasks[Chunk.Settings.bVisible][Chunk.Settings.bEnableCollisions].Emplace(Task.Get());
+
+	Task->bIsEditTask =
+		Chunk.PendingUpdates.Num() > 0 &&
+		Chunk.LOD <= CVarEditLaneMaxLOD.GetValueOnGameThread() &&
+		CVarEditLane.GetValueOnGameThread() != 0;
+
+	if (MainOrTransitions == EMainOrTransitions::Main &&
+		Chunk.LOD <= Settings.IncrementalRemeshMaxLOD &&
+		Settings.bRenderWorld &&
+		!Settings.bStaticWorld)
+	{
+		if (!Chunk.MesherChunkCache.IsValid())
+		{
+			Chunk.MesherChunkCache = MakeUnique<FVoxelMesherChunkCache>();
+		}
+		// If the task is canceled, the cache is destroyed with it and the next task remeshes everything
+		Task->ChunkCache = MoveTemp(Chunk.MesherChunkCache);
+		Task->DirtyBounds = Chunk.DirtyBounds;
+		Task->DirtyBoundsTime = FPlatformTime::Seconds();
+	}
+	if (MainOrTransitions == EMainOrTransitions::Main)
+	{
+		// Edits near the player are on the critical path
+		Task->bHighPriority = Chunk.LOD == 0 && Chunk.PendingUpdates.Num() > 0;
+		Chunk.DirtyBounds.Reset();
+	}
+	
+	if (Task->bIsEditTask)
+	{
+		QueuedEditTasks.Emplace(Task.Get());
+	}
+	else
+	{
+		QueuedTasks[Chunk.Settings.bVisible][Chunk.Settings.bEnableCollisions].Emplace(Task.Get());
+	}
 }
 
 void FVoxelDefaultRenderer::CancelTasks(FChunk& Chunk)
@@ -1090,6 +1235,10 @@ void FVoxelDefaultRenderer::CheckPendingUpdates(FChunk& Chunk)
 		}
 		if (PendingUpdate.WantedUpdateTime < FMath::Min(Chunk.BuiltData.MainChunkCreationTime, Chunk.BuiltData.TransitionsChunkCreationTime))
 		{
+			const double Latency = FPlatformTime::Seconds() - PendingUpdate.WantedUpdateTime;
+			EditLatencies.Add(Latency);
+			GVoxelEditLatencies.Add(Latency);
+
 			PendingUpdate.OnUpdateFinished.Broadcast(Chunk.Bounds);
 			Chunk.PendingUpdates.RemoveAtSwap(Index);
 			Index--;
@@ -1166,115 +1315,140 @@ void FVoxelDefaultRenderer::ProcessMeshUpdates(double MaxTime)
 	VOXEL_FUNCTION_COUNTER();
 	
 	FVoxelTaskCallback Callback;
+	{
+		VOXEL_SCOPE_COUNTER("Edit Tasks");
+		// An edit is waiting on these: process them first, but still within the budget
+		while (
+			FPlatformTime::Seconds() < MaxTime &&
+			EditTasksCallbacksQueue.Dequeue(Callback))
+		{
+			ProcessMeshUpdate(Callback);
+		}
+	}
 	while ( // First check the time, else dequeued elements aren't processed!
 		FPlatformTime::Seconds() < MaxTime &&
 		TasksCallbacksQueue.Dequeue(Callback))
 	{
-		FChunk* Chunk = ChunksMap.Find(Callback.ChunkId);
-		if (!Chunk) continue;
-
-		auto& Tasks = Chunk->Tasks;
-		auto& Task = Callback.bIsTransitionTask ? Tasks.TransitionsTask : Tasks.MainTask;
-		if (!Task.IsValid() || Task->TaskId != Callback.TaskId) continue; // If task was canceled
-		if (!ensure(Task->IsDone())) continue; // Must be done if we're in the callback
-
-		// Move built data
-		auto& BuiltData = Chunk->BuiltData;
-		const auto PreviousBuiltData = BuiltData;
-		if (Callback.bIsTransitionTask)
-		{
-			ensure(Task->TransitionsMask == Chunk->Settings.TransitionsMask); // Should have been canceled
-			BuiltData.TransitionsMask = Task->TransitionsMask;
-			BuiltData.TransitionsChunk = Task->Chunk;
-			BuiltData.TransitionsChunkCreationTime = Task->CreationTime;
-		}
-		else
-		{
-			BuiltData.MainChunk = Task->Chunk;
-			BuiltData.MainChunkCreationTime = Task->CreationTime;
-		}
+		ProcessMeshUpdate(Callback);
+	}
+}
 
-		// Finally, delete the task
-		Task.Reset();
+void FVoxelDefaultRenderer::ProcessMeshUpdate(const FVoxelTaskCallback& Callback)
+{
+	VOXEL_FUNCTION_COUNTER();
 
-		// Do nothing while the main chunk isn't valid - we don't want to have unneeded updates for transitions then main
-		if (BuiltData.MainChunk.IsValid())
-		{
-			auto& MeshId = Chunk->MeshId;
-			const auto Update = [&]()
-			{
-				if (!MeshId.IsValid())
-				{
-					MeshId = MeshHandler->AddChunk(Chunk->LOD, Chunk->Bounds.Min);
-				}
-				MeshHandler->UpdateChunk(MeshId, Chunk->Settings, *BuiltData.MainChunk, BuiltData.TransitionsChunk.Get(), BuiltData.TransitionsMask);
+	FChunk* Chunk = ChunksMap.Find(Callback.ChunkId);
+	if (!Chunk) return;
 
-				if (Settings.bStaticWorld)
-				{
-					// Free up memory ASAP
-					BuiltData.MainChunk.Reset();
-					BuiltData.TransitionsChunk.Reset();
-				}
-			};
+	auto& Tasks = Chunk->Tasks;
+	auto& Task = Callback.bIsTransitionTask ? Tasks.TransitionsTask : Tasks.MainTask;
+	if (!Task.IsValid() || Task->TaskId != Callback.TaskId) return; // If task was canceled
+	if (!ensure(Task->IsDone())) return; // Must be done if we're in the callback
 
-			const bool bTransitionsChunkIsBuilt =
-				BuiltData.TransitionsChunk.IsValid() ||
-				Chunk->Settings.TransitionsMask == 0 ||
-				Settings.RenderType == EVoxelRenderType::SurfaceNets;
+	// Move built data
+	auto& BuiltData = Chunk->BuiltData;
+	const auto PreviousBuiltData = BuiltData;
+	if (Callback.bIsTransitionTask)
+	{
+		ensure(Task->TransitionsMask == Chunk->Settings.TransitionsMask); // Should have been canceled
+		BuiltData.TransitionsMask = Task->TransitionsMask;
+		BuiltData.TransitionsChunk = Task->Chunk;
+		BuiltData.TransitionsChunkCreationTime = Task->CreationTime;
+	}
+	else
+	{
+		BuiltData.MainChunk = Task->Chunk;
+		BuiltData.MainChunkCreationTime = Task->CreationTime;
+		Chunk->MesherChunkCache = MoveTemp(Task->ChunkCache);
+	}
+
+	// Finally, delete the task
+	Task.Reset();
 
-			if (BuiltData.MainChunk->IsEmpty() && (!BuiltData.TransitionsChunk.IsValid() || BuiltData.TransitionsChunk->IsEmpty()))
+	// Do nothing while the main chunk isn't valid - we don't want to have unneeded updates for transitions then main
+	if (BuiltData.MainChunk.IsValid())
+	{
+		auto& MeshId = Chunk->MeshId;
+		const auto Update = [&]()
+		{
+			if (!MeshId.IsValid())
 			{
-				// Both empty, remove mesh if existing
-				if (MeshId.IsValid())
-				{
-					MeshHandler->RemoveChunk(MeshId);
-					MeshId = {};
-				}
+				MeshId = MeshHandler->AddChunk(Chunk->LOD, Chunk->Bounds.Min);
 			}
-			else
-			{
-				Update();
-				
-				ensure(MeshId.IsValid());
+			MeshHandler->UpdateChunk(MeshId, Chunk->Settings, *BuiltData.MainChunk, BuiltData.TransitionsChunk.Get(), BuiltData.TransitionsMask);
 
-				// Dither in if first update
-				// If first load and LOD 0, don't dither as it doesn't look nice to have the world dithering under the player
-				if (Settings.bDitherChunks &&
-					!PreviousBuiltData.MainChunk.IsValid() && 
-					!(UpdateIndex == 1 && Chunk->LOD == 0))
-				{
-					// Can be a first update if:
-					// - we are a showed new chunks that's dithering in
-					// - we are a hidden chunk that's updated for the first time. If so don't dither in
-					ensure(Chunk->GetState() == EChunkState::Hidden || Chunk->GetState() == EChunkState::DitheringIn);
-					if (Chunk->GetState() == EChunkState::DitheringIn)
-					{
-						DitherInChunk(*Chunk, Chunk->PreviousChunks);
-					}
-				}
+			if (Settings.bStaticWorld)
+			{
+				// Free up memory ASAP
+				BuiltData.MainChunk.Reset();
+				BuiltData.TransitionsChunk.Reset();
 			}
+		};
 
-			// Dither out/remove previous chunks only once transitions are built too
-			// Note: bTransitionsChunkIsBuilt is always true for surface nets
-			if (bTransitionsChunkIsBuilt)
+		const bool bTransitionsChunkIsBuilt =
+			BuiltData.TransitionsChunk.IsValid() ||
+			Chunk->Settings.TransitionsMask == 0 ||
+			Settings.RenderType == EVoxelRenderType::SurfaceNets;
+
+		if (BuiltData.MainChunk->IsEmpty() && (!BuiltData.TransitionsChunk.IsValid() || BuiltData.TransitionsChunk->IsEmpty()))
+		{
+			// Both empty, remove mesh if existing
+			if (MeshId.IsValid())
 			{
-				ClearPreviousChunks(*Chunk);
+				MeshHandler->RemoveChunk(MeshId);
+				MeshId = {};
 			}
 		}
 		else
 		{
-			ensure(!Chunk->MeshId.IsValid());
+			Update();
+			
+			ensure(MeshId.IsValid());
+
+			// Dither in if first update
+			// If first load and LOD 0, don't dither as it doesn't look nice to have the world dithering under the player
+			if (Settings.bDitherChunks &&
+				!PreviousBuiltData.MainChunk.IsValid() && 
+				!(UpdateIndex == 1 && Chunk->LOD == 0))
+			{
+				// Can be a first update if:
+				// - we are a showed new chunks that's dithering in
+				// - we are a hidden chunk that's updated for the first time. If so don't dither in
+				ensure(Chunk->GetState() == EChunkState::Hidden || Chunk->GetState() == EChunkState::DitheringIn);
+				if (Chunk->GetState() == EChunkState::DitheringIn)
+				{
+					DitherInChunk(*Chunk, Chunk->PreviousChunks);
+				}
+			}
 		}
 
-		// Start new tasks as needed
-		CheckPendingUpdates(*Chunk);
+		// Dither out/remove previous chunks only once transitions are built too
+		// Note: bTransitionsChunkIsBuilt is always true for surface nets
+		if (bTransitionsChunkIsBuilt)
+		{
+			ClearPreviousChunks(*Chunk);
+		}
+	}
+	else
+	{
+		ensure(!Chunk->MeshId.IsValid());
 	}
+
+	// Start new tasks as needed
+	CheckPendingUpdates(*Chunk);
 }
 
 void FVoxelDefaultRenderer::FlushQueuedTasks()
 {
 	VOXEL_FUNCTION_COUNTER();
 
+	if (QueuedEditTasks.Num() > 0)
+	{
+		TaskCount.Add(QueuedEditTasks.Num());
+		Settings.Pool->QueueTasks(EVoxelTaskType::EditChunksMeshing, QueuedEditTasks);
+		QueuedEditTasks.Reset();
+	}
+
 	const auto Flush = [&](bool bVisible, bool bHasCollisions)
 	{
 		auto& Tasks = QueuedTasks[bVisible][bHasCollisions];
@@ -1349,8 +1523,15 @@ void FVoxelDefaultRenderer::CancelTask(TUniquePtr<FVoxelMesherAsyncWork, TVoxelA
 	}
 }
 
-void FVoxelDefaultRenderer::QueueChunkCallback_AnyThread(uint64 TaskId, uint64 ChunkId, bool bIsTransitionTask)
+void FVoxelDefaultRenderer::QueueChunkCallback_AnyThread(uint64 TaskId, uint64 ChunkId, bool bIsTransitionTask, bool bIsEditTask)
 {
 	ensure(TaskCount.Decrement() >= 0);
-	TasksCallbacksQueue.Enqueue({TaskId, ChunkId, bIsTransitionTask});
+	if (bIsEditTask)
+	{
+		EditTasksCallbacksQueue.Enqueue({TaskId, ChunkId, bIsTransitionTask});
+	}
+	else
+	{
+		TasksCallbacksQueue.Enqueue({TaskId, ChunkId, bIsTransitionTask});
+	}
 }
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include "VoxelRender/IVoxelRenderer.h"
 #include "VoxelRender/VoxelMesherAsyncWork.h"
 #include "VoxelRender/VoxelChunkToUpdate.h"
+#include "VoxelRender/Meshers/VoxelMesherScratch.h"
+#include "VoxelRender/Meshers/VoxelMesherChunkCache.h"
 #include "VoxelRendererMeshHandler.h"
 #include "VoxelTickable.h"
 #include "VoxelQueueWithNum.h"
@@ -14,6 +16,26 @@ struct FVoxelChunkMesh;
 
 DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Renderer"), STAT_VoxelRenderer, STATGROUP_VoxelMemory, VOXEL_API);
 
+// Time between an edit calling UpdateChunks and the updated chunks meshes being sent to the mesh handler
+// Buckets are powers of 2 in milliseconds: [0, 1ms), [1ms, 2ms), [2ms, 4ms)... The last bucket has no upper bound
+struct FVoxelEditLatencyHistogram
+{
+	static constexpr int32 NumBuckets = 12;
+
+	uint64 Counts[NumBuckets] = {};
+	uint64 Num = 0;
+	double TotalTime = 0;
+	double MaxTime = 0;
+
+	void Add(double Time);
+	void Append(const FVoxelEditLatencyHistogram& Other);
+	// Upper bound of the bucket containing the percentile, in seconds
+	double GetPercentile(double Percentile) const;
+	void Log(const FString& Name) const;
+
+	static double GetBucketMax(int32 Bucket);
+};
+
 class FVoxelDefaultRenderer : public IVoxelRenderer, public FVoxelTickable, public TVoxelSharedFromThis<FVoxelDefaultRenderer>
 {
 public:
@@ -48,6 +70,10 @@ public:
 	virtual bool IsTickableInEditor() const override { return true; }
 	//~ End FVoxelTickable Interface
 
+public:
+	// Scratch buffers of the mesher tasks of this renderer
+	const TUniquePtr<FVoxelMesherScratchPool> MesherScratchPool = MakeUnique<FVoxelMesherScratchPool>();
+
 private:
 	enum class EChunkState : uint8
 	{
@@ -120,6 +146,11 @@ private:
 		};
 		FChunkBuiltData BuiltData;
 
+		// Kept between updates if the chunk can be remeshed incrementally. Moved to the main task while it's running
+		TUniquePtr<FVoxelMesherChunkCache> MesherChunkCache;
+		// Bounds edited since the last main task was started
+		FVoxelIntBoxWithValidity DirtyBounds;
+
 		IVoxelRendererMeshHandler::FChunkId MeshId;
 
 		// Settings to be applied once eg new chunks are spawned
@@ -164,6 +195,8 @@ private:
 	TArray<FChunkToShow> ChunksToShow;
 
 	TArray<IVoxelQueuedWork*> QueuedTasks[2][2]; // [bVisible][bHasCollisions]
+	// Tasks of chunks with pending updates, queued as EditChunksMeshing
+	TArray<IVoxelQueuedWork*> QueuedEditTasks;
 
 	enum class EIfTaskExists : uint8
 	{
@@ -205,7 +238,10 @@ private:
 	void UpdateAllocatedSize();
 
 public:
-	void QueueChunkCallback_AnyThread(uint64 TaskId, uint64 ChunkId, bool bIsTransitionTask);
+	void QueueChunkCallback_AnyThread(uint64 TaskId, uint64 ChunkId, bool bIsTransitionTask, bool bIsEditTask);
+
+	// Edit to mesh latencies of the chunks updated by this renderer
+	const FVoxelEditLatencyHistogram& GetEditLatencies() const { return EditLatencies; }
 
 private:
 	struct FVoxelTaskCallback
@@ -215,6 +251,12 @@ private:
 		bool bIsTransitionTask;
 	};
 	TVoxelQueueWithNum<FVoxelTaskCallback, EQueueMode::Mpsc> TasksCallbacksQueue;
+	// Callbacks of the edit tasks: processed before the other ones, within the mesh updates budget
+	TVoxelQueueWithNum<FVoxelTaskCallback, EQueueMode::Mpsc> EditTasksCallbacksQueue;
+
+	FVoxelEditLatencyHistogram EditLatencies;
+
+	void ProcessMeshUpdate(const FVoxelTaskCallback& Callback);
 
 	void CancelTask(TUniquePtr<FVoxelMesherAsyncWork, TVoxelAsyncWorkDelete<FVoxelMesherAsyncWork>>& Task);
 };
\ No newline at end of file
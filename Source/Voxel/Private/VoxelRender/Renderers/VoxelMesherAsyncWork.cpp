@@ -5,6 +5,7 @@
 #include "VoxelRender/Meshers/VoxelMarchingCubeMesher.h"
 #include "VoxelRender/Meshers/VoxelCubicMesher.h"
 #include "VoxelRender/Meshers/VoxelSurfaceNetMesher.h"
+#include "VoxelRender/Meshers/VoxelMesherChunkCache.h"
 #include "VoxelRender/VoxelChunkMesh.h"
 
 #include "Async/Async.h"
@@ -63,42 +64,60 @@ void FVoxelMesherAsyncWork::DoWork()
 	if (IsCanceled()) return;
 	if (!ensure(PinnedRenderer.IsValid())) return; // Either we're canceled, or the renderer is valid
 
-	const auto Mesher = GetMesher(
-		PinnedRenderer->Settings,
-		LOD,
-		ChunkPosition,
-		bIsTransitionTask,
-		TransitionsMask);
+	{
+		// Released before the renderer, as it's owned by the renderer pool
+		FVoxelMesherScratchPool::FScope ScratchScope(*PinnedRenderer->MesherScratchPool);
 
-	CreationTime = FPlatformTime::Seconds();
+		const auto Mesher = GetMesher(
+			PinnedRenderer->Settings,
+			ScratchScope.Get(),
+			LOD,
+			ChunkPosition,
+			bIsTransitionTask,
+			TransitionsMask);
 
-	if (PinnedRenderer->Settings.bRenderWorld)
-	{
-		const auto MesherChunk = Mesher->CreateFullChunk();
-		if (MesherChunk.IsValid())
+		Mesher->bHighPriority = bHighPriority;
+
+		CreationTime = FPlatformTime::Seconds();
+
+		if (ChunkCache.IsValid())
 		{
-			Chunk = MesherChunk.ToSharedRef();
+			check(!bIsTransitionTask);
+			static_cast<FVoxelMesher&>(*Mesher).SetChunkCache(ChunkCache.Get(), DirtyBounds);
+
+			// The cached parts of the mesh are only remeshed if they are in DirtyBounds:
+			// edits made between the task being queued and now might be missing
+			CreationTime = DirtyBoundsTime;
 		}
-		else
+
+		if (PinnedRenderer->Settings.bRenderWorld)
 		{
-			AsyncTask(ENamedThreads::GameThread, [Data = MakeVoxelWeakPtr(PinnedRenderer->Settings.Data)]() { ShowGeneratorError(Data); });
-			Chunk = Mesher->CreateEmptyChunk();
+			const auto MesherChunk = Mesher->CreateFullChunk();
+			if (MesherChunk.IsValid())
+			{
+				Chunk = MesherChunk.ToSharedRef();
+			}
+			else
+			{
+				AsyncTask(ENamedThreads::GameThread, [Data = MakeVoxelWeakPtr(PinnedRenderer->Settings.Data)]() { ShowGeneratorError(Data); });
+				Chunk = Mesher->CreateEmptyChunk();
+			}
 		}
-	}
-	else
-	{
-		// If we're not rendering the world, we only need the geometry for collisions/navmesh
+		else
+		{
+			// If we're not rendering the world, we only need the geometry for collisions/navmesh
 
-		TArray<uint32> Indices;
-		TArray<FVector> Vertices;
-		Mesher->CreateGeometry(Indices, Vertices);
+			TArray<uint32> Indices;
+			TArray<FVector> Vertices;
+			Mesher->CreateGeometry(Indices, Vertices);
 		
-		Chunk = MakeVoxelShared<FVoxelChunkMesh>();
-		Chunk->SetIsSingle(true);
-		FVoxelChunkMeshBuffers& Buffers = Chunk->CreateSingleBuffers();
+			Chunk = MakeVoxelShared<FVoxelChunkMesh>();
+			Chunk->SetIsSingle(true);
+			FVoxelChunkMeshBuffers& Buffers = Chunk->CreateSingleBuffers();
 
-		Buffers.Indices = MoveTemp(Indices);
-		Buffers.Positions = MoveTemp(Vertices);
+			Buffers.Indices = MoveTemp(Indices);
+			Buffers.Positions = MoveTemp(Vertices);
+		}
 	}
 	
 	FVoxelUtilities::DeleteOnGameThread_AnyThread(PinnedRenderer);
@@ -111,7 +130,7 @@ void FVoxelMesherAsyncWork::PostDoWork()
 	auto RendererPtr = Renderer.Pin();
 	if (ensure(RendererPtr.IsValid()))
 	{
-		RendererPtr->QueueChunkCallback_AnyThread(TaskId, ChunkId, bIsTransitionTask);
+		RendererPtr->QueueChunkCallback_AnyThread(TaskId, ChunkId, bIsTransitionTask, bIsEditTask);
 		FVoxelUtilities::DeleteOnGameThread_AnyThread(RendererPtr);
 	}
 }
@@ -123,6 +142,7 @@ uint32 FVoxelMesherAsyncWork::GetPriority() const
 
 TUniquePtr<FVoxelMesherBase> FVoxelMesherAsyncWork::GetMesher(
 	const FVoxelRendererSettings& Settings,
+	FVoxelMesherScratch& Scratch,
 	int32 LOD,
 	const FIntVector& ChunkPosition,
 	bool bIsTransitionTask,
@@ -137,22 +157,22 @@ TUniquePtr<FVoxelMesherBase> FVoxelMesherAsyncWork::GetMesher(
 	{
 		if (bIsTransitionTask)
 		{
-			return MakeUnique<FVoxelMarchingCubeTransitionsMesher>(LOD, ChunkPosition, Settings, TransitionsMask);
+			return MakeUnique<FVoxelMarchingCubeTransitionsMesher>(LOD, ChunkPosition, Settings, Scratch, TransitionsMask);
 		}
 		else
 		{
-			return MakeUnique<FVoxelMarchingCubeMesher>(LOD, ChunkPosition, Settings);
+			return MakeUnique<FVoxelMarchingCubeMesher>(LOD, ChunkPosition, Settings, Scratch);
 		}
 	}
 	case EVoxelRenderType::Cubic:
 	{
 		if (bIsTransitionTask)
 		{
-			return MakeUnique<FVoxelCubicTransitionsMesher>(LOD, ChunkPosition, Settings, TransitionsMask);
+			return MakeUnique<FVoxelCubicTransitionsMesher>(LOD, ChunkPosition, Settings, Scratch, TransitionsMask);
 		}
 		else
 		{
-			return MakeUnique<FVoxelCubicMesher>(LOD, ChunkPosition, Settings);
+			return MakeUnique<FVoxelCubicMesher>(LOD, ChunkPosition, Settings, Scratch);
 		}
 	}
 	case EVoxelRenderType::SurfaceNets:
@@ -164,7 +184,7 @@ TUniquePtr<FVoxelMesherBase> FVoxelMesherAsyncWork::GetMesher(
 		}
 		else
 		{
-			return MakeUnique<FVoxelSurfaceNetMesher>(LOD, ChunkPosition, Settings);
+			return MakeUnique<FVoxelSurfaceNetMesher>(LOD, ChunkPosition, Settings, Scratch);
 		}
 	}
 	}
@@ -177,6 +197,8 @@ void FVoxelMesherAsyncWork::CreateGeometry_AnyThread(
 	TArray<uint32>& OutIndices, 
 	TArray<FVector>& OutVertices)
 {
-	const auto Mesher = GetMesher(Renderer.Settings, LOD, ChunkPosition, false, 0);
+	FVoxelMesherScratchPool::FScope ScratchScope(*Renderer.MesherScratchPool);
+
+	const auto Mesher = GetMesher(Renderer.Settings, ScratchScope.Get(), LOD, ChunkPosition, false, 0);
 	Mesher->CreateGeometry(OutIndices, OutVertices);
 }
\ No newline at end of file
@@ -17,6 +17,7 @@
 #endif
 
 DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelChunkMeshMemory);
+DEFINE_VOXEL_MEMORY_STAT(STAT_VoxelChunkMeshPackedVerticesSavedMemory);
 
 #if ENABLE_TESSELLATION
 /**
@@ -68,7 +69,17 @@ void FVoxelChunkMeshBuffers::BuildAdjacency(TArray<uint32>& OutAdjacencyIndices)
 #if ENABLE_TESSELLATION
 	if (Indices.Num())
 	{
-		FVoxelStaticMeshNvRenderBuffer StaticMeshRenderBuffer(Positions, Indices);
+		TArray<FVector> UnpackedPositions;
+		if (bPackedVertices)
+		{
+			UnpackedPositions.SetNumUninitialized(PackedVertices.Num());
+			for (int32 Index = 0; Index < PackedVertices.Num(); Index++)
+			{
+				UnpackedPositions[Index] = PackedVertices[Index].GetPosition(PackedFormat);
+			}
+		}
+		
+		FVoxelStaticMeshNvRenderBuffer StaticMeshRenderBuffer(bPackedVertices ? UnpackedPositions : Positions, Indices);
 		nv::IndexBuffer* PnAENIndexBuffer = nv::tess::buildTessellationBuffer(&StaticMeshRenderBuffer, nv::DBM_PnAenDominantCorner, true);
 		check(PnAENIndexBuffer);
 		const int32 IndexCount = int32(PnAENIndexBuffer->getLength());
@@ -109,6 +120,7 @@ void FVoxelChunkMeshBuffers::Shrink()
 	Positions.Shrink();
 	Normals.Shrink();
 	Tangents.Shrink();
+	PackedVertices.Shrink();
 	Colors.Shrink();
 	for (auto& T : TextureCoordinates) T.Shrink();
 
@@ -118,9 +130,19 @@ void FVoxelChunkMeshBuffers::Shrink()
 void FVoxelChunkMeshBuffers::ComputeBounds()
 {
 	Bounds = FBox(ForceInit);
-	for (auto& Vertex : Positions)
+	if (bPackedVertices)
+	{
+		for (const FVoxelPackedVertex& Vertex : PackedVertices)
+		{
+			Bounds += Vertex.GetPosition(PackedFormat);
+		}
+	}
+	else
 	{
-		Bounds += Vertex;
+		for (auto& Vertex : Positions)
+		{
+			Bounds += Vertex;
+		}
 	}
 }
 
@@ -132,8 +154,14 @@ void FVoxelChunkMeshBuffers::UpdateStats()
 	LastAllocatedSize += Normals.GetAllocatedSize();
 	LastAllocatedSize += Tangents.GetAllocatedSize();
 	LastAllocatedSize += Colors.GetAllocatedSize();
+	LastAllocatedSize += PackedVertices.GetAllocatedSize();
 	for (auto& T : TextureCoordinates) LastAllocatedSize += T.GetAllocatedSize();
 	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelChunkMeshMemory, LastAllocatedSize);
+
+	DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelChunkMeshPackedVerticesSavedMemory, LastPackedVerticesSavedSize);
+	constexpr int32 UnpackedSize = sizeof(FVector) + sizeof(FVector) + sizeof(FVoxelProcMeshTangent);
+	LastPackedVerticesSavedSize = PackedVertices.Num() * (UnpackedSize - sizeof(FVoxelPackedVertex));
+	INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelChunkMeshPackedVerticesSavedMemory, LastPackedVerticesSavedSize);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -271,9 +271,19 @@ TUniquePtr<FVoxelProcMeshBuffers> FVoxelRenderUtilities::MergeSections_AnyThread
 	{
 		VOXEL_ASYNC_SCOPE_COUNTER("CopyPositions");
 		const int32 ChunkNumVertices = Chunk.GetNumVertices();
-		for (int32 Index = 0; Index < ChunkNumVertices; Index++)
+		if (Chunk.bPackedVertices)
+		{
+			for (int32 Index = 0; Index < ChunkNumVertices; Index++)
+			{
+				PositionBuffer.VertexPosition(VerticesOffset + Index) = FVector3f(Get(Chunk.PackedVertices, Index).GetPosition(Chunk.PackedFormat) + Offset);
+			}
+		}
+		else
 		{
-			PositionBuffer.VertexPosition(VerticesOffset + Index) = FVector3f(Get(Chunk.Positions, Index) + Offset);
+			for (int32 Index = 0; Index < ChunkNumVertices; Index++)
+			{
+				PositionBuffer.VertexPosition(VerticesOffset + Index) = FVector3f(Get(Chunk.Positions, Index) + Offset);
+			}
 		}
 	};
 	const auto CopyColors = [&](const FVoxelChunkMeshBuffers& Chunk)
@@ -297,6 +307,7 @@ TUniquePtr<FVoxelProcMeshBuffers> FVoxelRenderUtilities::MergeSections_AnyThread
 		{
 			ensure(Chunk.Tangents.Num() == 0);
 			ensure(Chunk.Normals.Num() == 0);
+			ensure(!Chunk.bPackedVertices);
 			for (auto& T : Chunk.TextureCoordinates) ensure(T.Num() == 0);
 			return;
 		}
@@ -305,6 +316,14 @@ TUniquePtr<FVoxelProcMeshBuffers> FVoxelRenderUtilities::MergeSections_AnyThread
 		const int32 ChunkNumVertices = Chunk.GetNumVertices();
 		for (int32 Index = 0; Index < ChunkNumVertices; Index++)
 		{
+			if (Chunk.bPackedVertices)
+			{
+				const FVoxelPackedVertex& Vertex = Get(Chunk.PackedVertices, Index);
+				const FVoxelProcMeshTangent Tangent = Vertex.GetTangent(Chunk.PackedFormat);
+				const FVector Normal = Vertex.GetNormal();
+				StaticMeshBuffer.SetVertexTangents(VerticesOffset + Index, FVector3f(Tangent.TangentX), FVector3f(Tangent.GetY(Normal)), FVector3f(Normal));
+			}
+			else
 			{
 				auto& Tangent = Get(Chunk.Tangents, Index);
 				auto& Normal = Get(Chunk.Normals, Index);
@@ -360,8 +379,8 @@ TUniquePtr<FVoxelProcMeshBuffers> FVoxelRenderUtilities::MergeSections_AnyThread
 				for (int32 Index = 0; Index < MainChunk.GetNumVertices(); Index++)
 				{
 					PositionBuffer.VertexPosition(VerticesOffset + Index) = FVector3f(FVoxelMesherUtilities::GetTranslatedTransvoxel(
-						Get(MainChunk.Positions, Index),
-						Get(MainChunk.Normals, Index),
+						MainChunk.GetPosition(Index),
+						MainChunk.GetNormal(Index),
 						Chunk.TransitionsMask,
 						Chunk.LOD) + PositionOffset);
 				}
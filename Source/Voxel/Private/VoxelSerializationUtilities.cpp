@@ -6,6 +6,12 @@
 #include "VoxelSettings.h"
 
 #include "Serialization/LargeMemoryWriter.h"
+#include "Serialization/MemoryWriter.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/ParallelFor.h"
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Compression.h"
 
 THIRD_PARTY_INCLUDES_START
 #include "zlib.h"
@@ -18,9 +24,22 @@ FORCEINLINE FArchive& operator<<(FArchive& Ar, TVoxelValueImpl<T>& Value)
 	return Ar;
 }
 
-void FVoxelSerializationUtilities::SerializeValues(FArchive& Archive, TNoGrowArray<FVoxelValue>& Values, uint32 ValueConfigFlag, FVoxelSerializationVersion::Type VoxelCustomVersion)
+void FVoxelSerializationUtilities::SerializeValues(FArchive& Archive, TNoGrowArray<FVoxelValue>& Values, uint32 ValueConfigFlag, FVoxelSerializationVersion::Type VoxelCustomVersion, bool bDeltaEncoded)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(!bDeltaEncoded || VoxelCustomVersion >= FVoxelSerializationVersion::ValueConfigFlagAndSaveGUIDs);
+
+	const auto SerializeBuffer = [&](auto* Data, int32 Num)
+	{
+		if (bDeltaEncoded)
+		{
+			SerializeDeltaEncoded(Archive, reinterpret_cast<uint8*>(Data), Num, sizeof(*Data));
+		}
+		else
+		{
+			Archive.Serialize(Data, Num * sizeof(*Data));
+		}
+	};
 
 	if (Archive.IsLoading())
 	{
@@ -58,7 +77,7 @@ void FVoxelSerializationUtilities::SerializeValues(FArchive& Archive, TNoGrowArr
 				TArray<FVoxelValue8> CompatValues;
 				CompatValues.Empty(ValuesSize);
 				CompatValues.SetNumUninitialized(ValuesSize);
-				Archive.Serialize(CompatValues.GetData(), ValuesSize * sizeof(FVoxelValue8));
+				SerializeBuffer(CompatValues.GetData(), ValuesSize);
 				Values = FVoxelValueConverter::ConvertValues(MoveTemp(CompatValues));
 			}
 			else
@@ -67,7 +86,7 @@ void FVoxelSerializationUtilities::SerializeValues(FArchive& Archive, TNoGrowArr
 				TArray<FVoxelValue16> CompatValues;
 				CompatValues.Empty(ValuesSize);
 				CompatValues.SetNumUninitialized(ValuesSize);
-				Archive.Serialize(CompatValues.GetData(), ValuesSize * sizeof(FVoxelValue16));
+				SerializeBuffer(CompatValues.GetData(), ValuesSize);
 				Values = FVoxelValueConverter::ConvertValues(MoveTemp(CompatValues));
 			}
 		}
@@ -76,7 +95,7 @@ void FVoxelSerializationUtilities::SerializeValues(FArchive& Archive, TNoGrowArr
 	{
 		int32 ValuesSize = Values.Num();
 		Archive << ValuesSize;
-		Archive.Serialize(Values.GetData(), ValuesSize * sizeof(FVoxelValue));
+		SerializeBuffer(Values.GetData(), ValuesSize);
 	}
 }
 
@@ -192,6 +211,18 @@ void FVoxelSerializationUtilities::SerializeMaterials(FArchive& Archive, TNoGrow
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+static TAutoConsoleVariable<int32> CVarCompressionChunkSize(
+	TEXT("voxel.data.CompressionChunkSize"),
+	8192,
+	TEXT("Size in KB of the chunks compressed independently when compressing saves & assets. Smaller chunks are compressed & decompressed in parallel, at the cost of a slightly worse compression ratio"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarCompressionMaxPendingChunks(
+	TEXT("voxel.data.CompressionMaxPendingChunks"),
+	0,
+	TEXT("Max number of chunks being compressed at once by a streaming compressed writer, bounding its memory usage. If 0, uses the number of worker threads + 1"),
+	ECVF_Default);
+
 namespace FVoxelSerializationUtilities
 {
 	constexpr int64 MaxChunkSize = MAX_int32; // Could be uint32, but let's not take any risk of overflow
@@ -215,13 +246,392 @@ namespace FVoxelSerializationUtilities
 		TVoxelStaticArray<uint32, MaxNumChunks> ChunksCompressedSize{ ForceInit };
 	};
 	static_assert(sizeof(FHeader) == 4 + 4 + 8 + 8 + 4 + 4 + MaxNumChunks * 4, "");
+
+	enum EHeaderFlags : uint32
+	{
+		// The header is followed by a table of NumChunks FChunkEntry, and ChunksCompressedSize is unused
+		// Allows for any number of small chunks, that can be compressed & decompressed in parallel
+		HeaderFlag_ChunkTable = 1 << 0
+	};
+	// Only with HeaderFlag_ChunkTable. 0 for data compressed before codecs were added, which is zlib without filter
+	constexpr int32 HeaderCodecShift = 8;
+	constexpr int32 HeaderFilterShift = 16;
+	constexpr int32 HeaderFilterStrideShift = 24;
+
+	// How the chunks are compressed
+	struct FChunkCodec
+	{
+		EVoxelCompressionCodec Codec = EVoxelCompressionCodec::Zlib;
+		// Zlib level, or mapped to a speed/size bias for Oodle
+		int32 Level = 1;
+		EVoxelCompressionFilter Filter = EVoxelCompressionFilter::None;
+		// Size of the elements the filter works on
+		int32 FilterStride = 1;
+
+		uint32 ToHeaderFlags() const
+		{
+			return
+				(uint32(Codec) << HeaderCodecShift) |
+				(uint32(Filter) << HeaderFilterShift) |
+				(uint32(FilterStride) << HeaderFilterStrideShift);
+		}
+		static bool FromHeaderFlags(uint32 Flags, FChunkCodec& OutCodec)
+		{
+			const uint32 Codec = (Flags >> HeaderCodecShift) & 0xFF;
+			const uint32 Filter = (Flags >> HeaderFilterShift) & 0xFF;
+			const uint32 FilterStride = (Flags >> HeaderFilterStrideShift) & 0xFF;
+
+			if (!ensureMsgf(Codec <= uint32(EVoxelCompressionCodec::Oodle), TEXT("Invalid codec %u"), Codec) ||
+				!ensureMsgf(Filter <= uint32(EVoxelCompressionFilter::SplitMaterialChannels), TEXT("Invalid filter %u"), Filter))
+			{
+				return false;
+			}
+
+			OutCodec.Codec = EVoxelCompressionCodec(Codec);
+			OutCodec.Filter = EVoxelCompressionFilter(Filter);
+			OutCodec.FilterStride = FMath::Max<uint32>(FilterStride, 1);
+			return true;
+		}
+	};
+
+	struct FChunkEntry
+	{
+		uint32 CompressedSize = 0;
+		uint32 UncompressedSize = 0;
+	};
+	static_assert(sizeof(FChunkEntry) == 8, "");
+
+	int32 GetCompressionLevel(EVoxelCompressionLevel::Type InCompressionLevel)
+	{
+		int32 CompressionLevel = InCompressionLevel;
+		if (CompressionLevel == EVoxelCompressionLevel::VoxelDefault)
+		{
+			CompressionLevel = GetDefault<UVoxelSettings>()->DefaultCompressionLevel;
+		}
+		CompressionLevel = FMath::Clamp(CompressionLevel, -1, 9);
+		static_assert(Z_NO_COMPRESSION == 0, "");
+		static_assert(Z_BEST_COMPRESSION == 9, "");
+		return CompressionLevel;
+	}
+
+	int64 GetCompressionChunkSize()
+	{
+		return int64(FMath::Clamp(CVarCompressionChunkSize.GetValueOnAnyThread(), 64, 1 << 20)) * 1024;
+	}
+
+	FChunkCodec GetChunkCodec(int32 CompressionLevel, EVoxelCompressionCodec Codec, EVoxelCompressionFilter Filter)
+	{
+		FChunkCodec Result;
+		Result.Level = CompressionLevel;
+		Result.Codec = Codec;
+		Result.Filter = Filter;
+		
+		if (Result.Codec == EVoxelCompressionCodec::Oodle && !FCompression::IsFormatValid(NAME_Oodle))
+		{
+			Result.Codec = EVoxelCompressionCodec::LZ4;
+		}
+
+		switch (Filter)
+		{
+		case EVoxelCompressionFilter::None: Result.FilterStride = 1; break;
+		case EVoxelCompressionFilter::DeltaValues: Result.FilterStride = sizeof(FVoxelValue); break;
+		case EVoxelCompressionFilter::SplitMaterialChannels: Result.FilterStride = FVoxelMaterial::NumChannels; break;
+		default: ensure(false);
+		}
+		
+		return Result;
+	}
+	
+	EVoxelCompressionCodec GetCompressionCodec(const TOptional<EVoxelCompressionCodec>& Codec)
+	{
+		return Codec.IsSet() ? Codec.GetValue() : EVoxelCompressionCodec::Zlib;
+	}
+
+	const TCHAR* ToString(EVoxelCompressionCodec Codec)
+	{
+		switch (Codec)
+		{
+		case EVoxelCompressionCodec::Zlib: return TEXT("Zlib");
+		case EVoxelCompressionCodec::LZ4: return TEXT("LZ4");
+		case EVoxelCompressionCodec::Oodle: return TEXT("Oodle");
+		default: ensure(false); return TEXT("");
+		}
+	}
+	const TCHAR* ToString(EVoxelCompressionFilter Filter)
+	{
+		switch (Filter)
+		{
+		case EVoxelCompressionFilter::None: return TEXT("None");
+		case EVoxelCompressionFilter::DeltaValues: return TEXT("DeltaValues");
+		case EVoxelCompressionFilter::SplitMaterialChannels: return TEXT("SplitMaterialChannels");
+		default: ensure(false); return TEXT("");
+		}
+	}
+
+	FName GetEngineCodecName(EVoxelCompressionCodec Codec)
+	{
+		ensure(Codec != EVoxelCompressionCodec::Zlib);
+		return Codec == EVoxelCompressionCodec::Oodle ? NAME_Oodle : NAME_LZ4;
+	}
+
+	ECompressionFlags GetEngineCompressionFlags(int32 CompressionLevel)
+	{
+		if (CompressionLevel == -1)
+		{
+			return COMPRESS_NoFlags;
+		}
+		return CompressionLevel <= 3 ? COMPRESS_BiasSpeed : CompressionLevel >= 7 ? COMPRESS_BiasSize : COMPRESS_NoFlags;
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+
+	// Delta encode the elements, then split the bytes of the deltas in planes
+	template<typename T>
+	void DeltaEncode(const uint8* RESTRICT Data, int64 NumElements, uint8* RESTRICT OutData)
+	{
+		T Previous = 0;
+		for (int64 Index = 0; Index < NumElements; Index++)
+		{
+			T Value;
+			FMemory::Memcpy(&Value, Data + Index * sizeof(T), sizeof(T));
+			
+			const T Delta = T(Value - Previous);
+			Previous = Value;
+
+			for (int32 Byte = 0; Byte < sizeof(T); Byte++)
+			{
+				OutData[Byte * NumElements + Index] = uint8(Delta >> (8 * Byte));
+			}
+		}
+	}
+	template<typename T>
+	void DeltaDecode(const uint8* RESTRICT Data, int64 NumElements, uint8* RESTRICT OutData)
+	{
+		T Previous = 0;
+		for (int64 Index = 0; Index < NumElements; Index++)
+		{
+			T Delta = 0;
+			for (int32 Byte = 0; Byte < sizeof(T); Byte++)
+			{
+				Delta |= T(Data[Byte * NumElements + Index]) << (8 * Byte);
+			}
+
+			const T Value = T(Previous + Delta);
+			Previous = Value;
+			
+			FMemory::Memcpy(OutData + Index * sizeof(T), &Value, sizeof(T));
+		}
+	}
+
+	void SplitPlanes(const uint8* RESTRICT Data, int64 NumElements, int32 Stride, uint8* RESTRICT OutData)
+	{
+		for (int32 Plane = 0; Plane < Stride; Plane++)
+		{
+			uint8* RESTRICT PlaneData = OutData + Plane * NumElements;
+			for (int64 Index = 0; Index < NumElements; Index++)
+			{
+				PlaneData[Index] = Data[Index * Stride + Plane];
+			}
+		}
+	}
+	void MergePlanes(const uint8* RESTRICT Data, int64 NumElements, int32 Stride, uint8* RESTRICT OutData)
+	{
+		for (int32 Plane = 0; Plane < Stride; Plane++)
+		{
+			const uint8* RESTRICT PlaneData = Data + Plane * NumElements;
+			for (int64 Index = 0; Index < NumElements; Index++)
+			{
+				OutData[Index * Stride + Plane] = PlaneData[Index];
+			}
+		}
+	}
+
+	// The bytes after the last full element are copied as is
+	void ApplyFilter(const FChunkCodec& Codec, const uint8* Data, int64 Num, uint8* OutData, bool bRevert)
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+		
+		const int64 NumElements = Num / Codec.FilterStride;
+		const int64 FilteredNum = NumElements * Codec.FilterStride;
+
+		switch (Codec.Filter)
+		{
+		case EVoxelCompressionFilter::DeltaValues:
+		{
+			if (Codec.FilterStride == 1)
+			{
+				(bRevert ? DeltaDecode<uint8> : DeltaEncode<uint8>)(Data, NumElements, OutData);
+			}
+			else if (Codec.FilterStride == 2)
+			{
+				(bRevert ? DeltaDecode<uint16> : DeltaEncode<uint16>)(Data, NumElements, OutData);
+			}
+			else
+			{
+				(bRevert ? MergePlanes : SplitPlanes)(Data, NumElements, Codec.FilterStride, OutData);
+			}
+			break;
+		}
+		case EVoxelCompressionFilter::SplitMaterialChannels:
+		{
+			(bRevert ? MergePlanes : SplitPlanes)(Data, NumElements, Codec.FilterStride, OutData);
+			break;
+		}
+		default:
+		{
+			ensure(false);
+			FMemory::Memcpy(OutData, Data, FilteredNum);
+		}
+		}
+
+		FMemory::Memcpy(OutData + FilteredNum, Data + FilteredNum, Num - FilteredNum);
+	}
+
+	///////////////////////////////////////////////////////////////////////////////
+
+	bool CompressChunk(const uint8* Data, int64 Num, const FChunkCodec& Codec, TArray64<uint8>& OutCompressedData)
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+		check(Num <= MaxChunkSize);
+
+		TArray64<uint8> FilteredData;
+		if (Codec.Filter != EVoxelCompressionFilter::None)
+		{
+			FilteredData.SetNumUninitialized(Num);
+			ApplyFilter(Codec, Data, Num, FilteredData.GetData(), false);
+			Data = FilteredData.GetData();
+		}
+
+		if (Codec.Codec == EVoxelCompressionCodec::Zlib)
+		{
+			uLong CompressedSize = compressBound(Num);
+			OutCompressedData.SetNumUninitialized(CompressedSize);
+
+			const auto Result = compress2(OutCompressedData.GetData(), &CompressedSize, Data, Num, Codec.Level);
+			if (!ensureMsgf(Result == Z_OK, TEXT("Compression failed: %d"), Result))
+			{
+				OutCompressedData.Empty();
+				return false;
+			}
+
+			OutCompressedData.SetNum(CompressedSize, UE_505_SWITCH(true, EAllowShrinking::Yes));
+			return true;
+		}
+		else
+		{
+			const FName FormatName = GetEngineCodecName(Codec.Codec);
+			const ECompressionFlags Flags = GetEngineCompressionFlags(Codec.Level);
+			
+			int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Num, Flags);
+			OutCompressedData.SetNumUninitialized(CompressedSize);
+
+			if (!ensureMsgf(FCompression::CompressMemory(FormatName, OutCompressedData.GetData(), CompressedSize, Data, Num, Flags), TEXT("%s compression failed"), *FormatName.ToString()))
+			{
+				OutCompressedData.Empty();
+				return false;
+			}
+
+			OutCompressedData.SetNum(CompressedSize, UE_505_SWITCH(true, EAllowShrinking::Yes));
+			return true;
+		}
+	}
+
+	bool DecompressChunk(const uint8* CompressedData, int64 CompressedSize, const FChunkCodec& Codec, uint8* OutData, int64 UncompressedSize)
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+
+		TArray64<uint8> FilteredData;
+		uint8* DecompressedData = OutData;
+		if (Codec.Filter != EVoxelCompressionFilter::None)
+		{
+			FilteredData.SetNumUninitialized(UncompressedSize);
+			DecompressedData = FilteredData.GetData();
+		}
+
+		if (Codec.Codec == EVoxelCompressionCodec::Zlib)
+		{
+			uLong DecompressedSize = UncompressedSize;
+			const auto Result = uncompress(DecompressedData, &DecompressedSize, CompressedData, CompressedSize);
+
+			if (!ensureMsgf(Result == Z_OK, TEXT("Decompression failed: %d"), Result) ||
+				!ensureMsgf(DecompressedSize == UncompressedSize, TEXT("Decompressed %lu bytes, expected %lld"), DecompressedSize, UncompressedSize))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			const FName FormatName = GetEngineCodecName(Codec.Codec);
+			if (!ensureMsgf(FCompression::IsFormatValid(FormatName), TEXT("Data was compressed with %s, which is not available"), *FormatName.ToString()) ||
+				!ensureMsgf(FCompression::UncompressMemory(FormatName, DecompressedData, UncompressedSize, CompressedData, CompressedSize), TEXT("%s decompression failed"), *FormatName.ToString()))
+			{
+				return false;
+			}
+		}
+
+		if (Codec.Filter != EVoxelCompressionFilter::None)
+		{
+			ApplyFilter(Codec, DecompressedData, UncompressedSize, OutData, true);
+		}
+
+		return true;
+	}
+
+	// Write the header, the chunk table and the chunks
+	void WriteChunks(FArchive& Ar, const FChunkCodec& Codec, const TArray<TArray64<uint8>>& CompressedChunks, const TArray<uint32>& ChunksUncompressedSize)
+	{
+		VOXEL_ASYNC_FUNCTION_COUNTER();
+		check(CompressedChunks.Num() == ChunksUncompressedSize.Num());
+
+		FHeader Header;
+		Header.Flags = HeaderFlag_ChunkTable | Codec.ToHeaderFlags();
+		Header.NumChunks = CompressedChunks.Num();
+		Header.CompressedSize = CompressedChunks.Num() * sizeof(FChunkEntry);
+
+		TArray<FChunkEntry> Entries;
+		Entries.Reserve(CompressedChunks.Num());
+		for (int32 ChunkIndex = 0; ChunkIndex < CompressedChunks.Num(); ChunkIndex++)
+		{
+			FChunkEntry& Entry = Entries.Emplace_GetRef();
+			Entry.CompressedSize = CompressedChunks[ChunkIndex].Num();
+			Entry.UncompressedSize = ChunksUncompressedSize[ChunkIndex];
+
+			Header.CompressedSize += Entry.CompressedSize;
+			Header.UncompressedSize += Entry.UncompressedSize;
+		}
+
+		Ar.Serialize(&Header, sizeof(FHeader));
+		Ar.Serialize(Entries.GetData(), Entries.Num() * sizeof(FChunkEntry));
+		for (const TArray64<uint8>& Chunk : CompressedChunks)
+		{
+			Ar.Serialize(const_cast<uint8*>(Chunk.GetData()), Chunk.Num());
+		}
+	}
+
+	void LogCompression(const FChunkCodec& Codec, double TotalTime, int64 UncompressedSize, int64 CompressedSize, double CompressionTime, int32 NumChunks)
+	{
+		const double UncompressedSizeMB = double(UncompressedSize) / double(1 << 20);
+		const double CompressedSizeMB = double(CompressedSize) / double(1 << 20);
+
+		LOG_VOXEL(Log, TEXT("Compressed %f MB with %s (filter: %s) in %fs (%f MB/s). Compressed Size: %f MB (%f%%). Compression: %fs (%f%%). Num Chunks: %d."), 
+			UncompressedSizeMB, 
+			ToString(Codec.Codec),
+			ToString(Codec.Filter),
+			TotalTime, 
+			UncompressedSizeMB / TotalTime, 
+			CompressedSizeMB,
+			100 * CompressedSizeMB / UncompressedSizeMB,
+			CompressionTime,
+			100 * CompressionTime / TotalTime,
+			NumChunks);
+	}
 }
 
 void FVoxelSerializationUtilities::CompressData(
 	const uint8* const UncompressedData, 
 	const int64 UncompressedDataNum, 
 	TArray<uint8>& OutCompressedData,
-	EVoxelCompressionLevel::Type InCompressionLevel)
+	const FVoxelCompressionOptions& Options)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 	
@@ -233,117 +643,189 @@ void FVoxelSerializationUtilities::CompressData(
 		return;
 	}
 
-	const auto GetCompressionLevel = [&]()
+	const FChunkCodec Codec = GetChunkCodec(GetCompressionLevel(Options.Level), GetCompressionCodec(Options.Codec), Options.Filter);
+	const int64 ChunkSize = GetCompressionChunkSize();
+	const int32 NumChunks = FVoxelUtilities::DivideCeil64(UncompressedDataNum, ChunkSize);
+
+	TArray<TArray64<uint8>> CompressedChunks;
+	TArray<uint32> ChunksUncompressedSize;
+	CompressedChunks.SetNum(NumChunks);
+	ChunksUncompressedSize.SetNum(NumChunks);
+
+	// Compress chunks
+	std::atomic<bool> bFailed{ false };
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
 	{
-		int32 CompressionLevel = InCompressionLevel;
-		if (CompressionLevel == EVoxelCompressionLevel::VoxelDefault)
+		const int64 Start = ChunkIndex * ChunkSize;
+		const int64 Size = FMath::Min(ChunkSize, UncompressedDataNum - Start);
+
+		ChunksUncompressedSize[ChunkIndex] = Size;
+		if (!CompressChunk(UncompressedData + Start, Size, Codec, CompressedChunks[ChunkIndex]))
 		{
-			CompressionLevel = GetDefault<UVoxelSettings>()->DefaultCompressionLevel;
+			bFailed = true;
 		}
-		CompressionLevel = FMath::Clamp(CompressionLevel, -1, 9);
-		static_assert(Z_NO_COMPRESSION == 0, "");
-		static_assert(Z_BEST_COMPRESSION == 9, "");
-		return CompressionLevel;
-	};
-	const int32 CompressionLevel = GetCompressionLevel();
+	});
+	const double CompressionTime = FPlatformTime::Seconds() - TotalStartTime;
 
-	const int32 NumChunks = FVoxelUtilities::DivideCeil64(UncompressedDataNum, MaxChunkSize);
-	check(0 < NumChunks && NumChunks < MaxNumChunks);
-
-	struct FChunk
+	if (bFailed)
 	{
-		int64 Start = 0;
-		int64 Size = 0;
-		uLong CompressedSize = 0;
-	};
-	TArray<FChunk, TFixedAllocator<MaxNumChunks>> Chunks;
+		OutCompressedData.Empty();
+		return;
+	}
 
-	// Fill chunks
-	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+	int64 TotalCompressedSize = 0;
+	for (const TArray64<uint8>& Chunk : CompressedChunks)
 	{
-		auto& NewChunk = Chunks.Emplace_GetRef();
-		NewChunk.Start = ChunkIndex * MaxChunkSize;
-		NewChunk.Size = FMath::Min(MaxChunkSize, UncompressedDataNum - ChunkIndex * MaxChunkSize);
+		TotalCompressedSize += Chunk.Num();
 	}
-	check(Chunks.Last().Start + Chunks.Last().Size == UncompressedDataNum);
+	const int64 TotalSize = sizeof(FHeader) + NumChunks * sizeof(FChunkEntry) + TotalCompressedSize;
+	checkf(TotalSize < MAX_int32, TEXT("Compressed data overflow: %lld"), TotalSize);
 
-	// Compute estimated compressed size
-	int64 TotalCompressedSizeBound = 0;
-	for (auto& Chunk : Chunks)
+	// Write final data
+	OutCompressedData.Reset(TotalSize);
+	FMemoryWriter Writer(OutCompressedData);
+	WriteChunks(Writer, Codec, CompressedChunks, ChunksUncompressedSize);
+	check(OutCompressedData.Num() == TotalSize);
+
+	if (Options.bLog)
 	{
-		Chunk.CompressedSize = compressBound(Chunk.Size);
-		TotalCompressedSizeBound += Chunk.CompressedSize;
+		LogCompression(Codec, FPlatformTime::Seconds() - TotalStartTime, UncompressedDataNum, TotalCompressedSize, CompressionTime, NumChunks);
 	}
+}
 
-	// Allocate memory
-	TArray64<uint8> CompressedData;
-	CompressedData.SetNumUninitialized(TotalCompressedSizeBound);
+void FVoxelSerializationUtilities::CompressData(FLargeMemoryWriter& UncompressedData, TArray<uint8>& CompressedData, const FVoxelCompressionOptions& Options)
+{
+	// Tell and not TotalSize: TotalSize returns the total memory allocated by the writer, which might be bigger if AllocatedMemory is too big
+	CompressData(UncompressedData.GetData(), UncompressedData.Tell(), CompressedData, Options);
+}
 
-	FHeader Header;
+void FVoxelSerializationUtilities::SerializeDeltaEncoded(FArchive& Archive, uint8* Data, int64 NumElements, int32 ElementSize)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(Archive.IsLoading() || Archive.IsSaving());
+	
+	FChunkCodec Codec;
+	Codec.Filter = EVoxelCompressionFilter::DeltaValues;
+	Codec.FilterStride = ElementSize;
 
-	int64 TotalCompressedSize = 0;
-	double CompressionTime = 0;
+	// Filter a block at a time, to not duplicate the whole buffer
+	const int64 BlockSize = int64(VOXELS_PER_DATA_CHUNK) * ElementSize;
+	TArray64<uint8> Block;
+	Block.SetNumUninitialized(FMath::Min(BlockSize, NumElements * ElementSize));
 
-	// Compress chunks
-	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ChunkIndex++)
+	for (int64 Offset = 0; Offset < NumElements * ElementSize; Offset += BlockSize)
 	{
-		FChunk& Chunk = Chunks[ChunkIndex];
-		
-		const double StartTime = FPlatformTime::Seconds();
-		const auto Result = compress2(CompressedData.GetData() + TotalCompressedSize, &Chunk.CompressedSize, UncompressedData + Chunk.Start, Chunk.Size, CompressionLevel);
-		const double EndTime = FPlatformTime::Seconds();
-		
-		if (!ensureMsgf(Result == Z_OK, TEXT("Compression failed: %d"), Result))
+		const int64 Num = FMath::Min(BlockSize, NumElements * ElementSize - Offset);
+		if (Archive.IsLoading())
+		{
+			Archive.Serialize(Block.GetData(), Num);
+			ApplyFilter(Codec, Block.GetData(), Num, Data + Offset, true);
+		}
+		else
 		{
-			CompressedData.Reset();
-			return;
+			ApplyFilter(Codec, Data + Offset, Num, Block.GetData(), false);
+			Archive.Serialize(Block.GetData(), Num);
 		}
+	}
+}
+
+static bool DecompressChunks(const FVoxelSerializationUtilities::FHeader& Header, const TArray<uint8>& CompressedData, TArray64<uint8>& UncompressedData, bool bLog)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	using namespace FVoxelSerializationUtilities;
 
-		CompressionTime += EndTime - StartTime;
-		TotalCompressedSize += Chunk.CompressedSize;
+	const double TotalStartTime = FPlatformTime::Seconds();
 
-		Header.ChunksCompressedSize[ChunkIndex] = Chunk.CompressedSize;
+	const int64 TableSize = int64(Header.NumChunks) * sizeof(FChunkEntry);
+	if (!ensureMsgf(TableSize <= Header.CompressedSize, TEXT("Header.NumChunks was %u"), Header.NumChunks))
+	{
+		UncompressedData.Empty();
+		return false;
 	}
-	check(TotalCompressedSize <= TotalCompressedSizeBound);
-	checkf(TotalCompressedSize < MAX_int32 - sizeof(FHeader), TEXT("Compressed data overflow: %lld"), TotalCompressedSize);
 
-	// Fill header
-	Header.CompressedSize = TotalCompressedSize;
-	Header.UncompressedSize = UncompressedDataNum;
-	Header.NumChunks = NumChunks;
+	FChunkCodec Codec;
+	if (!FChunkCodec::FromHeaderFlags(Header.Flags, Codec))
+	{
+		UncompressedData.Empty();
+		return false;
+	}
 
-	// Write final data
-	OutCompressedData.SetNumUninitialized(sizeof(FHeader) + TotalCompressedSize);
-	FMemory::Memcpy(OutCompressedData.GetData(), &Header, sizeof(FHeader));
-	FMemory::Memcpy(OutCompressedData.GetData() + sizeof(FHeader), CompressedData.GetData(), TotalCompressedSize);
+	TArray<FChunkEntry> Entries;
+	Entries.SetNumUninitialized(Header.NumChunks);
+	FMemory::Memcpy(Entries.GetData(), CompressedData.GetData() + sizeof(FHeader), TableSize);
 
-	// Log time
+	// Offsets of the chunks in the compressed & uncompressed data
+	TArray<int64> CompressedOffsets;
+	TArray<int64> UncompressedOffsets;
+	CompressedOffsets.SetNumUninitialized(Entries.Num());
+	UncompressedOffsets.SetNumUninitialized(Entries.Num());
 	
-	const double TotalEndTime = FPlatformTime::Seconds();
+	int64 TotalCompressedSize = TableSize;
+	int64 TotalUncompressedSize = 0;
+	for (int32 ChunkIndex = 0; ChunkIndex < Entries.Num(); ChunkIndex++)
+	{
+		CompressedOffsets[ChunkIndex] = sizeof(FHeader) + TotalCompressedSize;
+		UncompressedOffsets[ChunkIndex] = TotalUncompressedSize;
+
+		TotalCompressedSize += Entries[ChunkIndex].CompressedSize;
+		TotalUncompressedSize += Entries[ChunkIndex].UncompressedSize;
+	}
 	
-	const double UncompressedSizeMB = double(UncompressedDataNum) / double(1 << 20);
-	const double CompressedSizeMB = double(TotalCompressedSize) / double(1 << 20);
+	if (!ensureMsgf(TotalCompressedSize == Header.CompressedSize, TEXT("Compressed size mismatch: chunks are %lld, but %lld in header"), TotalCompressedSize, Header.CompressedSize))
+	{
+		UncompressedData.Empty();
+		return false;
+	}
+	if (!ensureMsgf(TotalUncompressedSize == Header.UncompressedSize, TEXT("Uncompressed size mismatch: chunks are %lld, but %lld in header"), TotalUncompressedSize, Header.UncompressedSize))
+	{
+		UncompressedData.Empty();
+		return false;
+	}
+
+	UncompressedData.SetNumUninitialized(Header.UncompressedSize);
+
+	std::atomic<bool> bFailed{ false };
+	ParallelFor(Entries.Num(), [&](int32 ChunkIndex)
+	{
+		const FChunkEntry& Entry = Entries[ChunkIndex];
+
+		if (!DecompressChunk(
+			CompressedData.GetData() + CompressedOffsets[ChunkIndex], Entry.CompressedSize,
+			Codec,
+			UncompressedData.GetData() + UncompressedOffsets[ChunkIndex], Entry.UncompressedSize))
+		{
+			bFailed = true;
+		}
+	});
 
-	const double TotalTime = TotalEndTime - TotalStartTime;
+	if (bFailed)
+	{
+		UncompressedData.Empty();
+		return false;
+	}
 	
-	LOG_VOXEL(Log, TEXT("Compressed %f MB in %fs (%f MB/s). Compressed Size: %f MB (%f%%). Compression: %fs (%f%%). Num Chunks: %d."), 
-		UncompressedSizeMB, 
-		TotalTime, 
-		UncompressedSizeMB / TotalTime, 
-		CompressedSizeMB,
-		100 * CompressedSizeMB / UncompressedSizeMB,
-		CompressionTime,
-		100 * CompressionTime / TotalTime,
-		NumChunks);
-}
+	if (!bLog)
+	{
+		return true;
+	}
+	
+	const double TotalTime = FPlatformTime::Seconds() - TotalStartTime;
+	const double UncompressedSizeMB = double(TotalUncompressedSize) / double(1 << 20);
 
-void FVoxelSerializationUtilities::CompressData(FLargeMemoryWriter& UncompressedData, TArray<uint8>& CompressedData, EVoxelCompressionLevel::Type CompressionLevel)
-{
-	// Tell and not TotalSize: TotalSize returns the total memory allocated by the writer, which might be bigger if AllocatedMemory is too big
-	CompressData(UncompressedData.GetData(), UncompressedData.Tell(), CompressedData, CompressionLevel);
+	LOG_VOXEL(Log, TEXT("Decompressed %f MB with %s (filter: %s) in %fs (%f MB/s). Compressed Size: %f MB (%f%%). Num Chunks: %d."),
+		UncompressedSizeMB,
+		ToString(Codec.Codec),
+		ToString(Codec.Filter),
+		TotalTime,
+		UncompressedSizeMB / TotalTime,
+		double(TotalCompressedSize) / double(1 << 20),
+		100 * double(TotalCompressedSize) / double(FMath::Max<int64>(TotalUncompressedSize, 1)),
+		Entries.Num());
+
+	return true;
 }
 
-bool FVoxelSerializationUtilities::DecompressData(const TArray<uint8>& CompressedData, TArray64<uint8>& UncompressedData)
+bool FVoxelSerializationUtilities::DecompressData(const TArray<uint8>& CompressedData, TArray64<uint8>& UncompressedData, bool bLog)
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
 	
@@ -384,6 +866,11 @@ bool FVoxelSerializationUtilities::DecompressData(const TArray<uint8>& Compresse
 			return false;
 		}
 		
+		if (Header.Flags & HeaderFlag_ChunkTable)
+		{
+			return DecompressChunks(Header, CompressedData, UncompressedData, bLog);
+		}
+
 		if (!ensureMsgf(Header.NumChunks <= MaxNumChunks, TEXT("Header.NumChunks was %u"), Header.NumChunks))
 		{
 			UncompressedData.Empty();
@@ -492,7 +979,7 @@ bool FVoxelSerializationUtilities::DecompressData(const TArray<uint8>& Compresse
 	}
 }
 
-void FVoxelSerializationUtilities::TestCompression(int64 Size, EVoxelCompressionLevel::Type CompressionLevel)
+void FVoxelSerializationUtilities::TestCompression(int64 Size, const FVoxelCompressionOptions& Options)
 {
 	LOG_VOXEL(Log, TEXT("Testing compression on %fMB"), double(Size) / double(1 << 20));
 	
@@ -506,7 +993,7 @@ void FVoxelSerializationUtilities::TestCompression(int64 Size, EVoxelCompression
 	}
 
 	TArray<uint8> CompressedData;
-	CompressData(Data.GetData(), Data.Num(), CompressedData, CompressionLevel);
+	CompressData(Data.GetData(), Data.Num(), CompressedData, Options);
 
 	TArray64<uint8> UncompressedData;
 	DecompressData(CompressedData, UncompressedData);
@@ -517,4 +1004,229 @@ void FVoxelSerializationUtilities::TestCompression(int64 Size, EVoxelCompression
 	{
 		check(Data[Index] == UncompressedData[Index]);
 	}
-}
\ No newline at end of file
+}
+
+void FVoxelSerializationUtilities::BenchmarkCompression(const uint8* Data, int64 Num)
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	const double SizeMB = double(Num) / double(1 << 20);
+	LOG_VOXEL(Log, TEXT("Compression benchmark on %f MB"), SizeMB);
+	
+	if (Num == 0)
+	{
+		return;
+	}
+
+	for (const EVoxelCompressionCodec Codec : { EVoxelCompressionCodec::Zlib, EVoxelCompressionCodec::LZ4, EVoxelCompressionCodec::Oodle })
+	{
+		if (Codec == EVoxelCompressionCodec::Oodle && !FCompression::IsFormatValid(NAME_Oodle))
+		{
+			LOG_VOXEL(Log, TEXT("%-6s: not available"), ToString(Codec));
+			continue;
+		}
+		
+		for (const EVoxelCompressionFilter Filter : { EVoxelCompressionFilter::None, EVoxelCompressionFilter::DeltaValues, EVoxelCompressionFilter::SplitMaterialChannels })
+		{
+			for (const int32 Level : { 1, 6 })
+			{
+				if (Codec == EVoxelCompressionCodec::LZ4 && Level != 1)
+				{
+					// Level is ignored
+					continue;
+				}
+				
+				FVoxelCompressionOptions Options;
+				Options.Level = EVoxelCompressionLevel::Type(Level);
+				Options.Codec = Codec;
+				Options.Filter = Filter;
+				Options.bLog = false;
+
+				const double CompressStartTime = FPlatformTime::Seconds();
+				TArray<uint8> CompressedData;
+				CompressData(Data, Num, CompressedData, Options);
+				const double CompressTime = FPlatformTime::Seconds() - CompressStartTime;
+
+				const double DecompressStartTime = FPlatformTime::Seconds();
+				TArray64<uint8> UncompressedData;
+				const bool bSuccess = DecompressData(CompressedData, UncompressedData, false);
+				const double DecompressTime = FPlatformTime::Seconds() - DecompressStartTime;
+
+				const bool bValid = bSuccess && UncompressedData.Num() == Num && FMemory::Memcmp(UncompressedData.GetData(), Data, Num) == 0;
+				ensureMsgf(bValid, TEXT("%s/%s: decompressed data doesn't match"), ToString(Codec), ToString(Filter));
+
+				LOG_VOXEL(Log, TEXT("%-6s level %d, filter %-21s: compress %8.2f MB/s, decompress %8.2f MB/s, ratio %6.2f%%%s"),
+					ToString(Codec),
+					Level,
+					ToString(Filter),
+					SizeMB / CompressTime,
+					SizeMB / DecompressTime,
+					100 * double(CompressedData.Num()) / double(Num),
+					bValid ? TEXT("") : TEXT(" INVALID"));
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+FVoxelCompressedWriter::FVoxelCompressedWriter(const FVoxelCompressionOptions& Options, bool bMultiThreaded)
+	: CompressionLevel(FVoxelSerializationUtilities::GetCompressionLevel(Options.Level))
+	, Codec(FVoxelSerializationUtilities::GetCompressionCodec(Options.Codec))
+	, Filter(Options.Filter)
+	, bLog(Options.bLog)
+	, bMultiThreaded(bMultiThreaded)
+	, ChunkSize(FVoxelSerializationUtilities::GetCompressionChunkSize())
+	, MaxPendingChunks(
+		CVarCompressionMaxPendingChunks.GetValueOnAnyThread() > 0
+		? CVarCompressionMaxPendingChunks.GetValueOnAnyThread()
+		: FTaskGraphInterface::Get().GetNumWorkerThreads() + 1)
+	, StartTime(FPlatformTime::Seconds())
+{
+	SetIsSaving(true);
+	SetIsPersistent(false);
+
+	CurrentChunk.Reserve(ChunkSize);
+}
+
+FVoxelCompressedWriter::~FVoxelCompressedWriter()
+{
+	// Don't leave tasks running if Finish wasn't called
+	WaitForAllChunks();
+}
+
+void FVoxelCompressedWriter::Serialize(void* Data, int64 Num)
+{
+	VOXEL_SLOW_FUNCTION_COUNTER();
+	check(!bFinished);
+
+	const uint8* Bytes = static_cast<const uint8*>(Data);
+	while (Num > 0)
+	{
+		const int64 NumToCopy = FMath::Min(Num, ChunkSize - CurrentChunk.Num());
+		FMemory::Memcpy(CurrentChunk.GetData() + CurrentChunk.AddUninitialized(NumToCopy), Bytes, NumToCopy);
+
+		Bytes += NumToCopy;
+		Num -= NumToCopy;
+		UncompressedSize += NumToCopy;
+
+		if (CurrentChunk.Num() == ChunkSize)
+		{
+			FlushCurrentChunk();
+		}
+	}
+}
+
+bool FVoxelCompressedWriter::Finish(FArchive& OutArchive)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(!bFinished);
+
+	if (CurrentChunk.Num() > 0)
+	{
+		FlushCurrentChunk();
+	}
+	WaitForAllChunks();
+	bFinished = true;
+
+	TArray<TArray64<uint8>> CompressedChunks;
+	TArray<uint32> ChunksUncompressedSize;
+	CompressedChunks.Reserve(Chunks.Num());
+	ChunksUncompressedSize.Reserve(Chunks.Num());
+
+	int64 TotalCompressedSize = 0;
+	double CompressionTime = 0;
+	for (FChunk& Chunk : Chunks)
+	{
+		if (!Chunk.bSuccess)
+		{
+			return false;
+		}
+		TotalCompressedSize += Chunk.CompressedData.Num();
+		CompressionTime += Chunk.CompressionTime;
+		ChunksUncompressedSize.Add(Chunk.UncompressedSize);
+		CompressedChunks.Add(MoveTemp(Chunk.CompressedData));
+	}
+	Chunks.Empty();
+
+	const FVoxelSerializationUtilities::FChunkCodec ChunkCodec = FVoxelSerializationUtilities::GetChunkCodec(CompressionLevel, Codec, Filter);
+	FVoxelSerializationUtilities::WriteChunks(OutArchive, ChunkCodec, CompressedChunks, ChunksUncompressedSize);
+
+	if (bLog)
+	{
+		// CompressionTime is the sum of the time spent compressing each chunk: it can exceed the total time when chunks are compressed in parallel
+		FVoxelSerializationUtilities::LogCompression(ChunkCodec, FPlatformTime::Seconds() - StartTime, UncompressedSize, TotalCompressedSize, CompressionTime, CompressedChunks.Num());
+	}
+
+	return !OutArchive.IsError();
+}
+
+bool FVoxelCompressedWriter::Finish(TArray<uint8>& OutCompressedData)
+{
+	OutCompressedData.Reset();
+
+	FMemoryWriter Writer(OutCompressedData);
+	if (!Finish(Writer))
+	{
+		OutCompressedData.Empty();
+		return false;
+	}
+	return true;
+}
+
+void FVoxelCompressedWriter::FlushCurrentChunk()
+{
+	VOXEL_SLOW_FUNCTION_COUNTER();
+
+	const auto CompressChunk = [](const TArray64<uint8>& Data, const FVoxelSerializationUtilities::FChunkCodec& ChunkCodec)
+	{
+		const double ChunkStartTime = FPlatformTime::Seconds();
+		
+		FChunk Chunk;
+		Chunk.UncompressedSize = Data.Num();
+		Chunk.bSuccess = FVoxelSerializationUtilities::CompressChunk(Data.GetData(), Data.Num(), ChunkCodec, Chunk.CompressedData);
+		Chunk.CompressionTime = FPlatformTime::Seconds() - ChunkStartTime;
+		return Chunk;
+	};
+	const FVoxelSerializationUtilities::FChunkCodec ChunkCodec = FVoxelSerializationUtilities::GetChunkCodec(CompressionLevel, Codec, Filter);
+
+	if (!bMultiThreaded)
+	{
+		Chunks.Add(CompressChunk(CurrentChunk, ChunkCodec));
+		CurrentChunk.Reset();
+		return;
+	}
+
+	// Bound the memory used by the chunks waiting to be compressed
+	while (PendingChunks.Num() >= MaxPendingChunks)
+	{
+		WaitForOldestChunk();
+	}
+
+	PendingChunks.Add(Async(EAsyncExecution::TaskGraph, [CompressChunk, ChunkCodec, Data = MoveTemp(CurrentChunk)]()
+	{
+		return CompressChunk(Data, ChunkCodec);
+	}));
+
+	CurrentChunk = {};
+	CurrentChunk.Reserve(ChunkSize);
+}
+
+void FVoxelCompressedWriter::WaitForOldestChunk()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+	check(PendingChunks.Num() > 0);
+
+	Chunks.Add(PendingChunks[0].Consume());
+	PendingChunks.RemoveAt(0);
+}
+
+void FVoxelCompressedWriter::WaitForAllChunks()
+{
+	while (PendingChunks.Num() > 0)
+	{
+		WaitForOldestChunk();
+	}
+}
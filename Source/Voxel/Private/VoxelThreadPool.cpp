@@ -4,12 +4,14 @@
 #include "VoxelQueuedWork.h"
 #include "VoxelMinimal.h"
 #include "IVoxelPool.h"
+#include "VoxelPriorityHandler.h"
 
 #include "HAL/Event.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
 #include "Misc/ScopeLock.h"
 #include "Misc/ScopeExit.h"
+#include "HAL/IConsoleManager.h"
 #include "Async/TaskGraphInterfaces.h"
 
 DECLARE_DWORD_COUNTER_STAT(TEXT("VoxelThreadPoolDummyCounter"), STAT_VoxelThreadPoolDummyCounter, STATGROUP_ThreadPoolAsyncTasks);
@@ -47,6 +49,147 @@ void FVoxelQueuedThreadPoolStats::LogTimes() const
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+inline uint32 AddPriorityOffset(uint32 Priority, int32 PriorityOffset)
+{
+	return FMath::Clamp<int64>(int64(Priority) + PriorityOffset, MIN_uint32, MAX_uint32);
+}
+
+uint32 FVoxelQueuedWorkPriorityIndex::ComputePriority(const IVoxelQueuedWork& Work, int32 PriorityOffset)
+{
+	return AddPriorityOffset(Work.GetPriority(), PriorityOffset);
+}
+
+void FVoxelQueuedWorkPriorityIndex::FPrioritiesUpdate::ComputePriorities()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	MinPriorityDuration = MAX_dbl;
+	for (FWorkInfo& WorkInfo : Works)
+	{
+		WorkInfo.Priority = ComputePriority(*WorkInfo.Work, WorkInfo.PriorityOffset);
+		MinPriorityDuration = FMath::Min(MinPriorityDuration, WorkInfo.Work->PriorityDuration);
+	}
+	Works.Heapify();
+}
+
+void FVoxelQueuedWorkPriorityIndex::Add(IVoxelQueuedWork* Work, uint32 PriorityCategory, int32 PriorityOffset, uint32 Priority, int32 PrioritiesVersion)
+{
+	int32 BucketIndex = 0;
+	while (BucketIndex < Buckets.Num() && Buckets[BucketIndex].PriorityCategory > PriorityCategory)
+	{
+		BucketIndex++;
+	}
+	if (BucketIndex == Buckets.Num() || Buckets[BucketIndex].PriorityCategory != PriorityCategory)
+	{
+		FBucket NewBucket;
+		NewBucket.PriorityCategory = PriorityCategory;
+		NewBucket.PrioritiesVersion = PrioritiesVersion;
+		Buckets.Insert(MoveTemp(NewBucket), BucketIndex);
+	}
+
+	FBucket& Bucket = Buckets[BucketIndex];
+	Bucket.Works.HeapPush(FWorkInfo{ Work, Priority, PriorityOffset });
+	Bucket.MinPriorityDuration = FMath::Min(Bucket.MinPriorityDuration, Work->PriorityDuration);
+	NumWorks++;
+}
+
+IVoxelQueuedWork* FVoxelQueuedWorkPriorityIndex::Pop(uint32 PriorityCategory)
+{
+	if (PriorityCategory != AnyPriorityCategory)
+	{
+		// The other categories might have works: having none in this one is expected
+		FBucket* Bucket = Buckets.FindByPredicate([&](const FBucket& It) { return It.PriorityCategory == PriorityCategory; });
+		return Bucket ? PopFromBucket(*Bucket) : nullptr;
+	}
+
+	for (FBucket& Bucket : Buckets)
+	{
+		if (IVoxelQueuedWork* Work = PopFromBucket(Bucket))
+		{
+			return Work;
+		}
+	}
+
+	check(NumWorks == 0);
+	return nullptr;
+}
+
+IVoxelQueuedWork* FVoxelQueuedWorkPriorityIndex::PopFromBucket(FBucket& Bucket)
+{
+	if (Bucket.Works.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	FWorkInfo WorkInfo;
+	Bucket.Works.HeapPop(WorkInfo, UE_505_SWITCH(false, EAllowShrinking::No));
+	NumWorks--;
+	return WorkInfo.Work;
+}
+
+bool FVoxelQueuedWorkPriorityIndex::StartPrioritiesUpdate(int32 PrioritiesVersion, double Time, uint32 PriorityCategory, FPrioritiesUpdate& OutUpdate)
+{
+	for (FBucket& Bucket : Buckets)
+	{
+		if (PriorityCategory != AnyPriorityCategory && Bucket.PriorityCategory != PriorityCategory)
+		{
+			continue;
+		}
+		if (Bucket.Works.Num() == 0)
+		{
+			continue;
+		}
+
+		// Only update the bucket we are going to pop from
+		// If another thread is already updating it, pop the works queued in the meantime
+		if (Bucket.bUpdatingPriorities || Bucket.PrioritiesVersion == PrioritiesVersion || Bucket.NextUpdateTime >= Time)
+		{
+			return false;
+		}
+
+		Bucket.bUpdatingPriorities = true;
+		// Works queued during the update will lower it again
+		Bucket.MinPriorityDuration = MAX_dbl;
+		NumWorks -= Bucket.Works.Num();
+
+		OutUpdate.PriorityCategory = Bucket.PriorityCategory;
+		OutUpdate.PrioritiesVersion = PrioritiesVersion;
+		OutUpdate.Time = Time;
+		OutUpdate.Works = MoveTemp(Bucket.Works);
+		return true;
+	}
+	return false;
+}
+
+void FVoxelQueuedWorkPriorityIndex::EndPrioritiesUpdate(FPrioritiesUpdate& Update)
+{
+	FBucket* Bucket = Buckets.FindByPredicate([&](const FBucket& It) { return It.PriorityCategory == Update.PriorityCategory; });
+	check(Bucket && Bucket->bUpdatingPriorities);
+
+	// The works queued during the update have up to date priorities
+	for (const FWorkInfo& WorkInfo : Bucket->Works)
+	{
+		Update.Works.HeapPush(WorkInfo);
+	}
+	NumWorks += Update.Works.Num() - Bucket->Works.Num();
+
+	Bucket->Works = MoveTemp(Update.Works);
+	Bucket->bUpdatingPriorities = false;
+	Bucket->PrioritiesVersion = Update.PrioritiesVersion;
+	Bucket->MinPriorityDuration = FMath::Min(Bucket->MinPriorityDuration, Update.MinPriorityDuration);
+	Bucket->NextUpdateTime = Update.Time + Bucket->MinPriorityDuration;
+}
+
+void FVoxelQueuedWorkPriorityIndex::Reset()
+{
+	Buckets.Reset();
+	NumWorks = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 class FScopeLockWithStats
 {
 public:
@@ -77,8 +220,10 @@ public:
 	FVoxelQueuedThreadPool* const ThreadPool;
 	/** The event that tells the thread there is work to do. */
 	FEvent* const DoWorkEvent;
+	/** If true, only runs works with the priority category ReservedPriorityCategory */
+	const bool bReserved;
 
-	FVoxelQueuedThread(FVoxelQueuedThreadPool* Pool, const FString& ThreadName, uint32 StackSize, EThreadPriority ThreadPriority);
+	FVoxelQueuedThread(FVoxelQueuedThreadPool* Pool, const FString& ThreadName, uint32 StackSize, EThreadPriority ThreadPriority, bool bReserved);
 	~FVoxelQueuedThread();
 
 	//~ Begin FRunnable Interface
@@ -98,10 +243,11 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
-FVoxelQueuedThread::FVoxelQueuedThread(FVoxelQueuedThreadPool* Pool, const FString& ThreadName, uint32 StackSize, EThreadPriority ThreadPriority)
+FVoxelQueuedThread::FVoxelQueuedThread(FVoxelQueuedThreadPool* Pool, const FString& ThreadName, uint32 StackSize, EThreadPriority ThreadPriority, bool bReserved)
 	: ThreadName(ThreadName)
 	, ThreadPool(Pool)
 	, DoWorkEvent(FPlatformProcess::GetSynchEventFromPool()) // Create event BEFORE thread
+	, bReserved(bReserved) // BEFORE creating thread
 	, TimeToDie(false) // BEFORE creating thread
 	, QueuedWork(nullptr)
 	, Thread(FRunnableThread::Create(this, *ThreadName, StackSize, ThreadPriority, FPlatformAffinity::GetPoolThreadMask()))
@@ -172,12 +318,16 @@ FVoxelQueuedThreadPoolSettings::FVoxelQueuedThreadPoolSettings(
 	uint32 NumThreads, 
 	uint32 StackSize, 
 	EThreadPriority ThreadPriority, 
-	bool bConstantPriorities)
+	bool bConstantPriorities,
+	uint32 NumReservedThreads,
+	uint32 ReservedPriorityCategory)
 	: PoolName(PoolName)
 	, NumThreads(NumThreads)
 	, StackSize(StackSize)
 	, ThreadPriority(ThreadPriority)
 	, bConstantPriorities(bConstantPriorities)
+	, NumReservedThreads(NumReservedThreads)
+	, ReservedPriorityCategory(ReservedPriorityCategory)
 {
 }
 
@@ -193,11 +343,16 @@ inline TArray<TUniquePtr<FVoxelQueuedThread>> CreateThreads(FVoxelQueuedThreadPo
 	const uint32 NumThreads = Settings.NumThreads;
 	
 	TArray<TUniquePtr<FVoxelQueuedThread>> Threads;
-	Threads.Reserve(NumThreads);
+	Threads.Reserve(NumThreads + Settings.NumReservedThreads);
 	for (uint32 ThreadIndex = 0; ThreadIndex < NumThreads; ThreadIndex++)
 	{
 		const FString Name = FString::Printf(TEXT("%s Thread %d"), *Settings.PoolName, ThreadIndex);
-		Threads.Add(MakeUnique<FVoxelQueuedThread>(Pool, Name, Settings.StackSize, Settings.ThreadPriority));
+		Threads.Add(MakeUnique<FVoxelQueuedThread>(Pool, Name, Settings.StackSize, Settings.ThreadPriority, false));
+	}
+	for (uint32 ThreadIndex = 0; ThreadIndex < Settings.NumReservedThreads; ThreadIndex++)
+	{
+		const FString Name = FString::Printf(TEXT("%s Reserved Thread %d"), *Settings.PoolName, ThreadIndex);
+		Threads.Add(MakeUnique<FVoxelQueuedThread>(Pool, Name, Settings.StackSize, Settings.ThreadPriority, true));
 	}
 	return Threads;
 }
@@ -206,7 +361,7 @@ FVoxelQueuedThreadPool::FVoxelQueuedThreadPool(const FVoxelQueuedThreadPoolSetti
 	: Settings(Settings)
 	, AllThreads(CreateThreads(this))
 {
-	QueuedThreads.Reserve(Settings.NumThreads);
+	QueuedThreads.Reserve(AllThreads.Num());
 	for (auto& Thread : AllThreads) 
 	{
 		QueuedThreads.Add(Thread.Get());
@@ -238,11 +393,6 @@ FVoxelQueuedThreadPool::~FVoxelQueuedThreadPool()
 	}
 }
 
-inline uint32 AddPriorityOffset(uint32 Priority, int32 PriorityOffset)
-{
-	return FMath::Clamp<int64>(int64(Priority) + PriorityOffset, MIN_uint32, MAX_uint32);
-}
-
 FORCEINLINE void FVoxelQueuedThreadPool::FQueuedWorkInfo::RecomputePriority(double Time)
 {
 	Priority = AddPriorityOffset(Work->GetPriority(), PriorityOffset);
@@ -262,10 +412,14 @@ void FVoxelQueuedThreadPool::AddQueuedWork(IVoxelQueuedWork* InQueuedWork, uint3
 		return;
 	}
 
+	// Before computing the priority: if it changes in the meantime, the priority will be recomputed
+	const int32 Version = PrioritiesVersion.GetValue();
+
 	FQueuedWorkInfo WorkInfo;
 	{
 		VOXEL_SCOPE_COUNTER("Compute Priority");
 		WorkInfo = FQueuedWorkInfo(InQueuedWork, PriorityCategory, PriorityOffset);
+		WorkInfo.RecomputePriority(FPlatformTime::Seconds());
 	}
 
 	{
@@ -276,23 +430,15 @@ void FVoxelQueuedThreadPool::AddQueuedWork(IVoxelQueuedWork* InQueuedWork, uint3
 		VOXEL_SCOPE_COUNTER("Add Work");
 		if (Settings.bConstantPriorities)
 		{
-			WorkInfo.RecomputePriority(FPlatformTime::Seconds());
-			StaticQueuedWorks.push(WorkInfo);
+			PushStaticWork(WorkInfo);
 		}
 		else
 		{
-			QueuedWorks.Add(WorkInfo);
+			QueuedWorks.Add(WorkInfo.Work, WorkInfo.PriorityCategory, WorkInfo.PriorityOffset, WorkInfo.Priority, Version);
 		}
 	}
 
-	{
-		VOXEL_SCOPE_COUNTER("Wake up threads");
-		for (auto* QueuedThread : QueuedThreads)
-		{
-			QueuedThread->DoWorkEvent->Trigger();
-		}
-		QueuedThreads.Reset();
-	}
+	WakeUpQueuedThreads();
 	
 	{
 		VOXEL_SCOPE_COUNTER("Unlock");
@@ -315,42 +461,42 @@ void FVoxelQueuedThreadPool::AddQueuedWorks(const TArray<IVoxelQueuedWork*>& InQ
 		return;
 	}
 
+	// Before computing the priorities: if they change in the meantime, they will be recomputed
+	const int32 Version = PrioritiesVersion.GetValue();
+
+	TArray<FQueuedWorkInfo> WorkInfos;
+	{
+		VOXEL_SCOPE_COUNTER("Compute Priorities");
+		const double Time = FPlatformTime::Seconds();
+		WorkInfos.Reserve(InQueuedWorks.Num());
+		for (auto* InQueuedWork : InQueuedWorks)
+		{
+			FQueuedWorkInfo& WorkInfo = WorkInfos.Emplace_GetRef(InQueuedWork, PriorityCategory, PriorityOffset);
+			WorkInfo.RecomputePriority(Time);
+		}
+	}
+
 	{
 		VOXEL_SCOPE_COUNTER("Lock");
 		Section.Lock();
 	}
 
 	{
-		if (!Settings.bConstantPriorities)
-		{
-			VOXEL_SCOPE_COUNTER("Reserve");
-			QueuedWorks.Reserve(QueuedWorks.Num() + InQueuedWorks.Num());
-		}
 		VOXEL_SCOPE_COUNTER("Add Works");
-		for (auto* InQueuedWork : InQueuedWorks)
+		for (const FQueuedWorkInfo& WorkInfo : WorkInfos)
 		{
-			FQueuedWorkInfo WorkInfo(InQueuedWork, PriorityCategory, PriorityOffset);
-
 			if (Settings.bConstantPriorities)
 			{
-				WorkInfo.RecomputePriority(FPlatformTime::Seconds());
-				StaticQueuedWorks.push(WorkInfo);
+				PushStaticWork(WorkInfo);
 			}
 			else
 			{
-				QueuedWorks.Add(WorkInfo);
+				QueuedWorks.Add(WorkInfo.Work, WorkInfo.PriorityCategory, WorkInfo.PriorityOffset, WorkInfo.Priority, Version);
 			}
 		}
 	}
 
-	{
-		VOXEL_SCOPE_COUNTER("Wake up threads");
-		for (auto* QueuedThread : QueuedThreads)
-		{
-			QueuedThread->DoWorkEvent->Trigger();
-		}
-		QueuedThreads.Reset();
-	}
+	WakeUpQueuedThreads();
 
 	{
 		VOXEL_SCOPE_COUNTER("Unlock");
@@ -364,58 +510,108 @@ IVoxelQueuedWork* FVoxelQueuedThreadPool::ReturnToPoolOrGetNextJob(FVoxelQueuedT
 
 	check(InQueuedThread);
 
+	const uint32 PriorityCategory = InQueuedThread->bReserved ? Settings.ReservedPriorityCategory : FVoxelQueuedWorkPriorityIndex::AnyPriorityCategory;
+
+	FVoxelQueuedWorkPriorityIndex::FPrioritiesUpdate PrioritiesUpdate;
+	{
+		FScopeLockWithStats Lock(Section);
+		if (QueuedWorks.Num() == 0 ||
+			!QueuedWorks.StartPrioritiesUpdate(PrioritiesVersion.GetValue(), FPlatformTime::Seconds(), PriorityCategory, PrioritiesUpdate))
+		{
+			return PopNextJob(InQueuedThread, PriorityCategory);
+		}
+	}
+
+	// The priorities are outdated: recompute them outside of the lock, so that the other threads can keep popping works from the other buckets
+	PrioritiesUpdate.ComputePriorities();
+	INC_DWORD_STAT_BY(STAT_RecomputedVoxelTasksPriorities, PrioritiesUpdate.Works.Num());
+
 	FScopeLockWithStats Lock(Section);
+	if (TimeToDie)
+	{
+		for (const auto& WorkInfo : PrioritiesUpdate.Works)
+		{
+			WorkInfo.Work->Abandon();
+		}
+	}
+	else
+	{
+		QueuedWorks.EndPrioritiesUpdate(PrioritiesUpdate);
+		// Threads might have gone idle while the works were out of the index
+		WakeUpQueuedThreads();
+	}
+	return PopNextJob(InQueuedThread, PriorityCategory);
+}
 
+IVoxelQueuedWork* FVoxelQueuedThreadPool::PopNextJob(FVoxelQueuedThread* InQueuedThread, uint32 PriorityCategory)
+{
 	if (QueuedWorks.Num() > 0)
 	{
 		check(!Settings.bConstantPriorities);
 		check(!TimeToDie);
 
-		VOXEL_ASYNC_SCOPE_COUNTER("Voxel Thread Pool Recompute Priorities");
-
-		// Find best work. We recompute every priorities as the priorities can change (eg, the camera might have moved)
-		int32 BestIndex = -1;
-		uint64 BestPriority = 0;
-		int32 NumRecomputed = 0;
-		const double Time = FPlatformTime::Seconds();
-		for (int32 Index = 0; Index < QueuedWorks.Num(); Index++)
+		if (auto* Work = QueuedWorks.Pop(PriorityCategory))
 		{
-			auto& WorkInfo = QueuedWorks.GetData()[Index];
-			if (WorkInfo.NextPriorityUpdateTime < Time)
-			{
-				NumRecomputed++;
-				WorkInfo.RecomputePriority(Time);
-			}
-			const uint64 Priority = WorkInfo.GetPriority();
-			if (Priority >= BestPriority)
-			{
-				BestPriority = Priority;
-				BestIndex = Index;
-			}
+			return Work;
 		}
+		// Reserved thread, and no work it can run
+		check(InQueuedThread->bReserved);
+	}
+	else if (!StaticQueuedWorks.empty() || !StaticReservedQueuedWorks.empty())
+	{
+		check(Settings.bConstantPriorities);
 
-		INC_DWORD_STAT_BY(STAT_RecomputedVoxelTasksPriorities, NumRecomputed);
+		// Reserved threads only run reserved works. The other threads run the best work of both queues
+		std::priority_queue<FQueuedWorkInfo>* Queue = nullptr;
+		if (InQueuedThread->bReserved || StaticQueuedWorks.empty())
+		{
+			Queue = StaticReservedQueuedWorks.empty() ? nullptr : &StaticReservedQueuedWorks;
+		}
+		else if (StaticReservedQueuedWorks.empty() || StaticReservedQueuedWorks.top() < StaticQueuedWorks.top())
+		{
+			Queue = &StaticQueuedWorks;
+		}
+		else
+		{
+			Queue = &StaticReservedQueuedWorks;
+		}
 
-		auto* Work = QueuedWorks[BestIndex].Work;
-		QueuedWorks.RemoveAtSwap(BestIndex);
-		check(Work);
-		return Work;
+		if (Queue)
+		{
+			auto* Work = Queue->top().Work;
+			Queue->pop();
+			check(Work);
+			return Work;
+		}
 	}
-	else if (!StaticQueuedWorks.empty())
+
+	QueuedThreads.Add(InQueuedThread);
+	return nullptr;
+}
+
+void FVoxelQueuedThreadPool::PushStaticWork(const FQueuedWorkInfo& WorkInfo)
+{
+	check(Settings.bConstantPriorities);
+	if (Settings.NumReservedThreads > 0 && WorkInfo.PriorityCategory == Settings.ReservedPriorityCategory)
 	{
-		check(Settings.bConstantPriorities);
-		auto* Work = StaticQueuedWorks.top().Work;
-		StaticQueuedWorks.pop();
-		check(Work);
-		return Work;
+		StaticReservedQueuedWorks.push(WorkInfo);
 	}
 	else
 	{
-		QueuedThreads.Add(InQueuedThread);
-		return nullptr;
+		StaticQueuedWorks.push(WorkInfo);
 	}
 }
 
+void FVoxelQueuedThreadPool::WakeUpQueuedThreads()
+{
+	VOXEL_ASYNC_SCOPE_COUNTER("Wake up threads");
+	for (auto* QueuedThread : QueuedThreads)
+	{
+		QueuedThread->DoWorkEvent->Trigger();
+	}
+	QueuedThreads.Reset();
+}
+
 void FVoxelQueuedThreadPool::AbandonAllTasks()
 {
 	VOXEL_ASYNC_FUNCTION_COUNTER();
@@ -426,16 +622,21 @@ void FVoxelQueuedThreadPool::AbandonAllTasks()
 		FScopeLockWithStats Lock(Section);
 		TimeToDie = true;
 		// Clean up all queued objects
-		for (auto& WorkInfo : QueuedWorks)
+		QueuedWorks.ForEachWork([](IVoxelQueuedWork* Work)
 		{
-			WorkInfo.Work->Abandon();
-		}
+			Work->Abandon();
+		});
 		QueuedWorks.Reset();
 		while (!StaticQueuedWorks.empty())
 		{
 			StaticQueuedWorks.top().Work->Abandon();
 			StaticQueuedWorks.pop();
 		}
+		while (!StaticReservedQueuedWorks.empty())
+		{
+			StaticReservedQueuedWorks.top().Work->Abandon();
+			StaticReservedQueuedWorks.pop();
+		}
 	}
 	// Wait for all threads to finish up
 	while (true)
@@ -450,3 +651,144 @@ void FVoxelQueuedThreadPool::AbandonAllTasks()
 		FPlatformProcess::Sleep(0.0f);
 	}
 }
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+class FVoxelPriorityBenchmarkWork : public IVoxelQueuedWork
+{
+public:
+	const FVoxelPriorityHandler PriorityHandler;
+	double NextPriorityUpdateTime = 0;
+	uint32 Priority = 0;
+
+	FVoxelPriorityBenchmarkWork(const FVoxelIntBox& Bounds, const TVoxelSharedRef<FInvokerPositionsArray>& InvokersPositions)
+		: IVoxelQueuedWork(TEXT("Priority Benchmark"), 0.5)
+		, PriorityHandler(Bounds, InvokersPositions)
+	{
+	}
+
+	//~ Begin IVoxelQueuedWork Interface
+	virtual void DoThreadedWork() override {}
+	virtual void Abandon() override {}
+	virtual uint32 GetPriority() const override
+	{
+		return PriorityHandler.GetPriority();
+	}
+	//~ End IVoxelQueuedWork Interface
+};
+
+// Compares the dequeue latency of the previous linear scan against FVoxelQueuedWorkPriorityIndex
+static void BenchmarkVoxelTasksPriorities(const TArray<FString>& Args)
+{
+	const int32 NumWorks = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 100000;
+	// The linear scan is O(N) per dequeue: don't empty the queue
+	const int32 NumPops = FMath::Min(NumWorks, Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000);
+	const int32 InvokerMoveRate = 100;
+
+	const TVoxelSharedRef<FInvokerPositionsArray> InvokersPositions = MakeVoxelShared<FInvokerPositionsArray>(1);
+	InvokersPositions->Set({ FIntVector::ZeroValue });
+
+	FRandomStream Stream(0);
+	TArray<TUniquePtr<FVoxelPriorityBenchmarkWork>> Works;
+	Works.Reserve(NumWorks);
+	for (int32 Index = 0; Index < NumWorks; Index++)
+	{
+		const FIntVector Position(Stream.RandRange(-10000, 10000), Stream.RandRange(-10000, 10000), Stream.RandRange(-1000, 1000));
+		Works.Emplace(MakeUnique<FVoxelPriorityBenchmarkWork>(FVoxelIntBox(Position, Position + FIntVector(32)), InvokersPositions));
+	}
+
+	// Same invoker positions for both runs
+	TArray<FIntVector> InvokerMoves;
+	for (int32 Pop = 0; Pop < NumPops; Pop += InvokerMoveRate)
+	{
+		InvokerMoves.Add(FIntVector(Stream.RandRange(-10000, 10000), Stream.RandRange(-10000, 10000), 0));
+	}
+	int32 PrioritiesVersion = 0;
+	const auto MoveInvoker = [&](int32 Pop)
+	{
+		if (InvokersPositions->Set({ InvokerMoves[Pop / InvokerMoveRate] }))
+		{
+			PrioritiesVersion++;
+		}
+	};
+
+	double LinearTime;
+	{
+		TArray<FVoxelPriorityBenchmarkWork*> QueuedWorks;
+		for (auto& Work : Works)
+		{
+			QueuedWorks.Add(Work.Get());
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Pop = 0; Pop < NumPops; Pop++)
+		{
+			if (Pop % InvokerMoveRate == 0)
+			{
+				MoveInvoker(Pop);
+			}
+
+			int32 BestIndex = -1;
+			uint32 BestPriority = 0;
+			const double Time = FPlatformTime::Seconds();
+			for (int32 Index = 0; Index < QueuedWorks.Num(); Index++)
+			{
+				FVoxelPriorityBenchmarkWork& Work = *QueuedWorks[Index];
+				if (Work.NextPriorityUpdateTime < Time)
+				{
+					Work.Priority = Work.GetPriority();
+					Work.NextPriorityUpdateTime = Time + Work.PriorityDuration;
+				}
+				if (Work.Priority >= BestPriority)
+				{
+					BestPriority = Work.Priority;
+					BestIndex = Index;
+				}
+			}
+			QueuedWorks.RemoveAtSwap(BestIndex);
+		}
+		LinearTime = FPlatformTime::Seconds() - StartTime;
+	}
+
+	double IndexTime;
+	int32 NumRecomputed = 0;
+	{
+		FVoxelQueuedWorkPriorityIndex Index;
+		for (auto& Work : Works)
+		{
+			Index.Add(Work.Get(), 0, 0, FVoxelQueuedWorkPriorityIndex::ComputePriority(*Work, 0), PrioritiesVersion);
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Pop = 0; Pop < NumPops; Pop++)
+		{
+			if (Pop % InvokerMoveRate == 0)
+			{
+				MoveInvoker(Pop);
+			}
+
+			// Same steps as FVoxelQueuedThreadPool::ReturnToPoolOrGetNextJob
+			FVoxelQueuedWorkPriorityIndex::FPrioritiesUpdate Update;
+			if (Index.StartPrioritiesUpdate(PrioritiesVersion, FPlatformTime::Seconds(), 0, Update))
+			{
+				Update.ComputePriorities();
+				NumRecomputed += Update.Works.Num();
+				Index.EndPrioritiesUpdate(Update);
+			}
+			verify(Index.Pop());
+		}
+		IndexTime = FPlatformTime::Seconds() - StartTime;
+		check(Index.Num() == NumWorks - NumPops);
+	}
+
+	LOG_VOXEL(Log, TEXT("Voxel tasks priorities benchmark: %d tasks, %d dequeues, invoker moved every %d dequeues"), NumWorks, NumPops, InvokerMoveRate);
+	LOG_VOXEL(Log, TEXT("Linear scan: %fus per dequeue"), LinearTime * 1e6 / NumPops);
+	LOG_VOXEL(Log, TEXT("Priority index: %fus per dequeue (%d priorities recomputed)"), IndexTime * 1e6 / NumPops, NumRecomputed);
+}
+
+static FAutoConsoleCommand BenchmarkVoxelTasksPrioritiesCmd(
+	TEXT("voxel.threadpool.BenchmarkPriorities"),
+	TEXT("Measure the dequeue latency of the voxel thread pool with dynamic priorities. Args: [NumTasks=100000] [NumDequeues=1000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkVoxelTasksPriorities));
@@ -20,6 +20,7 @@
 #include "VoxelAssets/VoxelHeightmapAssetData.h"
 #include "IVoxelPool.h"
 #include "VoxelDefaultPool.h"
+#include "VoxelWorkStealingPool.h"
 #include "VoxelMessages.h"
 #include "VoxelUtilities/VoxelGeneratorUtilities.h"
 
@@ -96,6 +97,8 @@ float UVoxelBlueprintLibrary::GetMemoryUsageInMB(EVoxelMemoryUsageType Type)
 		CASE(STAT_VoxelUncompressedSavesMemory_MemoryUsage);
 	case EVoxelMemoryUsageType::CompressedSaves:
 		CASE(STAT_VoxelCompressedSavesMemory_MemoryUsage);
+	case EVoxelMemoryUsageType::DataSlabsOverhead:
+		CASE(STAT_VoxelDataSlabsOverheadMemory_MemoryUsage);
 	default:
 		ensure(false);
 		return 0.f;
@@ -147,6 +150,8 @@ float UVoxelBlueprintLibrary::GetPeakMemoryUsageInMB(EVoxelMemoryUsageType Type)
 		CASE(STAT_VoxelUncompressedSavesMemory_MemoryPeak);
 	case EVoxelMemoryUsageType::CompressedSaves:
 		CASE(STAT_VoxelCompressedSavesMemory_MemoryPeak);
+	case EVoxelMemoryUsageType::DataSlabsOverhead:
+		CASE(STAT_VoxelDataSlabsOverheadMemory_MemoryPeak);
 	default:
 		ensure(false);
 		return 0.f;
@@ -998,7 +1003,9 @@ void UVoxelBlueprintLibrary::CreateGlobalVoxelThreadPool(
 	const TMap<EVoxelTaskType, int32>& PriorityCategoriesOverrides,
 	const TMap<EVoxelTaskType, int32>& PriorityOffsetsOverrides,
 	int32 NumberOfThreads,
-	bool bConstantPriorities)
+	bool bConstantPriorities,
+	bool bWorkStealing,
+	int32 NumberOfEditThreads)
 {
 	VOXEL_FUNCTION_COUNTER();
 	
@@ -1008,11 +1015,19 @@ void UVoxelBlueprintLibrary::CreateGlobalVoxelThreadPool(
 		return;
 	}
 	
-	const auto Pool = FVoxelDefaultPool::Create(
-		FMath::Max(1, NumberOfThreads),
-		bConstantPriorities,
-		PriorityCategoriesOverrides,
-		PriorityOffsetsOverrides);
+	const TVoxelSharedRef<IVoxelPool> Pool = bWorkStealing
+		? StaticCastVoxelSharedRef<IVoxelPool>(FVoxelWorkStealingPool::Create(
+			FMath::Max(1, NumberOfThreads),
+			bConstantPriorities,
+			PriorityCategoriesOverrides,
+			PriorityOffsetsOverrides,
+			FMath::Max(0, NumberOfEditThreads)))
+		: StaticCastVoxelSharedRef<IVoxelPool>(FVoxelDefaultPool::Create(
+			FMath::Max(1, NumberOfThreads),
+			bConstantPriorities,
+			PriorityCategoriesOverrides,
+			PriorityOffsetsOverrides,
+			FMath::Max(0, NumberOfEditThreads)));
 	IVoxelPool::SetGlobalPool(Pool, __FUNCTION__);
 }
 
@@ -1038,7 +1053,9 @@ void UVoxelBlueprintLibrary::CreateWorldVoxelThreadPool(
 	const TMap<EVoxelTaskType, int32>& PriorityCategoriesOverrides,
 	const TMap<EVoxelTaskType, int32>& PriorityOffsetsOverrides, 
 	int32 NumberOfThreads, 
-	bool bConstantPriorities)
+	bool bConstantPriorities,
+	bool bWorkStealing,
+	int32 NumberOfEditThreads)
 {
 	VOXEL_FUNCTION_COUNTER();
 	
@@ -1054,11 +1071,19 @@ void UVoxelBlueprintLibrary::CreateWorldVoxelThreadPool(
 		return;
 	}
 	
-	const auto Pool = FVoxelDefaultPool::Create(
-		FMath::Max(1, NumberOfThreads),
-		bConstantPriorities,
-		PriorityCategoriesOverrides,
-		PriorityOffsetsOverrides);
+	const TVoxelSharedRef<IVoxelPool> Pool = bWorkStealing
+		? StaticCastVoxelSharedRef<IVoxelPool>(FVoxelWorkStealingPool::Create(
+			FMath::Max(1, NumberOfThreads),
+			bConstantPriorities,
+			PriorityCategoriesOverrides,
+			PriorityOffsetsOverrides,
+			FMath::Max(0, NumberOfEditThreads)))
+		: StaticCastVoxelSharedRef<IVoxelPool>(FVoxelDefaultPool::Create(
+			FMath::Max(1, NumberOfThreads),
+			bConstantPriorities,
+			PriorityCategoriesOverrides,
+			PriorityOffsetsOverrides,
+			FMath::Max(0, NumberOfEditThreads)));
 	IVoxelPool::SetWorldPool(World, Pool, __FUNCTION__);
 }
 
@@ -3,7 +3,8 @@
 #include "VoxelTools/VoxelPhysics.h"
 #include "VoxelTools/VoxelPhysicsPartSpawner.h"
 #include "VoxelTools/VoxelToolHelpers.h"
-#include "VoxelData/VoxelData.h"
+#include "VoxelData/VoxelDataIncludes.h"
+#include "VoxelData/VoxelDataConnectedComponents.h"
 #include "VoxelData/VoxelDataAccelerator.h"
 #include "VoxelRender/IVoxelLODManager.h"
 #include "VoxelGenerators/VoxelEmptyGenerator.h"
@@ -16,6 +17,89 @@
 #include "DrawDebugHelpers.h"
 
 
+// Removes the components that are not connected to the sides of the bounds from Data, and returns them as parts
+static void RemoveFloatingParts(
+	FVoxelData& Data,
+	const FVoxelIntBox& Bounds,
+	int32 MinParts,
+	const FVoxelGeneratorInit& GeneratorInit,
+	TArray<FVoxelPhysicsPart>& OutParts)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	FVoxelWriteScopeLock Lock(Data, Bounds, FUNCTION_FNAME);
+
+	const FVoxelDataConnectedComponents ConnectedComponents(Data, Bounds);
+	const TArray<FVoxelDataConnectedComponent>& Components = ConnectedComponents.GetComponents();
+	if (Components.Num() < MinParts)
+	{
+		return;
+	}
+
+	for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+	{
+		const FVoxelDataConnectedComponent& Component = Components[ComponentIndex];
+		if (Component.bTouchesBorder)
+		{
+			continue;
+		}
+
+		FVoxelPhysicsPart& Part = OutParts.Emplace_GetRef();
+		Part.Bounds = Component.Bounds;
+		Part.Voxels.Reserve(Component.NumVoxels);
+
+		const auto EmptyGenerator = MakeVoxelShared<FVoxelEmptyGeneratorInstance>();
+		EmptyGenerator->Init(GeneratorInit);
+		Part.Data = FVoxelData::Create(FVoxelDataSettings(Component.Bounds.Extend(2), EmptyGenerator, false, false));
+
+		// Also copy the empty values around the part, so that its surface is the same as in the world
+		const FVoxelIntBox CopyBounds = Component.Bounds.Extend(1).Overlap(Bounds);
+		const FIntVector Size = CopyBounds.Size();
+		const TArray<FVoxelValue> Values = Data.GetValues(CopyBounds);
+		const TArray<FVoxelMaterial> Materials = Data.GetMaterials(CopyBounds);
+
+		{
+			FVoxelWriteScopeLock PartLock(*Part.Data, CopyBounds, FUNCTION_FNAME);
+			Part.Data->Set<FVoxelValue, FVoxelMaterial>(CopyBounds, [&](int32 X, int32 Y, int32 Z, FVoxelValue& Value, FVoxelMaterial& Material)
+			{
+				const FIntVector Position(X, Y, Z);
+				const FIntVector Local = Position - CopyBounds.Min;
+				const int32 Index = Local.X + Size.X * Local.Y + Size.X * Size.Y * Local.Z;
+
+				const int32 VoxelComponent = ConnectedComponents.GetComponent(Position);
+				if (VoxelComponent == ComponentIndex)
+				{
+					Value = Values[Index];
+					Material = Materials[Index];
+
+					FVoxelPositionValueMaterial& Voxel = Part.Voxels.Emplace_GetRef();
+					Voxel.Position = Position;
+					Voxel.Value = Value.ToFloat();
+					Voxel.Material = Material;
+				}
+				else if (VoxelComponent == -1)
+				{
+					Value = Values[Index];
+					Material = Materials[Index];
+				}
+				else
+				{
+					// Another part
+					Value = FVoxelValue::Empty();
+				}
+			});
+		}
+
+		Data.Set<FVoxelValue>(Component.Bounds, [&](int32 X, int32 Y, int32 Z, FVoxelValue& Value)
+		{
+			if (ConnectedComponents.GetComponent(FIntVector(X, Y, Z)) == ComponentIndex)
+			{
+				Value = FVoxelValue::Empty();
+			}
+		});
+	}
+}
+
 void UVoxelPhysicsTools::ApplyVoxelPhysics(
 	UObject* WorldContextObject,
 	FLatentActionInfo LatentInfo,
@@ -27,5 +111,74 @@ void UVoxelPhysicsTools::ApplyVoxelPhysics(
 	bool bDebug,
 	bool bHideLatentWarnings)
 {
-	FVoxelMessages::Info(FUNCTION_ERROR("Voxel Physics require Voxel Plugin Pro"));
-}
\ No newline at end of file
+	VOXEL_FUNCTION_COUNTER();
+	CHECK_VOXELWORLD_IS_CREATED_VOID();
+	CHECK_BOUNDS_ARE_VALID_VOID();
+
+	Bounds = Bounds.Overlap(World->GetWorldBounds());
+	if (!Bounds.IsValid())
+	{
+		return;
+	}
+
+	const FVoxelGeneratorInit GeneratorInit = World->GetGeneratorInit();
+	const TWeakObjectPtr<UObject> WeakPartSpawner = PartSpawner.GetObject();
+
+	using FWork = TVoxelLatentActionAsyncWork_WithWorld_WithValue<TArray<FVoxelPhysicsPart>>;
+	FVoxelToolHelpers::StartAsyncLatentActionImpl<FWork>(
+		WorldContextObject,
+		LatentInfo,
+		World,
+		FUNCTION_FNAME,
+		bHideLatentWarnings,
+		[&]()
+		{
+			return new FWork(FUNCTION_FNAME, World, [=](FVoxelData& Data, TArray<FVoxelPhysicsPart>& Parts)
+			{
+				RemoveFloatingParts(Data, Bounds, MinParts, GeneratorInit, Parts);
+			});
+		},
+		[=, WeakWorldContextObject = MakeWeakObjectPtr(WorldContextObject), &OutResults](FWork& Work)
+		{
+			AVoxelWorld* const VoxelWorld = Work.World.Get();
+			if (!VoxelWorld)
+			{
+				return;
+			}
+
+			const TVoxelSharedRef<FSimpleMulticastDelegate> OnWorldUpdated = MakeVoxelShared<FSimpleMulticastDelegate>();
+
+			TArray<TScriptInterface<IVoxelPhysicsPartSpawnerResult>> Results;
+			IVoxelPhysicsPartSpawner* const Spawner = Cast<IVoxelPhysicsPartSpawner>(WeakPartSpawner.Get());
+			for (FVoxelPhysicsPart& Part : Work.Value)
+			{
+				if (bDebug)
+				{
+					UVoxelDebugUtilities::DrawDebugIntBox(VoxelWorld, Part.Bounds, 5.f, 0.f, FLinearColor::Red);
+				}
+				if (Spawner)
+				{
+					Part.OnWorldUpdated = OnWorldUpdated;
+					const TScriptInterface<IVoxelPhysicsPartSpawnerResult> Result = Spawner->SpawnPart(VoxelWorld, MoveTemp(Part));
+					if (Result)
+					{
+						Results.Add(Result);
+					}
+				}
+			}
+
+			if (Work.Value.Num() > 0)
+			{
+				// Only wait for the chunks the parts were removed from, not for the rest of the world
+				VoxelWorld->GetLODManager().UpdateBounds_OnAllFinished(Bounds, FSimpleDelegate::CreateLambda([OnWorldUpdated]()
+				{
+					OnWorldUpdated->Broadcast();
+				}));
+			}
+
+			if (WeakWorldContextObject.IsValid())
+			{
+				OutResults = MoveTemp(Results);
+			}
+		});
+}
@@ -1,8 +1,10 @@
 // Copyright Voxel Plugin SAS. All Rights Reserved.
 
 #include "VoxelTools/VoxelPhysicsPartSpawner.h"
+#include "VoxelData/VoxelData.h"
 #include "VoxelData/VoxelDataUtilities.h"
 #include "VoxelWorld.h"
+#include "VoxelWorldCreateInfo.h"
 #include "VoxelWorldRootComponent.h"
 #include "VoxelUtilities/VoxelExampleUtilities.h"
 
@@ -16,6 +18,67 @@
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// The floating parts are removed from the data before being spawned, but the voxel world collisions are updated asynchronously
+// Wait for them to be updated before simulating the parts physics, else the parts would be spawned inside the world collisions
+static void CallOnceWorldIsUpdated(const FVoxelPhysicsPart& Part, TFunction<void()> Callback)
+{
+	if (!Part.OnWorldUpdated)
+	{
+		// Not spawned by ApplyVoxelPhysics: nothing to wait for
+		Callback();
+		return;
+	}
+	Part.OnWorldUpdated->AddLambda(MoveTemp(Callback));
+}
+
+TScriptInterface<IVoxelPhysicsPartSpawnerResult> UVoxelPhysicsPartSpawner_VoxelWorlds::SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part)
+{
+	VOXEL_FUNCTION_COUNTER();
+	check(World);
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AVoxelWorld* PartWorld = World->GetWorld()->SpawnActor<AVoxelWorld>(
+		VoxelWorldClass ? VoxelWorldClass.Get() : AVoxelWorld::StaticClass(),
+		World->GetActorTransform(),
+		SpawnParameters);
+	if (!ensure(PartWorld))
+	{
+		return nullptr;
+	}
+
+	// The part data is in the voxel world coordinates
+	PartWorld->VoxelSize = World->VoxelSize;
+	PartWorld->bUseCustomWorldBounds = true;
+	PartWorld->CustomWorldBounds = Part.Data->WorldBounds;
+	PartWorld->RenderType = World->RenderType;
+	PartWorld->MaterialConfig = World->MaterialConfig;
+	PartWorld->VoxelMaterial = World->VoxelMaterial;
+	PartWorld->MaterialCollection = World->MaterialCollection;
+	PartWorld->bEnableCollisions = true;
+	PartWorld->CollisionPresets = World->CollisionPresets;
+	PartWorld->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAndComplex;
+	PartWorld->GetWorldRoot().BodyInstance.bSimulatePhysics = true;
+
+	ConfigureVoxelWorld.ExecuteIfBound(PartWorld);
+
+	auto* Result = NewObject<UVoxelPhysicsPartSpawnerResult_VoxelWorlds>();
+	Result->VoxelWorld = PartWorld;
+
+	CallOnceWorldIsUpdated(Part, [WeakPartWorld = MakeWeakObjectPtr(PartWorld), Data = Part.Data]()
+	{
+		if (WeakPartWorld.IsValid() && !WeakPartWorld->IsCreated())
+		{
+			FVoxelWorldCreateInfo Info;
+			Info.bOverrideData = true;
+			Info.DataOverride_Raw = Data;
+			WeakPartWorld->CreateWorld(Info);
+		}
+	});
+
+	return Result;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
@@ -29,8 +92,71 @@ UVoxelPhysicsPartSpawner_Cubes::UVoxelPhysicsPartSpawner_Cubes()
 	Material = FVoxelExampleUtilities::LoadExampleObject<UMaterialInterface>(TEXT("Material'/Voxel/Examples/Materials/RGB/M_VoxelMaterial_Colors_Parameter.M_VoxelMaterial_Colors_Parameter'"));
 }
 
+TScriptInterface<IVoxelPhysicsPartSpawnerResult> UVoxelPhysicsPartSpawner_Cubes::SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part)
+{
+	VOXEL_FUNCTION_COUNTER();
+	check(World);
+
+	auto* Result = NewObject<UVoxelPhysicsPartSpawnerResult_Cubes>();
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (const FVoxelPositionValueMaterial& Voxel : Part.Voxels)
+	{
+		if (FMath::FRand() >= SpawnProbability)
+		{
+			continue;
+		}
+
+		AStaticMeshActor* Cube = World->GetWorld()->SpawnActor<AStaticMeshActor>(
+			World->LocalToGlobal(Voxel.Position),
+			World->GetActorRotation(),
+			SpawnParameters);
+		if (!ensure(Cube))
+		{
+			continue;
+		}
+
+		UStaticMeshComponent* MeshComponent = Cube->GetStaticMeshComponent();
+		MeshComponent->SetMobility(EComponentMobility::Movable);
+		MeshComponent->SetStaticMesh(CubeMesh);
+		MeshComponent->SetWorldScale3D(FVector(World->VoxelSize / 100));
+
+		UMaterialInstanceDynamic* MaterialInstance = UMaterialInstanceDynamic::Create(Material, Cube);
+		MaterialInstance->SetVectorParameterValue(STATIC_FNAME("VertexColor"), Voxel.Material.GetLinearColor());
+		MeshComponent->SetMaterial(0, MaterialInstance);
+
+		Result->Cubes.Add(Cube);
+	}
+
+	TArray<TWeakObjectPtr<AStaticMeshActor>> Cubes;
+	for (AStaticMeshActor* Cube : Result->Cubes)
+	{
+		Cubes.Add(Cube);
+	}
+
+	CallOnceWorldIsUpdated(Part, [Cubes]()
+	{
+		for (const TWeakObjectPtr<AStaticMeshActor>& Cube : Cubes)
+		{
+			if (Cube.IsValid())
+			{
+				Cube->GetStaticMeshComponent()->SetSimulatePhysics(true);
+			}
+		}
+	});
+
+	return Result;
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+TScriptInterface<IVoxelPhysicsPartSpawnerResult> UVoxelPhysicsPartSpawner_GetVoxels::SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part)
+{
+	auto* Result = NewObject<UVoxelPhysicsPartSpawnerResult_GetVoxels>();
+	Result->Voxels = MoveTemp(Part.Voxels);
+	return Result;
+}
@@ -3,6 +3,7 @@
 #include "VoxelTools/VoxelProjectionTools.h"
 #include "VoxelTools/VoxelToolHelpers.h"
 #include "VoxelData/VoxelDataAccelerator.h"
+#include "VoxelData/VoxelDataRaycast.h"
 
 #include "DrawDebugHelpers.h"
 #include "Engine/Engine.h"
@@ -307,6 +308,83 @@ int32 UVoxelProjectionTools::FindProjectionVoxels(
 	return NumTraced;
 }
 
+int32 UVoxelProjectionTools::FindProjectionVoxelsFromData(
+	TArray<FVoxelProjectionHit>& Hits, 
+	AVoxelWorld* World, 
+	FVector Position, 
+	FVector Direction, 
+	float Radius,
+	EVoxelProjectionShape Shape,
+	float NumRays, 
+	float MaxDistance)
+{
+	VOXEL_FUNCTION_COUNTER();
+	
+	Hits.Reset();
+	
+	CHECK_VOXELWORLD_IS_CREATED();
+
+	if (!Direction.Normalize())
+	{
+		FVoxelMessages::Error(FUNCTION_ERROR("Invalid Direction!"));
+		return 0;
+	}
+
+	struct FRayInfo
+	{
+		FVector Start;
+		FVector End;
+		FVector2D PlanePosition;
+	};
+	TArray<FRayInfo> RayInfos;
+	TArray<FVoxelDataRay> Rays;
+
+	const int32 NumTraced = GenerateRays(Position, Direction, Radius, Shape, NumRays, MaxDistance, [&](const FVector& Start, const FVector& End, const FVector2D& PlanePosition)
+	{
+		const FVoxelVector LocalStart = World->GlobalToLocalFloat(Start);
+		const FVoxelVector LocalEnd = World->GlobalToLocalFloat(End);
+
+		FVoxelDataRay& Ray = Rays.Emplace_GetRef();
+		Ray.Start = LocalStart;
+		Ray.Direction = (LocalEnd - LocalStart).GetSafeNormal();
+		Ray.MaxDistance = (LocalEnd - LocalStart).Size();
+
+		RayInfos.Add({ Start, End, PlanePosition });
+	});
+
+	TArray<FVoxelDataRayHit> RayHits;
+	FVoxelDataRaycast::RaycastBatch(World->GetData(), Rays, RayHits);
+
+	FHitsBuilder Builder;
+	for (int32 Index = 0; Index < RayHits.Num(); Index++)
+	{
+		const FVoxelDataRayHit& RayHit = RayHits[Index];
+		if (!RayHit.bHit)
+		{
+			continue;
+		}
+
+		const FRayInfo& RayInfo = RayInfos[Index];
+
+		FHitResult Hit(ForceInit);
+		Hit.bBlockingHit = true;
+		Hit.TraceStart = RayInfo.Start;
+		Hit.TraceEnd = RayInfo.End;
+		Hit.Location = World->LocalToGlobalFloat(RayHit.Position);
+		Hit.ImpactPoint = Hit.Location;
+		Hit.Normal = World->GetActorTransform().TransformVectorNoScale(RayHit.Normal);
+		Hit.ImpactNormal = Hit.Normal;
+		Hit.Distance = FVector::Distance(RayInfo.Start, Hit.Location);
+		Hit.Time = Hit.Distance / FMath::Max(FVector::Distance(RayInfo.Start, RayInfo.End), SMALL_NUMBER);
+
+		Builder.Add(World, Hit, RayInfo.PlanePosition);
+	}
+	
+	Hits = Builder.GetHits();
+
+	return NumTraced;
+}
+
 int32 UVoxelProjectionTools::FindProjectionVoxelsAsync(
 	UObject* WorldContextObject,
 	FLatentActionInfo LatentInfo,
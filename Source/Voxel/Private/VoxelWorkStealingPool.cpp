@@ -0,0 +1,674 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#include "VoxelWorkStealingPool.h"
+#include "VoxelDefaultPool.h"
+#include "VoxelThreadPool.h"
+#include "VoxelQueuedWork.h"
+#include "VoxelMinimal.h"
+
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformAffinity.h"
+#include "Misc/ScopeExit.h"
+#include "Async/TaskGraphInterfaces.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voxel Work Stealing Pool Steals"), STAT_VoxelWorkStealingPoolSteals, STATGROUP_VoxelCounters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voxel Work Stealing Pool Failed Steals"), STAT_VoxelWorkStealingPoolFailedSteals, STATGROUP_VoxelCounters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voxel Work Stealing Pool Contended Locks"), STAT_VoxelWorkStealingPoolContendedLocks, STATGROUP_VoxelCounters);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Voxel Work Stealing Pool Recomputed Priorities"), STAT_VoxelWorkStealingPoolRecomputedPriorities, STATGROUP_VoxelCounters);
+
+// Max number of works a thread takes from the injector at once
+static constexpr int32 MaxWorkStealingBatchSize = 32;
+
+struct FVoxelWorkStealingPoolStats
+{
+	FThreadSafeCounter64 NumLocalPops;
+	FThreadSafeCounter64 NumInjectorPops;
+	FThreadSafeCounter64 NumSteals;
+	FThreadSafeCounter64 NumFailedSteals;
+	FThreadSafeCounter64 NumContendedLocks;
+	FThreadSafeCounter64 LockWaitCycles;
+
+	static FVoxelWorkStealingPoolStats Singleton;
+
+	static void Clear()
+	{
+		Singleton.NumLocalPops.Reset();
+		Singleton.NumInjectorPops.Reset();
+		Singleton.NumSteals.Reset();
+		Singleton.NumFailedSteals.Reset();
+		Singleton.NumContendedLocks.Reset();
+		Singleton.LockWaitCycles.Reset();
+	}
+	static void PrintStats()
+	{
+		LOG_VOXEL(Log, TEXT("Work stealing pool: %lld works from own queue, %lld works from injector"), Singleton.NumLocalPops.GetValue(), Singleton.NumInjectorPops.GetValue());
+		LOG_VOXEL(Log, TEXT("Work stealing pool: %lld steals, %lld failed steals"), Singleton.NumSteals.GetValue(), Singleton.NumFailedSteals.GetValue());
+		LOG_VOXEL(Log, TEXT("Work stealing pool: %lld contended locks, %fs waiting for locks"), Singleton.NumContendedLocks.GetValue(), FPlatformTime::ToSeconds64(Singleton.LockWaitCycles.GetValue()));
+	}
+};
+
+FVoxelWorkStealingPoolStats FVoxelWorkStealingPoolStats::Singleton;
+
+static FAutoConsoleCommand ClearWorkStealingPoolStatsCmd(
+	TEXT("voxel.threadpool.ClearWorkStealingStats"),
+	TEXT("Clear the work stealing pool stats"),
+	FConsoleCommandDelegate::CreateStatic(&FVoxelWorkStealingPoolStats::Clear));
+
+static FAutoConsoleCommand PrintWorkStealingPoolStatsCmd(
+	TEXT("voxel.threadpool.PrintWorkStealingStats"),
+	TEXT("Print the work stealing pool stats: steal counts and lock contention"),
+	FConsoleCommandDelegate::CreateStatic(&FVoxelWorkStealingPoolStats::PrintStats));
+
+// Locks are short lived and per bucket/thread: only record the time when someone else has it
+class FScopeLockWithContentionStats
+{
+public:
+	explicit FScopeLockWithContentionStats(FCriticalSection& InSynchObject)
+		: SynchObject(InSynchObject)
+	{
+		if (!SynchObject.TryLock())
+		{
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			SynchObject.Lock();
+
+			FVoxelWorkStealingPoolStats::Singleton.NumContendedLocks.Increment();
+			FVoxelWorkStealingPoolStats::Singleton.LockWaitCycles.Add(FPlatformTime::Cycles64() - StartCycles);
+			INC_DWORD_STAT(STAT_VoxelWorkStealingPoolContendedLocks);
+		}
+	}
+	~FScopeLockWithContentionStats()
+	{
+		SynchObject.Unlock();
+	}
+
+private:
+	FCriticalSection& SynchObject;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+class FVoxelWorkStealingThread : public FRunnable
+{
+public:
+	FVoxelWorkStealingPool* const Pool;
+	const int32 ThreadIndex;
+	// Owned by the pool thread queue
+	FEvent* const DoWorkEvent;
+
+	FVoxelWorkStealingThread(FVoxelWorkStealingPool* Pool, int32 ThreadIndex, FEvent* DoWorkEvent, const FString& ThreadName, uint32 StackSize, EThreadPriority ThreadPriority)
+		: Pool(Pool)
+		, ThreadIndex(ThreadIndex)
+		, DoWorkEvent(DoWorkEvent)
+		, TimeToDie(false) // BEFORE creating thread
+		, Thread(FRunnableThread::Create(this, *ThreadName, StackSize, ThreadPriority, FPlatformAffinity::GetPoolThreadMask()))
+	{
+		check(Thread.IsValid());
+	}
+	~FVoxelWorkStealingThread()
+	{
+		TimeToDie = true;
+		DoWorkEvent->Trigger();
+		Thread->WaitForCompletion();
+	}
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override
+	{
+		while (!TimeToDie)
+		{
+			IVoxelQueuedWork* Work = Pool->GetNextWork(ThreadIndex);
+			if (!Work)
+			{
+				VOXEL_ASYNC_VERBOSE_SCOPE_COUNTER("FVoxelWorkStealingThread::Run.WaitForWork");
+				Pool->WaitForWork(ThreadIndex);
+				continue;
+			}
+
+			const FName Name = Work->Name;
+			const double StartTime = FPlatformTime::Seconds();
+
+			Work->DoThreadedWork();
+			// IMPORTANT: Work should be considered as deleted after this line
+
+			const double EndTime = FPlatformTime::Seconds();
+			FVoxelQueuedThreadPoolStats::Get().Report(Name, EndTime - StartTime);
+
+			Pool->OnWorkDone();
+		}
+		return 0;
+	}
+	//~ End FRunnable Interface
+
+private:
+	FThreadSafeBool TimeToDie;
+	const TUniquePtr<FRunnableThread> Thread;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+FVoxelWorkStealingPool::FVoxelWorkStealingPool(
+	int32 ThreadCount,
+	bool bConstantPriorities,
+	const TMap<EVoxelTaskType, int32>& InPriorityCategories,
+	const TMap<EVoxelTaskType, int32>& InPriorityOffsets,
+	int32 InNumEditThreads)
+	: NumThreads(ThreadCount)
+	, NumEditThreads(InNumEditThreads)
+	, bConstantPriorities(bConstantPriorities)
+{
+	TArray<int32> Categories;
+	for (auto& It : InPriorityCategories)
+	{
+		Categories.AddUnique(It.Value);
+	}
+	Categories.Sort([](int32 A, int32 B) { return A > B; });
+	if (Categories.Num() == 0)
+	{
+		Categories.Add(0);
+	}
+	check(Categories.Num() <= 256);
+
+	for (int32 Index = 0; Index < Categories.Num(); Index++)
+	{
+		Buckets.Add(MakeUnique<FBucket>());
+	}
+
+	if (const int32* EditCategory = InPriorityCategories.Find(EVoxelTaskType::EditChunksMeshing))
+	{
+		EditBucketIndex = Categories.IndexOfByKey(*EditCategory);
+	}
+	for (int32 Index = 0; Index < 256; Index++)
+	{
+		const int32* Category = InPriorityCategories.Find(EVoxelTaskType(Index));
+		const int32 BucketIndex = Category ? Categories.IndexOfByKey(*Category) : Categories.Num() - 1;
+
+		const_cast<TStaticArray<uint8, 256>&>(TaskTypeToBucket)[Index] = BucketIndex;
+		const_cast<TStaticArray<int32, 256>&>(PriorityOffsets)[Index] = InPriorityOffsets.FindRef(EVoxelTaskType(Index));
+	}
+
+	for (int32 Index = 0; Index < NumThreads + NumEditThreads; Index++)
+	{
+		ThreadQueues.Add(MakeUnique<FThreadQueue>());
+	}
+
+	UE::Trace::ThreadGroupBegin(TEXT("VoxelWorkStealingPool"));
+	ON_SCOPE_EXIT
+	{
+		UE::Trace::ThreadGroupEnd();
+	};
+
+	const uint64 PoolId = UNIQUE_ID();
+	for (int32 Index = 0; Index < NumThreads + NumEditThreads; Index++)
+	{
+		const FString Name = IsEditThread(Index)
+			? FString::Printf(TEXT("Voxel Work Stealing Pool %llu Edit Thread %d"), PoolId, Index - NumThreads)
+			: FString::Printf(TEXT("Voxel Work Stealing Pool %llu Thread %d"), PoolId, Index);
+		Threads.Add(MakeUnique<FVoxelWorkStealingThread>(this, Index, ThreadQueues[Index]->DoWorkEvent, Name, 1024 * 1024, EThreadPriority::TPri_Normal));
+	}
+}
+
+FVoxelWorkStealingPool::~FVoxelWorkStealingPool()
+{
+	if (!TimeToDie)
+	{
+		AbandonAllTasks();
+	}
+	Threads.Empty();
+	FPlatformProcess::ReturnSynchEventToPool(NoActiveThreadsEvent);
+}
+
+TVoxelSharedRef<FVoxelWorkStealingPool> FVoxelWorkStealingPool::Create(
+	int32 ThreadCount,
+	bool bConstantPriorities,
+	const TMap<EVoxelTaskType, int32>& PriorityCategories,
+	const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+	int32 NumEditThreads)
+{
+	LOG_VOXEL(Log, TEXT("Creating work stealing pool with %d threads and %d edit threads"), ThreadCount, NumEditThreads);
+	if (!ensureMsgf(ThreadCount >= 1, TEXT("Invalid MeshThreadCount: %d"), ThreadCount))
+	{
+		ThreadCount = 1;
+	}
+	NumEditThreads = FMath::Max(0, NumEditThreads);
+
+	auto FixedPriorityCategories = PriorityCategories;
+	auto FixedPriorityOffsets = PriorityOffsets;
+	FVoxelDefaultPool::FixPriorityCategories(FixedPriorityCategories);
+	FVoxelDefaultPool::FixPriorityOffsets(FixedPriorityOffsets);
+
+	const TVoxelSharedRef<FVoxelWorkStealingPool> Pool = MakeShareable(new FVoxelWorkStealingPool(
+		ThreadCount,
+		bConstantPriorities,
+		FixedPriorityCategories,
+		FixedPriorityOffsets,
+		NumEditThreads));
+
+	TFunction<void()> ShutdownCallback = [WeakPool = MakeVoxelWeakPtr(Pool)]()
+	{
+		auto PoolPtr = WeakPool.Pin();
+		if (PoolPtr.IsValid() && !PoolPtr->TimeToDie)
+		{
+			PoolPtr->AbandonAllTasks();
+		}
+	};
+	FTaskGraphInterface::Get().AddShutdownCallback(ShutdownCallback);
+
+	return Pool;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelWorkStealingPool::QueueTask(EVoxelTaskType Type, IVoxelQueuedWork* Task)
+{
+	QueueTasks(Type, { Task });
+}
+
+void FVoxelWorkStealingPool::QueueTasks(EVoxelTaskType Type, const TArray<IVoxelQueuedWork*>& Tasks)
+{
+	VOXEL_FUNCTION_COUNTER();
+
+	if (TimeToDie)
+	{
+		for (auto* Task : Tasks)
+		{
+			Task->Abandon();
+		}
+		return;
+	}
+
+	const int32 PriorityOffset = PriorityOffsets[uint8(Type)];
+	const auto Predicate = [](const FWorkInfo& A, const FWorkInfo& B) { return A.Priority > B.Priority; };
+
+	FBucket& Bucket = *Buckets[TaskTypeToBucket[uint8(Type)]];
+	// Before computing the priorities: if they change in the meantime, they will be recomputed
+	// A new bucket has no priorities to recompute yet
+	const int32 Version = PrioritiesVersion.GetValue();
+	if (Bucket.Num.GetValue() == 0)
+	{
+		Bucket.PrioritiesVersion.Set(Version);
+	}
+
+	TArray<FWorkInfo> WorkInfos;
+	{
+		VOXEL_SCOPE_COUNTER("Compute Priorities");
+		WorkInfos.Reserve(Tasks.Num());
+		for (auto* Task : Tasks)
+		{
+			check(Task);
+			WorkInfos.Add({ Task, FVoxelQueuedWorkPriorityIndex::ComputePriority(*Task, PriorityOffset), PriorityOffset });
+		}
+	}
+
+	{
+		VOXEL_SCOPE_COUNTER("Add Works");
+		FScopeLockWithContentionStats Lock(Bucket.Section);
+		for (const FWorkInfo& WorkInfo : WorkInfos)
+		{
+			Bucket.Works.HeapPush(WorkInfo, Predicate);
+		}
+		Bucket.Num.Add(WorkInfos.Num());
+	}
+	NumQueuedWorks.Add(WorkInfos.Num());
+
+	WakeUpThreads();
+}
+
+int32 FVoxelWorkStealingPool::GetNumTasks() const
+{
+	// Not exact: also counts the threads looking for a work
+	return NumQueuedWorks.GetValue() + NumActiveThreads.GetValue();
+}
+
+void FVoxelWorkStealingPool::InvalidatePriorities()
+{
+	if (!bConstantPriorities)
+	{
+		PrioritiesVersion.Increment();
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+IVoxelQueuedWork* FVoxelWorkStealingPool::GetNextWork(int32 ThreadIndex)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	// Count ourselves as active before popping, so that AbandonAllTasks never sees zero active threads while a work is in flight
+	NumActiveThreads.Increment();
+
+	IVoxelQueuedWork* Work = TimeToDie ? nullptr : FindWork(ThreadIndex);
+	if (!Work)
+	{
+		OnWorkDone();
+	}
+	return Work;
+}
+
+IVoxelQueuedWork* FVoxelWorkStealingPool::FindWork(int32 ThreadIndex)
+{
+	FThreadQueue& Queue = *ThreadQueues[ThreadIndex];
+	if (IsEditThread(ThreadIndex))
+	{
+		if (!HasEditWorks())
+		{
+			return nullptr;
+		}
+		return PopFromInjector(ThreadIndex, EditBucketIndex, EditBucketIndex + 1);
+	}
+
+	const int32 BestBucketIndex = GetBestBucketIndex();
+
+	// Only use our own queue if the injector doesn't have works with a higher category
+	if (Queue.Num.GetValue() > 0 && (BestBucketIndex == -1 || BestBucketIndex >= Queue.BucketIndex))
+	{
+		if (IVoxelQueuedWork* Work = PopFromThreadQueue(Queue))
+		{
+			return Work;
+		}
+	}
+
+	if (BestBucketIndex != -1)
+	{
+		if (IVoxelQueuedWork* Work = PopFromInjector(ThreadIndex, BestBucketIndex, Buckets.Num()))
+		{
+			return Work;
+		}
+	}
+
+	if (Queue.Num.GetValue() > 0)
+	{
+		if (IVoxelQueuedWork* Work = PopFromThreadQueue(Queue))
+		{
+			return Work;
+		}
+	}
+
+	return Steal(ThreadIndex);
+}
+
+void FVoxelWorkStealingPool::WaitForWork(int32 ThreadIndex)
+{
+	FThreadQueue& Queue = *ThreadQueues[ThreadIndex];
+
+	Queue.bIdle = true;
+	// Works might have been queued before we were marked as idle
+	// Edit threads can't run most works: only check the bucket they can take from
+	// Once TimeToDie is set, only the thread destruction wakes us up
+	const bool bHasWork = !TimeToDie && (IsEditThread(ThreadIndex)
+		? HasEditWorks()
+		: NumQueuedWorks.GetValue() > 0);
+	if (!bHasWork)
+	{
+		// No wake up can be missed: works are counted before WakeUpThreads checks bIdle, and we set bIdle before checking the counts
+		// If the event is triggered before we start waiting, Wait returns immediately
+		Queue.DoWorkEvent->Wait();
+	}
+	Queue.bIdle = false;
+}
+
+void FVoxelWorkStealingPool::OnWorkDone()
+{
+	if (NumActiveThreads.Decrement() == 0 && TimeToDie)
+	{
+		NoActiveThreadsEvent->Trigger();
+	}
+}
+
+void FVoxelWorkStealingPool::AbandonAllTasks()
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	ensure(!TimeToDie);
+	TimeToDie = true;
+
+	// Wait for the threads to finish their works. They stop looking for new ones once TimeToDie is set,
+	// so that no work can be moved between the buckets and the queues while we abandon them
+	while (NumActiveThreads.GetValue() > 0)
+	{
+		NoActiveThreadsEvent->Wait();
+	}
+
+	for (auto& Bucket : Buckets)
+	{
+		FScopeLockWithContentionStats Lock(Bucket->Section);
+		for (const FWorkInfo& WorkInfo : Bucket->Works)
+		{
+			WorkInfo.Work->Abandon();
+		}
+		Bucket->Works.Reset();
+		Bucket->Num.Reset();
+	}
+	for (auto& Queue : ThreadQueues)
+	{
+		FScopeLockWithContentionStats Lock(Queue->Section);
+		for (const FWorkInfo& WorkInfo : Queue->Works)
+		{
+			WorkInfo.Work->Abandon();
+		}
+		Queue->Works.Reset();
+		Queue->Num.Reset();
+	}
+	NumQueuedWorks.Reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+void FVoxelWorkStealingPool::WakeUpThreads()
+{
+	VOXEL_SCOPE_COUNTER("Wake up threads");
+	for (auto& Queue : ThreadQueues)
+	{
+		if (Queue->bIdle)
+		{
+			Queue->DoWorkEvent->Trigger();
+		}
+	}
+}
+
+int32 FVoxelWorkStealingPool::GetBestBucketIndex() const
+{
+	for (int32 Index = 0; Index < Buckets.Num(); Index++)
+	{
+		if (Buckets[Index]->Num.GetValue() > 0)
+		{
+			return Index;
+		}
+	}
+	return -1;
+}
+
+IVoxelQueuedWork* FVoxelWorkStealingPool::PopFromThreadQueue(FThreadQueue& Queue)
+{
+	FScopeLockWithContentionStats Lock(Queue.Section);
+	if (Queue.Works.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	IVoxelQueuedWork* Work = Queue.Works.Pop(UE_505_SWITCH(false, EAllowShrinking::No)).Work;
+	Queue.Num.Decrement();
+	NumQueuedWorks.Decrement();
+
+	FVoxelWorkStealingPoolStats::Singleton.NumLocalPops.Increment();
+	return Work;
+}
+
+IVoxelQueuedWork* FVoxelWorkStealingPool::PopFromInjector(int32 ThreadIndex, int32 FirstBucketIndex, int32 EndBucketIndex)
+{
+	const auto Predicate = [](const FWorkInfo& A, const FWorkInfo& B) { return A.Priority > B.Priority; };
+
+	FThreadQueue& Queue = *ThreadQueues[ThreadIndex];
+	// Don't mix categories in our queue
+	// Edit threads queues can't be stolen from: they never take batches
+	const bool bTakeBatch = Queue.Num.GetValue() == 0 && !IsEditThread(ThreadIndex);
+
+	for (int32 BucketIndex = FirstBucketIndex; BucketIndex < EndBucketIndex; BucketIndex++)
+	{
+		FBucket& Bucket = *Buckets[BucketIndex];
+		if (Bucket.Num.GetValue() == 0)
+		{
+			continue;
+		}
+		if (!bConstantPriorities)
+		{
+			UpdatePriorities(Bucket);
+		}
+
+		TArray<FWorkInfo, TInlineAllocator<MaxWorkStealingBatchSize>> Batch;
+		{
+			FScopeLockWithContentionStats Lock(Bucket.Section);
+			if (Bucket.Works.Num() == 0)
+			{
+				continue;
+			}
+
+			// Leave enough works for the other threads
+			const int32 BatchSize = bTakeBatch ? FMath::Clamp(Bucket.Works.Num() / (2 * NumThreads), 1, MaxWorkStealingBatchSize) : 1;
+			for (int32 Index = 0; Index < BatchSize; Index++)
+			{
+				FWorkInfo WorkInfo;
+				Bucket.Works.HeapPop(WorkInfo, Predicate, UE_505_SWITCH(false, EAllowShrinking::No));
+				Batch.Add(WorkInfo);
+			}
+			Bucket.Num.Subtract(BatchSize);
+		}
+		check(Batch.Num() > 0);
+
+		if (Batch.Num() > 1)
+		{
+			FScopeLockWithContentionStats Lock(Queue.Section);
+			check(Queue.Works.Num() == 0);
+			// Best work last
+			for (int32 Index = Batch.Num() - 1; Index >= 1; Index--)
+			{
+				Queue.Works.Add(Batch[Index]);
+			}
+			Queue.BucketIndex = BucketIndex;
+			Queue.Num.Add(Batch.Num() - 1);
+		}
+
+		NumQueuedWorks.Decrement();
+
+		FVoxelWorkStealingPoolStats::Singleton.NumInjectorPops.Increment();
+		return Batch[0].Work;
+	}
+
+	return nullptr;
+}
+
+void FVoxelWorkStealingPool::UpdatePriorities(FBucket& Bucket)
+{
+	const int32 Version = PrioritiesVersion.GetValue();
+	if (Bucket.PrioritiesVersion.GetValue() == Version)
+	{
+		return;
+	}
+
+	const double Time = FPlatformTime::Seconds();
+	TArray<FWorkInfo> Works;
+	{
+		FScopeLockWithContentionStats Lock(Bucket.Section);
+		if (Bucket.bUpdatingPriorities || Bucket.Works.Num() == 0 || Bucket.NextPrioritiesUpdateTime >= Time)
+		{
+			return;
+		}
+		Bucket.bUpdatingPriorities = true;
+		Works = MoveTemp(Bucket.Works);
+		// Edit threads will wait for WakeUpThreads below. Normal threads still see the works in NumQueuedWorks
+		Bucket.Num.Subtract(Works.Num());
+	}
+
+	VOXEL_ASYNC_SCOPE_COUNTER("Recompute Priorities");
+	INC_DWORD_STAT_BY(STAT_VoxelWorkStealingPoolRecomputedPriorities, Works.Num());
+
+	const auto Predicate = [](const FWorkInfo& A, const FWorkInfo& B) { return A.Priority > B.Priority; };
+
+	double MinPriorityDuration = MAX_dbl;
+	for (FWorkInfo& WorkInfo : Works)
+	{
+		WorkInfo.Priority = FVoxelQueuedWorkPriorityIndex::ComputePriority(*WorkInfo.Work, WorkInfo.PriorityOffset);
+		MinPriorityDuration = FMath::Min(MinPriorityDuration, WorkInfo.Work->PriorityDuration);
+	}
+	Works.Heapify(Predicate);
+
+	{
+		FScopeLockWithContentionStats Lock(Bucket.Section);
+		const int32 NumUpdated = Works.Num();
+		// The works queued during the update have up to date priorities
+		for (const FWorkInfo& WorkInfo : Bucket.Works)
+		{
+			Works.HeapPush(WorkInfo, Predicate);
+		}
+		Bucket.Works = MoveTemp(Works);
+		Bucket.Num.Add(NumUpdated);
+		Bucket.PrioritiesVersion.Set(Version);
+		Bucket.NextPrioritiesUpdateTime = Time + MinPriorityDuration;
+		Bucket.bUpdatingPriorities = false;
+	}
+
+	WakeUpThreads();
+}
+
+IVoxelQueuedWork* FVoxelWorkStealingPool::Steal(int32 ThreadIndex)
+{
+	FThreadQueue& Queue = *ThreadQueues[ThreadIndex];
+
+	for (int32 Offset = 1; Offset < NumThreads; Offset++)
+	{
+		FThreadQueue& Victim = *ThreadQueues[(ThreadIndex + Offset) % NumThreads];
+		if (Victim.Num.GetValue() == 0)
+		{
+			continue;
+		}
+
+		TArray<FWorkInfo, TInlineAllocator<MaxWorkStealingBatchSize>> Stolen;
+		int32 VictimBucketIndex;
+		{
+			FScopeLockWithContentionStats Lock(Victim.Section);
+			if (Victim.Works.Num() == 0)
+			{
+				FVoxelWorkStealingPoolStats::Singleton.NumFailedSteals.Increment();
+				INC_DWORD_STAT(STAT_VoxelWorkStealingPoolFailedSteals);
+				continue;
+			}
+
+			// Steal half of the victim works, starting with the lowest priorities
+			const int32 NumToSteal = FMath::Max(1, Victim.Works.Num() / 2);
+			Stolen.Append(Victim.Works.GetData(), NumToSteal);
+			Victim.Works.RemoveAt(0, NumToSteal, UE_505_SWITCH(false, EAllowShrinking::No));
+			Victim.Num.Subtract(NumToSteal);
+			VictimBucketIndex = Victim.BucketIndex;
+		}
+
+		FVoxelWorkStealingPoolStats::Singleton.NumSteals.Increment();
+		INC_DWORD_STAT(STAT_VoxelWorkStealingPoolSteals);
+
+		// Run the best one, queue the others
+		const FWorkInfo Best = Stolen.Pop(UE_505_SWITCH(false, EAllowShrinking::No));
+		if (Stolen.Num() > 0)
+		{
+			FScopeLockWithContentionStats Lock(Queue.Section);
+			// Our queue might have been refilled in the meantime: keep the lowest category
+			Queue.BucketIndex = Queue.Works.Num() == 0 ? VictimBucketIndex : FMath::Max(Queue.BucketIndex, VictimBucketIndex);
+			Queue.Works.Insert(Stolen.GetData(), Stolen.Num(), 0);
+			Queue.Num.Add(Stolen.Num());
+		}
+
+		NumQueuedWorks.Decrement();
+		return Best.Work;
+	}
+
+	return nullptr;
+}
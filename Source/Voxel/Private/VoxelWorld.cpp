@@ -6,6 +6,7 @@
 #include "IVoxelPool.h"
 #include "VoxelSettings.h"
 #include "VoxelDefaultPool.h"
+#include "VoxelWorkStealingPool.h"
 #include "VoxelWorldRootComponent.h"
 #include "VoxelRender/IVoxelRenderer.h"
 #include "VoxelRender/IVoxelLODManager.h"
@@ -30,6 +31,7 @@
 #include "VoxelDebug/VoxelLineBatchComponent.h"
 #include "VoxelEvents/VoxelEventManager.h"
 #include "VoxelMessages.h"
+#include "VoxelAsyncWork.h"
 #include "VoxelFeedbackContext.h"
 #include "VoxelUtilities/VoxelThreadingUtilities.h"
 
@@ -54,6 +56,14 @@
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Serialization/BufferArchive.h"
 #include "Serialization/MemoryReader.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarSaveRegionsLoadDistance(
+	TEXT("voxel.data.SaveRegionsLoadDistance"),
+	0,
+	TEXT("If not 0, only the regions of region indexed save objects closer than this distance (in voxels) to the invokers are loaded when creating the world. ")
+	TEXT("The other regions are loaded when invokers get close to them"),
+	ECVF_Default);
 
 void AVoxelWorld::FGameThreadTasks::Flush()
 {
@@ -502,6 +512,11 @@ void AVoxelWorld::Tick(float DeltaTime)
 	{
 		WorldRoot->TickWorldRoot();
 		GameThreadTasks->Flush();
+
+		if (Data->HasPendingSaveRegions() && !*IsLoadingPendingSaveRegions)
+		{
+			LoadPendingSaveRegions();
+		}
 #if WITH_EDITOR
 		if (PlayType == EVoxelPlayType::Preview && Data->IsDirty())
 		{
@@ -802,13 +817,23 @@ TVoxelSharedRef<IVoxelPool> AVoxelWorld::CreatePool() const
 {
 	VOXEL_FUNCTION_COUNTER();
 
-	const auto CreateOwnPool = [&](int32 InNumberOfThreads, bool bInConstantPriorities)
+	const auto CreateOwnPool = [&](int32 InNumberOfThreads, bool bInConstantPriorities) -> TVoxelSharedRef<IVoxelPool>
 	{
+		if (bUseWorkStealingPool && PlayType != EVoxelPlayType::Preview)
+		{
+			return FVoxelWorkStealingPool::Create(
+				FMath::Max(1, InNumberOfThreads),
+				bInConstantPriorities,
+				PriorityCategories,
+				PriorityOffsets,
+				FMath::Max(0, NumberOfEditThreads));
+		}
 		return FVoxelDefaultPool::Create(
 			FMath::Max(1, InNumberOfThreads),
 			bInConstantPriorities,
 			PriorityCategories,
-			PriorityOffsets);
+			PriorityOffsets,
+			PlayType == EVoxelPlayType::Preview ? 0 : FMath::Max(0, NumberOfEditThreads));
 	};
 	
 	if (PlayType == EVoxelPlayType::Preview)
@@ -880,7 +905,8 @@ TVoxelSharedRef<IVoxelLODManager> AVoxelWorld::CreateLODManager() const
 			Renderer.ToSharedRef(),
 			Pool.ToSharedRef()),
 		this,
-		LODDynamicSettings);
+		LODDynamicSettings,
+		Data);
 }
 
 TVoxelSharedPtr<FVoxelEventManager> AVoxelWorld::CreateEventManager() const
@@ -932,6 +958,7 @@ void AVoxelWorld::CreateWorldInternal(const FVoxelWorldCreateInfo& Info)
 	GeneratorCache->SetGeneratorInit(GetGeneratorInit());
 	
 	GameThreadTasks = MakeVoxelShared<FGameThreadTasks>();
+	IsLoadingPendingSaveRegions = MakeVoxelShared<FThreadSafeBool>(false);
 
 	if (Info.bOverrideData)
 	{
@@ -1066,6 +1093,7 @@ void AVoxelWorld::DestroyWorldInternal()
 
 	GameThreadTasks->Flush();
 	GameThreadTasks.Reset();
+	IsLoadingPendingSaveRegions.Reset();
 
 	// Clear generator cache to avoid keeping instances alive
 	if (ensure(GeneratorCache))
@@ -1116,20 +1144,45 @@ void AVoxelWorld::LoadFromSaveObject()
 		return;
 	}
 	
-	FVoxelUncompressedWorldSave Save;
-	UVoxelSaveUtilities::DecompressVoxelSave(SaveObject->Save, Save);
-	
-	if (Save.Const().GetDepth() == -1)
+	bool bSuccess;
+	const FVoxelCompressedWorldSaveImpl& CompressedSave = SaveObject->Save.Const();
+	if (CompressedSave.IsRegionIndexed() && CVarSaveRegionsLoadDistance.GetValueOnGameThread() > 0 && PlayType == EVoxelPlayType::Game)
 	{
-		FVoxelMessages::Error("Invalid Save Object!", this);
-		return;
+		// Only load the regions around the invokers, the other ones are loaded in Tick
+		if (CompressedSave.GetDepth() > Data->Depth)
+		{
+			LOG_VOXEL(Warning, TEXT("Save Object depth is bigger than world depth, the save data outside world bounds will be ignored"));
+		}
+
+		TArray<FVoxelIntBox> BoundsToLoad;
+		GetSaveRegionsBoundsToLoad(BoundsToLoad);
+		
+		const FVoxelGeneratorInit WorldInit = GetGeneratorInit();
+		const FVoxelPlaceableItemLoadInfo LoadInfo{ &WorldInit, &SaveObject->Save.Objects };
+
+		TArray<FVoxelIntBox> BoundsToUpdate;
+		bSuccess = Data->LoadFromSave(MakeVoxelSharedCopy(CompressedSave), LoadInfo, BoundsToLoad, &BoundsToUpdate);
+		GetLODManager().UpdateBounds(BoundsToUpdate);
 	}
-	if (Save.Const().GetDepth() > Data->Depth)
+	else
 	{
-		LOG_VOXEL(Warning, TEXT("Save Object depth is bigger than world depth, the save data outside world bounds will be ignored"));
-	}
+		FVoxelUncompressedWorldSave Save;
+		UVoxelSaveUtilities::DecompressVoxelSave(SaveObject->Save, Save);
 
-	if (!UVoxelDataTools::LoadFromSave(this, Save))
+		if (Save.Const().GetDepth() == -1)
+		{
+			FVoxelMessages::Error("Invalid Save Object!", this);
+			return;
+		}
+		if (Save.Const().GetDepth() > Data->Depth)
+		{
+			LOG_VOXEL(Warning, TEXT("Save Object depth is bigger than world depth, the save data outside world bounds will be ignored"));
+		}
+
+		bSuccess = UVoxelDataTools::LoadFromSave(this, Save);
+	}
+	
+	if (!bSuccess)
 	{
 		const auto Result = FMessageDialog::Open(
 			EAppMsgType::YesNoCancel,
@@ -1145,6 +1198,102 @@ void AVoxelWorld::LoadFromSaveObject()
 	}
 }
 
+// Will autodelete
+class FVoxelLoadPendingSaveRegionsWork : public FVoxelAsyncWork
+{
+public:
+	const TWeakObjectPtr<AVoxelWorld> World;
+	const TVoxelWeakPtr<FVoxelData> Data;
+	const TVoxelWeakPtr<AVoxelWorld::FGameThreadTasks> GameThreadTasks;
+	const TVoxelSharedRef<FThreadSafeBool> IsLoading;
+	const TArray<FVoxelIntBox> BoundsToLoad;
+
+	FVoxelLoadPendingSaveRegionsWork(AVoxelWorld& World, const TVoxelSharedRef<FThreadSafeBool>& IsLoading, TArray<FVoxelIntBox>&& BoundsToLoad)
+		: FVoxelAsyncWork(STATIC_FNAME("LoadPendingSaveRegions"), 1e9, true)
+		, World(&World)
+		, Data(World.GetDataSharedPtr())
+		, GameThreadTasks(World.GetGameThreadTasks())
+		, IsLoading(IsLoading)
+		, BoundsToLoad(MoveTemp(BoundsToLoad))
+	{
+	}
+
+	//~ Begin IVoxelQueuedWork Interface
+	virtual uint32 GetPriority() const override
+	{
+		return 0;
+	}
+	virtual void DoWork() override
+	{
+		const auto PinnedData = Data.Pin();
+		if (!PinnedData.IsValid())
+		{
+			return;
+		}
+
+		TArray<FVoxelIntBox> BoundsToUpdate;
+		for (const FVoxelIntBox& Bounds : BoundsToLoad)
+		{
+			PinnedData->LoadPendingSaveRegions(Bounds, &BoundsToUpdate);
+		}
+
+		const auto PinnedGameThreadTasks = GameThreadTasks.Pin();
+		if (!PinnedGameThreadTasks.IsValid())
+		{
+			return;
+		}
+		
+		PinnedGameThreadTasks->AddTask([World = World, IsLoading = IsLoading, BoundsToUpdate = MoveTemp(BoundsToUpdate)]()
+		{
+			// Only start the next load once the renderer knows about this one
+			*IsLoading = false;
+			
+			if (BoundsToUpdate.Num() > 0 && World.IsValid() && World->IsCreated())
+			{
+				World->GetLODManager().UpdateBounds(BoundsToUpdate);
+			}
+		});
+	}
+	//~ End IVoxelQueuedWork Interface
+};
+
+void AVoxelWorld::LoadPendingSaveRegions()
+{
+	VOXEL_FUNCTION_COUNTER();
+	check(IsLoadingPendingSaveRegions.IsValid());
+
+	TArray<FVoxelIntBox> BoundsToLoad;
+	GetSaveRegionsBoundsToLoad(BoundsToLoad);
+	if (BoundsToLoad.Num() == 0)
+	{
+		return;
+	}
+
+	// Decompressing & loading the regions takes the data write lock: don't do it on the game thread
+	*IsLoadingPendingSaveRegions = true;
+	GetPool().QueueTask(EVoxelTaskType::AsyncEditFunctions, new FVoxelLoadPendingSaveRegionsWork(*this, IsLoadingPendingSaveRegions.ToSharedRef(), MoveTemp(BoundsToLoad)));
+}
+
+void AVoxelWorld::GetSaveRegionsBoundsToLoad(TArray<FVoxelIntBox>& OutBounds) const
+{
+	const int32 LoadDistance = CVarSaveRegionsLoadDistance.GetValueOnGameThread();
+	if (LoadDistance <= 0)
+	{
+		// Load everything
+		OutBounds.Add(FVoxelIntBox::Infinite);
+		return;
+	}
+	
+	for (const TWeakObjectPtr<UVoxelInvokerComponentBase>& Invoker : UVoxelInvokerComponentBase::GetInvokers(GetWorld()))
+	{
+		if (Invoker.IsValid())
+		{
+			const FIntVector Position = Invoker->GetInvokerVoxelPosition(this);
+			OutBounds.Add(FVoxelIntBox(Position).Extend(LoadDistance));
+		}
+	}
+}
+
 void AVoxelWorld::ApplyPlaceableItems()
 {
 	VOXEL_FUNCTION_COUNTER();
@@ -1202,6 +1351,11 @@ void AVoxelWorld::UpdateDynamicLODSettings() const
 	
 	LODDynamicSettings->bComputeVisibleChunksNavmesh = bComputeVisibleChunksNavmesh;
 	LODDynamicSettings->VisibleChunksNavmeshMaxLOD = FVoxelUtilities::ClampDepth<RENDER_CHUNK_SIZE>(VisibleChunksNavmeshMaxLOD);
+
+	LODDynamicSettings->bEnablePrefetch = bEnableLODPrefetch;
+	LODDynamicSettings->PrefetchHorizon = FMath::Max(LODPrefetchHorizon, 0.f);
+	LODDynamicSettings->PrefetchMinSpeed = FMath::Max(LODPrefetchMinSpeed, 0.f);
+	LODDynamicSettings->PrefetchRadius = FMath::Max(LODPrefetchRadius, 0.f);
 }
 
 void AVoxelWorld::UpdateDynamicRendererSettings() const
@@ -10,9 +10,11 @@
 #include "FastNoise/VoxelFastNoise_SimplexNoise.h"
 #include "FastNoise/VoxelFastNoise_CellularNoise.h"
 #include "FastNoise/VoxelFastNoise_GradientPerturb.h"
+#include "FastNoise/VoxelFastNoise_Batch.h"
 
 // You will need to include FastNoise/VoxelFastNoise.inl to use fast noise functions
 class FVoxelFastNoise : public
+	TVoxelFastNoise_Batch<
 	TVoxelFastNoise_CubicNoise<
 	TVoxelFastNoise_ValueNoise<
 	TVoxelFastNoise_WhiteNoise<
@@ -20,7 +22,7 @@ class FVoxelFastNoise : public
 	TVoxelFastNoise_SimplexNoise<
 	TVoxelFastNoise_CellularNoise<
 	TVoxelFastNoise_GradientPerturb<
-	FVoxelFastNoiseBase>>>>>>>
+	FVoxelFastNoiseBase>>>>>>>>
 {
 public:
 	FVoxelFastNoise() = default;
@@ -9,4 +9,5 @@
 #include "FastNoise/VoxelFastNoise_PerlinNoise.inl"
 #include "FastNoise/VoxelFastNoise_SimplexNoise.inl"
 #include "FastNoise/VoxelFastNoise_CellularNoise.inl"
-#include "FastNoise/VoxelFastNoise_GradientPerturb.inl"
\ No newline at end of file
+#include "FastNoise/VoxelFastNoise_GradientPerturb.inl"
+#include "FastNoise/VoxelFastNoise_Batch.inl"
\ No newline at end of file
@@ -210,6 +210,7 @@ private:
 	template<typename T> friend class TVoxelFastNoise_SimplexNoise;
 	template<typename T> friend class TVoxelFastNoise_CellularNoise;
 	template<typename T> friend class TVoxelFastNoise_GradientPerturb;
+	template<typename T> friend class TVoxelFastNoise_Batch;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
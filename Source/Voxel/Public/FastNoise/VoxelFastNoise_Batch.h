@@ -0,0 +1,129 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FastNoise/VoxelFastNoiseBase.h"
+
+enum class EVoxelNoiseSIMDLevel : uint8
+{
+	// Reference path: one Single* call per point
+	Scalar,
+	SSE4,
+	AVX2,
+	AVX512
+};
+
+class VOXEL_API FVoxelFastNoiseSIMD
+{
+public:
+	// Best level supported by the CPU, clamped by voxel.noise.MaxSIMDLevel
+	static EVoxelNoiseSIMDLevel GetLevel();
+	// Best level supported by the CPU
+	static EVoxelNoiseSIMDLevel GetCPULevel();
+	static const TCHAR* ToString(EVoxelNoiseSIMDLevel Level);
+};
+
+// Per-function target attributes let us compile the same kernels for several instruction sets and pick one at runtime
+// MSVC has no such attribute: there all the levels run the kernels compiled for the module instruction set
+// fma is not enabled on AVX2 so that multiply-adds are not contracted, which keeps the results bit exact with the scalar path
+#if PLATFORM_CPU_X86_FAMILY && (defined(__clang__) || defined(__GNUC__))
+#define VOXEL_NOISE_TARGET_SSE4 __attribute__((target("sse4.1")))
+#define VOXEL_NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+#define VOXEL_NOISE_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define VOXEL_NOISE_TARGET_SSE4
+#define VOXEL_NOISE_TARGET_AVX2
+#define VOXEL_NOISE_TARGET_AVX512
+#endif
+
+// Batch entry points: compute a noise over arrays of points
+// Points are processed in blocks: floors, fractions, interpolations and lerps are computed for a whole block at once
+// in plain loops the compiler vectorizes, while the permutation table lookups are done per lane
+// Results are bit exact with the matching Get* function, except on AVX512 where multiply-adds may be fused (see voxel.noise.BenchmarkBatch)
+template<typename T>
+class TVoxelFastNoise_Batch : public T
+{
+public:
+	DEFINE_VOXEL_NOISE_CLASS()
+
+	static constexpr int32 BlockSize = 16;
+
+public:
+	void GetValue_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetValue_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetValueFractal_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetValueFractal_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+
+	void GetPerlin_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetPerlin_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetPerlinFractal_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetPerlinFractal_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+
+	// Simplex and cellular have data dependent branches (simplex corner ordering, cellular neighbors search):
+	// their batches run the scalar kernels, but still benefit from the fractal loops being done per block
+	void GetSimplex_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetSimplex_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetSimplexFractal_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+	void GetSimplexFractal_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level = FVoxelFastNoiseSIMD::GetLevel()) const;
+
+	void GetCellular_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num) const;
+	void GetCellular_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num) const;
+
+private:
+	enum class EKernel : uint8
+	{
+		Value,
+		Perlin,
+		Simplex
+	};
+
+	// Single noise on a block of already scaled coordinates
+	template<EKernel Kernel>
+	void Single_2D_Block(uint8 offset, const v_flt* RESTRICT x, const v_flt* RESTRICT y, v_flt* RESTRICT Out, int32 Num) const;
+	template<EKernel Kernel>
+	void Single_3D_Block(uint8 offset, const v_flt* RESTRICT x, const v_flt* RESTRICT y, const v_flt* RESTRICT z, v_flt* RESTRICT Out, int32 Num) const;
+
+	// Fractal noise on a block, octaves == 0 for a single noise
+	template<EKernel Kernel>
+	void Fractal_2D_Blocks(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const;
+	template<EKernel Kernel>
+	void Fractal_3D_Blocks(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const;
+
+	template<EKernel Kernel>
+	void Dispatch_2D(EVoxelNoiseSIMDLevel Level, const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const;
+	template<EKernel Kernel>
+	void Dispatch_3D(EVoxelNoiseSIMDLevel Level, const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const;
+
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_SSE4 FORCENOINLINE void Fractal_2D_SSE4(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_2D_Blocks<Kernel>(X, Y, frequency, octaves, Out, Num);
+	}
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_AVX2 FORCENOINLINE void Fractal_2D_AVX2(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_2D_Blocks<Kernel>(X, Y, frequency, octaves, Out, Num);
+	}
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_AVX512 FORCENOINLINE void Fractal_2D_AVX512(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_2D_Blocks<Kernel>(X, Y, frequency, octaves, Out, Num);
+	}
+
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_SSE4 FORCENOINLINE void Fractal_3D_SSE4(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_3D_Blocks<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	}
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_AVX2 FORCENOINLINE void Fractal_3D_AVX2(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_3D_Blocks<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	}
+	template<EKernel Kernel>
+	VOXEL_NOISE_TARGET_AVX512 FORCENOINLINE void Fractal_3D_AVX512(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+	{
+		Fractal_3D_Blocks<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	}
+};
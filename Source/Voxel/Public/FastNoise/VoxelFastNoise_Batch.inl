@@ -0,0 +1,563 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "FastNoise/VoxelFastNoise_Batch.h"
+#include "FastNoise/VoxelFastNoiseBase.inl"
+
+// THIS CODE IS A MODIFIED VERSION OF FAST NOISE: SEE LICENSE BELOW
+//
+// MIT License
+//
+// Copyright(c) 2017 Jordan Peck
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// ReSharper disable CppUE4CodingStandardNamingViolationWarning
+
+// The block kernels below do exactly the same operations as the matching Single* functions, lane by lane:
+// keep them in sync when changing those
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+FN_FORCEINLINE_SINGLE void TVoxelFastNoise_Batch<T>::Single_2D_Block(uint8 offset, const v_flt* RESTRICT x, const v_flt* RESTRICT y, v_flt* RESTRICT Out, int32 Num) const
+{
+	checkVoxelSlow(Num <= BlockSize);
+
+	if (Kernel == EKernel::Simplex)
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			Out[Lane] = this->SingleSimplex_2D(offset, x[Lane], y[Lane]);
+		}
+		return;
+	}
+
+	int32 x0[BlockSize];
+	int32 y0[BlockSize];
+	v_flt fx[BlockSize];
+	v_flt fy[BlockSize];
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		x0[Lane] = FNoiseMath::FastFloor(x[Lane]);
+		y0[Lane] = FNoiseMath::FastFloor(y[Lane]);
+		fx[Lane] = x[Lane] - x0[Lane];
+		fy[Lane] = y[Lane] - y0[Lane];
+	}
+
+	v_flt xs[BlockSize];
+	v_flt ys[BlockSize];
+	// Switch once per block instead of once per point
+	switch (This().Interpolation)
+	{
+	default: ensureVoxelSlow(false);
+	case EVoxelNoiseInterpolation::Linear:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = fx[Lane];
+			ys[Lane] = fy[Lane];
+		}
+		break;
+	}
+	case EVoxelNoiseInterpolation::Hermite:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = FNoiseMath::InterpHermiteFunc(fx[Lane]);
+			ys[Lane] = FNoiseMath::InterpHermiteFunc(fy[Lane]);
+		}
+		break;
+	}
+	case EVoxelNoiseInterpolation::Quintic:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = FNoiseMath::InterpQuinticFunc(fx[Lane]);
+			ys[Lane] = FNoiseMath::InterpQuinticFunc(fy[Lane]);
+		}
+		break;
+	}
+	}
+
+	// Corners: 00, 10, 01, 11
+	v_flt Corners[4][BlockSize];
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		const int32 x1 = x0[Lane] + 1;
+		const int32 y1 = y0[Lane] + 1;
+
+		if (Kernel == EKernel::Value)
+		{
+			Corners[0][Lane] = This().ValCoord2DFast(offset, x0[Lane], y0[Lane]);
+			Corners[1][Lane] = This().ValCoord2DFast(offset, x1, y0[Lane]);
+			Corners[2][Lane] = This().ValCoord2DFast(offset, x0[Lane], y1);
+			Corners[3][Lane] = This().ValCoord2DFast(offset, x1, y1);
+		}
+		else
+		{
+			const v_flt xd0 = fx[Lane];
+			const v_flt yd0 = fy[Lane];
+			const v_flt xd1 = xd0 - 1;
+			const v_flt yd1 = yd0 - 1;
+
+			Corners[0][Lane] = This().GradCoord2D(offset, x0[Lane], y0[Lane], xd0, yd0);
+			Corners[1][Lane] = This().GradCoord2D(offset, x1, y0[Lane], xd1, yd0);
+			Corners[2][Lane] = This().GradCoord2D(offset, x0[Lane], y1, xd0, yd1);
+			Corners[3][Lane] = This().GradCoord2D(offset, x1, y1, xd1, yd1);
+		}
+	}
+
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		const v_flt xf0 = FNoiseMath::Lerp(Corners[0][Lane], Corners[1][Lane], xs[Lane]);
+		const v_flt xf1 = FNoiseMath::Lerp(Corners[2][Lane], Corners[3][Lane], xs[Lane]);
+
+		Out[Lane] = FNoiseMath::Lerp(xf0, xf1, ys[Lane]);
+	}
+}
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+FN_FORCEINLINE_SINGLE void TVoxelFastNoise_Batch<T>::Single_3D_Block(uint8 offset, const v_flt* RESTRICT x, const v_flt* RESTRICT y, const v_flt* RESTRICT z, v_flt* RESTRICT Out, int32 Num) const
+{
+	checkVoxelSlow(Num <= BlockSize);
+
+	if (Kernel == EKernel::Simplex)
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			Out[Lane] = this->SingleSimplex_3D(offset, x[Lane], y[Lane], z[Lane]);
+		}
+		return;
+	}
+
+	int32 x0[BlockSize];
+	int32 y0[BlockSize];
+	int32 z0[BlockSize];
+	v_flt fx[BlockSize];
+	v_flt fy[BlockSize];
+	v_flt fz[BlockSize];
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		x0[Lane] = FNoiseMath::FastFloor(x[Lane]);
+		y0[Lane] = FNoiseMath::FastFloor(y[Lane]);
+		z0[Lane] = FNoiseMath::FastFloor(z[Lane]);
+		fx[Lane] = x[Lane] - x0[Lane];
+		fy[Lane] = y[Lane] - y0[Lane];
+		fz[Lane] = z[Lane] - z0[Lane];
+	}
+
+	v_flt xs[BlockSize];
+	v_flt ys[BlockSize];
+	v_flt zs[BlockSize];
+	// Switch once per block instead of once per point
+	switch (This().Interpolation)
+	{
+	default: ensureVoxelSlow(false);
+	case EVoxelNoiseInterpolation::Linear:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = fx[Lane];
+			ys[Lane] = fy[Lane];
+			zs[Lane] = fz[Lane];
+		}
+		break;
+	}
+	case EVoxelNoiseInterpolation::Hermite:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = FNoiseMath::InterpHermiteFunc(fx[Lane]);
+			ys[Lane] = FNoiseMath::InterpHermiteFunc(fy[Lane]);
+			zs[Lane] = FNoiseMath::InterpHermiteFunc(fz[Lane]);
+		}
+		break;
+	}
+	case EVoxelNoiseInterpolation::Quintic:
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			xs[Lane] = FNoiseMath::InterpQuinticFunc(fx[Lane]);
+			ys[Lane] = FNoiseMath::InterpQuinticFunc(fy[Lane]);
+			zs[Lane] = FNoiseMath::InterpQuinticFunc(fz[Lane]);
+		}
+		break;
+	}
+	}
+
+	// Corners: 000, 100, 010, 110, 001, 101, 011, 111
+	v_flt Corners[8][BlockSize];
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		const int32 x1 = x0[Lane] + 1;
+		const int32 y1 = y0[Lane] + 1;
+		const int32 z1 = z0[Lane] + 1;
+
+		if (Kernel == EKernel::Value)
+		{
+			Corners[0][Lane] = This().ValCoord3DFast(offset, x0[Lane], y0[Lane], z0[Lane]);
+			Corners[1][Lane] = This().ValCoord3DFast(offset, x1, y0[Lane], z0[Lane]);
+			Corners[2][Lane] = This().ValCoord3DFast(offset, x0[Lane], y1, z0[Lane]);
+			Corners[3][Lane] = This().ValCoord3DFast(offset, x1, y1, z0[Lane]);
+			Corners[4][Lane] = This().ValCoord3DFast(offset, x0[Lane], y0[Lane], z1);
+			Corners[5][Lane] = This().ValCoord3DFast(offset, x1, y0[Lane], z1);
+			Corners[6][Lane] = This().ValCoord3DFast(offset, x0[Lane], y1, z1);
+			Corners[7][Lane] = This().ValCoord3DFast(offset, x1, y1, z1);
+		}
+		else
+		{
+			const v_flt xd0 = fx[Lane];
+			const v_flt yd0 = fy[Lane];
+			const v_flt zd0 = fz[Lane];
+			const v_flt xd1 = xd0 - 1;
+			const v_flt yd1 = yd0 - 1;
+			const v_flt zd1 = zd0 - 1;
+
+			Corners[0][Lane] = This().GradCoord3D(offset, x0[Lane], y0[Lane], z0[Lane], xd0, yd0, zd0);
+			Corners[1][Lane] = This().GradCoord3D(offset, x1, y0[Lane], z0[Lane], xd1, yd0, zd0);
+			Corners[2][Lane] = This().GradCoord3D(offset, x0[Lane], y1, z0[Lane], xd0, yd1, zd0);
+			Corners[3][Lane] = This().GradCoord3D(offset, x1, y1, z0[Lane], xd1, yd1, zd0);
+			Corners[4][Lane] = This().GradCoord3D(offset, x0[Lane], y0[Lane], z1, xd0, yd0, zd1);
+			Corners[5][Lane] = This().GradCoord3D(offset, x1, y0[Lane], z1, xd1, yd0, zd1);
+			Corners[6][Lane] = This().GradCoord3D(offset, x0[Lane], y1, z1, xd0, yd1, zd1);
+			Corners[7][Lane] = This().GradCoord3D(offset, x1, y1, z1, xd1, yd1, zd1);
+		}
+	}
+
+	for (int32 Lane = 0; Lane < Num; Lane++)
+	{
+		const v_flt xf00 = FNoiseMath::Lerp(Corners[0][Lane], Corners[1][Lane], xs[Lane]);
+		const v_flt xf10 = FNoiseMath::Lerp(Corners[2][Lane], Corners[3][Lane], xs[Lane]);
+		const v_flt xf01 = FNoiseMath::Lerp(Corners[4][Lane], Corners[5][Lane], xs[Lane]);
+		const v_flt xf11 = FNoiseMath::Lerp(Corners[6][Lane], Corners[7][Lane], xs[Lane]);
+
+		const v_flt yf0 = FNoiseMath::Lerp(xf00, xf10, ys[Lane]);
+		const v_flt yf1 = FNoiseMath::Lerp(xf01, xf11, ys[Lane]);
+
+		Out[Lane] = FNoiseMath::Lerp(yf0, yf1, zs[Lane]);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+FN_FORCEINLINE void TVoxelFastNoise_Batch<T>::Fractal_2D_Blocks(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+{
+	const EVoxelNoiseFractalType FractalType = This().FractalType;
+	const v_flt Lacunarity = This().Lacunarity;
+	const v_flt Gain = This().Gain;
+	const v_flt FractalBounding = This().FractalBounding;
+
+	for (int32 Start = 0; Start < Num; Start += BlockSize)
+	{
+		const int32 Count = FMath::Min(BlockSize, Num - Start);
+
+		v_flt x[BlockSize];
+		v_flt y[BlockSize];
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			x[Lane] = X[Start + Lane] * frequency;
+			y[Lane] = Y[Start + Lane] * frequency;
+		}
+
+		if (octaves == 0)
+		{
+			Single_2D_Block<Kernel>(0, x, y, Out + Start, Count);
+			continue;
+		}
+
+		v_flt Noise[BlockSize];
+		v_flt Sum[BlockSize];
+		Single_2D_Block<Kernel>(This().Perm[0], x, y, Noise, Count);
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			switch (FractalType)
+			{
+			default:
+			case EVoxelNoiseFractalType::FBM: Sum[Lane] = Noise[Lane]; break;
+			case EVoxelNoiseFractalType::Billow: Sum[Lane] = FNoiseMath::FastAbs(Noise[Lane]) * 2 - 1; break;
+			case EVoxelNoiseFractalType::RigidMulti: Sum[Lane] = 1 - FNoiseMath::FastAbs(Noise[Lane]); break;
+			}
+		}
+
+		v_flt amp = 1;
+		for (int32 i = 1; i < octaves; i++)
+		{
+			for (int32 Lane = 0; Lane < Count; Lane++)
+			{
+				x[Lane] *= Lacunarity;
+				y[Lane] *= Lacunarity;
+			}
+			amp *= Gain;
+
+			Single_2D_Block<Kernel>(This().Perm[i], x, y, Noise, Count);
+
+			switch (FractalType)
+			{
+			default:
+			case EVoxelNoiseFractalType::FBM:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] += Noise[Lane] * amp;
+				}
+				break;
+			}
+			case EVoxelNoiseFractalType::Billow:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] += (FNoiseMath::FastAbs(Noise[Lane]) * 2 - 1) * amp;
+				}
+				break;
+			}
+			case EVoxelNoiseFractalType::RigidMulti:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] -= (1 - FNoiseMath::FastAbs(Noise[Lane])) * amp;
+				}
+				break;
+			}
+			}
+		}
+
+		// RigidMulti is not scaled by the fractal bounding
+		const bool bScale = FractalType != EVoxelNoiseFractalType::RigidMulti;
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			Out[Start + Lane] = bScale ? Sum[Lane] * FractalBounding : Sum[Lane];
+		}
+	}
+}
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+FN_FORCEINLINE void TVoxelFastNoise_Batch<T>::Fractal_3D_Blocks(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+{
+	const EVoxelNoiseFractalType FractalType = This().FractalType;
+	const v_flt Lacunarity = This().Lacunarity;
+	const v_flt Gain = This().Gain;
+	const v_flt FractalBounding = This().FractalBounding;
+
+	for (int32 Start = 0; Start < Num; Start += BlockSize)
+	{
+		const int32 Count = FMath::Min(BlockSize, Num - Start);
+
+		v_flt x[BlockSize];
+		v_flt y[BlockSize];
+		v_flt z[BlockSize];
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			x[Lane] = X[Start + Lane] * frequency;
+			y[Lane] = Y[Start + Lane] * frequency;
+			z[Lane] = Z[Start + Lane] * frequency;
+		}
+
+		if (octaves == 0)
+		{
+			Single_3D_Block<Kernel>(0, x, y, z, Out + Start, Count);
+			continue;
+		}
+
+		v_flt Noise[BlockSize];
+		v_flt Sum[BlockSize];
+		Single_3D_Block<Kernel>(This().Perm[0], x, y, z, Noise, Count);
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			switch (FractalType)
+			{
+			default:
+			case EVoxelNoiseFractalType::FBM: Sum[Lane] = Noise[Lane]; break;
+			case EVoxelNoiseFractalType::Billow: Sum[Lane] = FNoiseMath::FastAbs(Noise[Lane]) * 2 - 1; break;
+			case EVoxelNoiseFractalType::RigidMulti: Sum[Lane] = 1 - FNoiseMath::FastAbs(Noise[Lane]); break;
+			}
+		}
+
+		v_flt amp = 1;
+		for (int32 i = 1; i < octaves; i++)
+		{
+			for (int32 Lane = 0; Lane < Count; Lane++)
+			{
+				x[Lane] *= Lacunarity;
+				y[Lane] *= Lacunarity;
+				z[Lane] *= Lacunarity;
+			}
+			amp *= Gain;
+
+			Single_3D_Block<Kernel>(This().Perm[i], x, y, z, Noise, Count);
+
+			switch (FractalType)
+			{
+			default:
+			case EVoxelNoiseFractalType::FBM:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] += Noise[Lane] * amp;
+				}
+				break;
+			}
+			case EVoxelNoiseFractalType::Billow:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] += (FNoiseMath::FastAbs(Noise[Lane]) * 2 - 1) * amp;
+				}
+				break;
+			}
+			case EVoxelNoiseFractalType::RigidMulti:
+			{
+				for (int32 Lane = 0; Lane < Count; Lane++)
+				{
+					Sum[Lane] -= (1 - FNoiseMath::FastAbs(Noise[Lane])) * amp;
+				}
+				break;
+			}
+			}
+		}
+
+		// RigidMulti is not scaled by the fractal bounding
+		const bool bScale = FractalType != EVoxelNoiseFractalType::RigidMulti;
+		for (int32 Lane = 0; Lane < Count; Lane++)
+		{
+			Out[Start + Lane] = bScale ? Sum[Lane] * FractalBounding : Sum[Lane];
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+void TVoxelFastNoise_Batch<T>::Dispatch_2D(EVoxelNoiseSIMDLevel Level, const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+{
+	switch (Level)
+	{
+	case EVoxelNoiseSIMDLevel::AVX512: return Fractal_2D_AVX512<Kernel>(X, Y, frequency, octaves, Out, Num);
+	case EVoxelNoiseSIMDLevel::AVX2: return Fractal_2D_AVX2<Kernel>(X, Y, frequency, octaves, Out, Num);
+	case EVoxelNoiseSIMDLevel::SSE4: return Fractal_2D_SSE4<Kernel>(X, Y, frequency, octaves, Out, Num);
+	default: ensureVoxelSlow(false);
+	case EVoxelNoiseSIMDLevel::Scalar:
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			switch (Kernel)
+			{
+			default: ensureVoxelSlow(false);
+			case EKernel::Value: Out[Index] = octaves == 0 ? this->GetValue_2D(X[Index], Y[Index], frequency) : this->GetValueFractal_2D(X[Index], Y[Index], frequency, octaves); break;
+			case EKernel::Perlin: Out[Index] = octaves == 0 ? this->GetPerlin_2D(X[Index], Y[Index], frequency) : this->GetPerlinFractal_2D(X[Index], Y[Index], frequency, octaves); break;
+			case EKernel::Simplex: Out[Index] = octaves == 0 ? this->GetSimplex_2D(X[Index], Y[Index], frequency) : this->GetSimplexFractal_2D(X[Index], Y[Index], frequency, octaves); break;
+			}
+		}
+		return;
+	}
+	}
+}
+
+template<typename T>
+template<typename TVoxelFastNoise_Batch<T>::EKernel Kernel>
+void TVoxelFastNoise_Batch<T>::Dispatch_3D(EVoxelNoiseSIMDLevel Level, const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num) const
+{
+	switch (Level)
+	{
+	case EVoxelNoiseSIMDLevel::AVX512: return Fractal_3D_AVX512<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	case EVoxelNoiseSIMDLevel::AVX2: return Fractal_3D_AVX2<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	case EVoxelNoiseSIMDLevel::SSE4: return Fractal_3D_SSE4<Kernel>(X, Y, Z, frequency, octaves, Out, Num);
+	default: ensureVoxelSlow(false);
+	case EVoxelNoiseSIMDLevel::Scalar:
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			switch (Kernel)
+			{
+			default: ensureVoxelSlow(false);
+			case EKernel::Value: Out[Index] = octaves == 0 ? this->GetValue_3D(X[Index], Y[Index], Z[Index], frequency) : this->GetValueFractal_3D(X[Index], Y[Index], Z[Index], frequency, octaves); break;
+			case EKernel::Perlin: Out[Index] = octaves == 0 ? this->GetPerlin_3D(X[Index], Y[Index], Z[Index], frequency) : this->GetPerlinFractal_3D(X[Index], Y[Index], Z[Index], frequency, octaves); break;
+			case EKernel::Simplex: Out[Index] = octaves == 0 ? this->GetSimplex_3D(X[Index], Y[Index], Z[Index], frequency) : this->GetSimplexFractal_3D(X[Index], Y[Index], Z[Index], frequency, octaves); break;
+			}
+		}
+		return;
+	}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+#define DEFINE_VOXEL_NOISE_BATCH_2D(Name, Kernel) \
+	template<typename T> \
+	void TVoxelFastNoise_Batch<T>::Get ## Name ## _2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level) const \
+	{ \
+		Dispatch_2D<EKernel::Kernel>(Level, X, Y, frequency, 0, Out, Num); \
+	} \
+	template<typename T> \
+	void TVoxelFastNoise_Batch<T>::Get ## Name ## Fractal_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level) const \
+	{ \
+		/* 0 octaves is the single noise in the batch functions, but still the first octave in the fractal ones */ \
+		Dispatch_2D<EKernel::Kernel>(Level, X, Y, frequency, FMath::Max(octaves, 1), Out, Num); \
+	}
+
+#define DEFINE_VOXEL_NOISE_BATCH_3D(Name, Kernel) \
+	template<typename T> \
+	void TVoxelFastNoise_Batch<T>::Get ## Name ## _3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level) const \
+	{ \
+		Dispatch_3D<EKernel::Kernel>(Level, X, Y, Z, frequency, 0, Out, Num); \
+	} \
+	template<typename T> \
+	void TVoxelFastNoise_Batch<T>::Get ## Name ## Fractal_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, int32 octaves, v_flt* RESTRICT Out, int32 Num, EVoxelNoiseSIMDLevel Level) const \
+	{ \
+		Dispatch_3D<EKernel::Kernel>(Level, X, Y, Z, frequency, FMath::Max(octaves, 1), Out, Num); \
+	}
+
+DEFINE_VOXEL_NOISE_BATCH_2D(Value, Value)
+DEFINE_VOXEL_NOISE_BATCH_3D(Value, Value)
+DEFINE_VOXEL_NOISE_BATCH_2D(Perlin, Perlin)
+DEFINE_VOXEL_NOISE_BATCH_3D(Perlin, Perlin)
+DEFINE_VOXEL_NOISE_BATCH_2D(Simplex, Simplex)
+DEFINE_VOXEL_NOISE_BATCH_3D(Simplex, Simplex)
+
+#undef DEFINE_VOXEL_NOISE_BATCH_2D
+#undef DEFINE_VOXEL_NOISE_BATCH_3D
+
+template<typename T>
+void TVoxelFastNoise_Batch<T>::GetCellular_2D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, v_flt frequency, v_flt* RESTRICT Out, int32 Num) const
+{
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Out[Index] = this->GetCellular_2D(X[Index], Y[Index], frequency);
+	}
+}
+
+template<typename T>
+void TVoxelFastNoise_Batch<T>::GetCellular_3D_Batch(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt frequency, v_flt* RESTRICT Out, int32 Num) const
+{
+	for (int32 Index = 0; Index < Num; Index++)
+	{
+		Out[Index] = this->GetCellular_3D(X[Index], Y[Index], Z[Index], frequency);
+	}
+}
@@ -31,7 +31,14 @@ enum class EVoxelTaskType : uint8
 	MeshMerge,
 	// The render octree is used to determine the LODs to display
 	// Should be done as fast as possible to start meshing tasks 
-	RenderOctree
+	RenderOctree,
+	// Meshing of chunks an edit is waiting on, regardless of their visibility
+	// The pool edit threads only run tasks with this priority category, so that edits show up even when the other threads are busy streaming
+	EditChunksMeshing,
+	// Speculative caching of the data in front of fast invokers
+	// By default in the lowest priority category, shared with ChunksMeshing: these tasks have the lowest priority (0),
+	// so they are popped after the meshing tasks with a higher priority, but are not ordered against the ones with a priority of 0
+	DataPrefetch
 };
 
 namespace EVoxelTaskType_DefaultPriorityCategories
@@ -50,7 +57,9 @@ namespace EVoxelTaskType_DefaultPriorityCategories
 		HISMBuild                      = 1000,
 		AsyncEditFunctions             = 50,
 		MeshMerge                      = 100000,
-		RenderOctree                   = 1000000
+		RenderOctree                   = 1000000,
+		EditChunksMeshing              = 10000,
+		DataPrefetch                   = 0
 	};
 }
 
@@ -68,7 +77,9 @@ namespace EVoxelTaskType_DefaultPriorityOffsets
 		HISMBuild                      = 0,
 		AsyncEditFunctions             = 0,
 		MeshMerge                      = 0,
-		RenderOctree                   = 0
+		RenderOctree                   = 0,
+		EditChunksMeshing              = 0,
+		DataPrefetch                   = 0
 	};
 }
 
@@ -87,6 +98,8 @@ public:
 	virtual void QueueTasks(EVoxelTaskType Type, const TArray<IVoxelQueuedWork*>& Tasks) = 0;
 
 	virtual int32 GetNumTasks() const = 0;
+	// Called when the priorities of the queued tasks might have changed, eg when the invokers moved
+	virtual void InvalidatePriorities() {}
 	//~ End IVoxelPool Interface
 
 public:
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "VoxelIntBox.h"
+#include "VoxelData/VoxelDataSlabAllocator.h"
 
 class FVoxelGeneratorInstance;
 
@@ -19,12 +20,23 @@ public:
 		uint8 PadToAvoidContention2[PLATFORM_CACHE_LINE_SIZE];
 	};
 
+	IVoxelDataOctreeMemory() = default;
+	explicit IVoxelDataOctreeMemory(TUniquePtr<FVoxelDataSlabAllocator> SlabAllocator)
+		: SlabAllocator(MoveTemp(SlabAllocator))
+	{
+	}
+
 	const FDataOctreeMemory& GetCachedMemory() const { return CachedMemory; }
 	const FDataOctreeMemory& GetDirtyMemory() const { return DirtyMemory; }
+
+	// Null if the slab allocator is disabled, in which case buffers are allocated with FMemory
+	FVoxelDataSlabAllocator* GetSlabAllocator() const { return SlabAllocator.Get(); }
 	
 private:
 	mutable FDataOctreeMemory CachedMemory{};
 	mutable FDataOctreeMemory DirtyMemory{};
+	// Must outlive the octree: declared in the base class so that it's destroyed last
+	const TUniquePtr<FVoxelDataSlabAllocator> SlabAllocator;
 	
 	template<typename>
 	friend struct TVoxelDataOctreeLeafMemoryUsage;
@@ -45,7 +57,8 @@ public:
 		bool bEnableMultiplayer,
 		bool bEnableUndoRedo,
 		const TVoxelSharedRef<FVoxelGeneratorInstance>& Generator)
-		: Depth(Depth)
+		: IVoxelDataOctreeMemory(FVoxelDataSlabAllocator::Create())
+		, Depth(Depth)
 		, WorldBounds(WorldBounds)
 		, bEnableMultiplayer(bEnableMultiplayer)
 		, bEnableUndoRedo(bEnableUndoRedo)
@@ -17,6 +17,8 @@ class FVoxelDataLockInfo;
 class FVoxelDataOctreeBase;
 class FVoxelDataOctreeLeaf;
 class FVoxelDataOctreeParent;
+class FVoxelDataSnapshot;
+class FVoxelSaveLoader;
 class FVoxelGeneratorInstance;
 class FVoxelTransformableGeneratorInstance;
 
@@ -26,6 +28,7 @@ struct FVoxelObjectArchiveEntry;
 struct FVoxelDisableEditsBoxItem;
 struct FVoxelPlaceableItemLoadInfo;
 struct FVoxelUncompressedWorldSaveImpl;
+struct FVoxelCompressedWorldSaveImpl;
 
 template<typename T>
 struct TVoxelRange;
@@ -152,6 +155,22 @@ public:
 	 */
 	TUniquePtr<FVoxelDataLockInfo> Lock(EVoxelLockType LockType, const FVoxelIntBox& Bounds, FName Name) const;
 
+	/**
+	 * Read lock the bounds, but let writers preempt the lock:
+	 * a writer trying to lock the bounds bumps the version of the octrees it's waiting on, and IsLockValid then returns false
+	 * The reader is expected to check IsLockValid regularly, and to unlock & retry later if it's false
+	 * The data read under the lock is always consistent: writers still wait for the lock to be released
+	 * @param	Bounds				Bounds to lock
+	 * @param	Name				The name of the task locking these bounds, for debug
+	 */
+	TUniquePtr<FVoxelDataLockInfo> LockOptimistic(const FVoxelIntBox& Bounds, FName Name) const;
+
+	/**
+	 * Lock free check of an optimistic lock. Always true for other locks
+	 * @return	false if a writer is waiting on the lock
+	 */
+	bool IsLockValid(const FVoxelDataLockInfo& LockInfo) const;
+
 	/**
 	 * Unlock previously locked bounds
 	 */
@@ -173,6 +192,28 @@ public:
 	// Requires write lock
 	template<typename T>
 	void ClearCacheInBounds(const FVoxelIntBox& Bounds);
+
+	/**
+	 * Call Lambda on the leaves in Bounds that no one has locked, write locking them one at a time
+	 * The leaves that are locked are skipped instead of waited on
+	 * Only for changes that don't change the leaves values, eg caching:
+	 * unlike Lock, doesn't capture snapshots, and optimistic readers are never invalidated as there are none on the leaves locked
+	 * Must NOT be locked
+	 * @param	Bounds				Bounds of the leaves to iterate
+	 * @param	bCreateChildren		If true, the missing leaves are created. Else, only the existing ones are iterated
+	 * @param	Lambda				void(FVoxelDataOctreeLeaf& Leaf)
+	 */
+	void IterateUnlockedLeaves(const FVoxelIntBox& Bounds, bool bCreateChildren, TFunctionRef<void(FVoxelDataOctreeLeaf&)> Lambda);
+
+	// Cache the leaves in Bounds that are not locked. Adds the bounds of the leaves cached to OutCachedLeaves
+	// Must NOT be locked
+	template<typename T>
+	void TryCacheBounds(const FVoxelIntBox& Bounds, TArray<FVoxelIntBox>& OutCachedLeaves);
+
+	// Clear the cache of the leaves with these bounds that are not locked, eg the ones returned by TryCacheBounds
+	// Must NOT be locked
+	template<typename T>
+	void TryClearCache(TArrayView<const FVoxelIntBox> Leaves);
 	
 	// Requires write lock
 	template<typename T>
@@ -264,6 +305,7 @@ public:
 	 */
 
 	// Get a save of this world. No lock required
+	// Saves a snapshot of the data: edits can continue while the save is built
 	void GetSave(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FVoxelObjectArchiveEntry>& OutObjects);
 
 	/**
@@ -274,7 +316,69 @@ public:
 	 * @return true if loaded successfully, false if the world is corrupted and must not be saved again
 	 */
 	bool LoadFromSave(const FVoxelUncompressedWorldSaveImpl& Save, const FVoxelPlaceableItemLoadInfo& LoadInfo, TArray<FVoxelIntBox>* OutBoundsToUpdate = nullptr);
+	
+	/**
+	 * Load this world from a compressed save. No lock required
+	 * If the save is region indexed, only the regions intersecting BoundsToLoad are loaded: the other ones are kept pending,
+	 * and are loaded by LoadPendingSaveRegions. Pending regions are still part of the saves made by GetSave
+	 * @param	Save						Save to load from. Kept alive while there are pending regions
+	 * @param	LoadInfo					Used to load placeable items. Can use {}
+	 * @param	BoundsToLoad				The bounds to load now. Use FVoxelIntBox::Infinite to load everything
+	 * @param	OutBoundsToUpdate			The modified bounds
+	 * @return true if loaded successfully, false if the world is corrupted and must not be saved again
+	 */
+	bool LoadFromSave(
+		const TVoxelSharedRef<const FVoxelCompressedWorldSaveImpl>& Save,
+		const FVoxelPlaceableItemLoadInfo& LoadInfo,
+		TConstArrayView<FVoxelIntBox> BoundsToLoad,
+		TArray<FVoxelIntBox>* OutBoundsToUpdate = nullptr);
+
+	/**
+	 * Load the pending save regions intersecting Bounds. No lock required
+	 * The values or materials of leaves edited since the save was loaded are not overwritten, the other channel is loaded
+	 * Corrupted regions are reported and dropped
+	 * @return the number of regions loaded
+	 */
+	int32 LoadPendingSaveRegions(const FVoxelIntBox& Bounds, TArray<FVoxelIntBox>* OutBoundsToUpdate = nullptr);
+	bool HasPendingSaveRegions() const
+	{
+		return NumPendingSaveRegions.GetValue() > 0;
+	}
+
+private:
+	mutable FCriticalSection PendingSaveRegionsSection;
+	TVoxelSharedPtr<const FVoxelCompressedWorldSaveImpl> PendingSave;
+	// Indices in PendingSave->GetRegions()
+	TArray<int32> PendingSaveRegions;
+	FThreadSafeCounter NumPendingSaveRegions;
+
+	void ClearPendingSaveRegions();
+	// Requires write lock on the leaf
+	void LoadLeafFromSave(FVoxelDataOctreeLeaf& Leaf, const FVoxelSaveLoader& Loader, int32 ChunkIndex, bool bLoadValues = true, bool bLoadMaterials = true);
+
+
+public:
+	/**
+	 * Snapshots
+	 */
+
+	/**
+	 * Create a copy-on-write snapshot of the data. No lock required
+	 * Only waits for the current write locks to be released: the leaves data is copied lazily, when they are first write locked
+	 * The snapshot keeps this data alive
+	 */
+	TVoxelSharedRef<FVoxelDataSnapshot> CreateSnapshot() const;
+
+private:
+	mutable FCriticalSection SnapshotsSection;
+	mutable TArray<FVoxelDataSnapshot*> Snapshots;
+	// Checked on every write lock, to avoid locking SnapshotsSection when there are no snapshots
+	mutable FThreadSafeCounter NumSnapshots;
+
+	void CaptureSnapshots(const FVoxelIntBox& Bounds) const;
+	void UnregisterSnapshot(FVoxelDataSnapshot& Snapshot) const;
 
+	friend class FVoxelDataSnapshot;
 
 public:
 	/**
@@ -76,6 +76,46 @@ void FVoxelData::ClearCacheInBounds(const FVoxelIntBox& Bounds)
 	});
 }
 
+template<typename T>
+void FVoxelData::TryCacheBounds(const FVoxelIntBox& Bounds, TArray<FVoxelIntBox>& OutCachedLeaves)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	IterateUnlockedLeaves(Bounds, true, [&](FVoxelDataOctreeLeaf& Leaf)
+	{
+		auto& DataHolder = Leaf.GetData<T>();
+		if (DataHolder.HasData())
+		{
+			return;
+		}
+
+		DataHolder.CreateData(*this, [&](T* RESTRICT DataPtr)
+		{
+			TVoxelQueryZone<T> QueryZone(Leaf.GetBounds(), DataPtr);
+			Leaf.GetFromGeneratorAndAssets(*Generator, QueryZone, 0);
+		});
+		OutCachedLeaves.Add(Leaf.GetBounds());
+	});
+}
+
+template<typename T>
+void FVoxelData::TryClearCache(TArrayView<const FVoxelIntBox> Leaves)
+{
+	VOXEL_ASYNC_FUNCTION_COUNTER();
+
+	for (const FVoxelIntBox& LeafBounds : Leaves)
+	{
+		IterateUnlockedLeaves(LeafBounds, false, [&](FVoxelDataOctreeLeaf& Leaf)
+		{
+			auto& DataHolder = Leaf.GetData<T>();
+			if (Leaf.GetBounds() == LeafBounds && DataHolder.HasAllocation() && !DataHolder.IsDirty())
+			{
+				DataHolder.ClearData(*this);
+			}
+		});
+	}
+}
+
 template<typename T>
 TArray<T> FVoxelData::Get(const FVoxelIntBox& Bounds) const
 {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "VoxelMinimal.h"
 #include "VoxelIntBox.h"
 #include "VoxelValue.h"
 #include "VoxelMaterial.h"
@@ -11,13 +12,120 @@ class FVoxelData;
 class FVoxelDataOctreeLeaf;
 class FVoxelDataOctreeBase;
 
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Data Accelerator Grids Memory"), STAT_VoxelDataAcceleratorGridsMemory, STATGROUP_VoxelMemory, VOXEL_API);
+
 namespace FVoxelDataAcceleratorParameters
 {
 	VOXEL_API int32 GetDefaultCacheSize();
 	VOXEL_API bool GetUseAcceleratorMap();
 	VOXEL_API bool GetShowStats();
 }
-	
+
+// Hit/miss counters of data accelerators
+// Per accelerator counters are only recorded if VOXEL_DATA_ACCELERATOR_STATS is true, grid build counters are always recorded
+// Use voxel.data.DataAccelerator.PrintStats to log the totals since the last voxel.data.DataAccelerator.ResetStats
+struct VOXEL_API FVoxelDataAcceleratorStats
+{
+	uint64 NumGet = 0;
+	uint64 NumSet = 0;
+
+	uint64 NumCacheTopAccess = 0;
+	uint64 NumCacheTopMiss = 0;
+
+	uint64 NumCacheAllAccess = 0;
+	uint64 NumCacheAllMiss = 0;
+
+	uint64 NumMapAccess = 0;
+	uint64 NumMapMiss = 0;
+
+	uint64 NumOutOfWorld = 0;
+
+	uint64 NumAccelerators = 0;
+	uint64 NumDenseGrids = 0;
+	uint64 NumSparseGrids = 0;
+	uint64 NumGridLeaves = 0;
+	double GridsBuildTime = 0;
+
+	FVoxelDataAcceleratorStats& operator+=(const FVoxelDataAcceleratorStats& Other);
+	void Log(const TCHAR* Name) const;
+
+	// Called when an accelerator is destroyed
+	static void Report(const FVoxelDataAcceleratorStats& Stats);
+	static FVoxelDataAcceleratorStats GetGlobalStats();
+	static void ResetGlobalStats();
+};
+
+// Leaves of a data octree intersecting some bounds, indexed by Leaf.GetMin() / DATA_CHUNK_SIZE
+// Stored in a flat 3D grid so that lookups are a bounds check and a load. The grid is filled in parallel for big bounds
+// If the bounds are too big for a flat grid (see voxel.data.DataAccelerator.MaxGridSize), falls back to a map
+class VOXEL_API FVoxelDataAcceleratorGrid
+{
+public:
+	static TVoxelSharedRef<FVoxelDataAcceleratorGrid> Create(const FVoxelData& Data, const FVoxelIntBox& Bounds);
+
+	FVoxelDataAcceleratorGrid() = default;
+	~FVoxelDataAcceleratorGrid();
+
+	UE_NONCOPYABLE(FVoxelDataAcceleratorGrid);
+
+public:
+	FORCEINLINE bool IsDense() const
+	{
+		return bIsDense;
+	}
+	FORCEINLINE FVoxelDataOctreeLeaf* Find(const FIntVector& LeafPosition) const
+	{
+		if (!bIsDense)
+		{
+			return SparseLeaves.FindRef(LeafPosition);
+		}
+
+		const FIntVector Local = LeafPosition - Min;
+		if (uint32(Local.X) >= uint32(Size.X) ||
+			uint32(Local.Y) >= uint32(Size.Y) ||
+			uint32(Local.Z) >= uint32(Size.Z))
+		{
+			return nullptr;
+		}
+		return Leaves.GetData()[GetIndex(Local)];
+	}
+	// Leaves outside of the bounds the grid was built with are not stored
+	FORCEINLINE void Add(const FIntVector& LeafPosition, FVoxelDataOctreeLeaf* Leaf)
+	{
+		if (!bIsDense)
+		{
+			SparseLeaves.Add(LeafPosition, Leaf);
+			return;
+		}
+
+		const FIntVector Local = LeafPosition - Min;
+		if (!ensureVoxelSlowNoSideEffects(
+			uint32(Local.X) < uint32(Size.X) &&
+			uint32(Local.Y) < uint32(Size.Y) &&
+			uint32(Local.Z) < uint32(Size.Z)))
+		{
+			return;
+		}
+		Leaves.GetData()[GetIndex(Local)] = Leaf;
+	}
+
+private:
+	bool bIsDense = true;
+	// In leaves
+	FIntVector Min = FIntVector::ZeroValue;
+	FIntVector Size = FIntVector::ZeroValue;
+	TArray<FVoxelDataOctreeLeaf*> Leaves;
+	TMap<FIntVector, FVoxelDataOctreeLeaf*> SparseLeaves;
+	int64 AllocatedSize = 0;
+
+	FORCEINLINE int32 GetIndex(const FIntVector& Local) const
+	{
+		return Local.X + Size.X * (Local.Y + Size.Y * Local.Z);
+	}
+	void UpdateStats();
+};
+
+
 template<typename TData>
 class TVoxelDataAccelerator
 {
@@ -123,30 +231,17 @@ private:
 	mutable uint64 GlobalTime = 0;
 
 #if VOXEL_DATA_ACCELERATOR_STATS
-	mutable uint32 NumGet = 0;
-	mutable uint32 NumSet = 0;
-
-	mutable uint32 NumCacheTopAccess = 0;
-	mutable uint32 NumCacheTopMiss = 0;
-
-	mutable uint32 NumCacheAllAccess = 0;
-	mutable uint32 NumCacheAllMiss = 0;
-
-	mutable uint32 NumMapAccess = 0;
-	mutable uint32 NumMapMiss = 0;
-	
-	mutable uint32 NumOutOfWorld = 0;
+	mutable FVoxelDataAcceleratorStats Stats;
 #endif
 
-	using FAcceleratorMap = TMap<FIntVector, FVoxelDataOctreeLeaf*>;
 #if VOXEL_ENGINE_VERSION >= 504
-	using FConstAcceleratorMap = typename std::conditional_t<bIsConst, const FAcceleratorMap, FAcceleratorMap>;
+	using FConstAcceleratorGrid = typename std::conditional_t<bIsConst, const FVoxelDataAcceleratorGrid, FVoxelDataAcceleratorGrid>;
 #else
-	using FConstAcceleratorMap = typename TChooseClass<bIsConst, const FAcceleratorMap, FAcceleratorMap>::Result;
+	using FConstAcceleratorGrid = typename TChooseClass<bIsConst, const FVoxelDataAcceleratorGrid, FVoxelDataAcceleratorGrid>::Result;
 #endif
 	
-	// Map from Leaf.GetMin() to &Leaf
-	const TVoxelSharedPtr<FConstAcceleratorMap> AcceleratorMap;
+	// Leaves in Bounds, indexed by Leaf.GetMin() / DATA_CHUNK_SIZE
+	const TVoxelSharedPtr<FConstAcceleratorGrid> AcceleratorGrid;
 
 	template<typename T>
 	auto GetImpl(int32 X, int32 Y, int32 Z, T UseOctree) const;
@@ -159,8 +254,6 @@ private:
 	FVoxelDataOctreeBase* GetOctreeFromMap(int32 X, int32 Y, int32 Z) const;
 
 	void StoreOctreeInCache(FVoxelDataOctreeBase& Octree) const;
-
-	static TVoxelSharedRef<FAcceleratorMap> GetAcceleratorMap(const FVoxelData& Data, const FVoxelIntBox& Bounds);
 };
 
 class FVoxelMutableDataAccelerator : public TVoxelDataAccelerator<FVoxelData>
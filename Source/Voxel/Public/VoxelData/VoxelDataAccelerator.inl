@@ -30,7 +30,12 @@ TVoxelDataAccelerator<TData>::TVoxelDataAccelerator(TData& Data, const FVoxelInt
 	, Bounds(Bounds)
 	, CacheSize(CacheSize)
 	, bUseAcceleratorMap(FVoxelDataAcceleratorParameters::GetUseAcceleratorMap())
-	, AcceleratorMap(MapSource ? MapSource->AcceleratorMap : GetAcceleratorMap(Data, Bounds))
+	, AcceleratorGrid(
+		MapSource
+		? MapSource->AcceleratorGrid
+		: bUseAcceleratorMap
+		? TVoxelSharedPtr<FConstAcceleratorGrid>(FVoxelDataAcceleratorGrid::Create(Data, Bounds))
+		: nullptr)
 {
 	check(!MapSource || bIsConst);
 	ensure(!MapSource || bUseAcceleratorMap == MapSource->bUseAcceleratorMap);
@@ -41,23 +46,13 @@ template<typename TData>
 TVoxelDataAccelerator<TData>::~TVoxelDataAccelerator()
 {
 #if VOXEL_DATA_ACCELERATOR_STATS
-	if (FVoxelDataAcceleratorParameters::GetShowStats() && (NumGet > 0 || NumSet > 0))
+	if (Stats.NumGet > 0 || Stats.NumSet > 0)
 	{
-		LOG_VOXEL(
-			Log,
-			TEXT("DataAccelerator: %6u reads; %6u writes; %6u/%6u top cache miss (%3.2f%% hits); %6u/%6u other cache miss (%3.2f%% hits); %6u/%6u map miss (%3.2f%% hits); %6u out of world"),
-			NumGet,
-			NumSet,
-			NumCacheTopMiss,
-			NumCacheTopAccess,
-			NumCacheTopAccess > 0 ? 100 * double(NumCacheTopAccess - NumCacheTopMiss) / NumCacheTopAccess : 0,
-			NumCacheAllMiss,
-			NumCacheAllAccess,
-			NumCacheAllAccess > 0 ? 100 * double(NumCacheAllAccess - NumCacheAllMiss) / NumCacheAllAccess : 0,
-			NumMapMiss,
-			NumMapAccess,
-			NumMapAccess > 0 ? 100 * double(NumMapAccess - NumMapMiss) / NumMapAccess : 0,
-			NumOutOfWorld);
+		if (FVoxelDataAcceleratorParameters::GetShowStats())
+		{
+			Stats.Log(TEXT("DataAccelerator"));
+		}
+		FVoxelDataAcceleratorStats::Report(Stats);
 	}
 #endif
 }
@@ -124,7 +119,7 @@ template<typename TData>
 template<typename T>
 auto TVoxelDataAccelerator<TData>::GetImpl(int32 X, int32 Y, int32 Z, T UseOctree) const
 {
-	ACCELERATOR_STAT(NumGet++);
+	ACCELERATOR_STAT(Stats.NumGet++);
 
 	// Each caller should clamp the coordinates
 	ensureVoxelSlow(Data.IsInWorld(X, Y, Z));
@@ -173,7 +168,7 @@ bool TVoxelDataAccelerator<TData>::SetImpl(int32 X, int32 Y, int32 Z, TLambda Ed
 {
 	static_assert(!bIsConst, "Calling Set on a const data accelerator!");
 
-	ACCELERATOR_STAT(NumSet++);
+	ACCELERATOR_STAT(Stats.NumSet++);
 
 	ensureVoxelSlowNoSideEffects(!bUseAcceleratorMap || Bounds.Contains(X, Y, Z));
 
@@ -207,7 +202,7 @@ bool TVoxelDataAccelerator<TData>::SetImpl(int32 X, int32 Y, int32 Z, TLambda Ed
 		// No need to check IsInWorld if we get a hit, so check now instead
 		if (!Data.IsInWorld(X, Y, Z))
 		{
-			ACCELERATOR_STAT(NumOutOfWorld++);
+			ACCELERATOR_STAT(Stats.NumOutOfWorld++);
 			return false;
 		}
 		
@@ -224,9 +219,9 @@ bool TVoxelDataAccelerator<TData>::SetImpl(int32 X, int32 Y, int32 Z, TLambda Ed
 
 			if (bUseAcceleratorMap)
 			{
-				const FIntVector HashPosition = FVoxelUtilities::DivideFloor(FIntVector(X, Y, Z), DATA_CHUNK_SIZE);
-				ensureVoxelSlowNoSideEffects(AcceleratorMap.IsUnique());
-				AcceleratorMap->Add(HashPosition, &Octree->AsLeaf());
+				const FIntVector LeafPosition = FVoxelUtilities::DivideFloor(FIntVector(X, Y, Z), DATA_CHUNK_SIZE);
+				ensureVoxelSlowNoSideEffects(AcceleratorGrid.IsUnique());
+				AcceleratorGrid->Add(LeafPosition, &Octree->AsLeaf());
 			}
 		}
 
@@ -246,10 +241,10 @@ bool TVoxelDataAccelerator<TData>::SetImpl(int32 X, int32 Y, int32 Z, TLambda Ed
 template<typename TData>
 FORCEINLINE FVoxelDataOctreeBase* TVoxelDataAccelerator<TData>::GetOctreeFromCache_CheckTopOnly(int32 X, int32 Y, int32 Z) const
 {
-	ACCELERATOR_STAT(NumCacheTopAccess++);
+	ACCELERATOR_STAT(Stats.NumCacheTopAccess++);
 	if (CacheEntries.Num() == 0)
 	{
-		ACCELERATOR_STAT(NumCacheTopMiss++);
+		ACCELERATOR_STAT(Stats.NumCacheTopMiss++);
 		return nullptr;
 	}
 
@@ -262,7 +257,7 @@ FORCEINLINE FVoxelDataOctreeBase* TVoxelDataAccelerator<TData>::GetOctreeFromCac
 	}
 	else
 	{
-		ACCELERATOR_STAT(NumCacheTopMiss++);
+		ACCELERATOR_STAT(Stats.NumCacheTopMiss++);
 		return nullptr;
 	}
 }
@@ -271,7 +266,7 @@ template<typename TData>
 FVoxelDataOctreeBase* TVoxelDataAccelerator<TData>::GetOctreeFromCache_CheckAll(int32 X, int32 Y, int32 Z) const
 {
 	checkVoxelSlow(!GetOctreeFromCache_CheckTopOnly(X, Y, Z) || !GetOctreeFromCache_CheckTopOnly(X, Y, Z)->IsLeaf());
-	ACCELERATOR_STAT(NumCacheAllAccess++);
+	ACCELERATOR_STAT(Stats.NumCacheAllAccess++);
 	for (int32 Index = 1; Index < CacheEntries.Num(); Index++)
 	{
 		ensureVoxelSlowNoSideEffects(CacheEntries[Index - 1].LastAccessTime > CacheEntries[Index].LastAccessTime);
@@ -295,7 +290,7 @@ FVoxelDataOctreeBase* TVoxelDataAccelerator<TData>::GetOctreeFromCache_CheckAll(
 			return Octree;
 		}
 	}
-	ACCELERATOR_STAT(NumCacheAllMiss++);
+	ACCELERATOR_STAT(Stats.NumCacheAllMiss++);
 	return nullptr;
 }
 
@@ -308,10 +303,10 @@ FVoxelDataOctreeBase* TVoxelDataAccelerator<TData>::GetOctreeFromMap(int32 X, in
 {
 	checkVoxelSlow(bUseAcceleratorMap);
 
-	ACCELERATOR_STAT(NumMapAccess++);
-	const FIntVector HashPosition = FVoxelUtilities::DivideFloor(FIntVector(X, Y, Z), DATA_CHUNK_SIZE);
-	auto* Result = AcceleratorMap->FindRef(HashPosition);
-	ACCELERATOR_STAT(if (!Result) NumMapMiss++);
+	ACCELERATOR_STAT(Stats.NumMapAccess++);
+	const FIntVector LeafPosition = FVoxelUtilities::DivideFloor(FIntVector(X, Y, Z), DATA_CHUNK_SIZE);
+	auto* Result = AcceleratorGrid->Find(LeafPosition);
+	ACCELERATOR_STAT(if (!Result) Stats.NumMapMiss++);
 	return Result;
 }
 
@@ -330,19 +325,4 @@ void TVoxelDataAccelerator<TData>::StoreOctreeInCache(FVoxelDataOctreeBase& Octr
 	CacheEntries.Insert(CacheEntry, 0);
 }
 
-template<typename TData>
-TVoxelSharedRef<TMap<FIntVector, FVoxelDataOctreeLeaf*>> TVoxelDataAccelerator<TData>::GetAcceleratorMap(const FVoxelData& Data, const FVoxelIntBox& Bounds)
-{
-	VOXEL_ASYNC_FUNCTION_COUNTER();
-
-	const auto AcceleratorMap = MakeVoxelShared<FAcceleratorMap>();
-	FVoxelOctreeUtilities::IterateLeavesInBounds(Data.GetOctree(), Bounds, [&](auto& Leaf)
-	{
-		ensureThreadSafe(Leaf.IsLockedForRead());
-		AcceleratorMap->Add(Leaf.GetMin() / DATA_CHUNK_SIZE, &Leaf);
-	});
-	AcceleratorMap->Compact();
-	return AcceleratorMap;
-}
-
 #undef ACCELERATOR_STAT
\ No newline at end of file
@@ -0,0 +1,100 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelIntBox.h"
+
+class FVoxelData;
+
+struct FVoxelDataConnectedComponent
+{
+	// Bounds of the voxels of the component
+	FVoxelIntBox Bounds;
+	int32 NumVoxels = 0;
+	// If true, the component has voxels on the sides of the searched bounds that are not on the world sides:
+	// it might be connected to voxels outside of the searched bounds
+	bool bTouchesBorder = false;
+};
+
+/**
+ * Labels the connected components of the non-empty voxels of a data, using 6-connectivity
+ *
+ * The bounds are split in blocks aligned to the data chunks, which are labeled in parallel.
+ * Blocks whose value range is full (eg single value leaves or generator ranges) are a single label, and are not queried.
+ * The labels of the blocks are then merged along the blocks faces in parallel using a lock-free union find.
+ */
+class VOXEL_API FVoxelDataConnectedComponents
+{
+public:
+	// Requires read lock on Bounds
+	FVoxelDataConnectedComponents(const FVoxelData& Data, const FVoxelIntBox& Bounds, bool bMultiThreaded = true);
+
+	const FVoxelIntBox Bounds;
+
+	const TArray<FVoxelDataConnectedComponent>& GetComponents() const { return Components; }
+
+	// Index of the component Position is in. -1 if empty or outside of the bounds
+	int32 GetComponent(const FIntVector& Position) const;
+
+	// Lambda(const FIntVector& Position)
+	template<typename T>
+	void IterateVoxels(int32 ComponentIndex, T Lambda) const
+	{
+		for (const int32 BlockIndex : ComponentsBlocks[ComponentIndex])
+		{
+			const FBlock& Block = Blocks[BlockIndex];
+			Block.Bounds.Iterate([&](int32 X, int32 Y, int32 Z)
+			{
+				const int32 Label = Block.GetLabel(FIntVector(X, Y, Z));
+				if (Label != -1 && LabelsComponents[Label] == ComponentIndex)
+				{
+					Lambda(FIntVector(X, Y, Z));
+				}
+			});
+		}
+	}
+
+private:
+	struct FBlock
+	{
+		FVoxelIntBox Bounds;
+		// Local label of each voxel, -1 if empty. Empty if the block is uniform
+		TArray<int16> LocalLabels;
+		// Label of the voxels if uniform
+		bool bUniform = true;
+		int32 NumLabels = 0;
+		// Global label of the local label 0
+		int32 FirstLabel = 0;
+
+		FORCEINLINE int32 GetLabel(const FIntVector& Position) const
+		{
+			checkVoxelSlow(Bounds.Contains(Position));
+			if (bUniform)
+			{
+				return NumLabels > 0 ? FirstLabel : -1;
+			}
+
+			const FIntVector Local = Position - Bounds.Min;
+			const FIntVector Size = Bounds.Size();
+			const int32 LocalLabel = LocalLabels[Local.X + Size.X * Local.Y + Size.X * Size.Y * Local.Z];
+			return LocalLabel == -1 ? -1 : FirstLabel + LocalLabel;
+		}
+	};
+
+	// Blocks are aligned on BlocksGridMin
+	FIntVector BlocksGridMin;
+	FIntVector BlocksGridSize;
+	TArray<FBlock> Blocks;
+
+	TArray<int32> LabelsComponents;
+
+	TArray<FVoxelDataConnectedComponent> Components;
+	TArray<TArray<int32>> ComponentsBlocks;
+
+	FORCEINLINE int32 GetBlockIndex(const FIntVector& BlockPosition) const
+	{
+		return BlockPosition.X + BlocksGridSize.X * BlockPosition.Y + BlocksGridSize.X * BlocksGridSize.Y * BlockPosition.Z;
+	}
+};
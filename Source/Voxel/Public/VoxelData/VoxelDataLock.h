@@ -6,6 +6,37 @@
 #include "VoxelData/VoxelData.h"
 #include "VoxelOctreeId.h"
 
+// Contention counters of FVoxelData::Lock
+// Only recorded if voxel.data.LockStats is set. Use voxel.data.PrintLockStats to log them, and voxel.data.ClearLockStats to reset them
+struct VOXEL_API FVoxelDataLockStats
+{
+	struct FLockTypeStats
+	{
+		uint64 NumLocks = 0;
+		// Time spent waiting in FVoxelData::Lock
+		double WaitTime = 0;
+		double MaxWaitTime = 0;
+	};
+	FLockTypeStats Read;
+	FLockTypeStats Write;
+
+	// Optimistic locks are also counted as Read
+	uint64 NumOptimisticLocks = 0;
+	// Number of times an optimistic reader released its lock early because a writer was waiting on it
+	uint64 NumOptimisticConflicts = 0;
+	// Number of times an optimistic reader had too many conflicts and fell back to a regular read lock
+	uint64 NumOptimisticFallbacks = 0;
+
+	static bool IsEnabled();
+	static void ReportLock(EVoxelLockType LockType, bool bOptimistic, uint64 WaitCycles);
+	static void ReportOptimisticConflict();
+	static void ReportOptimisticFallback();
+
+	static FVoxelDataLockStats Get();
+	static void Clear();
+	static void Print();
+};
+
 class FVoxelDataLockInfo
 {
 public:
@@ -23,6 +54,11 @@ private:
 	FName Name;
 	EVoxelLockType LockType = EVoxelLockType::Read;
 	TArray<FVoxelOctreeId> LockedOctrees; // In depth first order
+
+	// Only set for optimistic locks: the version of each locked octree mutex when it was locked
+	// The mutexes are valid as long as they are locked
+	bool bOptimistic = false;
+	TArray<TPair<const FVoxelSharedMutex*, uint32>> LockedVersions;
 	
 	friend class FVoxelData;
 };
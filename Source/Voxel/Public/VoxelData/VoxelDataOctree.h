@@ -95,6 +95,7 @@ private:
 	
 	friend class FVoxelDataOctreeLocker;
 	friend class FVoxelDataOctreeUnlocker;
+	friend class FVoxelDataOctreeTryLocker;
 	friend class FVoxelDataOctreeParent;
 };
 
@@ -163,23 +164,28 @@ public:
 class VOXEL_API FVoxelDataOctreeParent : public TVoxelOctreeParent<FVoxelDataOctreeBase, FVoxelDataOctreeLeaf, FVoxelDataOctreeParent>
 {
 public:
-	explicit FVoxelDataOctreeParent(uint8 Height)
+	// SlabAllocator is used for the children of this node and of all its descendants, and must outlive them
+	FVoxelDataOctreeParent(uint8 Height, FVoxelDataSlabAllocator* SlabAllocator)
 		: TVoxelOctreeParent(Height)
+		, SlabAllocator(SlabAllocator)
 	{
 		INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataOctreesMemory, sizeof(FVoxelDataOctreeParent));
 	}
-	~FVoxelDataOctreeParent()
-	{
-		DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataOctreesMemory, sizeof(FVoxelDataOctreeParent));
-	}
+	~FVoxelDataOctreeParent();
 	FVoxelDataOctreeParent(const FVoxelDataOctreeParent& Parent, uint8 ChildIndex)
 		: TVoxelOctreeParent(Parent, ChildIndex)
+		, SlabAllocator(Parent.SlabAllocator)
 	{
 		INC_VOXEL_MEMORY_STAT_BY(STAT_VoxelDataOctreesMemory, sizeof(FVoxelDataOctreeParent));
 	}
 
 	void CreateChildren();
 	void DestroyChildren();
+
+private:
+	FVoxelDataSlabAllocator* const SlabAllocator;
+
+	void FreeChildren();
 };
 
 ///////////////////////////////////////////////////////////////////////////////
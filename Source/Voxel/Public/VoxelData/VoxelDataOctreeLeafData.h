@@ -6,6 +6,7 @@
 #include "VoxelValue.h"
 #include "VoxelMaterial.h"
 #include "VoxelData/IVoxelData.h"
+#include "VoxelData/VoxelDataSlabAllocator.h"
 #include "VoxelUtilities/VoxelMiscUtilities.h"
 
 DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Dirty Values Memory"), STAT_VoxelDataOctreeDirtyValuesMemory, STATGROUP_VoxelMemory, VOXEL_API);
@@ -61,6 +62,232 @@ struct TVoxelDataOctreeLeafMemoryUsage
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// Fixed size leaf buffers come from the voxel data slab allocator when it's enabled
+// The leaf datas store the allocator their buffers come from, so that they are freed in the right place
+// even when cleared without the voxel data (see ~TVoxelDataOctreeLeafData)
+struct FVoxelDataOctreeLeafBuffer
+{
+	FORCEINLINE static void* Malloc(EVoxelDataSlabPool Pool, int32 MemorySize, const IVoxelDataOctreeMemory& Memory, FVoxelDataSlabAllocator*& OutSlabAllocator)
+	{
+		checkVoxelSlow(MemorySize <= FVoxelDataSlabAllocator::GetBlockSize(Pool));
+		OutSlabAllocator = Memory.GetSlabAllocator();
+		if (OutSlabAllocator)
+		{
+			return OutSlabAllocator->Malloc(Pool);
+		}
+		else
+		{
+			return FMemory::Malloc(MemorySize);
+		}
+	}
+	FORCEINLINE static void Free(EVoxelDataSlabPool Pool, void* Ptr, FVoxelDataSlabAllocator* SlabAllocator)
+	{
+		if (SlabAllocator)
+		{
+			SlabAllocator->Free(Pool, Ptr);
+		}
+		else
+		{
+			FMemory::Free(Ptr);
+		}
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
+// Stores the distinct values of a chunk once, with a bit-packed index into them per voxel
+// Used for chunks that aren't a single value but only have a handful of distinct values, eg edited materials
+// Indices are 1, 2, 4 or 8 bits so that they never straddle two words
+template<typename T>
+class TVoxelDataOctreeLeafPalette
+{
+public:
+	static constexpr int32 MaxNumEntries = 256;
+
+	TVoxelDataOctreeLeafPalette() = default;
+	~TVoxelDataOctreeLeafPalette()
+	{
+		ensureVoxelSlow(!DataPtr);
+	}
+
+	UE_NONCOPYABLE(TVoxelDataOctreeLeafPalette);
+
+public:
+	FORCEINLINE bool IsValid() const
+	{
+		return DataPtr != nullptr;
+	}
+	FORCEINLINE int32 GetAllocatedSize() const
+	{
+		return MemorySize;
+	}
+	FORCEINLINE int32 NumEntries() const
+	{
+		return NumPaletteEntries;
+	}
+
+	FORCEINLINE T Get(int32 Index) const
+	{
+		checkVoxelSlow(IsValid());
+		checkVoxelSlow(0 <= Index && Index < VOXELS_PER_DATA_CHUNK);
+
+		const uint32 BitIndex = uint32(Index) << BitsPerIndexLog2;
+		const uint32 Word = GetIndices()[BitIndex / 32];
+		const uint32 Mask = (1u << (1u << BitsPerIndexLog2)) - 1;
+		const uint32 PaletteIndex = (Word >> (BitIndex % 32)) & Mask;
+		checkVoxelSlow(PaletteIndex < NumPaletteEntries);
+
+		return GetPalette()[PaletteIndex];
+	}
+	void CopyTo(T* RESTRICT DestPtr) const
+	{
+		checkVoxelSlow(IsValid());
+		for (int32 Index = 0; Index < VOXELS_PER_DATA_CHUNK; Index++)
+		{
+			DestPtr[Index] = Get(Index);
+		}
+	}
+
+public:
+	// Will fail if there are too many distinct values, or if the palette wouldn't be smaller than MaxMemorySize
+	bool TryCreate(const T* RESTRICT Data, int32 MaxMemorySize, bool bDirty, const IVoxelDataOctreeMemory& Memory)
+	{
+		VOXEL_SLOW_FUNCTION_COUNTER();
+		check(!DataPtr);
+
+		TVoxelStaticArray<T, MaxNumEntries> Palette;
+		TVoxelStaticArray<uint8, VOXELS_PER_DATA_CHUNK> PaletteIndices;
+
+		// Open addressing, 0 = empty slot, else palette index + 1
+		constexpr uint32 HashTableSize = 2 * MaxNumEntries;
+		TVoxelStaticArray<uint16, HashTableSize> HashTable{ ForceInit };
+
+		int32 NewNumEntries = 0;
+		uint8 LastPaletteIndex = 0;
+		for (int32 Index = 0; Index < VOXELS_PER_DATA_CHUNK; Index++)
+		{
+			const T& Value = Data[Index];
+
+			// Neighbors along X are usually the same: skip the hash lookup
+			if (Index > 0 && Value == Palette[LastPaletteIndex])
+			{
+				PaletteIndices[Index] = LastPaletteIndex;
+				continue;
+			}
+
+			uint32 Slot = FCrc::MemCrc32(&Value, sizeof(T)) % HashTableSize;
+			while (true)
+			{
+				const uint16 Entry = HashTable[Slot];
+				if (Entry == 0)
+				{
+					if (NewNumEntries == MaxNumEntries)
+					{
+						return false;
+					}
+					Palette[NewNumEntries] = Value;
+					HashTable[Slot] = NewNumEntries + 1;
+					LastPaletteIndex = NewNumEntries;
+					NewNumEntries++;
+					break;
+				}
+				if (Palette[Entry - 1] == Value)
+				{
+					LastPaletteIndex = Entry - 1;
+					break;
+				}
+				Slot = (Slot + 1) % HashTableSize;
+			}
+			PaletteIndices[Index] = LastPaletteIndex;
+		}
+
+		const uint8 NewBitsPerIndexLog2 =
+			NewNumEntries <= 2 ? 0 :
+			NewNumEntries <= 4 ? 1 :
+			NewNumEntries <= 16 ? 2 : 3;
+
+		const int32 NewIndicesSize = (VOXELS_PER_DATA_CHUNK << NewBitsPerIndexLog2) / 8;
+		const int32 NewMemorySize = NewIndicesSize + NewNumEntries * sizeof(T);
+		if (NewMemorySize >= MaxMemorySize)
+		{
+			return false;
+		}
+
+		BitsPerIndexLog2 = NewBitsPerIndexLog2;
+		NumPaletteEntries = NewNumEntries;
+		Allocate(NewMemorySize, bDirty, Memory);
+
+		uint32* RESTRICT Indices = GetIndices();
+		FMemory::Memzero(Indices, NewIndicesSize);
+		for (int32 Index = 0; Index < VOXELS_PER_DATA_CHUNK; Index++)
+		{
+			const uint32 BitIndex = uint32(Index) << BitsPerIndexLog2;
+			Indices[BitIndex / 32] |= uint32(PaletteIndices[Index]) << (BitIndex % 32);
+		}
+		FMemory::Memcpy(GetPalette(), Palette.GetData(), NewNumEntries * sizeof(T));
+
+		return true;
+	}
+	void CreateFrom(const TVoxelDataOctreeLeafPalette& Source, bool bDirty, const IVoxelDataOctreeMemory& Memory)
+	{
+		check(!DataPtr && Source.DataPtr);
+		BitsPerIndexLog2 = Source.BitsPerIndexLog2;
+		NumPaletteEntries = Source.NumPaletteEntries;
+		Allocate(Source.MemorySize, bDirty, Memory);
+		FMemory::Memcpy(DataPtr, Source.DataPtr, MemorySize);
+	}
+	void Destroy(bool bDirty, const IVoxelDataOctreeMemory& Memory)
+	{
+		VOXEL_SLOW_FUNCTION_COUNTER();
+
+		check(DataPtr);
+		FMemory::Free(DataPtr);
+		DataPtr = nullptr;
+
+		TVoxelDataOctreeLeafMemoryUsage<T>::Decrease(MemorySize, bDirty, Memory);
+
+		MemorySize = 0;
+		NumPaletteEntries = 0;
+		BitsPerIndexLog2 = 0;
+	}
+
+private:
+	// Indices are first to keep them aligned, then the palette
+	uint8* RESTRICT DataPtr = nullptr;
+	int32 MemorySize = 0;
+	uint16 NumPaletteEntries = 0;
+	uint8 BitsPerIndexLog2 = 0;
+
+	static_assert((VOXELS_PER_DATA_CHUNK / 8) % sizeof(uint32) == 0, "");
+	static_assert(alignof(T) <= alignof(uint32), "");
+
+	FORCEINLINE uint32* GetIndices() const
+	{
+		return reinterpret_cast<uint32*>(DataPtr);
+	}
+	FORCEINLINE T* GetPalette() const
+	{
+		return reinterpret_cast<T*>(DataPtr + (VOXELS_PER_DATA_CHUNK << BitsPerIndexLog2) / 8);
+	}
+
+	void Allocate(int32 NewMemorySize, bool bDirty, const IVoxelDataOctreeMemory& Memory)
+	{
+		VOXEL_SLOW_FUNCTION_COUNTER();
+
+		check(!DataPtr);
+		MemorySize = NewMemorySize;
+		DataPtr = static_cast<uint8*>(FMemory::Malloc(MemorySize));
+
+		TVoxelDataOctreeLeafMemoryUsage<T>::Increase(MemorySize, bDirty, Memory);
+	}
+};
+
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
+
 template<typename T>
 class TVoxelDataOctreeLeafData;
 
@@ -72,9 +299,12 @@ template<>
 class TVoxelDataOctreeLeafData<FVoxelValue>
 {
 	FVoxelValue* RESTRICT DataPtr = nullptr;
+	TVoxelDataOctreeLeafPalette<FVoxelValue> Palette;
 	FVoxelValue SingleValue;
 	bool bIsSingleValue = false;
 	bool bDirty = false;
+	// Allocator DataPtr comes from, null if allocated with FMemory
+	FVoxelDataSlabAllocator* SlabAllocator = nullptr;
 
 	static constexpr int32 MemorySize = VOXELS_PER_DATA_CHUNK * sizeof(FVoxelValue);
 
@@ -85,7 +315,7 @@ public:
 	TVoxelDataOctreeLeafData() = default;
 	~TVoxelDataOctreeLeafData()
 	{
-		if (!ensureVoxelSlow(!DataPtr))
+		if (!ensureVoxelSlow(!DataPtr && !Palette.IsValid()))
 		{
 			ClearData(IVoxelDataOctreeMemory());
 		}
@@ -117,6 +347,11 @@ public:
 			TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Decrease(MemorySize, bOldDirty, Memory);
 			TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Increase(MemorySize, bNewDirty, Memory);
 		}
+		if (Palette.IsValid())
+		{
+			TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Decrease(Palette.GetAllocatedSize(), bOldDirty, Memory);
+			TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Increase(Palette.GetAllocatedSize(), bNewDirty, Memory);
+		}
 	}
 
 public:
@@ -151,6 +386,10 @@ public:
 				Allocate(Memory);
 				FMemory::Memcpy(DataPtr, Source.DataPtr, MemorySize);
 			}
+			else if (Source.Palette.IsValid())
+			{
+				Palette.CreateFrom(Source.Palette, bDirty, Memory);
+			}
 		}
 		CheckState();
 	}
@@ -163,6 +402,10 @@ public:
 		{
 			Deallocate(Memory);
 		}
+		if (Palette.IsValid())
+		{
+			Palette.Destroy(bDirty, Memory);
+		}
 		bIsSingleValue = false;
 		checkVoxelSlow(!HasData());
 		CheckState();
@@ -172,11 +415,11 @@ public:
 	// Used to determine if it's worth compressing or clearing the cache
 	FORCEINLINE bool HasAllocation() const
 	{
-		return DataPtr != nullptr;
+		return DataPtr || Palette.IsValid();
 	}
 	FORCEINLINE bool HasData() const
 	{
-		return DataPtr || bIsSingleValue;
+		return DataPtr || bIsSingleValue || Palette.IsValid();
 	}
 	
 public:
@@ -186,6 +429,10 @@ public:
 		{
 			TryCompressToSingleValue(Memory);
 		}
+		if (DataPtr)
+		{
+			TryCompressToPalette(Memory);
+		}
 	}
 
 public:
@@ -197,11 +444,14 @@ public:
 		{
 			return SingleValue;
 		}
-		else
+		else if (DataPtr)
 		{
-			checkVoxelSlow(DataPtr);
 			return DataPtr[Index];
 		}
+		else
+		{
+			return Palette.Get(Index);
+		}
 	}
 
 public:
@@ -213,6 +463,10 @@ public:
 		{
 			ExpandSingleValue(Memory);
 		}
+		else if (Palette.IsValid())
+		{
+			ExpandPalette(Memory);
+		}
 		CheckState();
 	}
 	FORCEINLINE FVoxelValue& GetRef(int32 Index)
@@ -234,10 +488,14 @@ public:
 				DestPtr[Index] = SingleValue;
 			}
 		}
-		else
+		else if (DataPtr)
 		{
 			FMemory::Memcpy(DestPtr, DataPtr, MemorySize);
 		}
+		else
+		{
+			Palette.CopyTo(DestPtr);
+		}
 	}
 
 public:
@@ -254,7 +512,7 @@ public:
 	void SetSingleValue(FVoxelValue InSingleValue)
 	{
 		CheckState();
-		check(!DataPtr && !bIsSingleValue);
+		check(!DataPtr && !bIsSingleValue && !Palette.IsValid());
 		bIsSingleValue = true;
 		SingleValue = InSingleValue;
 		CheckState();
@@ -294,11 +552,40 @@ public:
 		
 		CheckState();
 	}
+
+public:
+	FORCEINLINE bool IsPalette() const
+	{
+		return Palette.IsValid();
+	}
+	void ExpandPalette(const IVoxelDataOctreeMemory& Memory)
+	{
+		CheckState();
+		check(Palette.IsValid());
+
+		Allocate(Memory);
+		Palette.CopyTo(DataPtr);
+		Palette.Destroy(bDirty, Memory);
+		CheckState();
+	}
+	void TryCompressToPalette(const IVoxelDataOctreeMemory& Memory)
+	{
+		CheckState();
+		check(DataPtr);
+
+		if (!Palette.TryCreate(DataPtr, MemorySize, bDirty, Memory))
+		{
+			return;
+		}
+
+		Deallocate(Memory);
+		CheckState();
+	}
 	
 private:
 	FORCEINLINE void CheckState() const
 	{
-		checkVoxelSlow(!(DataPtr && bIsSingleValue));
+		checkVoxelSlow(int32(DataPtr != nullptr) + int32(bIsSingleValue) + int32(Palette.IsValid()) <= 1);
 		checkVoxelSlow(!bDirty || HasData());
 	}
 	FORCEINLINE static void CheckBounds(int32 Index)
@@ -311,8 +598,8 @@ private:
 	{
 		VOXEL_SLOW_FUNCTION_COUNTER();
 
-		check(!DataPtr && !bIsSingleValue);
-		DataPtr = static_cast<FVoxelValue*>(FMemory::Malloc(MemorySize));
+		check(!DataPtr && !bIsSingleValue && !Palette.IsValid());
+		DataPtr = static_cast<FVoxelValue*>(FVoxelDataOctreeLeafBuffer::Malloc(EVoxelDataSlabPool::Values, MemorySize, Memory, SlabAllocator));
 		
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Increase(MemorySize, bDirty, Memory);
 	}
@@ -321,7 +608,7 @@ private:
 		VOXEL_SLOW_FUNCTION_COUNTER();
 
 		check(DataPtr);
-		FMemory::Free(DataPtr);
+		FVoxelDataOctreeLeafBuffer::Free(EVoxelDataSlabPool::Values, DataPtr, SlabAllocator);
 		DataPtr = nullptr;
 		
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelValue>::Decrease(MemorySize, bDirty, Memory);
@@ -341,11 +628,15 @@ class TVoxelDataOctreeLeafData<FVoxelMaterial>
 	TVoxelStaticArray<uint8, NumChannels> Channels_SingleValue{ ForceInit };
 	
 	FVoxelMaterial* RESTRICT Main_DataPtr = nullptr;
+	TVoxelDataOctreeLeafPalette<FVoxelMaterial> Palette;
 	// If set, implies the data stored in Channels is valid
 	// If Channels_DataPtr[I] is null, then Channels_SingleValue[I] is valid
 	// Data in Channels is assumed constant: compression won't try to compress it again
 	bool bUseChannels = false;
 	bool bDirty = false;
+	// Allocator Main_DataPtr and Channels_DataPtr come from, null if allocated with FMemory
+	// All the buffers of a voxel data come from the same place, so a single pointer is enough
+	FVoxelDataSlabAllocator* SlabAllocator = nullptr;
 
 	friend class FVoxelSaveBuilder;
 	friend class FVoxelSaveLoader;
@@ -354,7 +645,7 @@ public:
 	TVoxelDataOctreeLeafData() = default;
 	~TVoxelDataOctreeLeafData()
 	{
-		bool bClear = !ensureVoxelSlow(!Main_DataPtr);
+		bool bClear = !ensureVoxelSlow(!Main_DataPtr && !Palette.IsValid());
 		for (auto& DataPtr : Channels_DataPtr)
 		{
 			bClear |= !ensureVoxelSlow(!DataPtr);
@@ -405,6 +696,11 @@ public:
 				TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Decrease(Main_MemorySize, bOldDirty, Memory);
 				TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Increase(Main_MemorySize, bNewDirty, Memory);
 			}
+			if (Palette.IsValid())
+			{
+				TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Decrease(Palette.GetAllocatedSize(), bOldDirty, Memory);
+				TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Increase(Palette.GetAllocatedSize(), bNewDirty, Memory);
+			}
 		}
 	}
 
@@ -430,6 +726,7 @@ public:
 		bUseChannels = Source.bUseChannels;
 		if (Source.bUseChannels)
 		{
+			Channels_SingleValue = Source.Channels_SingleValue;
 			for (int32 Channel = 0; Channel < NumChannels; Channel++)
 			{
 				auto* SourceDataPtr = Source.Channels_DataPtr[Channel];
@@ -446,8 +743,13 @@ public:
 		{
 			if (Source.Main_DataPtr)
 			{
+				Main_Allocate(Memory);
 				FMemory::Memcpy(Main_DataPtr, Source.Main_DataPtr, Main_MemorySize);
 			}
+			else if (Source.Palette.IsValid())
+			{
+				Palette.CreateFrom(Source.Palette, bDirty, Memory);
+			}
 		}
 		CheckState();
 	}
@@ -472,6 +774,10 @@ public:
 			{
 				Main_Deallocate(Memory);
 			}
+			if (Palette.IsValid())
+			{
+				Palette.Destroy(bDirty, Memory);
+			}
 		}
 		bUseChannels = false;
 		checkVoxelSlow(!HasData());
@@ -495,12 +801,12 @@ public:
 		}
 		else
 		{
-			return Main_DataPtr != nullptr;
+			return Main_DataPtr || Palette.IsValid();
 		}
 	}
 	FORCEINLINE bool HasData() const
 	{
-		return bUseChannels || Main_DataPtr;
+		return bUseChannels || Main_DataPtr || Palette.IsValid();
 	}
 	
 public:
@@ -510,6 +816,7 @@ public:
 		
 		if (bUseChannels || !Main_DataPtr)
 		{
+			// Channels and palettes are not compressed again
 			return;
 		}
 		
@@ -532,10 +839,27 @@ public:
 			if (DoNotCompressChannel == DoNotCompressAnyChannel)
 			{
 				// Fast path if all channels are different
-				return;
+				break;
 			}
 		}
-		checkVoxelSlow(DoNotCompressChannel != DoNotCompressAnyChannel);
+
+		// Use a palette if it's smaller than the channels we would have to allocate
+		const int32 ChannelsMemorySize =
+			DoNotCompressChannel == DoNotCompressAnyChannel
+			? Main_MemorySize
+			: FMath::CountBits(DoNotCompressChannel) * Channels_MemorySize;
+
+		if (ChannelsMemorySize > 0 && Palette.TryCreate(Main_DataPtr, ChannelsMemorySize, bDirty, Memory))
+		{
+			Main_Deallocate(Memory);
+			CheckState();
+			return;
+		}
+
+		if (DoNotCompressChannel == DoNotCompressAnyChannel)
+		{
+			return;
+		}
 
 		// Create channels
 		for (int32 Channel = 0; Channel < NumChannels; Channel++)
@@ -575,11 +899,14 @@ public:
 		{
 			return GetFromChannels(Index);
 		}
-		else
+		else if (Main_DataPtr)
 		{
-			checkVoxelSlow(Main_DataPtr);
 			return Main_DataPtr[Index];
 		}
+		else
+		{
+			return Palette.Get(Index);
+		}
 	}
 
 public:
@@ -609,7 +936,13 @@ public:
 			}
 			bUseChannels = false;
 		}
-		checkVoxelSlow(!bUseChannels);
+		else if (Palette.IsValid())
+		{
+			Main_Allocate(Memory);
+			Palette.CopyTo(Main_DataPtr);
+			Palette.Destroy(bDirty, Memory);
+		}
+		checkVoxelSlow(!bUseChannels && Main_DataPtr);
 		checkVoxelSlow(HasData());
 		CheckState();
 	}
@@ -643,17 +976,26 @@ public:
 				DestPtr[Index] = GetFromChannels(Index);
 			}
 		}
-		else
+		else if (Main_DataPtr)
 		{
-			checkVoxelSlow(Main_DataPtr);
 			FMemory::Memcpy(DestPtr, Main_DataPtr, Main_MemorySize);
 		}
+		else
+		{
+			Palette.CopyTo(DestPtr);
+		}
+	}
+
+public:
+	FORCEINLINE bool IsPalette() const
+	{
+		return Palette.IsValid();
 	}
 	
 private:
 	FORCEINLINE void CheckState() const
 	{
-		checkVoxelSlow(!(Main_DataPtr && bUseChannels));
+		checkVoxelSlow(int32(Main_DataPtr != nullptr) + int32(bUseChannels) + int32(Palette.IsValid()) <= 1);
 		checkVoxelSlow(!bDirty || HasData());
 	}
 	FORCEINLINE static void CheckBounds(int32 Index)
@@ -690,7 +1032,7 @@ private:
 		VOXEL_SLOW_FUNCTION_COUNTER();
 		
 		check(!Main_DataPtr);
-		Main_DataPtr = static_cast<FVoxelMaterial*>(FMemory::Malloc(Main_MemorySize));
+		Main_DataPtr = static_cast<FVoxelMaterial*>(FVoxelDataOctreeLeafBuffer::Malloc(EVoxelDataSlabPool::Materials, Main_MemorySize, Memory, SlabAllocator));
 
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Increase(Main_MemorySize, bDirty, Memory);
 	}
@@ -699,18 +1041,18 @@ private:
 		VOXEL_SLOW_FUNCTION_COUNTER();
 
 		check(Main_DataPtr);
-		FMemory::Free(Main_DataPtr);
+		FVoxelDataOctreeLeafBuffer::Free(EVoxelDataSlabPool::Materials, Main_DataPtr, SlabAllocator);
 		Main_DataPtr = nullptr;
 
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Decrease(Main_MemorySize, bDirty, Memory);
 	}
 	
-	void Channels_Allocate(uint8* RESTRICT& DataPtr, const IVoxelDataOctreeMemory& Memory) const
+	void Channels_Allocate(uint8* RESTRICT& DataPtr, const IVoxelDataOctreeMemory& Memory)
 	{
 		VOXEL_SLOW_FUNCTION_COUNTER();
 
 		check(!DataPtr);
-		DataPtr = static_cast<uint8*>(FMemory::Malloc(Channels_MemorySize));
+		DataPtr = static_cast<uint8*>(FVoxelDataOctreeLeafBuffer::Malloc(EVoxelDataSlabPool::MaterialChannels, Channels_MemorySize, Memory, SlabAllocator));
 
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Increase(Channels_MemorySize, bDirty, Memory);
 	}
@@ -719,7 +1061,7 @@ private:
 		VOXEL_SLOW_FUNCTION_COUNTER();
 
 		check(DataPtr);
-		FMemory::Free(DataPtr);
+		FVoxelDataOctreeLeafBuffer::Free(EVoxelDataSlabPool::MaterialChannels, DataPtr, SlabAllocator);
 		DataPtr = nullptr;
 
 		TVoxelDataOctreeLeafMemoryUsage<FVoxelMaterial>::Decrease(Channels_MemorySize, bDirty, Memory);
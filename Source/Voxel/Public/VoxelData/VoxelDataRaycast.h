@@ -0,0 +1,53 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelVector.h"
+#include "VoxelIntBox.h"
+#include "VoxelMaterial.h"
+
+class FVoxelData;
+
+// In voxel space
+struct FVoxelDataRay
+{
+	FVoxelVector Start = FVoxelVector(ForceInit);
+	// Must be normalized
+	FVoxelVector Direction = FVoxelVector::ForwardVector;
+	v_flt MaxDistance = 0;
+};
+
+// In voxel space
+struct FVoxelDataRayHit
+{
+	bool bHit = false;
+	// Distance from the ray start
+	v_flt Distance = 0;
+	FVoxelVector Position = FVoxelVector(ForceInit);
+	// Gradient of the values at the hit position. Points outside of the surface
+	FVector Normal = FVector::UpVector;
+	// Material of the voxel closest to the hit position
+	FVoxelMaterial Material = FVoxelMaterial::Default();
+};
+
+/**
+ * Ray traversal of the voxel data, independent of the render chunks & of their collisions
+ * The surface hit is the one the marching cubes mesher would build: the rays stop where the trilinear interpolation of the values becomes <= 0
+ *
+ * The empty space is skipped hierarchically: boxes whose value range is empty, be it from single value leaves
+ * or from the generator GetValueRange, are not traversed. Blocks of DATA_CHUNK_SIZE cells that might contain the surface
+ * are queried at once and traversed cell by cell
+ */
+namespace FVoxelDataRaycast
+{
+	// Bounds to read lock to use Raycast on Ray
+	VOXEL_API FVoxelIntBox GetBoundsToLock(const FVoxelData& Data, const FVoxelDataRay& Ray);
+
+	// Requires read lock on GetBoundsToLock(Ray). Thread safe
+	VOXEL_API FVoxelDataRayHit Raycast(const FVoxelData& Data, const FVoxelDataRay& Ray);
+
+	// Locks the data. Thread safe
+	VOXEL_API void RaycastBatch(const FVoxelData& Data, TArrayView<const FVoxelDataRay> Rays, TArray<FVoxelDataRayHit>& OutHits, bool bMultiThreaded = true);
+}
@@ -0,0 +1,119 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Data Slabs Overhead Memory"), STAT_VoxelDataSlabsOverheadMemory, STATGROUP_VoxelMemory, VOXEL_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Voxel Data Slabs Count"), STAT_VoxelDataSlabsCount, STATGROUP_VoxelCounters, VOXEL_API);
+
+// The fixed size blocks allocated by the data octree
+enum class EVoxelDataSlabPool : uint8
+{
+	// VOXELS_PER_DATA_CHUNK FVoxelValue
+	Values,
+	// VOXELS_PER_DATA_CHUNK FVoxelMaterial
+	Materials,
+	// VOXELS_PER_DATA_CHUNK uint8, used by single channel material buffers
+	MaterialChannels,
+	// 8 FVoxelDataOctreeLeaf
+	LeafChildren,
+	// 8 FVoxelDataOctreeParent
+	ParentChildren,
+
+	Num
+};
+
+// Slab allocator owned by a FVoxelData, used for the leaves buffers and the octree nodes
+// Each pool carves identically sized blocks out of large slabs, and recycles freed blocks through a free list
+// This avoids fragmenting the heap when editing or clearing the cache of large worlds, as all the blocks of a world
+// live in a few large allocations that are returned to the OS once empty
+//
+// Each pool is split in shards with their own slabs and lock, picked by the allocating thread:
+// threads allocating in parallel (eg when caching values for meshing) don't contend on a single lock.
+// Blocks are freed in the shard of their slab
+//
+// Palettes have variable sizes and are still allocated through FMemory
+class VOXEL_API FVoxelDataSlabAllocator
+{
+public:
+	// Returns null if disabled by voxel.data.SlabAllocator
+	static TUniquePtr<FVoxelDataSlabAllocator> Create();
+
+	FVoxelDataSlabAllocator(bool bUseHugePages, int32 NumShards);
+	~FVoxelDataSlabAllocator();
+
+	UE_NONCOPYABLE(FVoxelDataSlabAllocator);
+
+public:
+	void* Malloc(EVoxelDataSlabPool Pool);
+	void Free(EVoxelDataSlabPool Pool, void* Ptr);
+
+	static int32 GetBlockSize(EVoxelDataSlabPool Pool);
+
+public:
+	struct FStats
+	{
+		int32 NumSlabs = 0;
+		int64 NumBlocks = 0;
+		// Memory allocated for the slabs
+		int64 AllocatedMemory = 0;
+		// Memory used by live blocks
+		int64 UsedMemory = 0;
+	};
+	FStats GetStats() const;
+
+private:
+	struct FSlab
+	{
+		uint8* Data = nullptr;
+		// Shard owning this slab
+		int32 ShardIndex = 0;
+		// Allocated blocks
+		int32 NumUsed = 0;
+		// Blocks are carved lazily so that the pages of a new slab are only touched when used
+		int32 NumCarved = 0;
+		// Index in FShard::PartialSlabs, -1 if full
+		int32 PartialIndex = -1;
+		void* FreeList = nullptr;
+		// Mapped directly from the OS to use huge pages
+		bool bMapped = false;
+	};
+	struct FShard
+	{
+		mutable FCriticalSection Section;
+
+		// Slabs with free or not yet carved blocks
+		TArray<FSlab*> PartialSlabs;
+		// Empty slabs are kept around to avoid thrashing when a single block is allocated & freed repeatedly
+		int32 NumEmptySlabs = 0;
+		int64 NumUsedBlocks = 0;
+
+		// Avoid false sharing between the shards locks
+		uint8 Padding[PLATFORM_CACHE_LINE_SIZE];
+	};
+	struct FPool
+	{
+		int32 BlockSize = 0;
+		int32 BlocksPerSlab = 0;
+
+		// Only write locked when adding or removing slabs
+		mutable FRWLock SlabsLock;
+		// Sorted by Data, to find the slab of a block when freeing it
+		TArray<FSlab*> Slabs;
+
+		TArray<TUniquePtr<FShard>> Shards;
+	};
+
+	const bool bUseHugePages;
+	const int64 SlabSize;
+	TVoxelStaticArray<FPool, int32(EVoxelDataSlabPool::Num)> Pools;
+
+	int32 GetShardIndex() const;
+
+	// Requires the shard lock
+	FSlab* AllocateSlab(FPool& Pool, int32 ShardIndex) const;
+	// Slab must be removed from the pool, or the allocator being destroyed
+	void FreeSlab(FPool& Pool, FSlab* Slab) const;
+};
@@ -0,0 +1,98 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelData/IVoxelData.h"
+#include "VoxelData/VoxelDataOctreeLeafData.h"
+#include "VoxelPlaceableItems/VoxelPlaceableItem.h"
+
+class FVoxelData;
+class FVoxelDataOctreeLeaf;
+struct FVoxelObjectArchiveEntry;
+struct FVoxelUncompressedWorldSaveImpl;
+
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Data Snapshots Memory"), STAT_VoxelDataSnapshotsMemory, STATGROUP_VoxelMemory, VOXEL_API);
+
+/**
+ * Frozen view of the dirty data of a FVoxelData, created by FVoxelData::CreateSnapshot
+ *
+ * Creating a snapshot only records the leaves of the octree: their data is shared with the live octree.
+ * The first time a leaf is write locked after the snapshot was created, its dirty data is copied into the snapshot
+ * before being modified. Readers of the snapshot thus see the data as it was when the snapshot was created,
+ * while edits continue on the live data.
+ *
+ * Only dirty data is captured: non-dirty data is a cache of the generator, and is reported as not dirty.
+ * Leaves created after the snapshot are not part of it.
+ *
+ * The snapshot keeps the voxel data alive. Destroying it frees the captured copies.
+ */
+class VOXEL_API FVoxelDataSnapshot
+{
+public:
+	~FVoxelDataSnapshot();
+
+	UE_NONCOPYABLE(FVoxelDataSnapshot);
+
+	const FVoxelData& GetData() const { return *Data; }
+	const TArray<FVoxelAssetItem>& GetAssetItems() const { return AssetItems; }
+
+	int32 NumLeaves() const { return Entries.Num(); }
+	// Number of leaves copied because they were edited since the snapshot was created
+	int32 NumCapturedLeaves() const { return NumCaptured.GetValue(); }
+
+	/**
+	 * Iterate the leaves of the snapshot, in octree order. LeafIndex is between 0 and NumLeaves()
+	 * Each leaf is read locked while Apply is called on it: Apply must not lock the data
+	 * The buffers passed to Apply are only valid during the call
+	 */
+	using FIterateLeavesFunction = TFunctionRef<void(int32 LeafIndex, const FIntVector& Position, const TVoxelDataOctreeLeafData<FVoxelValue>& Values, const TVoxelDataOctreeLeafData<FVoxelMaterial>& Materials)>;
+	void IterateLeaves(FIterateLeavesFunction Apply) const;
+	// Same as IterateLeaves, but Apply is called from multiple threads in any order
+	void ParallelIterateLeaves(FIterateLeavesFunction Apply) const;
+
+	// Get a save of the data at the time the snapshot was created. No lock required
+	void GetSave(FVoxelUncompressedWorldSaveImpl& OutSave, TArray<FVoxelObjectArchiveEntry>& OutObjects) const;
+
+private:
+	explicit FVoxelDataSnapshot(const FVoxelData& Data);
+
+	struct FCapturedLeaf
+	{
+		TVoxelDataOctreeLeafData<FVoxelValue> Values;
+		TVoxelDataOctreeLeafData<FVoxelMaterial> Materials;
+	};
+	struct FEntry
+	{
+		FIntVector Position;
+		FVoxelIntBox Bounds;
+		// Only valid until the leaf is captured: the live octree might be destroyed afterwards
+		const FVoxelDataOctreeLeaf* Leaf = nullptr;
+		// Set when the live leaf is about to be modified
+		TUniquePtr<FCapturedLeaf> Captured;
+	};
+
+	const TVoxelSharedRef<const FVoxelData> Data;
+	// Memory of the captured copies, separate from the data octree memory
+	IVoxelDataOctreeMemory Memory;
+
+	TArray<FEntry> Entries;
+	// Leaf position to entry index. Immutable once the snapshot is created
+	TMap<FIntVector, int32> PositionToEntry;
+	TArray<FVoxelAssetItem> AssetItems;
+
+	// Captures are serialized by FVoxelData::SnapshotsSection
+	FThreadSafeCounter NumCaptured;
+	// Memory reported to STAT_VoxelDataSnapshotsMemory
+	int64 ReportedMemory = 0;
+
+	// Leaf must be write locked, or the data main lock must be write locked
+	void IterateLeaf(int32 LeafIndex, FIterateLeavesFunction Apply) const;
+
+	void CaptureLeaf(const FVoxelDataOctreeLeaf& Leaf);
+	void CaptureAll();
+	void UpdateStats();
+
+	friend class FVoxelData;
+};
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "VoxelValue.h"
 #include "VoxelMaterial.h"
+#include "VoxelIntBox.h"
 #include "VoxelSaveStruct.h"
 #include "VoxelObjectArchive.h"
 #include "VoxelSave.generated.h"
@@ -32,6 +33,8 @@ namespace FVoxelSaveVersion
 		SHARED_StoreSpawnerMatricesRelativeToComponent,
 		StoreMaterialChannelsIndividuallyAndRemoveFoliage,
 		ProperlySerializePlaceableItemsObjects,
+		RegionIndexedSaves,
+		FilteredSaveBuffers,
 		
 		// -----<new versions can be added above this line>-------------------------------------------------
 		VersionPlusOne,
@@ -163,15 +166,61 @@ private:
 
 	friend class FVoxelSaveBuilder;
 	friend class FVoxelSaveLoader;
+	friend class FVoxelSaveRegionUtilities;
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
+// A part of a region indexed save that can be decompressed on its own
+struct FVoxelSaveRegion
+{
+	// Bounds of the region. Chunks belong to the region containing their min
+	FVoxelIntBox Bounds;
+	// Location of the region compressed save in the save CompressedData
+	int32 Offset = 0;
+	int32 Size = 0;
+	int32 NumChunks = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FVoxelSaveRegion& Region)
+	{
+		Ar << Region.Bounds;
+		Ar << Region.Offset;
+		Ar << Region.Size;
+		Ar << Region.NumChunks;
+		return Ar;
+	}
+};
+
 struct VOXEL_API FVoxelCompressedWorldSaveImpl
 {
 	FVoxelCompressedWorldSaveImpl() = default;
+	FVoxelCompressedWorldSaveImpl(const FVoxelCompressedWorldSaveImpl& Other)
+		: Version(Other.Version)
+		, Guid(Other.Guid)
+		, Depth(Other.Depth)
+		, CompressedData(Other.CompressedData)
+		, RegionSize(Other.RegionSize)
+		, ItemsRegion(Other.ItemsRegion)
+		, Regions(Other.Regions)
+	{
+		// Not copying AllocatedSize, as it's not accounted for in the stats yet
+		UpdateAllocatedSize();
+	}
+	FVoxelCompressedWorldSaveImpl& operator=(const FVoxelCompressedWorldSaveImpl& Other)
+	{
+		Version = Other.Version;
+		Guid = Other.Guid;
+		Depth = Other.Depth;
+		CompressedData = Other.CompressedData;
+		RegionSize = Other.RegionSize;
+		ItemsRegion = Other.ItemsRegion;
+		Regions = Other.Regions;
+		// Keep our own AllocatedSize, as it's what is accounted for in the stats
+		UpdateAllocatedSize();
+		return *this;
+	}
 	~FVoxelCompressedWorldSaveImpl();
 
 	int32 GetDepth() const
@@ -179,6 +228,29 @@ struct VOXEL_API FVoxelCompressedWorldSaveImpl
 		return Depth;
 	}
 
+	/**
+	 * Region indexed saves store the chunks grouped in spatial regions that are compressed independently
+	 * This allows to only decompress & load the regions around the invokers, see FVoxelData::LoadFromSave
+	 */
+	bool IsRegionIndexed() const
+	{
+		return RegionSize > 0;
+	}
+	int32 GetRegionSize() const
+	{
+		return RegionSize;
+	}
+	// Regions with chunks, sorted by position
+	const TArray<FVoxelSaveRegion>& GetRegions() const
+	{
+		return Regions;
+	}
+	// Region holding the placeable items, and no chunks
+	const FVoxelSaveRegion& GetItemsRegion() const
+	{
+		return ItemsRegion;
+	}
+
 	bool operator==(const FVoxelCompressedWorldSaveImpl& Other) const
 	{
 		return Guid == Other.Guid;
@@ -193,6 +265,11 @@ private:
 	int32 Depth = -1;
 	TArray<uint8> CompressedData;
 
+	// 0 if not region indexed
+	int32 RegionSize = 0;
+	FVoxelSaveRegion ItemsRegion;
+	TArray<FVoxelSaveRegion> Regions;
+
 	mutable int64 AllocatedSize = 0;
 
 	friend class UVoxelSaveUtilities;
@@ -57,6 +57,8 @@ public:
 		const IVoxelDataOctreeMemory& Memory,
 		TVoxelDataOctreeLeafData<FVoxelValue>& OutValues,
 		TVoxelDataOctreeLeafData<FVoxelMaterial>& OutMaterials) const;
+	void ExtractValues(int32 ChunkIndex, const IVoxelDataOctreeMemory& Memory, TVoxelDataOctreeLeafData<FVoxelValue>& OutValues) const;
+	void ExtractMaterials(int32 ChunkIndex, const IVoxelDataOctreeMemory& Memory, TVoxelDataOctreeLeafData<FVoxelMaterial>& OutMaterials) const;
 	
 	void GetPlaceableItems(const FVoxelPlaceableItemLoadInfo& LoadInfo, TArray<FVoxelAssetItem>& OutAssetItems);
 
@@ -79,6 +81,50 @@ private:
 	bool bError = false;
 };
 
+// Split & merge uncompressed saves, used by region indexed saves
+class VOXEL_API FVoxelSaveRegionUtilities
+{
+public:
+	/**
+	 * Group the chunks of a save in cubic regions
+	 * @param	RegionSize			Size of the regions in voxels. Must be a multiple of DATA_CHUNK_SIZE
+	 * @param	OutRegionsBounds	The bounds of the regions with chunks, sorted by position
+	 * @param	OutRegionsChunks	The chunks indices of each region, in the same order as in the save
+	 */
+	static void GroupChunksByRegion(
+		const FVoxelUncompressedWorldSaveImpl& Save,
+		int32 RegionSize,
+		TArray<FVoxelIntBox>& OutRegionsBounds,
+		TArray<TArray<int32>>& OutRegionsChunks);
+	
+	// Copy some chunks of a save into a new save. If bCopyPlaceableItems, also copies the placeable items
+	static void CopyChunks(
+		const FVoxelUncompressedWorldSaveImpl& Save,
+		TConstArrayView<int32> ChunkIndices,
+		bool bCopyPlaceableItems,
+		FVoxelUncompressedWorldSaveImpl& OutSave);
+
+	// Merge parts of the same save. The chunks are sorted in octree order, as expected by FVoxelData::LoadFromSave
+	static void Merge(
+		TConstArrayView<const FVoxelUncompressedWorldSaveImpl*> Saves,
+		FVoxelUncompressedWorldSaveImpl& OutSave);
+
+	// Add the chunks of Save that are not already in OutSave
+	static void AddMissingChunks(
+		const FVoxelUncompressedWorldSaveImpl& Save,
+		FVoxelUncompressedWorldSaveImpl& OutSave);
+
+private:
+	static void Init(
+		const FVoxelUncompressedWorldSaveImpl& Save,
+		FVoxelUncompressedWorldSaveImpl& OutSave);
+	static void SortChunks(FVoxelUncompressedWorldSaveImpl& Save);
+	static void AppendChunks(
+		const FVoxelUncompressedWorldSaveImpl& Save,
+		TConstArrayView<int32> ChunkIndices,
+		FVoxelUncompressedWorldSaveImpl& OutSave);
+};
+
 UCLASS()
 class VOXEL_API UVoxelSaveUtilities : public UBlueprintFunctionLibrary
 {
@@ -92,4 +138,21 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Voxel|Data|Save")
 	static bool DecompressVoxelSave(const FVoxelCompressedWorldSave& CompressedSave, FVoxelUncompressedWorldSave& OutUncompressedSave);
 	static bool DecompressVoxelSave(const FVoxelCompressedWorldSaveImpl& CompressedSave, FVoxelUncompressedWorldSaveImpl& OutUncompressedSave);
+
+public:
+	/**
+	 * Compress a save as a region indexed save. CompressVoxelSave does so if voxel.data.SaveRegionSize is not 0
+	 * @param	RegionSize		Size of the regions in voxels. Rounded up to a multiple of DATA_CHUNK_SIZE
+	 */
+	static void CompressVoxelSaveByRegions(const FVoxelUncompressedWorldSaveImpl& UncompressedSave, FVoxelCompressedWorldSaveImpl& OutCompressedSave, int32 RegionSize);
+
+	/**
+	 * Decompress some regions of a region indexed save
+	 * @param	RegionIndices				Indices in CompressedSave.GetRegions()
+	 * @param	bDecompressPlaceableItems	Whether to also decompress the items region
+	 */
+	static bool DecompressVoxelSaveRegions(const FVoxelCompressedWorldSaveImpl& CompressedSave, TConstArrayView<int32> RegionIndices, FVoxelUncompressedWorldSaveImpl& OutUncompressedSave, bool bDecompressPlaceableItems = true);
+	
+	// Get the indices of the regions intersecting Bounds
+	static void GetSaveRegionsInBounds(const FVoxelCompressedWorldSaveImpl& CompressedSave, const FVoxelIntBox& Bounds, TArray<int32>& OutRegionIndices);
 };
\ No newline at end of file
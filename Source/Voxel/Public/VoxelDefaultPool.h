@@ -9,11 +9,13 @@
 class VOXEL_API FVoxelDefaultPool : public IVoxelPool
 {
 public:
+	// NumEditThreads: threads created in addition to ThreadCount, only running the tasks in the EditChunksMeshing priority category
 	static TVoxelSharedRef<FVoxelDefaultPool> Create(
 		int32 ThreadCount,
 		bool bConstantPriorities,
 		const TMap<EVoxelTaskType, int32>& PriorityCategories,
-		const TMap<EVoxelTaskType, int32>& PriorityOffsets);
+		const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+		int32 NumEditThreads = 0);
 	virtual ~FVoxelDefaultPool();
 
 public:
@@ -22,6 +24,7 @@ public:
 	virtual void QueueTasks(EVoxelTaskType Type, const TArray<IVoxelQueuedWork*>& Tasks) override;
 
 	virtual int32 GetNumTasks() const override;
+	virtual void InvalidatePriorities() override;
 	//~ End IVoxelPool Interface
 	
 private:
@@ -33,7 +36,8 @@ private:
 		int32 ThreadCount,
 		bool bConstantPriorities,
 		const TMap<EVoxelTaskType, int32>& PriorityCategories,
-		const TMap<EVoxelTaskType, int32>& PriorityOffsets);
+		const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+		int32 NumEditThreads);
 
 public:
 	static void FixPriorityCategories(TMap<EVoxelTaskType, int32>& PriorityCategories);
@@ -172,4 +172,29 @@ enum class EVoxelDataItemCombineMode
 	Min,
 	Max,
 	Sum
-};
\ No newline at end of file
+};
+
+// Codec used to compress saves & assets. The codec is stored in the compressed data: data compressed with any codec can be decompressed
+UENUM(BlueprintType)
+enum class EVoxelCompressionCodec : uint8
+{
+	// Best compression ratio, slowest
+	Zlib,
+	// Several times faster than zlib to compress & decompress, but bigger data. Compression level is ignored
+	LZ4,
+	// Oodle Data, if available in the engine. Falls back to LZ4 otherwise
+	Oodle
+};
+
+// Reversible transform applied before compressing data, to make it more compressible
+UENUM(BlueprintType)
+enum class EVoxelCompressionFilter : uint8
+{
+	None,
+	// Delta encode the data as a stream of FVoxelValue, and split the bytes of the deltas in planes
+	// In saves, only applied to the value buffers
+	DeltaValues,
+	// Split the data as a stream of FVoxelMaterial in one plane per channel
+	// In saves, the material buffers are already stored per channel: each channel is delta encoded instead
+	SplitMaterialChannels
+};
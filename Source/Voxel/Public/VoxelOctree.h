@@ -231,11 +231,27 @@ protected:
 
 	template<typename... TArgs>
 	inline void CreateChildren(TArgs&&... Args)
-	{		
+	{
+		check(!HasChildren() && this->Height > 0);
+		CreateChildrenInPlace(FMemory::Malloc(GetChildrenMemorySize()), Forward<TArgs>(Args)...);
+	}
+	inline void DestroyChildren()
+	{
+		FMemory::Free(DestroyChildrenInPlace());
+	}
+
+	// Used by octrees with their own allocator for the children
+	inline uint32 GetChildrenMemorySize() const
+	{
+		return 8 * (this->Height == 1 ? sizeof(LeafType) : sizeof(ParentType));
+	}
+	template<typename... TArgs>
+	inline void CreateChildrenInPlace(void* Memory, TArgs&&... Args)
+	{
 		check(!HasChildren() && this->Height > 0);
+		check(Memory);
 
-		// TODO PERF: Specialized malloc call
-		Children = FMemory::Malloc(8 * (this->Height == 1 ? sizeof(LeafType) : sizeof(ParentType)));
+		Children = Memory;
 
 		for (int32 Index = 0; Index < 8 ; Index++)
 		{
@@ -251,7 +267,8 @@ protected:
 			}
 		}
 	}
-	inline void DestroyChildren()
+	// Returns the children memory, to be freed by the caller
+	inline void* DestroyChildrenInPlace()
 	{
 		check(HasChildren());
 
@@ -267,8 +284,9 @@ protected:
 			}
 		}
 
-		FMemory::Free(Children);
+		void* const Memory = Children;
 		Children = nullptr;
+		return Memory;
 	}
 
 private:
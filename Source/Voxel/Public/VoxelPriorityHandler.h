@@ -20,11 +20,14 @@ public:
 		FMemory::Free(Data);
 	}
 
-	void Set(const TArray<FIntVector>& Array)
+	// Returns true if the positions changed, in which case the priorities using them must be invalidated
+	bool Set(const TArray<FIntVector>& Array)
 	{
 		check(Array.Num() <= Max);
+		bool bChanged = Array.Num() != Num;
 		for (int32 Index = 0; Index < Array.Num(); Index++)
 		{
+			bChanged |= Index >= Num || Data[Index] != Array[Index];
 			Data[Index] = Array[Index];
 		}
 		// Make sure all the data is written before updating Num
@@ -32,6 +35,8 @@ public:
 		Num = Array.Num();
 		// Force Num update
 		FPlatformMisc::MemoryBarrier();
+
+		return bChanged;
 	}
 	FORCEINLINE int32 GetMax() const
 	{
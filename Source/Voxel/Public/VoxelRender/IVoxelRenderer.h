@@ -69,10 +69,20 @@ struct FVoxelRendererSettingsBase
 
 	const EVoxelRenderType RenderType;
 	const uint32 RenderSharpness;
+	const bool bGreedyCubicMeshing;
 	const bool bCreateMaterialInstances;
 	const bool bDitherChunks;
 	const float ChunksDitheringDuration;
 	const bool bOptimizeIndices;
+	const bool bPackVertices;
+
+	const bool bSimplifyMeshes;
+	const int32 SimplificationMinLOD;
+	const float SimplificationMaxError;
+	const TMap<int32, float> SimplificationMaxErrorPerLOD;
+
+	// -1 if disabled
+	const int32 IncrementalRemeshMaxLOD;
 
 	const int32 MaxDistanceFieldLOD;
 	const int32 DistanceFieldBoundsExtension;
@@ -116,6 +126,9 @@ public:
 		return FVector(Position + *WorldOffset) * VoxelSize;
 	}
 
+	// In voxels of the chunk LOD. 0 if chunks of this LOD shouldn't be simplified
+	float GetSimplificationMaxError(int32 LOD) const;
+
 	UMaterialInterface* GetVoxelMaterial(int32 LOD, const FVoxelMaterialIndices& MaterialIndices) const;
 	UMaterialInterface* GetVoxelMaterial(int32 LOD) const;
 
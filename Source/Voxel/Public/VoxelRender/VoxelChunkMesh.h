@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "VoxelMinimal.h"
 #include "VoxelRender/VoxelProcMeshTangent.h"
+#include "VoxelRender/VoxelPackedVertex.h"
 #include "VoxelRender/VoxelMaterialIndices.h"
 
 class FVoxelData;
@@ -12,6 +13,7 @@ class FDistanceFieldVolumeData;
 struct FVoxelRendererSettingsBase;
 
 DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Chunk Mesh Memory"), STAT_VoxelChunkMeshMemory, STATGROUP_VoxelMemory, VOXEL_API);
+DECLARE_VOXEL_MEMORY_STAT(TEXT("Voxel Chunk Mesh Memory Saved By Packed Vertices"), STAT_VoxelChunkMeshPackedVerticesSavedMemory, STATGROUP_VoxelMemory, VOXEL_API);
 
 struct VOXEL_API FVoxelChunkMeshBuffers
 {
@@ -24,6 +26,12 @@ struct VOXEL_API FVoxelChunkMeshBuffers
 	TArray<FColor> Colors;
 	TArray<TArray<FVector2D>> TextureCoordinates;
 
+	// If bPackedVertices is true, Positions, Normals and Tangents are empty and packed here instead
+	// Use the GetPosition/GetNormal/GetTangent helpers to read vertices that might be packed
+	bool bPackedVertices = false;
+	FVoxelPackedVertex::FFormat PackedFormat;
+	TArray<FVoxelPackedVertex> PackedVertices;
+
 	FBox Bounds;
 	FGuid Guid; // Use to avoid rebuilding collisions when the mesh didn't change
 
@@ -31,11 +39,25 @@ struct VOXEL_API FVoxelChunkMeshBuffers
 	~FVoxelChunkMeshBuffers()
 	{
 		DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelChunkMeshMemory, LastAllocatedSize);
+		DEC_VOXEL_MEMORY_STAT_BY(STAT_VoxelChunkMeshPackedVerticesSavedMemory, LastPackedVerticesSavedSize);
 	}
 
 	inline int32 GetNumVertices() const
 	{
-		return Positions.Num();
+		return bPackedVertices ? PackedVertices.Num() : Positions.Num();
+	}
+
+	FORCEINLINE FVector GetPosition(int32 Index) const
+	{
+		return bPackedVertices ? PackedVertices[Index].GetPosition(PackedFormat) : Positions[Index];
+	}
+	FORCEINLINE FVector GetNormal(int32 Index) const
+	{
+		return bPackedVertices ? PackedVertices[Index].GetNormal() : Normals[Index];
+	}
+	FORCEINLINE FVoxelProcMeshTangent GetTangent(int32 Index) const
+	{
+		return bPackedVertices ? PackedVertices[Index].GetTangent(PackedFormat) : Tangents[Index];
 	}
 
 	void BuildAdjacency(TArray<uint32>& OutAdjacencyIndices) const;
@@ -45,6 +67,7 @@ struct VOXEL_API FVoxelChunkMeshBuffers
 
 private:
 	int32 LastAllocatedSize = 0;
+	int32 LastPackedVerticesSavedSize = 0;
 
 	void UpdateStats();
 };
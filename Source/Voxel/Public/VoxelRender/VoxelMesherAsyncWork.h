@@ -12,6 +12,8 @@ struct FVoxelRendererSettings;
 struct FVoxelChunkMesh;
 class FVoxelDefaultRenderer;
 class FVoxelMesherBase;
+class FVoxelMesherScratch;
+class FVoxelMesherChunkCache;
 
 class VOXEL_API FVoxelMesherAsyncWork : public FVoxelAsyncWork
 {
@@ -24,8 +26,20 @@ public:
 	const bool bIsTransitionTask;
 	const uint8 TransitionsMask; // If bIsTransitionTask is true
 
+	// Input & output: previous mesh of the chunk, updated by the task. Only for main tasks
+	TUniquePtr<FVoxelMesherChunkCache> ChunkCache;
+	// Input: bounds edited since the chunk cache was built
+	FVoxelIntBoxWithValidity DirtyBounds;
+	// Input: when DirtyBounds was taken. Edits made after that are not in DirtyBounds, even if they are before DoWork
+	double DirtyBoundsTime = 0;
+	// Input: use worker threads to finish the task sooner. Only for main tasks
+	bool bHighPriority = false;
+	// Input: an edit is waiting on this task. Its result is applied by the renderer before the other tasks ones
+	bool bIsEditTask = false;
+
 	// Output
 	TVoxelSharedPtr<FVoxelChunkMesh> Chunk;
+	// Edits made before this time are in Chunk
 	double CreationTime = 0;
 
 	FVoxelMesherAsyncWork(
@@ -55,6 +69,7 @@ private:
 
 	static TUniquePtr<FVoxelMesherBase> GetMesher(
 		const FVoxelRendererSettings& Settings,
+		FVoxelMesherScratch& Scratch,
 		int32 LOD,
 		const FIntVector& ChunkPosition,
 		bool bIsTransitionTask,
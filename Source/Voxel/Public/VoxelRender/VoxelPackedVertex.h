@@ -0,0 +1,142 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "VoxelRender/VoxelProcMeshTangent.h"
+
+/**
+ * Compact vertex used by chunk meshes when AVoxelWorld::bPackVertices is true
+ * Replaces the position, normal and tangent of a vertex: 16 bytes instead of 80
+ *
+ * Positions are chunk local: they are quantized to 16 bits in [-PositionMargin, RENDER_CHUNK_SIZE + PositionMargin] << LOD
+ * Normals and tangents are octahedral encoded in 2 x 16 bits
+ * Surface nets store the parent position in the tangent: in that case it's quantized like the position
+ */
+struct FVoxelPackedVertex
+{
+	// In voxels, before scaling by the LOD step
+	static constexpr int32 PositionMargin = 2;
+
+	struct FFormat
+	{
+		int32 LOD = 0;
+		// True for surface nets
+		bool bTangentIsPosition = false;
+
+		FORCEINLINE float GetPositionMin() const
+		{
+			return -PositionMargin * (1 << LOD);
+		}
+		FORCEINLINE float GetPositionStep() const
+		{
+			return float((RENDER_CHUNK_SIZE + 2 * PositionMargin) << LOD) / MAX_uint16;
+		}
+	};
+
+	uint16 Position[3];
+	int16 Normal[2];
+	// Octahedral tangent + flip, or quantized parent position
+	uint16 Tangent[3];
+
+	FORCEINLINE static FVoxelPackedVertex Pack(const FFormat& Format, const FVector& InPosition, const FVector& InNormal, const FVoxelProcMeshTangent& InTangent)
+	{
+		FVoxelPackedVertex Vertex;
+		PackPosition(Format, InPosition, Vertex.Position);
+		PackOctahedron(InNormal, Vertex.Normal);
+		if (Format.bTangentIsPosition)
+		{
+			PackPosition(Format, InTangent.TangentX, Vertex.Tangent);
+		}
+		else
+		{
+			int16 Octahedron[2];
+			PackOctahedron(InTangent.TangentX, Octahedron);
+			Vertex.Tangent[0] = uint16(Octahedron[0]);
+			Vertex.Tangent[1] = uint16(Octahedron[1]);
+			Vertex.Tangent[2] = InTangent.bFlipTangentY ? 1 : 0;
+		}
+		return Vertex;
+	}
+
+	FORCEINLINE FVector GetPosition(const FFormat& Format) const
+	{
+		return UnpackPosition(Format, Position);
+	}
+	FORCEINLINE FVector GetNormal() const
+	{
+		return UnpackOctahedron(Normal);
+	}
+	FORCEINLINE FVoxelProcMeshTangent GetTangent(const FFormat& Format) const
+	{
+		if (Format.bTangentIsPosition)
+		{
+			return FVoxelProcMeshTangent(UnpackPosition(Format, Tangent), false);
+		}
+		else
+		{
+			const int16 Octahedron[2] = { int16(Tangent[0]), int16(Tangent[1]) };
+			return FVoxelProcMeshTangent(UnpackOctahedron(Octahedron), Tangent[2] != 0);
+		}
+	}
+
+private:
+	FORCEINLINE static void PackPosition(const FFormat& Format, const FVector& InPosition, uint16 OutPosition[3])
+	{
+		const float Min = Format.GetPositionMin();
+		const float Step = Format.GetPositionStep();
+		for (int32 Index = 0; Index < 3; Index++)
+		{
+			const int32 Value = FMath::RoundToInt((InPosition[Index] - Min) / Step);
+			ensureVoxelSlowNoSideEffects(0 <= Value && Value <= MAX_uint16);
+			OutPosition[Index] = uint16(FMath::Clamp(Value, 0, int32(MAX_uint16)));
+		}
+	}
+	FORCEINLINE static FVector UnpackPosition(const FFormat& Format, const uint16 InPosition[3])
+	{
+		const float Min = Format.GetPositionMin();
+		const float Step = Format.GetPositionStep();
+		return FVector(
+			Min + InPosition[0] * Step,
+			Min + InPosition[1] * Step,
+			Min + InPosition[2] * Step);
+	}
+
+	FORCEINLINE static void PackOctahedron(const FVector& InVector, int16 OutOctahedron[2])
+	{
+		const float L1Norm = FMath::Abs(InVector.X) + FMath::Abs(InVector.Y) + FMath::Abs(InVector.Z);
+		if (L1Norm == 0)
+		{
+			OutOctahedron[0] = 0;
+			OutOctahedron[1] = 0;
+			return;
+		}
+
+		float X = InVector.X / L1Norm;
+		float Y = InVector.Y / L1Norm;
+		if (InVector.Z < 0)
+		{
+			// Fold the lower hemisphere over the diagonals
+			const float NewX = (1 - FMath::Abs(Y)) * (X >= 0 ? 1 : -1);
+			const float NewY = (1 - FMath::Abs(X)) * (Y >= 0 ? 1 : -1);
+			X = NewX;
+			Y = NewY;
+		}
+
+		OutOctahedron[0] = int16(FMath::Clamp(FMath::RoundToInt(X * MAX_int16), -int32(MAX_int16), int32(MAX_int16)));
+		OutOctahedron[1] = int16(FMath::Clamp(FMath::RoundToInt(Y * MAX_int16), -int32(MAX_int16), int32(MAX_int16)));
+	}
+	FORCEINLINE static FVector UnpackOctahedron(const int16 InOctahedron[2])
+	{
+		const float X = InOctahedron[0] / float(MAX_int16);
+		const float Y = InOctahedron[1] / float(MAX_int16);
+
+		FVector Vector(X, Y, 1 - FMath::Abs(X) - FMath::Abs(Y));
+		const float T = FMath::Max(-Vector.Z, 0.f);
+		Vector.X += Vector.X >= 0 ? -T : T;
+		Vector.Y += Vector.Y >= 0 ? -T : T;
+		return Vector.GetSafeNormal();
+	}
+};
+static_assert(sizeof(FVoxelPackedVertex) == 16, "");
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "VoxelEnums.h"
 #include "VoxelSettings.generated.h"
 
 /**
@@ -40,6 +41,15 @@ public:
 	// In my tests a compression level of 1 was very fast without compromising too much compression
 	UPROPERTY(Config, EditAnywhere, Category="Compression", meta = (ClampMin = -1, ClampMax = 9, UIMin = -1, UIMax = 9))
     int32 DefaultCompressionLevel = 1;
+
+	// Codec used when compressing voxel saves. Heightmaps & data assets are always compressed with zlib
+	// Use voxel.data.BenchmarkCompression to compare the codecs on your saves
+	UPROPERTY(Config, EditAnywhere, Category="Compression")
+	EVoxelCompressionCodec SaveCompressionCodec = EVoxelCompressionCodec::Zlib;
+
+	// Filter applied to the value or material buffers of the voxel saves when serializing them. Stored in the save
+	UPROPERTY(Config, EditAnywhere, Category="Compression")
+	EVoxelCompressionFilter SaveCompressionFilter = EVoxelCompressionFilter::None;
 	
     virtual FName GetContainerName() const override;
     virtual void PostInitProperties() override;
@@ -6,6 +6,7 @@
 #include "VoxelMinimal.h"
 #include "Misc/ScopeLock.h"
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
 enum class EVoxelLockType
@@ -40,6 +41,8 @@ public:
 			}
 
 			bWriting = true;
+			// Odd: optimistic readers still holding the lock will see it and release it
+			Version.fetch_add(1, std::memory_order_release);
 
 			while (0 < NumReaders)
 			{
@@ -47,6 +50,32 @@ public:
 			}
 		}
 	}
+	// Lock without waiting: fails if a writer holds the lock, or for writes if a reader holds it
+	bool TryLock(EVoxelLockType LockType)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(Mutex);
+			if (bWriting || (LockType == EVoxelLockType::Write && NumReaders > 0))
+			{
+				return false;
+			}
+
+			if (LockType == EVoxelLockType::Read)
+			{
+				NumReaders++;
+			}
+			else
+			{
+				bWriting = true;
+				// No reader to invalidate, but keep the version odd while locked
+				Version.fetch_add(1, std::memory_order_release);
+			}
+		}
+#if DO_THREADSAFE_CHECKS
+		AddThreadId();
+#endif
+		return true;
+	}
 	void Unlock(EVoxelLockType LockType)
 	{
 #if DO_THREADSAFE_CHECKS
@@ -75,6 +104,7 @@ public:
 				std::lock_guard<std::mutex> Lock(Mutex);
 				checkf(bWriting, TEXT("Unlock Write called, but not locked for write!"));
 				bWriting = false;
+				Version.fetch_add(1, std::memory_order_release);
 			}
 
 			WriteQueue.notify_all();
@@ -91,6 +121,13 @@ public:
 		std::lock_guard<std::mutex> Lock(Mutex);
 		return bWriting;
 	}
+
+	// Seqlock style version: odd while a writer holds or is waiting for the lock, incremented again when it's released
+	// Readers can compare it with the version they locked at, without taking the mutex, to know if a writer is waiting on them
+	FORCEINLINE uint32 GetVersion() const
+	{
+		return Version.load(std::memory_order_acquire);
+	}
 	
 private:
 	mutable std::mutex Mutex;
@@ -98,6 +135,7 @@ private:
 	std::condition_variable WriteQueue;
 	int32 NumReaders = 0;
 	bool bWriting = false;
+	std::atomic<uint32> Version{ 0 };
 
 #if DO_THREADSAFE_CHECKS
 	FCriticalSection ThreadIdsSection;
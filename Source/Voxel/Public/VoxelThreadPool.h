@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "HAL/PlatformAffinity.h"
 #include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "VoxelMinimal.h"
 #include <queue>
 
@@ -26,6 +27,91 @@ private:
 	TMap<FName, double> Times;
 };
 
+// Queued works sorted by priority category, then by priority
+// Each category is a heap: popping the best work is O(log N)
+// Priorities are only recomputed when the pool priorities version changed (see IVoxelPool::InvalidatePriorities),
+// and at most once every PriorityDuration
+// Not thread safe: the recompute is split in StartPrioritiesUpdate/EndPrioritiesUpdate so that it can be done outside of the pool lock
+class VOXEL_API FVoxelQueuedWorkPriorityIndex
+{
+public:
+	struct FWorkInfo
+	{
+		IVoxelQueuedWork* Work;
+		uint32 Priority;
+		int32 PriorityOffset;
+
+		FORCEINLINE bool operator<(const FWorkInfo& Other) const
+		{
+			// TArray heaps are min heaps
+			return Priority > Other.Priority;
+		}
+	};
+	// Works of a bucket whose priorities are being recomputed
+	struct FPrioritiesUpdate
+	{
+		uint32 PriorityCategory = 0;
+		int32 PrioritiesVersion = 0;
+		double Time = 0;
+		double MinPriorityDuration = MAX_dbl;
+		TArray<FWorkInfo> Works;
+
+		// Does not access the index: can be called without any lock
+		void ComputePriorities();
+	};
+
+	static constexpr uint32 AnyPriorityCategory = MAX_uint32;
+
+	void Add(IVoxelQueuedWork* Work, uint32 PriorityCategory, int32 PriorityOffset, uint32 Priority, int32 PrioritiesVersion);
+	// If PriorityCategory is not AnyPriorityCategory, only pops works of that priority category. Returns null if there are none
+	IVoxelQueuedWork* Pop(uint32 PriorityCategory = AnyPriorityCategory);
+
+	// If the priorities of the bucket the next work would be popped from are outdated, moves its works to OutUpdate
+	// These works are not in the index until EndPrioritiesUpdate is called. Returns false if there is nothing to update
+	bool StartPrioritiesUpdate(int32 PrioritiesVersion, double Time, uint32 PriorityCategory, FPrioritiesUpdate& OutUpdate);
+	// Merges back the works of an update, along with the ones queued in the meantime
+	void EndPrioritiesUpdate(FPrioritiesUpdate& Update);
+
+	template<typename T>
+	void ForEachWork(T Lambda) const
+	{
+		for (const FBucket& Bucket : Buckets)
+		{
+			for (const FWorkInfo& WorkInfo : Bucket.Works)
+			{
+				Lambda(WorkInfo.Work);
+			}
+		}
+	}
+	void Reset();
+
+	// Does not count the works being updated
+	FORCEINLINE int32 Num() const
+	{
+		return NumWorks;
+	}
+
+	static uint32 ComputePriority(const IVoxelQueuedWork& Work, int32 PriorityOffset);
+
+private:
+	struct FBucket
+	{
+		uint32 PriorityCategory = 0;
+		TArray<FWorkInfo> Works;
+		// Pool priorities version used to compute the priorities
+		int32 PrioritiesVersion = 0;
+		double NextUpdateTime = 0;
+		double MinPriorityDuration = MAX_dbl;
+		// If true, the works of this bucket are in a FPrioritiesUpdate
+		bool bUpdatingPriorities = false;
+	};
+	// Sorted by decreasing priority category
+	TArray<FBucket> Buckets;
+	int32 NumWorks = 0;
+
+	IVoxelQueuedWork* PopFromBucket(FBucket& Bucket);
+};
+
 struct VOXEL_API FVoxelQueuedThreadPoolSettings
 {
 	const FString PoolName;
@@ -33,13 +119,19 @@ struct VOXEL_API FVoxelQueuedThreadPoolSettings
 	const uint32 StackSize;
 	const EThreadPriority ThreadPriority;
 	const bool bConstantPriorities;
+	// Threads created in addition to NumThreads, that only run works with the priority category ReservedPriorityCategory
+	// Guarantees that these works get threads even when the other threads are busy with other works
+	const uint32 NumReservedThreads;
+	const uint32 ReservedPriorityCategory;
 
 	FVoxelQueuedThreadPoolSettings(
 		const FString& PoolName, 
 		uint32 NumThreads, 
 		uint32 StackSize, 
 		EThreadPriority ThreadPriority, 
-		bool bConstantPriorities);
+		bool bConstantPriorities,
+		uint32 NumReservedThreads = 0,
+		uint32 ReservedPriorityCategory = 0);
 };
 
 class VOXEL_API FVoxelQueuedThreadPool : public TVoxelSharedFromThis<FVoxelQueuedThreadPool>
@@ -54,7 +146,7 @@ public:
 	{
 		// Not really thread safe, only use this for debug
 		// Also count active threads
-		return (Settings.bConstantPriorities ? StaticQueuedWorks.size() : QueuedWorks.Num()) + GetNumThreads() - QueuedThreads.Num();
+		return (Settings.bConstantPriorities ? StaticQueuedWorks.size() + StaticReservedQueuedWorks.size() : QueuedWorks.Num()) + GetNumThreads() - QueuedThreads.Num();
 	}
 	int32 GetNumThreads() const
 	{
@@ -66,6 +158,12 @@ public:
 	void AddQueuedWork(IVoxelQueuedWork* InQueuedWork, uint32 PriorityCategory, int32 PriorityOffset);
 	void AddQueuedWorks(const TArray<IVoxelQueuedWork*>& InQueuedWorks, uint32 PriorityCategory, int32 PriorityOffset);
 
+	// Priorities of the queued works will be recomputed before popping them. No-op if bConstantPriorities
+	void InvalidatePriorities()
+	{
+		PrioritiesVersion.Increment();
+	}
+
 	IVoxelQueuedWork* ReturnToPoolOrGetNextJob(FVoxelQueuedThread* InQueuedThread);
 
 	void AbandonAllTasks();
@@ -73,6 +171,11 @@ public:
 private:
 	explicit FVoxelQueuedThreadPool(const FVoxelQueuedThreadPoolSettings& Settings);
 
+	// Requires Section to be locked
+	IVoxelQueuedWork* PopNextJob(FVoxelQueuedThread* InQueuedThread, uint32 PriorityCategory);
+	// Requires Section to be locked
+	void WakeUpQueuedThreads();
+
 	const TArray<TUniquePtr<FVoxelQueuedThread>> AllThreads;
 
 	FCriticalSection Section;
@@ -110,8 +213,14 @@ private:
 			return GetPriority() < Other.GetPriority();
 		}
 	};
-	TArray<FQueuedWorkInfo> QueuedWorks;
+	FVoxelQueuedWorkPriorityIndex QueuedWorks;
 	std::priority_queue<FQueuedWorkInfo> StaticQueuedWorks;
+	// Works with the ReservedPriorityCategory if there are reserved threads, so that they don't wait behind the other works
+	std::priority_queue<FQueuedWorkInfo> StaticReservedQueuedWorks;
+
+	// Requires Section to be locked
+	void PushStaticWork(const FQueuedWorkInfo& WorkInfo);
+	FThreadSafeCounter PrioritiesVersion;
 	
 	FThreadSafeBool TimeToDie = false;
 };
\ No newline at end of file
@@ -55,7 +55,8 @@ enum class EVoxelMemoryUsageType : uint8
 	DataAssets,
 	HeightmapAssets,
 	UncompressedSaves,
-	CompressedSaves
+	CompressedSaves,
+	DataSlabsOverhead
 };
 
 UCLASS()
@@ -393,13 +394,17 @@ public:
 	 * CreateWorldVoxelThreadPool is preferred, as pools will be per level
 	 * @param	NumberOfThreads		At least 1
 	 * @param	bConstantPriorities	If true won't recompute the tasks priorities once added. Useful if you have many tasks, but will give bad task scheduling when moving fast
+	 * @param	bWorkStealing		If true will use a work stealing pool, with per-thread task queues. Useful with many threads and many tasks
+	 * @param	NumberOfEditThreads	Threads created in addition to NumberOfThreads, only used to remesh the chunks an edit is waiting on
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Voxel|Threads", meta = (AdvancedDisplay = "PriorityCategoriesOverrides, PriorityOffsetsOverrides"))
 	static void CreateGlobalVoxelThreadPool(
 		const TMap<EVoxelTaskType, int32>& PriorityCategoriesOverrides,
 		const TMap<EVoxelTaskType, int32>& PriorityOffsetsOverrides,
 		int32 NumberOfThreads = 2,
-		bool bConstantPriorities = false);
+		bool bConstantPriorities = false,
+		bool bWorkStealing = false,
+		int32 NumberOfEditThreads = 0);
 
 	// Destroy the global voxel thread pool
 	UFUNCTION(BlueprintCallable, Category = "Voxel|Threads")
@@ -413,6 +418,8 @@ public:
 	 * Create the voxel thread pool for a specific world. Must not be already created.
 	 * @param	NumberOfThreads		At least 1
 	 * @param	bConstantPriorities	If true won't recompute the tasks priorities once added. Useful if you have many tasks, but will give bad task scheduling when moving fast
+	 * @param	bWorkStealing		If true will use a work stealing pool, with per-thread task queues. Useful with many threads and many tasks
+	 * @param	NumberOfEditThreads	Threads created in addition to NumberOfThreads, only used to remesh the chunks an edit is waiting on
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Voxel|Threads", meta = (AdvancedDisplay = "PriorityCategoriesOverrides, PriorityOffsetsOverrides"))
 	static void CreateWorldVoxelThreadPool(
@@ -420,7 +427,9 @@ public:
 		const TMap<EVoxelTaskType, int32>& PriorityCategoriesOverrides,
 		const TMap<EVoxelTaskType, int32>& PriorityOffsetsOverrides,
 		int32 NumberOfThreads = 2,
-		bool bConstantPriorities = false);
+		bool bConstantPriorities = false,
+		bool bWorkStealing = false,
+		int32 NumberOfEditThreads = 0);
 
 	// Destroy the world voxel thread pool
 	UFUNCTION(BlueprintCallable, Category = "Voxel|Threads")
@@ -45,6 +45,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel")
 	TSubclassOf<AVoxelWorld> VoxelWorldClass;
 	
+public:
+	//~ Begin IVoxelPhysicsPartSpawner Interface
+	virtual TScriptInterface<IVoxelPhysicsPartSpawnerResult> SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part) override;
+	//~ End IVoxelPhysicsPartSpawner Interface
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -82,6 +86,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel")
 	float SpawnProbability = 1.f;
 	
+public:
+	//~ Begin IVoxelPhysicsPartSpawner Interface
+	virtual TScriptInterface<IVoxelPhysicsPartSpawnerResult> SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part) override;
+	//~ End IVoxelPhysicsPartSpawner Interface
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -103,4 +111,8 @@ class VOXEL_API UVoxelPhysicsPartSpawner_GetVoxels : public UObject, public IVox
 {
 	GENERATED_BODY()
 
+public:
+	//~ Begin IVoxelPhysicsPartSpawner Interface
+	virtual TScriptInterface<IVoxelPhysicsPartSpawnerResult> SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part) override;
+	//~ End IVoxelPhysicsPartSpawner Interface
 };
\ No newline at end of file
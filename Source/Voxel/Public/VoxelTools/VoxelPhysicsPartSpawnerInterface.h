@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "VoxelMaterial.h"
 #include "VoxelMinimal.h"
+#include "VoxelIntBox.h"
 #include "UObject/Interface.h"
 #include "VoxelPhysicsPartSpawnerInterface.generated.h"
 
@@ -29,6 +30,20 @@ struct FVoxelPositionValueMaterial
 	FVoxelMaterial Material = FVoxelMaterial(ForceInit);
 };
 
+// A floating part found by UVoxelPhysicsTools::ApplyVoxelPhysics. It has already been removed from its voxel world
+struct FVoxelPhysicsPart
+{
+	// Bounds of the part voxels, in the voxel world coordinates
+	FVoxelIntBox Bounds;
+	// The non-empty voxels of the part
+	TArray<FVoxelPositionValueMaterial> Voxels;
+	// Data containing only the part, in the voxel world coordinates
+	TVoxelSharedPtr<FVoxelData> Data;
+	// Broadcast on the game thread once the voxel world chunks the part was removed from are updated,
+	// so that the part can be simulated without being spawned inside the world collisions
+	TVoxelSharedPtr<FSimpleMulticastDelegate> OnWorldUpdated;
+};
+
 // Represents the result for a single part
 UINTERFACE(BlueprintType)
 class VOXEL_API UVoxelPhysicsPartSpawnerResult : public UInterface
@@ -53,4 +68,7 @@ class VOXEL_API IVoxelPhysicsPartSpawner : public IInterface
 	GENERATED_BODY()
 	
 public:
+	// Called on the game thread for each floating part, after the part has been removed from World
+	// Returns the result for this part, or null if nothing was spawned
+	virtual TScriptInterface<IVoxelPhysicsPartSpawnerResult> SpawnPart(AVoxelWorld* World, FVoxelPhysicsPart&& Part) { return nullptr; }
 };
@@ -109,6 +109,30 @@ public:
 		float NumRays = 100.f,
 		float MaxDistance = 1e9);
 	
+	/**
+	 * Find voxels by tracing the rays directly against the voxel data, instead of against the collisions
+	 * Works in areas that have no collisions or whose collisions are not cooked yet, but only hits the voxel world
+	 * The rays are traced in parallel
+	 * @param World					The voxel world
+	 * @param Position				The center of the rays
+	 * @param Direction				The direction of the rays
+	 * @param Radius				The radius in world space (cm)
+	 * @param Shape					The shape of the rays start positions
+	 * @param NumRays				The approximate number of rays to trace
+	 * @param MaxDistance			The max ray distance
+	 * @return	Number of rays actually traced (should be close to NumRays)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Voxel|Tools|Projection Tools", meta = (DefaultToSelf = "World"))
+	static int32 FindProjectionVoxelsFromData(
+		TArray<FVoxelProjectionHit>& Hits,
+		AVoxelWorld* World,
+		FVector Position,
+		FVector Direction,
+		float Radius = 100.f,
+		EVoxelProjectionShape Shape = EVoxelProjectionShape::Circle,
+		float NumRays = 100.f,
+		float MaxDistance = 1e9);
+	
 	/**
 	 * Find voxels using linetraces, asynchronously
 	 * @param World					The voxel world
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "VoxelValue.h"
 #include "VoxelMaterial.h"
+#include "VoxelEnums.h"
+#include "Async/Future.h"
 
 class FArchive;
 class FLargeMemoryWriter;
@@ -47,11 +49,32 @@ namespace EVoxelCompressionLevel
 	};
 }
 
+struct FVoxelCompressionOptions
+{
+	EVoxelCompressionLevel::Type Level = EVoxelCompressionLevel::VoxelDefault;
+	// If not set, zlib is used
+	TOptional<EVoxelCompressionCodec> Codec;
+	EVoxelCompressionFilter Filter = EVoxelCompressionFilter::None;
+	// Whether to log the compression speed & ratio
+	bool bLog = true;
+
+	FVoxelCompressionOptions() = default;
+	FVoxelCompressionOptions(EVoxelCompressionLevel::Type Level)
+		: Level(Level)
+	{
+	}
+};
+
 namespace FVoxelSerializationUtilities
 {
-	VOXEL_API void SerializeValues(FArchive& Archive, TNoGrowArray<FVoxelValue>& Values, uint32 ValueConfigFlag, FVoxelSerializationVersion::Type VoxelCustomVersion);
+	// If bDeltaEncoded, the values are serialized with SerializeDeltaEncoded. Only supported by the latest serialization version
+	VOXEL_API void SerializeValues(FArchive& Archive, TNoGrowArray<FVoxelValue>& Values, uint32 ValueConfigFlag, FVoxelSerializationVersion::Type VoxelCustomVersion, bool bDeltaEncoded = false);
 	VOXEL_API void SerializeMaterials(FArchive& Archive, TNoGrowArray<FVoxelMaterial>& Materials, uint32 MaterialConfigFlag, FVoxelSerializationVersion::Type VoxelCustomVersion);
 
+	// Serialize NumElements elements of ElementSize bytes, delta encoded by blocks of VOXELS_PER_DATA_CHUNK elements with the bytes of the deltas split in planes
+	// When loading, Data must already be allocated
+	VOXEL_API void SerializeDeltaEncoded(FArchive& Archive, uint8* Data, int64 NumElements, int32 ElementSize);
+
 	template<typename T>
 	void SerializeMaterials(FArchive& Archive, TNoGrowArray<TVoxelMaterialStorage<T>>& Materials, uint32 MaterialConfigFlag)
 	{
@@ -95,21 +118,80 @@ namespace FVoxelSerializationUtilities
 		const uint8* UncompressedData,
 		int64 UncompressedDataNum, 
 		TArray<uint8>& OutCompressedData,
-		EVoxelCompressionLevel::Type CompressionLevel = EVoxelCompressionLevel::VoxelDefault);
+		const FVoxelCompressionOptions& Options = {});
 	VOXEL_API void CompressData(
 		FLargeMemoryWriter& UncompressedData,
 		TArray<uint8>& CompressedData,
-		EVoxelCompressionLevel::Type CompressionLevel = EVoxelCompressionLevel::VoxelDefault);
+		const FVoxelCompressionOptions& Options = {});
 	
 	inline void CompressData(
 		const TArray<uint8>& UncompressedData, 
 		TArray<uint8>& CompressedData,
-		EVoxelCompressionLevel::Type CompressionLevel = EVoxelCompressionLevel::VoxelDefault)
+		const FVoxelCompressionOptions& Options = {})
 	{
-		CompressData(UncompressedData.GetData(), UncompressedData.Num(), CompressedData, CompressionLevel);
+		CompressData(UncompressedData.GetData(), UncompressedData.Num(), CompressedData, Options);
 	}
 
-	VOXEL_API bool DecompressData(const TArray<uint8>& CompressedData, TArray64<uint8>& UncompressedData);
+	// The codec & filter used are read from the compressed data
+	VOXEL_API bool DecompressData(const TArray<uint8>& CompressedData, TArray64<uint8>& UncompressedData, bool bLog = true);
+
+	VOXEL_API void TestCompression(int64 Size, const FVoxelCompressionOptions& Options);
+	// Log the compression & decompression speed and the ratio of every codec and filter on Data
+	VOXEL_API void BenchmarkCompression(const uint8* Data, int64 Num);
+}
+
+// Archive compressing the data serialized into it on the fly, in the same format as FVoxelSerializationUtilities::CompressData
+// The data is split in chunks of voxel.data.CompressionChunkSize that are compressed in parallel on the task graph while the serialization continues
+// Only a few uncompressed chunks are kept in memory at once, so the full uncompressed data is never materialized
+class VOXEL_API FVoxelCompressedWriter : public FArchive
+{
+public:
+	// If bMultiThreaded is false, the chunks are compressed inline when full. Use when the caller is already running in parallel
+	explicit FVoxelCompressedWriter(const FVoxelCompressionOptions& Options = {}, bool bMultiThreaded = true);
+	virtual ~FVoxelCompressedWriter() override;
+
+	//~ Begin FArchive Interface
+	virtual void Serialize(void* Data, int64 Num) override;
+	virtual int64 Tell() override { return UncompressedSize; }
+	virtual int64 TotalSize() override { return UncompressedSize; }
+	virtual FString GetArchiveName() const override { return TEXT("FVoxelCompressedWriter"); }
+	//~ End FArchive Interface
+
+	/**
+	 * Wait for all the chunks to be compressed, and write the compressed data to OutArchive
+	 * Nothing can be serialized into this archive afterwards
+	 * @return false if the compression failed
+	 */
+	bool Finish(FArchive& OutArchive);
+	bool Finish(TArray<uint8>& OutCompressedData);
+
+private:
+	struct FChunk
+	{
+		uint32 UncompressedSize = 0;
+		TArray64<uint8> CompressedData;
+		double CompressionTime = 0;
+		bool bSuccess = false;
+	};
+
+	const int32 CompressionLevel;
+	const EVoxelCompressionCodec Codec;
+	const EVoxelCompressionFilter Filter;
+	const bool bLog;
+	const bool bMultiThreaded;
+	const int64 ChunkSize;
+	const int32 MaxPendingChunks;
+	const double StartTime;
+
+	int64 UncompressedSize = 0;
+	bool bFinished = false;
 
-	VOXEL_API void TestCompression(int64 Size, EVoxelCompressionLevel::Type CompressionLevel);
-}
\ No newline at end of file
+	TArray64<uint8> CurrentChunk;
+	// Chunks being compressed, in order
+	TArray<TFuture<FChunk>> PendingChunks;
+	TArray<FChunk> Chunks;
+
+	void FlushCurrentChunk();
+	void WaitForOldestChunk();
+	void WaitForAllChunks();
+};
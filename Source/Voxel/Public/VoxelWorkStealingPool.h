@@ -0,0 +1,141 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "IVoxelPool.h"
+
+class IVoxelQueuedWork;
+class FVoxelWorkStealingThread;
+
+// Pool meant for many threads and many queued tasks
+// Tasks are queued in a global injector, with one bucket per priority category sorted by task priority
+// Threads take batches of tasks from the injector into their own queue, and steal from other threads queues once both are empty
+// Threads never contend on a single lock nor scan every queued task to find the next one
+// Task priorities are computed when queued. Unless bConstantPriorities, the priorities of a bucket are recomputed when the pool priorities
+// are invalidated, at most once every PriorityDuration. Works already taken by a thread keep their priorities
+// Edit threads are created in addition to ThreadCount: they only take works from the EditChunksMeshing bucket,
+// one at a time, and never steal
+class VOXEL_API FVoxelWorkStealingPool : public IVoxelPool
+{
+public:
+	static TVoxelSharedRef<FVoxelWorkStealingPool> Create(
+		int32 ThreadCount,
+		bool bConstantPriorities,
+		const TMap<EVoxelTaskType, int32>& PriorityCategories,
+		const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+		int32 NumEditThreads = 0);
+	virtual ~FVoxelWorkStealingPool();
+
+public:
+	//~ Begin IVoxelPool Interface
+	virtual void QueueTask(EVoxelTaskType Type, IVoxelQueuedWork* Task) override;
+	virtual void QueueTasks(EVoxelTaskType Type, const TArray<IVoxelQueuedWork*>& Tasks) override;
+
+	virtual int32 GetNumTasks() const override;
+	virtual void InvalidatePriorities() override;
+	//~ End IVoxelPool Interface
+
+public:
+	// Called by the pool threads. Returns null if there is nothing to do
+	IVoxelQueuedWork* GetNextWork(int32 ThreadIndex);
+	// Called by the pool threads when GetNextWork returned null. Returns once works are queued
+	void WaitForWork(int32 ThreadIndex);
+	// Called by the pool threads once the work returned by GetNextWork is done
+	void OnWorkDone();
+
+	void AbandonAllTasks();
+
+private:
+	struct FWorkInfo
+	{
+		IVoxelQueuedWork* Work = nullptr;
+		uint32 Priority = 0;
+		int32 PriorityOffset = 0;
+	};
+	struct FBucket
+	{
+		FCriticalSection Section;
+		// Heap, highest priority on top
+		TArray<FWorkInfo> Works;
+		FThreadSafeCounter Num;
+
+		// Pool priorities version used to compute the priorities. Can be read without locking
+		FThreadSafeCounter PrioritiesVersion;
+		double NextPrioritiesUpdateTime = 0;
+		// If true, the works are being moved out of the bucket to recompute their priorities
+		bool bUpdatingPriorities = false;
+	};
+	struct FThreadQueue
+	{
+		FEvent* const DoWorkEvent = FPlatformProcess::GetSynchEventFromPool();
+		FThreadSafeBool bIdle = false;
+
+		FCriticalSection Section;
+		// Sorted by increasing priority: the owner pops from the end, thieves steal from the start
+		TArray<FWorkInfo> Works;
+		// Bucket the works were taken from
+		int32 BucketIndex = -1;
+		FThreadSafeCounter Num;
+
+		FThreadQueue() = default;
+		~FThreadQueue()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(DoWorkEvent);
+		}
+	};
+
+	// Not counting the edit threads. Edit threads indices are after the normal threads ones
+	const int32 NumThreads;
+	const int32 NumEditThreads;
+	const bool bConstantPriorities;
+	// Bucket of the EditChunksMeshing tasks, the only one the edit threads run. -1 if none
+	int32 EditBucketIndex = -1;
+	const TStaticArray<uint8, 256> TaskTypeToBucket;
+	const TStaticArray<int32, 256> PriorityOffsets;
+	// Sorted by decreasing priority category
+	TArray<TUniquePtr<FBucket>> Buckets;
+	TArray<TUniquePtr<FThreadQueue>> ThreadQueues;
+
+	FThreadSafeCounter NumQueuedWorks;
+	// Threads looking for a work or running one
+	FThreadSafeCounter NumActiveThreads;
+	FThreadSafeBool TimeToDie = false;
+	// Triggered when NumActiveThreads reaches 0 once TimeToDie is set
+	FEvent* const NoActiveThreadsEvent = FPlatformProcess::GetSynchEventFromPool();
+	FThreadSafeCounter PrioritiesVersion;
+
+	// Last: threads start querying works as soon as they are created
+	TArray<TUniquePtr<FVoxelWorkStealingThread>> Threads;
+
+	FVoxelWorkStealingPool(
+		int32 ThreadCount,
+		bool bConstantPriorities,
+		const TMap<EVoxelTaskType, int32>& PriorityCategories,
+		const TMap<EVoxelTaskType, int32>& PriorityOffsets,
+		int32 NumEditThreads);
+
+	FORCEINLINE bool IsEditThread(int32 ThreadIndex) const
+	{
+		return ThreadIndex >= NumThreads;
+	}
+	FORCEINLINE bool HasEditWorks() const
+	{
+		return EditBucketIndex != -1 && Buckets[EditBucketIndex]->Num.GetValue() > 0;
+	}
+
+	void WakeUpThreads();
+	int32 GetBestBucketIndex() const;
+	IVoxelQueuedWork* FindWork(int32 ThreadIndex);
+	// Recomputes the bucket priorities if they are outdated. The bucket lock is not held while computing them
+	void UpdatePriorities(FBucket& Bucket);
+	IVoxelQueuedWork* PopFromThreadQueue(FThreadQueue& Queue);
+	// Pops from the buckets in [FirstBucketIndex, EndBucketIndex)
+	IVoxelQueuedWork* PopFromInjector(int32 ThreadIndex, int32 FirstBucketIndex, int32 EndBucketIndex);
+	IVoxelQueuedWork* Steal(int32 ThreadIndex);
+};
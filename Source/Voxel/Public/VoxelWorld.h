@@ -41,6 +41,7 @@ class IVoxelSpawnerManager;
 class FVoxelMultiplayerManager;
 class FVoxelInstancedMeshManager;
 class FVoxelToolRenderingManager;
+class FThreadSafeBool;
 struct FVoxelLODDynamicSettings;
 struct FVoxelUncompressedWorldSave;
 struct FVoxelRendererDynamicSettings;
@@ -240,6 +241,23 @@ public:
 	// For example, can be useful when used with a Max LOD of 0 for worlds that have the highest resolution LOD everywhere
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - LOD Settings", meta = (RecreateRender))
 	bool bConstantLOD = false;
+
+	// If true, the voxel data in front of fast moving invokers will be cached ahead of time,
+	// and the chunks there will be meshed first. Use voxel.lod.PrintPrefetchStats to check the prefetches hit rate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - LOD Settings", meta = (UpdateLODs), DisplayName = "Enable LOD Prefetch")
+	bool bEnableLODPrefetch = false;
+
+	// In seconds. How far in the future the invokers positions are predicted
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - LOD Settings", meta = (UpdateLODs, ClampMin = 0, EditCondition = "bEnableLODPrefetch"), DisplayName = "LOD Prefetch Horizon")
+	float LODPrefetchHorizon = 1;
+
+	// In world space per second. Invokers slower than this are not prefetched for
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - LOD Settings", meta = (UpdateLODs, ClampMin = 0, EditCondition = "bEnableLODPrefetch"), DisplayName = "LOD Prefetch Min Speed")
+	float LODPrefetchMinSpeed = 2000;
+
+	// In world space. Radius of the region cached around the predicted invokers positions
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - LOD Settings", meta = (UpdateLODs, ClampMin = 0, EditCondition = "bEnableLODPrefetch"), DisplayName = "LOD Prefetch Radius")
+	float LODPrefetchRadius = 3200;
 	
 	//////////////////////////////////////////////////////////////////////////////
 	
@@ -336,6 +354,12 @@ public:
 	// Visually, it will give a more "sharp" look, 1 being the sharpest, 2 3 etc being less and less sharp
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender, UIMin = 0, UIMax = 10, ClampMin = 0))
 	int32 RenderSharpness = 0;
+
+	// For cubic only
+	// If true, adjacent coplanar faces with the same material are merged into larger quads, with tiled UVs
+	// Greatly reduces the number of triangles of blocky worlds, but creates T-junctions between the quads
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender))
+	bool bGreedyCubicMeshing = false;
 	
 	// If true, a dynamic instance will be created for each chunk. Else, the material will be used directly
 	// Disable this if you want to use dynamic material instances as voxel world materials
@@ -374,6 +398,40 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender))
 	bool bOptimizeIndices = false;
 
+	// If true, chunk meshes will store their positions, normals and tangents in 16 bytes per vertex instead of 80
+	// Positions are quantized to 16 bits per axis relative to the chunk, and normals/tangents are octahedral encoded
+	// Reduces the memory used by the chunk meshes kept by the renderer, see the Voxel Chunk Mesh Memory stats
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender))
+	bool bPackVertices = false;
+
+	// If true, marching cubes chunks will be simplified by collapsing the edges with a low quadric error
+	// Reduces the number of triangles of distant chunks, at the cost of some async mesher time. See voxel.mesher.PrintStats
+	// The chunks borders are never simplified, so that chunks and transitions still match
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender))
+	bool bSimplifyMeshes = false;
+
+	// Chunks with a lower LOD won't be simplified
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender, EditCondition = "bSimplifyMeshes", ClampMin = 0, ClampMax = 25, UIMin = 0, UIMax = 25))
+	int32 SimplificationMinLOD = 2;
+
+	// Max distance a simplified surface can move, in voxels of the chunk LOD
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender, EditCondition = "bSimplifyMeshes", ClampMin = 0, UIMin = 0, UIMax = 1))
+	float SimplificationMaxError = 0.1f;
+
+	// Override SimplificationMaxError for specific LODs. Set to 0 to not simplify a LOD
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender, EditCondition = "bSimplifyMeshes"))
+	TMap<int32, float> SimplificationMaxErrorPerLOD;
+
+	// Marching cubes only
+	// If true, the renderer keeps the mesh of the chunks split in slabs between updates, and edits only remesh the slabs they touch
+	// Makes small edits a lot cheaper to remesh, at the cost of keeping a copy of the mesh data of these chunks
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender))
+	bool bIncrementalRemesh = false;
+
+	// Chunks with a higher LOD are always fully remeshed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Rendering", meta = (RecreateRender, EditCondition = "bIncrementalRemesh", ClampMin = 0, ClampMax = 25, UIMin = 0, UIMax = 25))
+	int32 IncrementalRemeshMaxLOD = 0;
+
 	// Will generate distance fields on LOD 0 chunks
 	// Has a cost of around 1 ms per chunk (on async thread)
 	// Doesn't work with chunks merging or single/double index material config with different materials per chunk
@@ -540,6 +598,11 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Voxel - Performance", meta = (Recreate, ClampMin = 1, EditCondition = "bCreateGlobalPool"))
 	int32 NumberOfThreads = 2;
 
+	// Threads created in addition to NumberOfThreads, only used to remesh the chunks an edit is waiting on (EditChunksMeshing tasks)
+	// Makes sure edits show up quickly even when the other threads are busy loading new chunks. 0 to disable
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Performance", meta = (Recreate, ClampMin = 0, EditCondition = "bCreateGlobalPool"))
+	int32 NumberOfEditThreads = 0;
+
 	// Async tasks are sorted based on 2 values:
 	// - first, their priority category
 	// - then, their own priority (most of the time their distance from voxel invokers)
@@ -563,6 +626,12 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Performance", meta = (Recreate, EditCondition = "bCreateGlobalPool"))
 	bool bConstantPriorities = false;
 
+	// If true, will use a work stealing pool: each thread has its own task queue, and steals from the others when it runs out of tasks
+	// Priorities of the tasks already taken by a thread are not recomputed
+	// Useful with many threads and many tasks, where the default pool single lock becomes a bottleneck
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Voxel - Performance", meta = (Recreate, EditCondition = "bCreateGlobalPool"))
+	bool bUseWorkStealingPool = false;
+
 	// Only used if ConstantPriorities is false
 	// Time, in seconds, during which a task priority is valid and does not need to be recomputed
 	// Lowering this will increase async cost to recompute priorities, but will lead to more precise scheduling
@@ -790,6 +859,8 @@ private:
 	TVoxelSharedRef<FVoxelRendererDynamicSettings> RendererDynamicSettings = TVoxelSharedPtr<FVoxelRendererDynamicSettings>().ToSharedRef();
 	
 	TVoxelSharedPtr<FGameThreadTasks> GameThreadTasks;
+	// Set while the pending save regions are being loaded on the pool
+	TVoxelSharedPtr<FThreadSafeBool> IsLoadingPendingSaveRegions;
 	
 private:
 	void OnWorldLoadedCallback();
@@ -808,6 +879,9 @@ private:
 
 public:
 	void LoadFromSaveObject();
+	// Load the pending regions of a region indexed save object that are close to the invokers, on the pool
+	void LoadPendingSaveRegions();
+	void GetSaveRegionsBoundsToLoad(TArray<FVoxelIntBox>& OutBounds) const;
 	void ApplyPlaceableItems();
 
 	void UpdateDynamicLODSettings() const;
@@ -130,6 +130,10 @@ public:
 		{
 			Function0_XYZWithCache_Compute(Context, BufferX, BufferXY, Outputs);
 		}
+		void ComputeXYZColumnWithCache(const FVoxelContext& Context, const FBufferX& BufferX, const FBufferXY& BufferXY, const v_flt* RESTRICT Zs, int32 Num, FOutputs* RESTRICT Outputs) const
+		{
+			Function0_XYZColumnWithCache_Compute(Context, BufferX, BufferXY, Zs, Num, Outputs);
+		}
 		void ComputeXYZWithoutCache(const FVoxelContext& Context, FOutputs& Outputs) const
 		{
 			Function0_XYZWithoutCache_Compute(Context, Outputs);
@@ -321,6 +325,85 @@ public:
 			Outputs.Value = Variable_4;
 		}
 		
+		void Function0_XYZColumnWithCache_Compute(const FVoxelContext& Context, const FBufferX& BufferX, const FBufferXY& BufferXY, const v_flt* RESTRICT Zs, int32 Num, FOutputs* RESTRICT Outputs) const
+		{
+			checkVoxelSlow(Num <= FVoxelBatchNodeFunctions::MaxNum);
+			
+			// Z
+			const v_flt* RESTRICT Variable_2 = Zs; // Z output 0
+			
+			// Z
+			const v_flt* RESTRICT Variable_18 = Zs; // Z output 0
+			
+			// Vector Length
+			v_flt Variable_3[FVoxelBatchNodeFunctions::MaxNum]; // Vector Length output 0
+			FVoxelBatchNodeFunctions::VectorLength(BufferX.Variable_0, BufferXY.Variable_1, Variable_2, Variable_3, Num);
+			
+			// Sphere Normalize with Preview.Normalize.Vector Length
+			v_flt Variable_21[FVoxelBatchNodeFunctions::MaxNum]; // Sphere Normalize with Preview.Normalize.Vector Length output 0
+			FVoxelBatchNodeFunctions::VectorLength(BufferX.Variable_16, BufferXY.Variable_17, Variable_18, Variable_21, Num);
+			
+			// Sphere Normalize with Preview.Normalize./
+			v_flt Variable_23[FVoxelBatchNodeFunctions::MaxNum]; // Sphere Normalize with Preview.Normalize./ output 0
+			FVoxelBatchNodeFunctions::Divide(BufferXY.Variable_17, Variable_21, Variable_23, Num);
+			
+			// Sphere Normalize with Preview.Normalize./
+			v_flt Variable_24[FVoxelBatchNodeFunctions::MaxNum]; // Sphere Normalize with Preview.Normalize./ output 0
+			FVoxelBatchNodeFunctions::Divide(Variable_18, Variable_21, Variable_24, Num);
+			
+			// Sphere Normalize with Preview.Normalize./
+			v_flt Variable_22[FVoxelBatchNodeFunctions::MaxNum]; // Sphere Normalize with Preview.Normalize./ output 0
+			FVoxelBatchNodeFunctions::Divide(BufferX.Variable_16, Variable_21, Variable_22, Num);
+			
+			// 3D Gradient Perturb and 3D IQ Noise
+			v_flt Variable_6[FVoxelBatchNodeFunctions::MaxNum]; // 3D IQ Noise output 0
+			for (int32 Lane = 0; Lane < Num; Lane++)
+			{
+				v_flt Variable_13 = Variable_22[Lane]; // 3D Gradient Perturb output 0
+				v_flt Variable_14 = Variable_23[Lane]; // 3D Gradient Perturb output 1
+				v_flt Variable_15 = Variable_24[Lane]; // 3D Gradient Perturb output 2
+				_3D_Gradient_Perturb_0_Noise.GradientPerturb_3D(Variable_13, Variable_14, Variable_15, v_flt(0.02f), v_flt(0.01f));
+				
+				v_flt _3D_IQ_Noise_0_Temp_1; // 3D IQ Noise output 1
+				v_flt _3D_IQ_Noise_0_Temp_2; // 3D IQ Noise output 2
+				v_flt _3D_IQ_Noise_0_Temp_3; // 3D IQ Noise output 3
+				Variable_6[Lane] = _3D_IQ_Noise_0_Noise.IQNoise_3D_Deriv(Variable_13, Variable_14, Variable_15, BufferConstant.Variable_10, _3D_IQ_Noise_0_LODToOctaves[FMath::Clamp(Context.LOD, 0, 31)],_3D_IQ_Noise_0_Temp_1,_3D_IQ_Noise_0_Temp_2,_3D_IQ_Noise_0_Temp_3);
+			}
+			FVoxelBatchNodeFunctions::Clamp(Variable_6, -0.653693, 0.750231, Num);
+			
+			// -
+			v_flt Variable_19[FVoxelBatchNodeFunctions::MaxNum]; // - output 0
+			FVoxelBatchNodeFunctions::Subtract(Variable_6, v_flt(0.1f), Variable_19, Num);
+			
+			// /
+			v_flt Variable_12[FVoxelBatchNodeFunctions::MaxNum]; // / output 0
+			FVoxelBatchNodeFunctions::Divide(Variable_19, v_flt(0.5f), Variable_12, Num);
+			
+			// Float Curve: PlanetCurve
+			v_flt Variable_11[FVoxelBatchNodeFunctions::MaxNum]; // Float Curve: PlanetCurve output 0
+			FVoxelBatchNodeFunctions::GetCurveValue(Params.PlanetCurve, Variable_12, Variable_11, Num);
+			
+			// *
+			v_flt Variable_7[FVoxelBatchNodeFunctions::MaxNum]; // * output 0
+			for (int32 Lane = 0; Lane < Num; Lane++)
+			{
+				Variable_7[Lane] = BufferConstant.Variable_5 * Variable_11[Lane] * BufferConstant.Variable_8;
+			}
+			
+			// +
+			v_flt Variable_9[FVoxelBatchNodeFunctions::MaxNum]; // + output 0
+			FVoxelBatchNodeFunctions::Add(Variable_7, BufferConstant.Variable_5, Variable_9, Num);
+			
+			// -
+			v_flt Variable_4[FVoxelBatchNodeFunctions::MaxNum]; // - output 0
+			FVoxelBatchNodeFunctions::Subtract(Variable_3, Variable_9, Variable_4, Num);
+			
+			for (int32 Lane = 0; Lane < Num; Lane++)
+			{
+				Outputs[Lane].Value = Variable_4[Lane];
+			}
+		}
+		
 		void Function0_XYZWithoutCache_Compute(const FVoxelContext& Context, FOutputs& Outputs) const
 		{
 			// X
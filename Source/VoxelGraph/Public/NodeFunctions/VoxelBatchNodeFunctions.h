@@ -0,0 +1,141 @@
+// Copyright Voxel Plugin SAS. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoxelMinimal.h"
+#include "NodeFunctions/VoxelNodeFunctions.h"
+
+// Lane-wise versions of the node functions, used by the generated ComputeXYZColumnWithCache functions
+// A column is a run of voxels along Z sharing the same X and Y
+// These are simple branchless loops over restrict pointers so that the compiler vectorizes them
+namespace FVoxelBatchNodeFunctions
+{
+	// Max number of lanes computed at once. Columns longer than this are split
+	static constexpr int32 MaxNum = 32;
+
+	FORCEINLINE void Set(v_flt* RESTRICT Out, v_flt Value, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = Value;
+		}
+	}
+
+	FORCEINLINE void Add(const v_flt* RESTRICT A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] + B[Index];
+		}
+	}
+	FORCEINLINE void Add(const v_flt* RESTRICT A, v_flt B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] + B;
+		}
+	}
+
+	FORCEINLINE void Subtract(const v_flt* RESTRICT A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] - B[Index];
+		}
+	}
+	FORCEINLINE void Subtract(const v_flt* RESTRICT A, v_flt B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] - B;
+		}
+	}
+	FORCEINLINE void Subtract(v_flt A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A - B[Index];
+		}
+	}
+
+	FORCEINLINE void Multiply(const v_flt* RESTRICT A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] * B[Index];
+		}
+	}
+	FORCEINLINE void Multiply(const v_flt* RESTRICT A, v_flt B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] * B;
+		}
+	}
+
+	FORCEINLINE void Divide(const v_flt* RESTRICT A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] / B[Index];
+		}
+	}
+	FORCEINLINE void Divide(const v_flt* RESTRICT A, v_flt B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A[Index] / B;
+		}
+	}
+	FORCEINLINE void Divide(v_flt A, const v_flt* RESTRICT B, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = A / B[Index];
+		}
+	}
+
+	FORCEINLINE void Clamp(v_flt* RESTRICT InOut, v_flt Min, v_flt Max, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			InOut[Index] = FMath::Min(FMath::Max(InOut[Index], Min), Max);
+		}
+	}
+
+	FORCEINLINE void Sqrt(const v_flt* RESTRICT F, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			// Same as FVoxelRangeUtilities::Sqrt: negative values are 0
+			Out[Index] = std::sqrt(FMath::Max<v_flt>(F[Index], 0));
+		}
+	}
+
+	// X and Y are constant along a column
+	FORCEINLINE void VectorLength(v_flt X, v_flt Y, const v_flt* RESTRICT Z, v_flt* RESTRICT Out, int32 Num)
+	{
+		const v_flt XY = X * X + Y * Y;
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = std::sqrt(FMath::Max<v_flt>(XY + Z[Index] * Z[Index], 0));
+		}
+	}
+	FORCEINLINE void VectorLength(const v_flt* RESTRICT X, const v_flt* RESTRICT Y, const v_flt* RESTRICT Z, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = std::sqrt(FMath::Max<v_flt>(X[Index] * X[Index] + Y[Index] * Y[Index] + Z[Index] * Z[Index], 0));
+		}
+	}
+
+	// Curves cannot be vectorized, but keeping them in a loop keeps the curve data hot
+	FORCEINLINE void GetCurveValue(const FVoxelRichCurve& Curve, const v_flt* RESTRICT Value, v_flt* RESTRICT Out, int32 Num)
+	{
+		for (int32 Index = 0; Index < Num; Index++)
+		{
+			Out[Index] = FVoxelNodeFunctions::GetCurveValue(Curve, Value[Index]);
+		}
+	}
+}
@@ -7,6 +7,7 @@
 #include "VoxelMinimal.h"
 #include "VoxelContext.h"
 #include "VoxelGraphConstants.h"
+#include "NodeFunctions/VoxelBatchNodeFunctions.h"
 #include "VoxelGenerators/VoxelGeneratorHelpers.h"
 #include "VoxelGenerators/VoxelGeneratorInstance.inl"
 #include "VoxelGraphGeneratorHelpers.generated.h"
@@ -178,15 +179,26 @@ public:
 					auto BufferXY = Target.GetBufferXY();
 					Target.ComputeXYWithCache(Context, BufferX, BufferXY);
 
-					for (VOXEL_QUERY_ZONE_ITERATE(QueryZone, Z))
+					// Compute the Z column in batches: targets defining ComputeXYZColumnWithCache run every node on all the lanes at once
+					for (int32 StartZ = QueryZone.Bounds.Min.Z; StartZ < QueryZone.Bounds.Max.Z; StartZ += FVoxelBatchNodeFunctions::MaxNum * QueryZone.Step)
 					{
-						Context.LocalZ = Context.WorldZ = Z;
-
-						auto Outputs = Target.GetOutputs();
-						Outputs.Init(FVoxelGraphOutputsInit{ MaterialConfig });
-						Outputs.template Set<T, Index>(DefaultValue);
-						Target.ComputeXYZWithCache(Context, static_cast<const decltype(BufferX)&>(BufferX), static_cast<const decltype(BufferXY)&>(BufferXY), Outputs);
-						QueryZone.Set(X, Y, Z, QueryZoneType(Outputs.template Get<T, Index>()));
+						const int32 Num = FMath::Min<int32>(FVoxelBatchNodeFunctions::MaxNum, FVoxelUtilities::DivideCeil(QueryZone.Bounds.Max.Z - StartZ, QueryZone.Step));
+
+						v_flt Zs[FVoxelBatchNodeFunctions::MaxNum];
+						decltype(Target.GetOutputs()) Outputs[FVoxelBatchNodeFunctions::MaxNum];
+						for (int32 Lane = 0; Lane < Num; Lane++)
+						{
+							Zs[Lane] = StartZ + Lane * int32(QueryZone.Step);
+							Outputs[Lane].Init(FVoxelGraphOutputsInit{ MaterialConfig });
+							Outputs[Lane].template Set<T, Index>(DefaultValue);
+						}
+						
+						ComputeXYZColumn(Target, Context, static_cast<const decltype(BufferX)&>(BufferX), static_cast<const decltype(BufferXY)&>(BufferXY), Zs, Num, Outputs, 0);
+						
+						for (int32 Lane = 0; Lane < Num; Lane++)
+						{
+							QueryZone.Set(X, Y, StartZ + Lane * QueryZone.Step, QueryZoneType(Outputs[Lane].template Get<T, Index>()));
+						}
 					}
 				}
 			}
@@ -332,6 +344,42 @@ public:
 public:
 	virtual void InitGraph(const FVoxelGeneratorInit& InitStruct) = 0;
 
+protected:
+	// Preferred overload, picked if the target has a batched column path
+	template<typename TTarget, typename TBufferX, typename TBufferXY, typename TOutputs>
+	static auto ComputeXYZColumn(
+		const TTarget& Target,
+		FVoxelContext& Context,
+		const TBufferX& BufferX,
+		const TBufferXY& BufferXY,
+		const v_flt* RESTRICT Zs,
+		int32 Num,
+		TOutputs* RESTRICT Outputs,
+		int32) -> decltype(Target.ComputeXYZColumnWithCache(Context, BufferX, BufferXY, Zs, Num, Outputs))
+	{
+		// Column functions read Z from Zs: only keep the context coherent
+		Context.LocalZ = Context.WorldZ = Zs[0];
+		return Target.ComputeXYZColumnWithCache(Context, BufferX, BufferXY, Zs, Num, Outputs);
+	}
+	// Fallback: one voxel at a time
+	template<typename TTarget, typename TBufferX, typename TBufferXY, typename TOutputs>
+	static void ComputeXYZColumn(
+		const TTarget& Target,
+		FVoxelContext& Context,
+		const TBufferX& BufferX,
+		const TBufferXY& BufferXY,
+		const v_flt* RESTRICT Zs,
+		int32 Num,
+		TOutputs* RESTRICT Outputs,
+		int64)
+	{
+		for (int32 Lane = 0; Lane < Num; Lane++)
+		{
+			Context.LocalZ = Context.WorldZ = Zs[Lane];
+			Target.ComputeXYZWithCache(Context, BufferX, BufferXY, Outputs[Lane]);
+		}
+	}
+
 protected:
 	template<typename T>
 	struct NoTransformAccessor